@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""
+Porównanie dwóch wyników imu_bench (JSON z --benchmark_out_format=json).
+
+Dla każdego benchmarku z obu plików liczymy stosunek czasu nowy/bazowy.
+Przy powtórzeniach (--benchmark_repetitions) bierzemy medianę, inaczej
+pojedynczy pomiar. Kod wyjścia 1, jeśli któryś benchmark jest wolniejszy
+o więcej niż --threshold (domyślnie 10%).
+
+    imu_bench --benchmark_repetitions=5 --benchmark_report_aggregates_only=true \\
+              --benchmark_out=new.json --benchmark_out_format=json
+    bench/bench_compare.py bench/baselines/x86_64.json new.json
+
+Wyniki z innej maszyny (liczba CPU, MHz) albo z debugowej biblioteki
+Google Benchmark nie są porównywalne: wtedy tabela jest tylko informacyjna,
+regresji się nie liczy, a kod wyjścia to 2 (--force porównuje mimo to).
+
+Nowa baza dla maszyny (<cpu> = uname -m, np. aarch64 na Pi z 64-bitowym
+systemem) – --save zapisuje wynik bez pól jednego przebiegu (ścieżka
+programu, nazwa hosta, load average):
+
+    bench/bench_compare.py --save bench/baselines/<cpu>.json new.json
+"""
+
+import argparse
+import json
+import sys
+from typing import Any, Dict, List
+
+_TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+# pola kontekstu, które muszą się zgadzać, żeby czasy dało się porównać
+_MACHINE_KEYS = ("num_cpus", "mhz_per_cpu")
+# pola jednego przebiegu – nie trafiają do bazy
+_VOLATILE_KEYS = ("executable", "host_name", "load_avg")
+
+
+def load_times(path: str, field: str) -> Dict[str, float]:
+    with open(path, encoding="utf-8") as f:
+        doc = json.load(f)
+
+    plain: Dict[str, float] = {}
+    median: Dict[str, float] = {}
+    for b in doc.get("benchmarks", []):
+        if b.get("error_occurred"):
+            continue
+        name = b.get("run_name", b["name"])
+        ns = float(b[field]) * _TIME_UNIT_NS[b.get("time_unit", "ns")]
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                median[name] = ns
+        else:
+            plain.setdefault(name, ns)
+    plain.update(median)
+    return plain
+
+
+def load_context(path: str) -> Dict[str, Any]:
+    with open(path, encoding="utf-8") as f:
+        return json.load(f).get("context", {})
+
+
+def describe(ctx: Dict[str, Any]) -> str:
+    return "{} cpus @ {} MHz, {}".format(
+        ctx.get("num_cpus", "?"), ctx.get("mhz_per_cpu", "?"), ctx.get("library_build_type", "?"))
+
+
+def context_problems(base: Dict[str, Any], cur: Dict[str, Any]) -> List[str]:
+    problems = []
+    for which, ctx in (("baseline", base), ("current", cur)):
+        if ctx.get("library_build_type") == "debug":
+            problems.append("{}: Google Benchmark library built as debug".format(which))
+    for key in _MACHINE_KEYS:
+        if base.get(key) != cur.get(key):
+            problems.append("{}: baseline {} vs current {}".format(key, base.get(key), cur.get(key)))
+    return problems
+
+
+def save_baseline(src: str, dst: str, allow_debug: bool) -> None:
+    with open(src, encoding="utf-8") as f:
+        doc = json.load(f)
+    ctx = doc.get("context", {})
+    if ctx.get("library_build_type") == "debug" and not allow_debug:
+        print("{}: Google Benchmark library built as debug; "
+              "rebuild it as release or pass --allow-debug".format(src))
+        sys.exit(2)
+    for key in _VOLATILE_KEYS:
+        ctx.pop(key, None)
+    with open(dst, "w", encoding="utf-8") as f:
+        json.dump(doc, f, indent=2)
+        f.write("\n")
+    print("saved {} ({})".format(dst, describe(ctx)))
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Porównaj wyniki imu_bench z bazą.")
+    parser.add_argument("baseline", help="bazowy JSON (np. bench/baselines/x86_64.json)")
+    parser.add_argument("current", help="nowy JSON z imu_bench")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="dopuszczalny wzrost czasu (ułamek, domyślnie 0.10)")
+    parser.add_argument("--field", choices=("cpu_time", "real_time"), default="cpu_time")
+    parser.add_argument("--force", action="store_true",
+                        help="licz regresje także przy niezgodnym kontekście")
+    parser.add_argument("--save", action="store_true",
+                        help="zapisz current jako baseline zamiast porównywać")
+    parser.add_argument("--allow-debug", action="store_true",
+                        help="przy --save: przyjmij wynik z debugowej biblioteki")
+    args = parser.parse_args()
+
+    if args.save:
+        save_baseline(args.current, args.baseline, args.allow_debug)
+        return
+
+    base = load_times(args.baseline, args.field)
+    cur = load_times(args.current, args.field)
+    base_ctx = load_context(args.baseline)
+    cur_ctx = load_context(args.current)
+    problems = context_problems(base_ctx, cur_ctx)
+    comparable = not problems or args.force
+
+    print("baseline: {} ({})".format(args.baseline, describe(base_ctx)))
+    print("current:  {} ({})".format(args.current, describe(cur_ctx)))
+    print("{:<28} {:>12} {:>12} {:>8}".format("benchmark", "base ns", "new ns", "ratio"))
+
+    regressions = 0
+    for name in sorted(set(base) | set(cur)):
+        if name not in base or name not in cur:
+            where = "baseline" if name not in base else "current"
+            print("{:<28} missing in {}".format(name, where))
+            continue
+        ratio = cur[name] / base[name] if base[name] > 0 else float("inf")
+        mark = ""
+        if not comparable:
+            pass    # czasy z innej maszyny – tylko do wglądu
+        elif ratio > 1.0 + args.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        elif ratio < 1.0 - args.threshold:
+            mark = "  faster"
+        print("{:<28} {:>12.1f} {:>12.1f} {:>8.3f}{}".format(name, base[name], cur[name], ratio, mark))
+
+    if not comparable:
+        print("not comparable ({}); --force to count regressions anyway".format("; ".join(problems)))
+        sys.exit(2)
+    if problems:
+        print("warning: {}".format("; ".join(problems)))
+    if regressions:
+        print("{} benchmark(s) slower than baseline by more than {:.0%}".format(regressions, args.threshold))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Test dymny modułu Pythona bno (src/bno_py.cpp) na prawdziwym pybind11 + numpy.
+
+    PYTHONPATH=build python3 bench/bno_py_smoke.py data/left3.csv
+
+Sprawdza:
+    - import bno,
+    - read_samples() z ReplayTransport: kolumny t float64 i float32, jedna
+      próbka na wiersz nagrania, wartości jak w CSV po kwantyzacji SH-2,
+    - tablice bez kopii: dane należą do kapsuły C++ (owndata False, base to
+      PyCapsule) i przeżywają słownik, transport i gc,
+    - add_samples() detektora na tych kolumnach i parse_sh2_input_reports().
+
+Uruchamiany przez ctest (test bno_py_smoke), gdy moduł jest budowany.
+Kod wyjścia 1 przy pierwszym niespełnionym warunku.
+"""
+
+import csv
+import gc
+import sys
+
+import numpy as np
+
+import bno
+
+COLUMNS = ("ax", "ay", "az", "gx", "gy", "gz", "qw", "qi", "qj", "qk")
+# krok kwantyzacji raportu SH-2: accel Q8, gyro Q9, kwaternion Q14
+QUANT = {"ax": 1 / 256, "ay": 1 / 256, "az": 1 / 256,
+         "gx": 1 / 512, "gy": 1 / 512, "gz": 1 / 512,
+         "qw": 1 / 16384, "qi": 1 / 16384, "qj": 1 / 16384, "qk": 1 / 16384}
+
+
+def check(cond: bool, what: str) -> None:
+    if not cond:
+        print(f"FAIL: {what}")
+        sys.exit(1)
+
+
+def main() -> None:
+    if len(sys.argv) != 2:
+        print(f"usage: {sys.argv[0]} <recording.csv>")
+        sys.exit(2)
+    path = sys.argv[1]
+    with open(path, newline="") as f:
+        rows = list(csv.DictReader(f))
+    check(len(rows) > 0, f"{path}: no rows")
+
+    tr = bno.ReplayTransport(path)
+    s = bno.read_samples(tr)
+    check(tr.finished, "replay not finished after read_samples()")
+    check(set(s) == {"t", *COLUMNS}, f"columns {sorted(s)}")
+    check(s["t"].dtype == np.float64, f"t dtype {s['t'].dtype}")
+    for name in COLUMNS:
+        a = s[name]
+        check(a.dtype == np.float32 and a.ndim == 1, f"{name}: {a.dtype} ndim {a.ndim}")
+        check(a.shape == s["t"].shape, f"{name}: length {a.shape} vs t {s['t'].shape}")
+    check(s["t"].shape[0] == len(rows), f"{s['t'].shape[0]} samples for {len(rows)} rows")
+    # replay liczy czas od pierwszej ramki – porównujemy odstępy (rozdzielczość 1 µs)
+    dt_err = float(np.max(np.abs(np.diff(s["t"]) - np.diff([float(r["t"]) for r in rows]))))
+    check(dt_err <= 2e-6, f"t: max step error {dt_err}")
+    for name in COLUMNS:
+        ref = np.array([float(r[name]) for r in rows])
+        err = float(np.max(np.abs(s[name] - ref)))
+        check(err <= QUANT[name], f"{name}: max error {err} > {QUANT[name]}")
+
+    # bez kopii: pamięć trzyma kapsuła z wektorem C++
+    for name in ("t", *COLUMNS):
+        a = s[name]
+        check(not a.flags.owndata, f"{name}: numpy owns a copy")
+        check(type(a.base).__name__ == "PyCapsule", f"{name}: base is {type(a.base).__name__}")
+
+    az = s["az"]
+    expected = np.array([float(r["az"]) for r in rows])
+    del s, tr
+    gc.collect()
+    check(float(np.max(np.abs(az - expected))) <= QUANT["az"], "az changed after the dict was freed")
+
+    # detektor na kolumnach z read_samples (te same dtype – bez konwersji)
+    s = bno.read_samples(bno.ReplayTransport(path))
+    det = bno.GestureDirectionDetector(bno.imu_dir_config())
+    results = det.add_samples(s)
+    check(isinstance(results, list), "add_samples() did not return a list")
+
+    # payload kanału 3: 0xFB + Linear Acceleration (Q8) z az = 1.0 m/s²
+    payload = bytes([0xFB, 0, 0, 0, 0, 0x04, 0, 0x03, 0, 0, 0, 0, 0, 0x00, 0x01])
+    events = bno.parse_sh2_input_reports(payload)
+    check(len(events) == 1, f"{len(events)} events from one report")
+
+    print(f"bno_py smoke: {len(rows)} samples, zero-copy columns, {len(results)} gestures")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,328 @@
+// Ścieżka stałoprzecinkowa (gesture_dir_t.hpp) vs float: zgodność i szybkość.
+//
+// Te same ramki SH-2 idą przez trzy ścieżki bajty -> etykieta:
+//   host   – parse_sh2_input_reports + GestureDirectionDetector (double/float, jak imu_dir)
+//   float  – BasicGestureFrontEnd<float>
+//   q16    – BasicGestureFrontEnd<Q16>, bez ani jednej operacji zmiennoprzecinkowej
+// Ramki: nagrania z argumentów (zakodowane jak imu_dir --replay) oraz
+// symulator (ShtpSimTransport, gesty co ~2 s, batching po 3 raporty).
+//
+// Zgodność: wynik A pasuje do B, jeśli ta sama etykieta i |Δt_center| <= 50 ms.
+// Dla pary q16/float także największy błąd Δv. Czas: ns na próbkę akcelerometru
+// (parsowanie + detektor), najlepszy z kilku przebiegów.
+//
+// --check (test ctest gesture_parity): bez pomiaru czasu, kod wyjścia 1, gdy
+// float i host nie dają tych samych gestów posuwistych (wynik float w miejscu
+// gestu obrotowego hosta jest dozwolony – ścieżka MCU ich nie zna) albo Δv
+// różni się o więcej niż 1e-3 m/s, lub gdy q16 gubi albo dodaje gesty.
+//
+// Użycie: imu_fixed_bench [--check] [--devices N] [--duration S] [data/*.csv ...]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"
+#include "bno/gesture_dir_t.hpp"
+#include "bno/imu_log.hpp"
+#include "bno/sh2_enable.hpp"
+#include "bno/sh2_reports.hpp"
+#include "bno/shtp_replay.hpp"
+#include "bno/shtp_sim.hpp"
+
+namespace {
+
+struct Frame {
+    std::vector<std::uint8_t> payload;
+    std::uint32_t t_read_us;
+};
+
+// Jedno źródło = jedna sesja detektora (nagranie albo urządzenie symulatora)
+struct Stream {
+    std::string name;
+    std::vector<Frame> frames;
+};
+
+struct Hit {
+    std::uint32_t t_center_us;
+    std::string label;
+    double dv[3];
+};
+
+std::uint32_t to_us(double t)
+{
+    return static_cast<std::uint32_t>(std::llround(t * 1e6));
+}
+
+// ---------- trzy ścieżki ----------
+
+std::size_t run_host(const Stream& s, std::vector<Hit>* hits)
+{
+    bno::GestureDirectionDetector det(bno::GestureDirectionDetector::Config{});
+    bno::Sh2SensorEvent events[16];
+    bno::Quat quat{};
+    bno::Vec3 gyro{};
+    bool have_quat = false;
+    std::size_t samples = 0;
+    for (const auto& f : s.frames) {
+        const std::size_t n = bno::parse_sh2_input_reports(f.payload.data(), f.payload.size(),
+                                                           events, std::size(events));
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& e = events[i];
+            if (e.gyro) {
+                gyro = bno::Vec3{e.gyro->x, e.gyro->y, e.gyro->z};
+            }
+            if (e.game_quat) {
+                quat = bno::Quat{e.game_quat->real, e.game_quat->i, e.game_quat->j, e.game_quat->k};
+                have_quat = true;
+            }
+            if (!e.accel || !have_quat) {
+                continue;
+            }
+            // czas jak ścieżka MCU: µs odczytu + offset raportu
+            const double t = static_cast<double>(f.t_read_us + static_cast<std::uint32_t>(e.host_offset_us)) * 1e-6;
+            det.add_sample(t, bno::Vec3{e.accel->x, e.accel->y, e.accel->z}, gyro, quat);
+            ++samples;
+            if (auto r = det.poll_result(); r && hits) {
+                hits->push_back(Hit{to_us(r->t_center), r->label,
+                                    {r->delta_v_world.x, r->delta_v_world.y, r->delta_v_world.z}});
+            }
+        }
+    }
+    return samples;
+}
+
+template <typename Num>
+std::size_t run_templated(const Stream& s, std::vector<Hit>* hits)
+{
+    using FrontEnd = bno::BasicGestureFrontEnd<Num>;
+    FrontEnd fe(typename FrontEnd::Detector::Config{});
+    std::size_t samples = 0;
+    for (const auto& f : s.frames) {
+        samples += fe.feed(f.payload.data(), f.payload.size(), f.t_read_us,
+                           [&](const typename FrontEnd::Result& r) {
+            if (hits) {
+                hits->push_back(Hit{r.t_center_us, bno::gesture_direction_label(r.direction),
+                                    {bno::NumOps<Num>::to_double(r.delta_v[0]),
+                                     bno::NumOps<Num>::to_double(r.delta_v[1]),
+                                     bno::NumOps<Num>::to_double(r.delta_v[2])}});
+            }
+        });
+    }
+    return samples;
+}
+
+// ---------- porównanie ----------
+
+struct Agreement {
+    std::size_t a{0};
+    std::size_t b{0};
+    std::size_t matched{0};
+    std::size_t excused{0};   // A bez pary w miejscu gestu obrotowego B
+    double max_dv_err{0.0};
+    double max_dt_ms{0.0};
+};
+
+constexpr std::int64_t TOL_US = 50000;
+
+bool near(const Hit& x, const Hit& y)
+{
+    return std::llabs(static_cast<std::int64_t>(x.t_center_us) -
+                      static_cast<std::int64_t>(y.t_center_us)) <= TOL_US;
+}
+
+void compare(const std::vector<Hit>& a, const std::vector<Hit>& b, Agreement& out,
+             const std::vector<Hit>& b_rotation = {})
+{
+    out.a += a.size();
+    out.b += b.size();
+    std::vector<bool> used(b.size(), false);
+    for (const auto& ha : a) {
+        bool found = false;
+        for (std::size_t j = 0; j < b.size(); ++j) {
+            const std::int64_t dt = static_cast<std::int64_t>(b[j].t_center_us) -
+                                    static_cast<std::int64_t>(ha.t_center_us);
+            if (used[j] || std::llabs(dt) > TOL_US || b[j].label != ha.label) {
+                continue;
+            }
+            used[j] = true;
+            ++out.matched;
+            out.max_dt_ms = std::max(out.max_dt_ms, static_cast<double>(std::llabs(dt)) * 1e-3);
+            for (int k = 0; k < 3; ++k) {
+                out.max_dv_err = std::max(out.max_dv_err, std::fabs(ha.dv[k] - b[j].dv[k]));
+            }
+            found = true;
+            break;
+        }
+        if (!found && std::any_of(b_rotation.begin(), b_rotation.end(),
+                                  [&](const Hit& hr) { return near(ha, hr); })) {
+            ++out.excused;
+        }
+    }
+}
+
+void print_agreement(const char* name, const Agreement& g)
+{
+    std::printf("  %-14s %6zu %6zu %8zu %10.1f %12.5f\n",
+                name, g.a, g.b, g.matched, g.max_dt_ms, g.max_dv_err);
+}
+
+template <typename Fn>
+double ns_per_sample(const std::vector<Stream>& streams, Fn&& fn)
+{
+    double best = 1e300;
+    for (int rep = 0; rep < 5; ++rep) {
+        std::size_t samples = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (const auto& s : streams) {
+            samples += fn(s);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - t0).count();
+        if (samples > 0) {
+            best = std::min(best, ns / static_cast<double>(samples));
+        }
+    }
+    return best;
+}
+
+// false, gdy check i ścieżki się rozjechały
+bool report(const char* title, const std::vector<Stream>& streams, bool check)
+{
+    constexpr double DV_TOL = 1e-3;   // m/s, float vs host
+    Agreement float_host;
+    Agreement q16_float;
+    std::size_t host_other = 0;   // TWIST/FLICK/CIRCLE – ścieżka MCU ich nie zna
+    for (const auto& s : streams) {
+        std::vector<Hit> host;
+        std::vector<Hit> f32;
+        std::vector<Hit> q16;
+        run_host(s, &host);
+        run_templated<float>(s, &f32);
+        run_templated<bno::Q16>(s, &q16);
+        const auto is_translation = [](const Hit& h) {
+            return h.label.find('_') == std::string::npos;
+        };
+        std::vector<Hit> rotation;
+        std::copy_if(host.begin(), host.end(), std::back_inserter(rotation),
+                     [&](const Hit& h) { return !is_translation(h); });
+        host_other += rotation.size();
+        host.erase(std::remove_if(host.begin(), host.end(),
+                                  [&](const Hit& h) { return !is_translation(h); }),
+                   host.end());
+        compare(f32, host, float_host, rotation);
+        compare(q16, f32, q16_float);
+    }
+
+    std::printf("== %s: %zu streams ==\n", title, streams.size());
+    std::printf("  %-14s %6s %6s %8s %10s %12s\n", "pair A/B", "A", "B", "matched", "max_dt_ms", "max_dv_err");
+    print_agreement("float/host", float_host);
+    print_agreement("q16/float", q16_float);
+    if (host_other > 0) {
+        std::printf("  host rotation gestures (not in MCU path): %zu, float hits there: %zu\n",
+                    host_other, float_host.excused);
+    }
+    if (check) {
+        const bool ok = float_host.matched == float_host.b &&
+                        float_host.matched + float_host.excused == float_host.a &&
+                        float_host.max_dv_err <= DV_TOL &&
+                        q16_float.matched == q16_float.a && q16_float.matched == q16_float.b;
+        std::printf("  parity: %s\n\n", ok ? "OK" : "FAIL");
+        return ok;
+    }
+    std::printf("  ns/sample: host %.0f, float %.0f, q16 %.0f\n\n",
+                ns_per_sample(streams, [](const Stream& s) { return run_host(s, nullptr); }),
+                ns_per_sample(streams, [](const Stream& s) { return run_templated<float>(s, nullptr); }),
+                ns_per_sample(streams, [](const Stream& s) { return run_templated<bno::Q16>(s, nullptr); }));
+    return true;
+}
+
+// ---------- źródła ramek ----------
+
+std::vector<Stream> load_recordings(int argc, char** argv, int first)
+{
+    std::vector<Stream> out;
+    std::vector<bno::ImuCsvRow> rows;
+    for (int a = first; a < argc; ++a) {
+        std::string err;
+        if (!bno::read_imu_samples(argv[a], rows, err)) {
+            std::cerr << "skip: " << err << "\n";
+            continue;
+        }
+        Stream s;
+        s.name = argv[a];
+        std::uint8_t seq = 0;
+        for (const auto& r : rows) {
+            Frame f;
+            bno::encode_sh2_input_payload(r, seq++, f.payload);
+            f.t_read_us = to_us(r.t);
+            s.frames.push_back(std::move(f));
+        }
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+std::vector<Stream> simulate(std::size_t devices, double duration_s)
+{
+    bno::SimDeviceConfig cfg;
+    cfg.batch = 3;
+    cfg.gyro_hz = 0;   // ścieżka MCU nie używa ω – tylko accel + GRV
+    std::vector<Stream> out;
+    for (std::size_t d = 0; d < devices; ++d) {
+        bno::ShtpSimTransport sim(cfg, 1000 + d);
+        bno::ShtpError err;
+        bno::enable_sensor_report(sim, bno::Sh2SensorId::LinearAcceleration, cfg.accel_hz, err);
+        bno::enable_sensor_report(sim, bno::Sh2SensorId::GameRotationVector, cfg.grv_hz, err);
+        Stream s;
+        s.name = "sim" + std::to_string(d);
+        while (sim.now() < duration_s) {
+            auto frame = sim.read_frame(err, 20);
+            if (frame && frame->header.channel == static_cast<std::uint8_t>(bno::ShtpChannel::SensorReport)) {
+                s.frames.push_back(Frame{std::move(frame->payload), to_us(sim.frame_time())});
+            }
+        }
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t devices = 16;
+    double duration_s = 60.0;
+    bool check = false;
+    int first_file = 1;
+    for (; first_file < argc; ++first_file) {
+        const std::string arg = argv[first_file];
+        if (arg == "--check") {
+            check = true;
+        } else if (arg == "--devices" && first_file + 1 < argc) {
+            devices = std::strtoul(argv[++first_file], nullptr, 10);
+        } else if (arg == "--duration" && first_file + 1 < argc) {
+            duration_s = std::atof(argv[++first_file]);
+        } else if (arg == "-h" || arg == "--help") {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--check] [--devices N] [--duration S] [imu_read.csv...]\n";
+            return 0;
+        } else {
+            break;
+        }
+    }
+
+    bool ok = true;
+    if (first_file < argc) {
+        ok = report("recordings", load_recordings(argc, argv, first_file), check) && ok;
+    }
+    ok = report("simulator", simulate(devices, duration_s), check) && ok;
+    return ok ? 0 : 1;
+}
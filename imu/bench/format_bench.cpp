@@ -0,0 +1,189 @@
+// Koszt formatowania wierszy CSV imu_read (11 double na wiersz):
+//
+//   iostream     – stara ścieżka: operator<< do std::ofstream
+//   snprintf     – "%g" do bufora + fwrite
+//   RowFormatter – std::to_chars, stała liczba miejsc, fwrite co 8 KiB
+//
+// Wyjście idzie do /dev/null (albo --out <plik>), więc mierzymy głównie
+// formatowanie. Na końcu sprawdzamy, że RowFormatter wczytuje się z
+// powrotem z błędem ≤ 0.5e-6 (połowa ostatniego miejsca).
+//
+// Użycie: imu_format_bench [--rows N] [--out path]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bno/imu_csv.hpp"
+#include "bno/row_format.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+std::vector<bno::ImuCsvRow> make_rows(std::size_t n)
+{
+    // wartości jak z nagrania: accel Q8, gyro Q9, kwaternion Q14
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<bno::ImuCsvRow> rows(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto& r = rows[i];
+        r.t  = 0.123456 + static_cast<double>(i) * 0.01;
+        r.ax = std::round(noise(rng) * 256.0) / 256.0;
+        r.ay = std::round(noise(rng) * 256.0) / 256.0;
+        r.az = std::round((9.81 + noise(rng)) * 256.0) / 256.0;
+        r.gx = std::round(noise(rng) * 512.0) / 512.0;
+        r.gy = std::round(noise(rng) * 512.0) / 512.0;
+        r.gz = std::round(noise(rng) * 512.0) / 512.0;
+        double q[4] = {1.0 + noise(rng), noise(rng), noise(rng), noise(rng)};
+        const double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        r.qw = std::round(q[0] / norm * 16384.0) / 16384.0;
+        r.qi = std::round(q[1] / norm * 16384.0) / 16384.0;
+        r.qj = std::round(q[2] / norm * 16384.0) / 16384.0;
+        r.qk = std::round(q[3] / norm * 16384.0) / 16384.0;
+    }
+    return rows;
+}
+
+struct Result {
+    const char* name;
+    double seconds;
+};
+
+template <typename Fn>
+double time_best(int reps, Fn&& fn)
+{
+    double best = 1e30;
+    for (int k = 0; k < reps; ++k) {
+        const auto t0 = clock_type::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(clock_type::now() - t0).count());
+    }
+    return best;
+}
+
+double run_iostream(const std::vector<bno::ImuCsvRow>& rows, const std::string& path)
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    return time_best(3, [&] {
+        for (const auto& row : rows) {
+            out << row.t << ','
+                << row.ax << ',' << row.ay << ',' << row.az << ','
+                << row.gx << ',' << row.gy << ',' << row.gz << ','
+                << row.qw << ',' << row.qi << ',' << row.qj << ',' << row.qk << '\n';
+        }
+        out.flush();
+    });
+}
+
+double run_snprintf(const std::vector<bno::ImuCsvRow>& rows, const std::string& path)
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        return 0.0;
+    }
+    const double s = time_best(3, [&] {
+        char line[256];
+        for (const auto& row : rows) {
+            const int n = std::snprintf(line, sizeof(line), "%g,%g,%g,%g,%g,%g,%g,%g,%g,%g,%g\n",
+                                        row.t, row.ax, row.ay, row.az, row.gx, row.gy, row.gz,
+                                        row.qw, row.qi, row.qj, row.qk);
+            std::fwrite(line, 1, static_cast<std::size_t>(n), f);
+        }
+        std::fflush(f);
+    });
+    std::fclose(f);
+    return s;
+}
+
+double run_row_formatter(const std::vector<bno::ImuCsvRow>& rows, const std::string& path)
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        return 0.0;
+    }
+    bno::RowFormatter text(16 * 1024);
+    const double s = time_best(3, [&] {
+        for (const auto& row : rows) {
+            text.put_imu_row(row);
+            if (text.size() >= 8 * 1024) {
+                text.write_to(f, false);
+            }
+        }
+        text.write_to(f);
+    });
+    std::fclose(f);
+    return s;
+}
+
+// RowFormatter -> parse_imu_csv_line: największy błąd po drodze
+double roundtrip_error(const std::vector<bno::ImuCsvRow>& rows)
+{
+    bno::RowFormatter text(256);
+    double max_err = 0.0;
+    for (const auto& row : rows) {
+        text.clear();
+        text.put_imu_row(row);
+        bno::ImuCsvRow back;
+        if (!bno::parse_imu_csv_line(text.data(), text.data() + text.size() - 1, back)) {
+            return 1e30;
+        }
+        const double a[11] = {row.t, row.ax, row.ay, row.az, row.gx, row.gy, row.gz,
+                              row.qw, row.qi, row.qj, row.qk};
+        const double b[11] = {back.t, back.ax, back.ay, back.az, back.gx, back.gy, back.gz,
+                              back.qw, back.qi, back.qj, back.qk};
+        for (std::size_t i = 0; i < 11; ++i) {
+            max_err = std::max(max_err, std::fabs(a[i] - b[i]));
+        }
+    }
+    return max_err;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t n_rows = 200000;
+    std::string path = "/dev/null";
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--rows" && i + 1 < argc) {
+            n_rows = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--out" && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--rows N] [--out path]\n";
+            return 1;
+        }
+    }
+
+    const auto rows = make_rows(n_rows);
+
+    const Result results[] = {
+        {"iostream", run_iostream(rows, path)},
+        {"snprintf", run_snprintf(rows, path)},
+        {"RowFormatter", run_row_formatter(rows, path)},
+    };
+
+    const double base = results[0].seconds;
+    std::printf("%zu rows -> %s\n", n_rows, path.c_str());
+    for (const auto& r : results) {
+        const double rows_per_s = (r.seconds > 0.0) ? static_cast<double>(n_rows) / r.seconds : 0.0;
+        std::printf("  %-13s %8.1f ms  %10.0f rows/s  x%.2f\n",
+                    r.name, r.seconds * 1000.0, rows_per_s,
+                    (r.seconds > 0.0) ? base / r.seconds : 0.0);
+    }
+
+    const double err = roundtrip_error(rows);
+    std::printf("RowFormatter round-trip max error: %.3g (limit 1e-6)\n", err);
+    return err < 1e-6 ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+// Dokładność fuzji orientacji i trackera toru na danych syntetycznych.
+//
+// 1) Fuzja: gyro 1 kHz z biasem i szumem, co 2 s szybki obrót (15 rad/s,
+//    150 ms), GRV 100 Hz z opóźnieniem 20 ms. Błąd orientacji względem prawdy:
+//    sam GRV (ostatni pomiar) vs OrientationFusion każdą metodą.
+// 2) Tracker: 400 Hz, a z biasem i szumem; odcinek 0.2 m wzdłuż -z (0.5 s),
+//    potem okrąg o promieniu 0.1 m w płaszczyźnie xy (1 s), pomiędzy bezruch.
+//    Drukuje cechy toru obu fragmentów i pozycję końcową.
+//
+// Użycie: imu_fusion_bench [--seed N]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "bno/motion_tracker.hpp"
+#include "bno/orientation_fusion.hpp"
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double RAD_TO_DEG = 180.0 / PI;
+
+bno::Quat quat_exp(const bno::Vec3& v)
+{
+    const double a = bno::norm(v);
+    if (a < 1e-12) {
+        return bno::Quat{};
+    }
+    const double s = std::sin(0.5 * a) / a;
+    return bno::Quat{std::cos(0.5 * a), v.x * s, v.y * s, v.z * s};
+}
+
+double angle_between(const bno::Quat& a, const bno::Quat& b)
+{
+    return bno::quat_angle(bno::quat_mul(bno::quat_conj(a), b));
+}
+
+struct FusionResult {
+    double mean_deg{0.0};
+    double max_deg{0.0};
+    double fast_mean_deg{0.0};   // tylko próbki w szybkim obrocie
+    bno::Vec3 bias{};
+};
+
+// method < 0: sam GRV (orientacja = ostatni pomiar)
+FusionResult run_fusion(int method, unsigned seed)
+{
+    constexpr double GYRO_DT = 0.001;
+    constexpr int GRV_EVERY = 10;       // 100 Hz
+    constexpr std::size_t GRV_LAG = 20; // próbek gyro = 20 ms
+    constexpr int SAMPLES = 20000;      // 20 s
+    const bno::Vec3 bias{0.02, -0.015, 0.01};
+
+    bno::OrientationFusion::Config cfg;
+    if (method >= 0) {
+        cfg.method = static_cast<bno::FusionMethod>(method);
+    }
+    bno::OrientationFusion fusion(cfg);
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.005);
+
+    bno::Quat truth{};
+    bno::Quat last_grv{};
+    bool have_grv = false;
+    std::vector<bno::Quat> history(GRV_LAG + 1);   // prawda sprzed 0..GRV_LAG próbek
+    FusionResult r;
+    double sum = 0.0, fast_sum = 0.0;
+    int count = 0, fast_count = 0;
+
+    for (int k = 0; k < SAMPLES; ++k) {
+        const double t = k * GYRO_DT;
+        bno::Vec3 w{0.3 * std::sin(t), 0.2 * std::cos(0.7 * t), 0.1};
+        const double phase = std::fmod(t, 2.0);
+        const bool fast = phase > 1.0 && phase < 1.15;
+        if (fast) {
+            w.z += 15.0 * std::sin(PI * (phase - 1.0) / 0.15);
+        }
+        truth = bno::quat_mul(truth, quat_exp(bno::Vec3{w.x * GYRO_DT, w.y * GYRO_DT, w.z * GYRO_DT}));
+        history[static_cast<std::size_t>(k) % history.size()] = truth;
+
+        fusion.update_gyro(t, bno::Vec3{w.x + bias.x + noise(rng), w.y + bias.y + noise(rng),
+                                        w.z + bias.z + noise(rng)});
+        if (k % GRV_EVERY == 0 && static_cast<std::size_t>(k) >= GRV_LAG) {
+            const std::size_t then = static_cast<std::size_t>(k) - GRV_LAG;
+            last_grv = history[then % history.size()];
+            fusion.correct_quat(static_cast<double>(then) * GYRO_DT, last_grv);
+            have_grv = true;
+        }
+        if (t > 2.0 && have_grv) {
+            const double e = angle_between(method < 0 ? last_grv : fusion.quat(), truth);
+            sum += e;
+            ++count;
+            r.max_deg = std::max(r.max_deg, e);
+            if (fast) {
+                fast_sum += e;
+                ++fast_count;
+            }
+        }
+    }
+    r.mean_deg = sum / count * RAD_TO_DEG;
+    r.max_deg *= RAD_TO_DEG;
+    r.fast_mean_deg = fast_sum / fast_count * RAD_TO_DEG;
+    r.bias = fusion.gyro_bias();
+    return r;
+}
+
+// Minimum-jerk 0 -> 1 na s w [0, 1]
+double min_jerk(double s)
+{
+    if (s <= 0.0) {
+        return 0.0;
+    }
+    if (s >= 1.0) {
+        return 1.0;
+    }
+    return s * s * s * (10.0 - 15.0 * s + 6.0 * s * s);
+}
+
+bno::Vec3 track_position(double t)
+{
+    bno::Vec3 p{0.0, 0.0, -0.2 * min_jerk((t - 1.0) / 0.5)};
+    const double th = 2.0 * PI * min_jerk((t - 2.5) / 1.0);
+    p.x += 0.1 * (std::cos(th) - 1.0);
+    p.y += 0.1 * std::sin(th);
+    return p;
+}
+
+void run_tracker(unsigned seed)
+{
+    constexpr double HZ = 400.0;
+    constexpr double H = 1e-3;   // krok różnicy skończonej dla a = p''
+    const bno::Vec3 bias{0.05, -0.03, 0.08};
+
+    bno::MotionTracker tracker;
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.05);
+
+    for (int i = 0; i < static_cast<int>(5.0 * HZ); ++i) {
+        const double t = i / HZ;
+        const bno::Vec3 a = track_position(t - H);
+        const bno::Vec3 b = track_position(t);
+        const bno::Vec3 c = track_position(t + H);
+        const bno::Vec3 accel{(a.x - 2.0 * b.x + c.x) / (H * H) + bias.x + noise(rng),
+                              (a.y - 2.0 * b.y + c.y) / (H * H) + bias.y + noise(rng),
+                              (a.z - 2.0 * b.z + c.z) / (H * H) + bias.z + noise(rng)};
+        // |ω| > still_gyro w ruchu, żeby bezruch nie zależał tylko od a
+        const bool moving = (t >= 1.0 && t < 1.5) || (t >= 2.5 && t < 3.5);
+        tracker.add_sample(t, accel, bno::Vec3{moving ? 0.3 : 0.0, 0.0, 0.0}, bno::Quat{});
+    }
+
+    const bno::PathFeatures line = tracker.path_features(0.95, 1.6);
+    std::printf("line   0.2 m: path=(%.3f,%.3f,%.3f) len=%.3f straight=%.2f round=%.2f shape=%s\n",
+                line.displacement.x, line.displacement.y, line.displacement.z, line.length,
+                line.straightness, line.roundness, bno::path_shape_name(bno::classify_path(line)));
+    const bno::PathFeatures circle = tracker.path_features(2.45, 3.6);
+    std::printf("circle 0.1 m: path=(%.3f,%.3f,%.3f) len=%.3f straight=%.2f round=%.2f shape=%s\n",
+                circle.displacement.x, circle.displacement.y, circle.displacement.z, circle.length,
+                circle.straightness, circle.roundness,
+                bno::path_shape_name(bno::classify_path(circle)));
+    const bno::Vec3 p = tracker.position();
+    const bno::Vec3 b = tracker.accel_bias();
+    std::printf("end position=(%.3f,%.3f,%.3f) m (truth (0,0,-0.200)), accel bias=(%.3f,%.3f,%.3f) "
+                "(truth (%.3f,%.3f,%.3f)), zupt=%llu\n",
+                p.x, p.y, p.z, b.x, b.y, b.z, bias.x, bias.y, bias.z,
+                static_cast<unsigned long long>(tracker.stats().zupt_updates));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::fprintf(stderr, "usage: %s [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("fusion: gyro 1 kHz (bias 0.02/-0.015/0.01 rad/s), GRV 100 Hz, 20 ms latency\n");
+    for (int m = -1; m <= static_cast<int>(bno::FusionMethod::Ekf); ++m) {
+        const FusionResult r = run_fusion(m, seed);
+        std::printf("  %-9s mean %.3f deg  max %.3f deg  fast-turn mean %.3f deg",
+                    m < 0 ? "grv only" : bno::fusion_method_name(static_cast<bno::FusionMethod>(m)),
+                    r.mean_deg, r.max_deg, r.fast_mean_deg);
+        if (m >= 0) {
+            std::printf("  bias (%.4f,%.4f,%.4f)", r.bias.x, r.bias.y, r.bias.z);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("tracker: 400 Hz, accel bias (0.05,-0.03,0.08) m/s^2, noise 0.05 m/s^2\n");
+    run_tracker(seed);
+    return 0;
+}
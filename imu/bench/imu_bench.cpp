@@ -0,0 +1,531 @@
+// Mikrobenchmarki ścieżki próbka -> gest (Google Benchmark):
+//
+//   BM_ParseSensorEvent    – parse_sh2_sensor_event() dla accel / gyro / GRV
+//   BM_ParseInputReports   – cały payload kanału 3 (0xFB + accel + gyro + GRV)
+//   BM_ShtpFrameDecode     – ramka z ShtpSimTransport (accel + gyro + GRV po 100 Hz,
+//                            po 3 raporty w ramce, włączone przez Set Feature)
+//                            + parse_sh2_input_reports;
+//                            czas obejmuje też składanie ramki przez symulator
+//   BM_RotateVectorByQuat  – obrót próbki do układu świata
+//   BM_DetectorAddSample   – GestureDirectionDetector::add_sample przy 100/400/1000 Hz
+//   BM_DetectorTriggered   – jw., ale pik nad progiem stale w buforze, a gest się
+//                            nie klasyfikuje: cechy okna przy każdej próbce
+//   BM_CsvFormatRow        – RowFormatter::put_imu_row (bez I/O)
+//   BM_FusionGyroStep      – OrientationFusion::update_gyro (Madgwick / Mahony / EKF)
+//   BM_FusionCorrect       – krok gyro + correct_quat co 10 próbek (GRV 100 Hz przy 1 kHz)
+//   BM_MotionTrackerStep   – MotionTracker::add_sample przy 400 Hz (Kalman + ZUPT)
+//   BM_WindowFeatures      – cechy okna 0.6 s przy 400 Hz dla klasyfikatora uczonego
+//   BM_DtwEvaluate         – jedna ocena 32 wzorców (60–110 ramek) bez odcięć:
+//                            LB_Keogh + pełne DTW każdego wzorca (budżet 2 ms na Pi 3)
+//   BM_DtwAddSample        – DtwRecognizer::add_sample przy 100 Hz z 32 wzorcami
+//
+// Dane są syntetyczne ze stałym ziarnem, więc wyniki z różnych commitów
+// i maszyn dotyczą tych samych wejść. Zapis i porównanie z bazą:
+//
+//   imu_bench --benchmark_out=new.json --benchmark_out_format=json
+//   bench/bench_compare.py bench/baselines/x86_64.json new.json
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bno/augment.hpp"
+#include "bno/gesture_dtw.hpp"
+#include "bno/gesture_dir.hpp"
+#include "bno/gesture_features.hpp"
+#include "bno/imu_csv.hpp"
+#include "bno/motion_tracker.hpp"
+#include "bno/orientation_fusion.hpp"
+#include "bno/row_format.hpp"
+#include "bno/sh2_enable.hpp"
+#include "bno/sh2_reports.hpp"
+#include "bno/shtp.hpp"
+#include "bno/shtp_sim.hpp"
+
+namespace {
+
+void put_i16(std::vector<std::uint8_t>& out, double v, double q_scale)
+{
+    const auto raw = static_cast<std::int16_t>(std::lround(v * q_scale));
+    const auto u = static_cast<std::uint16_t>(raw);
+    out.push_back(static_cast<std::uint8_t>(u & 0xFF));
+    out.push_back(static_cast<std::uint8_t>(u >> 8));
+}
+
+// Raport SH-2: id, seq, status (accuracy 3), delay – potem wartości Qn
+void put_report(std::vector<std::uint8_t>& out, std::uint8_t id, std::uint8_t seq,
+                std::initializer_list<double> values, double q_scale)
+{
+    out.push_back(id);
+    out.push_back(seq);
+    out.push_back(0x03);
+    out.push_back(0x10);
+    for (double v : values) {
+        put_i16(out, v, q_scale);
+    }
+}
+
+// Payload kanału 3 taki, jak wysyła BNO085 przy accel + gyro + GRV
+std::vector<std::uint8_t> make_input_payload(std::uint8_t seq, std::mt19937& rng)
+{
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<std::uint8_t> p{0xFB, 0x20, 0x00, 0x00, 0x00};   // Base Timestamp Reference
+    p.reserve(64);
+    put_report(p, 0x04, seq, {noise(rng), noise(rng), 9.81 + noise(rng)}, 256.0);
+    put_report(p, 0x02, seq, {noise(rng), noise(rng), noise(rng)}, 512.0);
+    put_report(p, 0x08, seq, {0.1, -0.2, 0.05, 0.97}, 16384.0);   // i, j, k, real
+    return p;
+}
+
+// Spoczynek z szumem i co sekundę ruch start-stop wzdłuż jednej osi
+std::vector<bno::ImuCsvRow> make_motion(int hz, double seconds)
+{
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    constexpr double pi = 3.14159265358979323846;
+    const double dt = 1.0 / hz;
+    std::vector<bno::ImuCsvRow> rows;
+    rows.reserve(static_cast<std::size_t>(seconds * hz));
+    for (double t = 0.0; t < seconds; t += dt) {
+        const double phase = std::fmod(t, 1.0);
+        double a = 0.0;
+        if (phase > 0.4 && phase < 0.6) {
+            a = 8.0 * std::sin(2.0 * pi * (phase - 0.4) / 0.2);
+        }
+        rows.push_back(bno::ImuCsvRow{t,
+            a + noise(rng), noise(rng), 9.81 + noise(rng),
+            noise(rng), noise(rng), noise(rng),
+            1.0, 0.0, 0.0, 0.0});
+    }
+    return rows;
+}
+
+void BM_ParseSensorEvent(benchmark::State& state)
+{
+    std::mt19937 rng(5);
+    const auto payload = make_input_payload(1, rng);
+    // raporty po 0xFB (5 B): accel 10 B, gyro 10 B, GRV 12 B
+    const std::size_t offsets[3] = {5, 15, 25};
+    const std::size_t lengths[3] = {10, 10, 12};
+    std::size_t k = 0;
+    for (auto _ : state) {
+        auto evt = bno::parse_sh2_sensor_event(payload.data() + offsets[k], lengths[k]);
+        benchmark::DoNotOptimize(evt);
+        k = (k + 1) % 3;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseSensorEvent);
+
+void BM_ParseInputReports(benchmark::State& state)
+{
+    std::mt19937 rng(5);
+    const auto payload = make_input_payload(1, rng);
+    bno::Sh2SensorEvent events[16];
+    for (auto _ : state) {
+        const std::size_t n = bno::parse_sh2_input_reports(
+            payload.data(), payload.size(), events, std::size(events));
+        benchmark::DoNotOptimize(n);
+        benchmark::DoNotOptimize(events);
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+}
+BENCHMARK(BM_ParseInputReports);
+
+void BM_ShtpFrameDecode(benchmark::State& state)
+{
+    bno::SimDeviceConfig cfg;
+    cfg.gesture_every_s = 1.0;
+    cfg.batch = 3;   // jak payload BM_ParseInputReports: trzy raporty na ramkę
+    bno::ShtpSimTransport transport(cfg, 11);
+    bno::ShtpError err;
+    bno::enable_sensor_report(transport, bno::Sh2SensorId::LinearAcceleration, cfg.accel_hz, err);
+    bno::enable_sensor_report(transport, bno::Sh2SensorId::GyroscopeCalibrated, cfg.gyro_hz, err);
+    bno::enable_sensor_report(transport, bno::Sh2SensorId::GameRotationVector, cfg.grv_hz, err);
+
+    bno::Sh2SensorEvent events[16];
+    std::size_t total = 0;
+    std::size_t frames = 0;
+    for (auto _ : state) {
+        auto frame = transport.read_frame(err, 20);
+        if (!frame) {
+            if (err) {
+                state.SkipWithError("simulator returned a transport error");
+                break;
+            }
+            continue;   // okno bez ramki (czas wirtualny idzie dalej)
+        }
+        if (frame->header.channel != static_cast<std::uint8_t>(bno::ShtpChannel::SensorReport)) {
+            continue;
+        }
+        ++frames;
+        total += bno::parse_sh2_input_reports(
+            frame->payload.data(), frame->payload.size(), events, std::size(events));
+        benchmark::DoNotOptimize(events);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["events_per_frame"] =
+        static_cast<double>(total) / static_cast<double>(std::max<std::size_t>(frames, 1));
+}
+BENCHMARK(BM_ShtpFrameDecode);
+
+void BM_RotateVectorByQuat(benchmark::State& state)
+{
+    const bno::Quat q{0.9659, 0.0, 0.2588, 0.0};   // 30° wokół Y
+    bno::Vec3 v{0.1, 0.2, 9.81};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v);
+        auto r = bno::rotate_vector_by_quat(v, q);
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RotateVectorByQuat);
+
+// Te same progi co w imu_dir; okno w próbkach rośnie z częstotliwością
+void BM_DetectorAddSample(benchmark::State& state)
+{
+    const int hz = static_cast<int>(state.range(0));
+    const double seconds = 10.0;
+    const auto rows = make_motion(hz, seconds);
+
+    bno::GestureDirectionDetector::Config cfg;
+    cfg.baseline_window_s    = 0.2;
+    cfg.half_window_s        = 0.3;
+    cfg.min_dyn_threshold    = 0.3;
+    cfg.min_peak_magnitude   = 1.0;
+    cfg.min_gesture_interval = 0.5;
+    bno::GestureDirectionDetector detector(cfg);
+
+    std::size_t i = 0;
+    double t_offset = 0.0;
+    std::uint64_t gestures = 0;
+    for (auto _ : state) {
+        const auto& r = rows[i];
+        detector.add_sample(r.t + t_offset,
+                            bno::Vec3{r.ax, r.ay, r.az},
+                            bno::Vec3{r.gx, r.gy, r.gz},
+                            bno::Quat{r.qw, r.qi, r.qj, r.qk});
+        if (detector.poll_result()) {
+            ++gestures;
+        }
+        if (++i == rows.size()) {
+            i = 0;
+            t_offset += seconds;   // czas rośnie dalej, jak w długim nagraniu
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["gestures"] = static_cast<double>(gestures);
+}
+BENCHMARK(BM_DetectorAddSample)->Arg(100)->Arg(400)->Arg(1000);
+
+// Najgorszy przypadek dla cech okna: co 0.5 s dwie próbki ω = 4 rad/s
+// (przekracza min_gyro_peak, ale bez obrotu netto, drogi kątowej na FLICK
+// i piku przyspieszenia), więc każda próbka próbuje detekcji na oknie
+// wokół piku i żadna nie kończy się gestem.
+void BM_DetectorTriggered(benchmark::State& state)
+{
+    const int hz = static_cast<int>(state.range(0));
+    const double seconds = 10.0;
+    std::mt19937 rng(4);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    std::vector<bno::ImuCsvRow> rows;
+    for (int k = 0; k < static_cast<int>(seconds * hz); ++k) {
+        const double t = static_cast<double>(k) / hz;
+        const double w = (std::fmod(t, 0.5) < 2.0 / hz) ? 4.0 : 0.0;
+        rows.push_back(bno::ImuCsvRow{t, noise(rng), noise(rng), 9.81 + noise(rng),
+                                      0.0, 0.0, w, 1.0, 0.0, 0.0, 0.0});
+    }
+
+    bno::GestureDirectionDetector detector(bno::GestureDirectionDetector::Config{});
+
+    std::size_t i = 0;
+    double t_offset = 0.0;
+    std::uint64_t gestures = 0;
+    for (auto _ : state) {
+        const auto& r = rows[i];
+        detector.add_sample(r.t + t_offset, bno::Vec3{r.ax, r.ay, r.az},
+                            bno::Vec3{r.gx, r.gy, r.gz}, bno::Quat{r.qw, r.qi, r.qj, r.qk});
+        if (detector.poll_result()) {
+            ++gestures;
+        }
+        if (++i == rows.size()) {
+            i = 0;
+            t_offset += seconds;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["gestures"] = static_cast<double>(gestures);
+}
+BENCHMARK(BM_DetectorTriggered)->Arg(100)->Arg(400)->Arg(1000);
+
+void BM_CsvFormatRow(benchmark::State& state)
+{
+    const auto rows = make_motion(100, 1.0);
+    bno::RowFormatter out(64 * 1024);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        out.put_imu_row(rows[i]);
+        out.put('\n');
+        if (++i == rows.size()) {
+            i = 0;
+            benchmark::DoNotOptimize(out.view().data());
+            out.clear();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CsvFormatRow);
+
+// Gyro 1 kHz: wolny obrót wokół wszystkich osi plus bias
+bno::Vec3 gyro_at(std::size_t k)
+{
+    const double t = static_cast<double>(k) * 0.001;
+    return bno::Vec3{0.3 * std::sin(t) + 0.02, 0.2 * std::cos(0.7 * t) - 0.015, 0.1};
+}
+
+void BM_FusionGyroStep(benchmark::State& state)
+{
+    bno::OrientationFusion::Config cfg;
+    cfg.method = static_cast<bno::FusionMethod>(state.range(0));
+    bno::OrientationFusion fusion(cfg);
+    fusion.correct_quat(0.0, bno::Quat{});
+    std::size_t k = 0;
+    for (auto _ : state) {
+        ++k;
+        const auto& q = fusion.update_gyro(static_cast<double>(k) * 0.001, gyro_at(k));
+        benchmark::DoNotOptimize(q);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(bno::fusion_method_name(cfg.method));
+}
+BENCHMARK(BM_FusionGyroStep)->Arg(0)->Arg(1)->Arg(2);
+
+void BM_FusionCorrect(benchmark::State& state)
+{
+    bno::OrientationFusion::Config cfg;
+    cfg.method = static_cast<bno::FusionMethod>(state.range(0));
+    bno::OrientationFusion fusion(cfg);
+    std::size_t k = 0;
+    for (auto _ : state) {
+        ++k;
+        const double t = static_cast<double>(k) * 0.001;
+        fusion.update_gyro(t, gyro_at(k));
+        if (k % 10 == 0) {
+            // GRV sprzed 20 ms – przeniesiony do teraz z historii gyro
+            fusion.correct_quat(t - 0.02, bno::Quat{});
+        }
+        benchmark::DoNotOptimize(fusion.quat());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(bno::fusion_method_name(cfg.method));
+}
+BENCHMARK(BM_FusionCorrect)->Arg(0)->Arg(1)->Arg(2);
+
+// Ruchy z make_motion przeplatane bezruchem, więc część próbek idzie z ZUPT
+void BM_MotionTrackerStep(benchmark::State& state)
+{
+    const double seconds = 10.0;
+    const auto rows = make_motion(400, seconds);
+    bno::MotionTracker tracker;
+
+    std::size_t i = 0;
+    double t_offset = 0.0;
+    for (auto _ : state) {
+        const auto& r = rows[i];
+        tracker.add_sample(r.t + t_offset,
+                           bno::Vec3{r.ax, r.ay, r.az},
+                           bno::Vec3{r.gx, r.gy, r.gz},
+                           bno::Quat{r.qw, r.qi, r.qj, r.qk});
+        if (++i == rows.size()) {
+            i = 0;
+            t_offset += seconds;
+        }
+    }
+    benchmark::DoNotOptimize(tracker.position());
+    state.SetItemsProcessed(state.iterations());
+    state.counters["zupt"] = static_cast<double>(tracker.stats().zupt_updates) /
+                             static_cast<double>(std::max<std::uint64_t>(tracker.stats().samples, 1));
+}
+BENCHMARK(BM_MotionTrackerStep);
+
+void BM_WindowFeatures(benchmark::State& state)
+{
+    const auto rows = make_motion(400, 2.0);
+    bno::WindowFeatureExtractor window;
+    for (const auto& r : rows) {
+        window.add_sample(r.t, bno::Vec3{r.ax, r.ay, r.az}, bno::Vec3{r.gx, r.gy, r.gz},
+                          bno::Quat{r.qw, r.qi, r.qj, r.qk});
+    }
+    bno::GestureFeatureVector f{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(window.extract(0.7, 1.3, bno::Vec3{}, f));
+        benchmark::DoNotOptimize(f.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WindowFeatures);
+
+constexpr std::size_t DTW_TEMPLATES = 32;
+
+// Nagranie jednego gestu jak z imu_read przy 100 Hz: 0.3 s spokoju, ruch
+// trwający 0.4–0.9 s, 0.3 s spokoju. Wariant wybiera oś i znak ruchu
+// posuwistego, udział obrotu i liczbę półokresów, więc wzorce się różnią,
+// a po przycięciu mają 60–110 ramek – tyle, ile nagrane gesty.
+std::vector<bno::ImuCsvRow> make_dtw_gesture(std::size_t variant, std::mt19937& rng)
+{
+    constexpr double pi = 3.14159265358979323846;
+    std::normal_distribution<double> noise(0.0, 0.05);
+    const double duration = 0.4 + 0.5 * static_cast<double>(variant % 11) / 10.0;
+    const std::size_t axis = variant % 3;
+    const double sign = (variant / 3) % 2 ? -1.0 : 1.0;
+    const double twist = (variant % 4 == 0) ? 4.0 : 0.0;
+    const double half_periods = 2.0 + static_cast<double>(variant % 2);
+
+    std::vector<bno::ImuCsvRow> rows;
+    for (double t = 0.0; t < duration + 0.6; t += 0.01) {
+        const double s = (t - 0.3) / duration;
+        double a[3] = {0.0, 0.0, 0.0};
+        double w = 0.0;
+        if (s > 0.0 && s < 1.0) {
+            a[axis] = sign * 6.0 * std::sin(half_periods * pi * s);
+            a[(axis + 1) % 3] = 2.0 * std::sin(pi * s);
+            w = twist * std::sin(pi * s);
+        }
+        rows.push_back(bno::ImuCsvRow{t,
+            a[0] + noise(rng), a[1] + noise(rng), 9.81 + a[2] + noise(rng),
+            noise(rng), noise(rng), w + noise(rng),
+            1.0, 0.0, 0.0, 0.0});
+    }
+    return rows;
+}
+
+bool add_dtw_templates(bno::DtwRecognizer& dtw, std::string& err)
+{
+    std::mt19937 rng(21);
+    for (std::size_t k = 0; k < DTW_TEMPLATES; ++k) {
+        if (!dtw.add_template("g" + std::to_string(k), make_dtw_gesture(k, rng), err)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Najgorszy przypadek jednej oceny: każdy wzorzec przechodzi LB_Keogh
+// i pełne DTW (bez wczesnego przerwania). Zapytanie to cechy innego gestu
+// w tym samym układzie SoA co pierścień rozpoznawacza.
+void BM_DtwEvaluate(benchmark::State& state)
+{
+    bno::DtwRecognizer dtw(bno::DtwRecognizer::Config{});
+    std::string err;
+    if (!add_dtw_templates(dtw, err)) {
+        state.SkipWithError(err.c_str());
+        return;
+    }
+
+    constexpr std::size_t QUERY_STRIDE = 256;
+    std::mt19937 rng(22);
+    const auto rows = make_dtw_gesture(7, rng);
+    std::vector<float> query(bno::DTW_DIMS * QUERY_STRIDE, 0.0f);
+    for (std::size_t j = 0; j < std::min(rows.size(), QUERY_STRIDE); ++j) {
+        const auto& r = rows[j];
+        const float f[bno::DTW_DIMS] = {
+            static_cast<float>(r.ax), static_cast<float>(r.ay), static_cast<float>(r.az - 9.81),
+            0.5f * static_cast<float>(r.gx), 0.5f * static_cast<float>(r.gy),
+            0.5f * static_cast<float>(r.gz)};
+        for (std::size_t d = 0; d < bno::DTW_DIMS; ++d) {
+            query[d * QUERY_STRIDE + j] = f[d];
+        }
+    }
+
+    std::size_t frames = 0;
+    for (std::size_t k = 0; k < dtw.template_count(); ++k) {
+        frames += dtw.template_at(k).length;
+    }
+    const float inf = std::numeric_limits<float>::infinity();
+    for (auto _ : state) {
+        float sum = 0.0f;
+        for (std::size_t k = 0; k < dtw.template_count(); ++k) {
+            const bno::DtwTemplate& tmpl = dtw.template_at(k);
+            sum += bno::dtw_kernels::lb_keogh(query.data(), QUERY_STRIDE, tmpl.upper.data(),
+                                              tmpl.lower.data(), tmpl.stride, tmpl.length);
+            sum += dtw.distance(query.data(), QUERY_STRIDE, tmpl, inf);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["templates"] = static_cast<double>(dtw.template_count());
+    state.counters["mean_len"] = static_cast<double>(frames) / static_cast<double>(dtw.template_count());
+    state.SetLabel(bno::dtw_kernels::active_isa());
+}
+BENCHMARK(BM_DtwEvaluate)->Unit(benchmark::kMicrosecond);
+
+// Strumień 100 Hz z 32 wzorcami: ocena co eval_stride próbek, z odcięciami
+// LB_Keogh i wczesnym przerwaniem DTW – koszt na próbkę w praktyce
+void BM_DtwAddSample(benchmark::State& state)
+{
+    bno::DtwRecognizer dtw(bno::DtwRecognizer::Config{});
+    std::string err;
+    if (!add_dtw_templates(dtw, err)) {
+        state.SkipWithError(err.c_str());
+        return;
+    }
+    const double seconds = 10.0;
+    const auto rows = make_motion(100, seconds);
+
+    std::size_t i = 0;
+    double t_offset = 0.0;
+    for (auto _ : state) {
+        const auto& r = rows[i];
+        dtw.add_sample(r.t + t_offset, bno::Vec3{r.ax, r.ay, r.az}, bno::Vec3{r.gx, r.gy, r.gz},
+                       bno::Quat{r.qw, r.qi, r.qj, r.qk});
+        benchmark::DoNotOptimize(dtw.poll_result());
+        if (++i == rows.size()) {
+            i = 0;
+            t_offset += seconds;
+        }
+    }
+    const bno::DtwStats& st = dtw.stats();
+    const double scored = static_cast<double>(st.evaluations) * static_cast<double>(DTW_TEMPLATES);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["evaluations"] = static_cast<double>(st.evaluations);
+    state.counters["lb_pruned"] = scored > 0.0 ? static_cast<double>(st.lb_pruned) / scored : 0.0;
+    state.counters["full_dtw"] = scored > 0.0 ? static_cast<double>(st.full_dtw) / scored : 0.0;
+}
+BENCHMARK(BM_DtwAddSample);
+
+// Jedno okno imu_augment (50 próbek, wszystkie przekształcenia włączone)
+void BM_AugmentWindow(benchmark::State& state)
+{
+    bno::AugmentSource src;
+    std::string err;
+    if (!bno::prepare_augment_source(make_motion(100, 3.0), 0, src, err)) {
+        state.SkipWithError(err.c_str());
+        return;
+    }
+    bno::WindowAugmenter::Config cfg;
+    cfg.mount_deg = 5.0;
+    cfg.background_ratio = 0.2;
+    const bno::WindowAugmenter aug(cfg);
+    std::mt19937_64 rng(5);
+    bno::AugmentWindow w;
+    for (auto _ : state) {
+        aug.generate(src, rng, w);
+        benchmark::DoNotOptimize(w.c[0].data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AugmentWindow);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,316 @@
+// Porównanie opóźnienia detekcji: PeakWindow vs Segmented.
+//
+// 1) Nagrania imu_read (CSV lub .imlog) z argumentów: brak prawdy o końcu gestu,
+//    więc mierzymy t_emit - t_peak i zgodność etykiet wstępnych/końcowych.
+// 2) Syntetyczna sekwencja gestów (100 Hz, szum, znany początek/koniec
+//    i kierunek): mierzymy t_emit - t_koniec_ruchu i trafność etykiet.
+//
+// Użycie: imu_latency_bench [--seed N] [data/*.csv ...]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"
+#include "bno/imu_csv.hpp"
+#include "bno/imu_log.hpp"
+
+namespace {
+
+using Mode = bno::GestureDirectionDetector::Mode;
+
+struct LatencyStats {
+    std::vector<double> ms;
+
+    void add(double seconds) { ms.push_back(seconds * 1000.0); }
+
+    double percentile(double p) const
+    {
+        if (ms.empty()) {
+            return 0.0;
+        }
+        std::vector<double> sorted = ms;
+        std::sort(sorted.begin(), sorted.end());
+        const double pos = p * static_cast<double>(sorted.size() - 1);
+        return sorted[static_cast<std::size_t>(pos + 0.5)];
+    }
+
+    double mean() const
+    {
+        double sum = 0.0;
+        for (double v : ms) {
+            sum += v;
+        }
+        return ms.empty() ? 0.0 : sum / static_cast<double>(ms.size());
+    }
+};
+
+void print_header(const char* what)
+{
+    std::printf("latency = %s (ms)\n", what);
+    std::printf("%-22s %6s %9s %9s %9s %9s\n", "mode", "n", "mean", "p50", "p95", "max");
+}
+
+void print_row(const char* name, const LatencyStats& s)
+{
+    std::printf("%-22s %6zu %9.1f %9.1f %9.1f %9.1f\n",
+                name, s.ms.size(), s.mean(),
+                s.percentile(0.5), s.percentile(0.95),
+                s.ms.empty() ? 0.0 : *std::max_element(s.ms.begin(), s.ms.end()));
+}
+
+// Te same progi co w imu_dir.
+bno::GestureDirectionDetector::Config make_config(Mode mode)
+{
+    bno::GestureDirectionDetector::Config cfg;
+    cfg.baseline_window_s    = 0.2;
+    cfg.half_window_s        = 0.3;
+    cfg.min_dyn_threshold    = 0.3;
+    cfg.min_peak_magnitude   = 1.0;
+    cfg.min_gesture_interval = 0.5;
+    cfg.mode = mode;
+    return cfg;
+}
+
+// ---------- nagrania ----------
+
+void run_recordings(int argc, char** argv, int first_arg)
+{
+    LatencyStats window_lat;
+    LatencyStats seg_provisional_lat;
+    LatencyStats seg_final_lat;
+    std::size_t seg_pairs = 0;
+    std::size_t seg_agree = 0;
+    std::size_t files = 0;
+
+    std::vector<bno::ImuCsvRow> rows;
+    for (int a = first_arg; a < argc; ++a) {
+        std::string err;
+        if (!bno::read_imu_samples(argv[a], rows, err)) {
+            std::cerr << "skip: " << err << "\n";
+            continue;
+        }
+        ++files;
+
+        bno::GestureDirectionDetector window_det(make_config(Mode::PeakWindow));
+        bno::GestureDirectionDetector seg_det(make_config(Mode::Segmented));
+        std::map<std::uint32_t, std::string> provisional_label;
+
+        for (const auto& r : rows) {
+            const bno::Vec3 accel{r.ax, r.ay, r.az};
+            const bno::Vec3 gyro{r.gx, r.gy, r.gz};
+            const bno::Quat quat{r.qw, r.qi, r.qj, r.qk};
+
+            window_det.add_sample(r.t, accel, gyro, quat);
+            if (auto res = window_det.poll_result()) {
+                window_lat.add(res->t_emit - res->t_center);
+            }
+
+            seg_det.add_sample(r.t, accel, gyro, quat);
+            if (auto res = seg_det.poll_result()) {
+                if (res->provisional) {
+                    seg_provisional_lat.add(res->t_emit - res->t_center);
+                    provisional_label[res->gesture_id] = res->label;
+                } else {
+                    seg_final_lat.add(res->t_emit - res->t_center);
+                    auto it = provisional_label.find(res->gesture_id);
+                    if (it != provisional_label.end()) {
+                        ++seg_pairs;
+                        seg_agree += (it->second == res->label) ? 1u : 0u;
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("== recordings: %zu files ==\n", files);
+    print_header("t_emit - t_peak");
+    print_row("peak-window", window_lat);
+    print_row("segmented/provisional", seg_provisional_lat);
+    print_row("segmented/final", seg_final_lat);
+    std::printf("provisional == final label: %zu/%zu\n\n", seg_agree, seg_pairs);
+}
+
+// ---------- syntetyczne gesty ----------
+
+struct TruthGesture {
+    double t_start;
+    double t_end;
+    std::string label;
+};
+
+struct Synthetic {
+    std::vector<bno::ImuCsvRow> rows;
+    std::vector<TruthGesture> truth;
+};
+
+// Ruch start-stop: półsinus przyspieszania (T1, A), potem dłuższy i słabszy
+// półsinus hamowania (T2, A*T1/T2) – netto Δv = 0, jak przy prawdziwej ręce.
+Synthetic make_synthetic(std::uint32_t seed, std::size_t n_gestures)
+{
+    static const struct { const char* label; int axis; double sign; } dirs[] = {
+        {"UP", 0, 1.0},    {"DOWN", 0, -1.0},
+        {"FORWARD", 1, 1.0}, {"BACKWARD", 1, -1.0},
+        {"RIGHT", 2, 1.0}, {"LEFT", 2, -1.0},
+    };
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u01(0.0, 1.0);
+    std::normal_distribution<double> noise(0.0, 0.05);
+
+    constexpr double dt = 0.01;  // 100 Hz
+    constexpr double pi = 3.14159265358979323846;
+    const double gravity[3] = {9.81, 0.0, 0.0};
+
+    Synthetic out;
+    double t = 0.0;
+    auto emit_rest = [&](double seconds) {
+        for (double end = t + seconds; t < end; t += dt) {
+            out.rows.push_back(bno::ImuCsvRow{t,
+                gravity[0] + noise(rng), gravity[1] + noise(rng), gravity[2] + noise(rng),
+                0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0});
+        }
+    };
+
+    emit_rest(0.5);
+    for (std::size_t g = 0; g < n_gestures; ++g) {
+        const auto& d = dirs[static_cast<std::size_t>(u01(rng) * 6.0) % 6];
+        const double amp = 6.0 + 4.0 * u01(rng);
+        const double t1 = 0.15 + 0.10 * u01(rng);
+        const double t2 = t1 * (1.2 + 0.8 * u01(rng));
+
+        const double t_start = t;
+        for (; t < t_start + t1 + t2; t += dt) {
+            const double tau = t - t_start;
+            const double a = (tau < t1)
+                ? amp * std::sin(pi * tau / t1)
+                : -amp * (t1 / t2) * std::sin(pi * (tau - t1) / t2);
+            double v[3] = {gravity[0], gravity[1], gravity[2]};
+            v[d.axis] += d.sign * a;
+            out.rows.push_back(bno::ImuCsvRow{t,
+                v[0] + noise(rng), v[1] + noise(rng), v[2] + noise(rng),
+                0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0});
+        }
+        out.truth.push_back(TruthGesture{t_start, t, d.label});
+        emit_rest(0.8 + 0.7 * u01(rng));
+    }
+    return out;
+}
+
+// Pierwszy wynik przypisany do gestu (t_center w [start, end]).
+const TruthGesture* match_truth(const std::vector<TruthGesture>& truth, double t_center)
+{
+    for (const auto& g : truth) {
+        if (t_center >= g.t_start - 0.05 && t_center <= g.t_end + 0.05) {
+            return &g;
+        }
+    }
+    return nullptr;
+}
+
+void run_synthetic(std::uint32_t seed)
+{
+    const Synthetic syn = make_synthetic(seed, 200);
+
+    struct Run {
+        const char* name;
+        Mode mode;
+        bool provisional;
+        LatencyStats lat;
+        std::size_t correct{0};
+        std::size_t detected{0};
+    } runs[] = {
+        {"peak-window", Mode::PeakWindow, false, {}, 0, 0},
+        {"segmented/provisional", Mode::Segmented, true, {}, 0, 0},
+        {"segmented/final", Mode::Segmented, false, {}, 0, 0},
+    };
+
+    // Syntetyka idzie ścieżką paczkową (add_samples), nagrania – add_sample.
+    const std::size_t n = syn.rows.size();
+    std::vector<double> t(n);
+    std::vector<float> cols[7];
+    for (auto& c : cols) {
+        c.resize(n);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto& r = syn.rows[i];
+        t[i] = r.t;
+        cols[0][i] = static_cast<float>(r.ax);
+        cols[1][i] = static_cast<float>(r.ay);
+        cols[2][i] = static_cast<float>(r.az);
+        cols[3][i] = static_cast<float>(r.qw);
+        cols[4][i] = static_cast<float>(r.qi);
+        cols[5][i] = static_cast<float>(r.qj);
+        cols[6][i] = static_cast<float>(r.qk);
+    }
+    bno::SampleBatch batch;
+    batch.t  = t.data();
+    batch.ax = cols[0].data();
+    batch.ay = cols[1].data();
+    batch.az = cols[2].data();
+    batch.qw = cols[3].data();
+    batch.qx = cols[4].data();
+    batch.qy = cols[5].data();
+    batch.qz = cols[6].data();
+    batch.n  = n;
+
+    for (auto& run : runs) {
+        bno::GestureDirectionDetector det(make_config(run.mode));
+        std::map<const TruthGesture*, bool> seen;
+        det.add_samples(batch, [&](const bno::GestureResult& res) {
+            if (run.mode == Mode::Segmented && res.provisional != run.provisional) {
+                return;
+            }
+            const TruthGesture* g = match_truth(syn.truth, res.t_center);
+            if (!g || seen[g]) {
+                return;  // fałszywy alarm albo kolejny wynik dla tego samego gestu
+            }
+            seen[g] = true;
+            ++run.detected;
+            run.correct += (res.label == g->label) ? 1u : 0u;
+            run.lat.add(res.t_emit - g->t_end);
+        });
+    }
+
+    std::printf("== synthetic: %zu gestures, seed %u ==\n", syn.truth.size(), seed);
+    print_header("t_emit - t_motion_end");
+    for (const auto& run : runs) {
+        print_row(run.name, run.lat);
+    }
+    std::printf("%-22s %9s %9s\n", "mode", "detected", "correct");
+    for (const auto& run : runs) {
+        std::printf("%-22s %9zu %9zu\n", run.name, run.detected, run.correct);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::uint32_t seed = 1;
+    int first_file = 1;
+    for (; first_file < argc; ++first_file) {
+        const std::string arg = argv[first_file];
+        if (arg == "--seed" && first_file + 1 < argc) {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[++first_file], nullptr, 0));
+        } else if (arg == "-h" || arg == "--help") {
+            std::cerr << "Usage: " << argv[0] << " [--seed N] [imu_read.csv...]\n";
+            return 0;
+        } else {
+            break;
+        }
+    }
+
+    if (first_file < argc) {
+        run_recordings(argc, argv, first_file);
+    }
+    run_synthetic(seed);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Koszt logowania na wątku wołającym (bno/log.hpp):
+//
+//   timestamp    – sam odczyt licznika cykli (część każdego rekordu)
+//   off          – BNO_LOG_DEBUG przy poziomie runtime Info (tylko sprawdzenie)
+//   info 2 args  – rekord do pierścienia wątku, drain w tle
+//   span off     – BNO_TRACE_SPAN bez --trace
+//   span on      – BNO_TRACE_SPAN z --trace (dwa odczyty zegara + rekord);
+//                  budżet liczymy na wywołanie, więc porównujemy połowę
+//   iostream     – stare DEBUG_LOG z logger.hpp: cout << ... << endl
+//
+// Wyjście drain idzie do /dev/null. Pierścień ma 1024 rekordy, więc
+// mierzymy paczkami po 512 z przerwą na opróżnienie – inaczej liczylibyśmy
+// koszt odrzucania.
+//
+// Budżet gorącej ścieżki: ≤ 50 ns na wywołanie. Na x86 pod VM sam rdtsc
+// kosztuje ~20 ns, więc zapas jest niewielki – stąd status w ostatniej linii.
+//
+// Użycie: imu_log_bench [--calls N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+#include "bno/log.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int BATCH = 512;
+
+template <typename Fn>
+double ns_per_call(int calls, Fn&& fn)
+{
+    double total_s = 0.0;
+    for (int done = 0; done < calls; done += BATCH) {
+        const auto t0 = clock_type::now();
+        for (int i = 0; i < BATCH; ++i) {
+            fn(done + i);
+        }
+        total_s += std::chrono::duration<double>(clock_type::now() - t0).count();
+        std::this_thread::sleep_for(std::chrono::milliseconds(25));   // drain nadąża
+    }
+    const int rounded = ((calls + BATCH - 1) / BATCH) * BATCH;
+    return total_s * 1e9 / rounded;
+}
+
+constexpr double BUDGET_NS = 50.0;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int calls = 20 * BATCH;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--calls" && i + 1 < argc) {
+            calls = std::max(BATCH, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--calls N]\n";
+            return 1;
+        }
+    }
+
+    std::FILE* sink = std::fopen("/dev/null", "w");
+    bno::log::start(sink, bno::log::Level::Info);
+
+    volatile double sink_v = 0.0;
+    volatile std::uint64_t ticks_v = 0;
+    const double stamp = ns_per_call(calls, [&](int) {
+        ticks_v = ticks_v + bno::log::detail::now_ticks();
+    });
+    const double off = ns_per_call(calls, [&](int i) {
+        BNO_LOG_DEBUG("bench: debug i={}", i);
+    });
+    const double info = ns_per_call(calls, [&](int i) {
+        BNO_LOG_INFO("bench: frame={} t={}", i, static_cast<double>(i) * 0.01);
+    });
+    bno::log::set_trace(false);
+    const double span_off = ns_per_call(calls, [&](int i) {
+        BNO_TRACE_SPAN("bench.span");
+        sink_v = sink_v + i;
+    });
+    bno::log::set_trace(true);
+    const double span_on = ns_per_call(calls, [&](int i) {
+        BNO_TRACE_SPAN("bench.span");
+        sink_v = sink_v + i;
+    });
+    bno::log::set_trace(false);
+
+    std::ofstream null_out("/dev/null");
+    const double iostream = ns_per_call(calls, [&](int i) {
+        null_out << "[DEBUG] " << "bench: frame=" << i << " t=" << static_cast<double>(i) * 0.01 << std::endl;
+    });
+
+    bno::log::stop();
+    const auto st = bno::log::stats();
+    std::fclose(sink);
+
+    std::printf("%d calls per case\n", calls);
+    std::printf("  %-14s %7.1f ns\n", "timestamp", stamp);
+    std::printf("  %-14s %7.1f ns\n", "off", off);
+    std::printf("  %-14s %7.1f ns\n", "info 2 args", info);
+    std::printf("  %-14s %7.1f ns\n", "span off", span_off);
+    std::printf("  %-14s %7.1f ns\n", "span on", span_on);
+    std::printf("  %-14s %7.1f ns\n", "iostream endl", iostream);
+    const double span_call = span_on / 2.0;
+    std::printf("budget %.0f ns/call: info %s, span %.1f ns/call %s\n", BUDGET_NS,
+                info <= BUDGET_NS ? "ok" : "OVER", span_call, span_call <= BUDGET_NS ? "ok" : "OVER");
+    std::printf("records written=%llu dropped=%llu\n",
+                static_cast<unsigned long long>(st.written),
+                static_cast<unsigned long long>(st.dropped));
+    return st.dropped == 0 ? 0 : 1;
+}
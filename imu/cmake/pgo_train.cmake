@@ -0,0 +1,61 @@
+# Trening PGO: imu_dir --replay po wszystkich nagraniach z DATA_DIR.
+#
+#   cmake -DIMU_DIR=<imu_dir> -DDATA_DIR=<imu/data> [-DEMULATOR=qemu-aarch64] -P pgo_train.cmake
+#
+# Każde nagranie idzie w trzech konfiguracjach (okno piku, segmentacja,
+# wzorce DTW + sekwencje), żeby profil pokrył wszystkie gałęzie detektora.
+# Nagrania, których imu_dir nie wczyta (np. ucięte w pół wiersza), są pomijane.
+
+if (NOT IMU_DIR OR NOT DATA_DIR)
+    message(FATAL_ERROR "pgo_train.cmake: IMU_DIR and DATA_DIR are required")
+endif()
+
+file(GLOB_RECURSE recordings ${DATA_DIR}/*.csv ${DATA_DIR}/*.imlog)
+list(SORT recordings)
+list(LENGTH recordings count)
+if (count EQUAL 0)
+    message(FATAL_ERROR "pgo_train.cmake: no recordings in ${DATA_DIR}")
+endif()
+
+set(runs 0)
+set(template_file "")
+
+function(run_imu_dir ok_var)
+    execute_process(
+        COMMAND ${EMULATOR} ${IMU_DIR} ${ARGN}
+        RESULT_VARIABLE rc
+        OUTPUT_QUIET
+        ERROR_VARIABLE stderr_text
+    )
+    if (rc EQUAL 0)
+        set(${ok_var} TRUE PARENT_SCOPE)
+    else()
+        string(STRIP "${stderr_text}" stderr_text)
+        string(REGEX MATCH "[^\n]+$" last_line "${stderr_text}")
+        message(STATUS "skip: ${last_line}")
+        set(${ok_var} FALSE PARENT_SCOPE)
+    endif()
+endfunction()
+
+foreach (recording IN LISTS recordings)
+    set(replay --replay ${recording} --speed 0)
+
+    run_imu_dir(ok ${replay})
+    if (NOT ok)
+        continue()
+    endif()
+    # wzorzec DTW z pierwszego poprawnego nagrania – wystarczy, by liczyły się jądra DTW
+    if (template_file STREQUAL "")
+        set(template_file ${recording})
+    endif()
+
+    run_imu_dir(ok ${replay} --segmented)
+    run_imu_dir(ok ${replay} --template TMPL=${template_file}
+                --combo PAIR=LEFT,RIGHT --min-interval 0.3)
+    math(EXPR runs "${runs} + 3")
+endforeach()
+
+if (runs EQUAL 0)
+    message(FATAL_ERROR "pgo_train.cmake: imu_dir failed on every recording")
+endif()
+message(STATUS "PGO training: ${runs} runs over ${count} recordings")
@@ -0,0 +1,32 @@
+# Raspberry Pi 3 z 64-bitowym systemem (Cortex-A53, aarch64).
+#
+#   cmake -S imu -B build-pi -DCMAKE_TOOLCHAIN_FILE=imu/cmake/toolchains/aarch64-rpi3.cmake \
+#         -DCMAKE_BUILD_TYPE=Release -DBNO_LTO=ON [-DRPI_SYSROOT=/path/to/sysroot]
+#
+# Kompilator: aarch64-linux-gnu-g++ (Debian/Ubuntu: g++-aarch64-linux-gnu).
+# Sysroot potrzebny tylko do bibliotek spoza libc (liburing, benchmark).
+
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR aarch64)
+
+set(BNO_CROSS_PREFIX aarch64-linux-gnu- CACHE STRING "Cross compiler prefix")
+set(CMAKE_C_COMPILER   ${BNO_CROSS_PREFIX}gcc)
+set(CMAKE_CXX_COMPILER ${BNO_CROSS_PREFIX}g++)
+
+set(CMAKE_CXX_FLAGS_INIT "-mcpu=cortex-a53")
+set(CMAKE_C_FLAGS_INIT   "-mcpu=cortex-a53")
+
+if (RPI_SYSROOT)
+    set(CMAKE_SYSROOT ${RPI_SYSROOT})
+    set(CMAKE_FIND_ROOT_PATH ${RPI_SYSROOT})
+endif()
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_PACKAGE ONLY)
+
+# imu_pgo_train przez qemu-user, jeśli jest na hoście
+find_program(BNO_QEMU_AARCH64 NAMES qemu-aarch64-static qemu-aarch64)
+if (BNO_QEMU_AARCH64)
+    set(CMAKE_CROSSCOMPILING_EMULATOR ${BNO_QEMU_AARCH64})
+endif()
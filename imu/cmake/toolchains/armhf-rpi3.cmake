@@ -0,0 +1,31 @@
+# Raspberry Pi 3 z 32-bitowym Raspberry Pi OS (Cortex-A53 w trybie ARMv8 AArch32, hard-float).
+#
+#   cmake -S imu -B build-pi -DCMAKE_TOOLCHAIN_FILE=imu/cmake/toolchains/armhf-rpi3.cmake \
+#         -DCMAKE_BUILD_TYPE=Release -DBNO_LTO=ON [-DRPI_SYSROOT=/path/to/sysroot]
+#
+# Kompilator: arm-linux-gnueabihf-g++ (Debian/Ubuntu: g++-arm-linux-gnueabihf).
+
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR armv7l)
+
+set(BNO_CROSS_PREFIX arm-linux-gnueabihf- CACHE STRING "Cross compiler prefix")
+set(CMAKE_C_COMPILER   ${BNO_CROSS_PREFIX}gcc)
+set(CMAKE_CXX_COMPILER ${BNO_CROSS_PREFIX}g++)
+
+set(BNO_ARMHF_FLAGS "-mcpu=cortex-a53 -mfpu=neon-fp-armv8 -mfloat-abi=hard")
+set(CMAKE_CXX_FLAGS_INIT "${BNO_ARMHF_FLAGS}")
+set(CMAKE_C_FLAGS_INIT   "${BNO_ARMHF_FLAGS}")
+
+if (RPI_SYSROOT)
+    set(CMAKE_SYSROOT ${RPI_SYSROOT})
+    set(CMAKE_FIND_ROOT_PATH ${RPI_SYSROOT})
+endif()
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_PACKAGE ONLY)
+
+find_program(BNO_QEMU_ARM NAMES qemu-arm-static qemu-arm)
+if (BNO_QEMU_ARM)
+    set(CMAKE_CROSSCOMPILING_EMULATOR ${BNO_QEMU_ARM})
+endif()
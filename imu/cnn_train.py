@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+"""
+Uczenie małej sieci konwolucyjnej 1D (TCN) na nagraniach i eksport do ONNX
+dla imu_dir --cnn (StreamingGestureCnn, cv::dnn).
+
+    python3 cnn_train.py --out gestures.onnx data/*.csv
+    python3 cnn_train.py --out g.onnx CIRCLE=rec1.csv ZIGZAG=rec2.imlog
+    python3 cnn_train.py --out g.onnx --corpus corpus/aug     # okna z imu_augment
+
+Wejście sieci jest dokładnie tym, co liczy StreamingGestureCnn:
+    6 kanałów (a_dyn x,y,z oraz ω x,y,z w układzie świata) na siatce RATE_HZ,
+    okno WINDOW_S sekund → tensor "imu" o kształcie (1, 6, N).
+a_dyn = R(q)·a − g0, g0 ze średniej z pierwszych 0.2 s (jak dir_offline.py;
+imu_dir bierze baseline z detektora kierunku).
+
+Okna uczące:
+    - gest: okno wokół piku |a_dyn| w nagraniu, przesunięte o kilka próbek
+      (sieć na żywo widzi gest w różnych miejscach okna),
+    - NONE: okna ze spokojnego początku/końca nagrania (tło).
+Etykieta pliku to litery z początku nazwy (left3.csv → LEFT), jak imu_train,
+albo jawnie LABEL=ścieżka.
+
+--corpus PREFIX dokłada gotowe okna z imu_augment (<PREFIX>.<k>.imlog
+i <PREFIX>.labels). Okno syntetyczne nie ma spokojnego początku, więc g0 to
+średnia R(q)·a w oknie – całka a_dyn po pełnym geście jest bliska zera.
+
+Wyjście: <out>.onnx (opset 13, softmax na końcu), <out>.labels – etykiety
+w kolejności wyjść sieci, po jednej w linii – i <out>.calib: losowe okna
+uczące do kalibracji int8 (imu_dir --cnn-int8 kwantyzuje sieć w load(),
+nie na oknach z pierwszych sekund pracy). Format .calib: "BNOCALIB",
+uint32 LE okna, kanały, N, potem float32 LE [okna][kanały][N].
+
+Wymaga: numpy, torch (eksport ONNX przez torch.onnx).
+"""
+
+import argparse
+import glob
+import os
+import re
+from typing import Dict, List, Tuple
+
+import numpy as np
+
+from dir_offline import accel_world_from_sensor, estimate_baseline
+from imu_log import is_imu_log, load_imu_log
+
+RATE_HZ = 50.0      # siatka wejścia – jak StreamingGestureCnn::Config::rate_hz
+WINDOW_S = 1.0      # jak Config::window_s
+CHANNELS = 6
+NONE_LABEL = "NONE"
+CALIB_MAGIC = b"BNOCALIB"   # jak CALIB_MAGIC w gesture_cnn.cpp
+REQUIRED_COLS = ("t", "ax", "ay", "az", "gx", "gy", "gz", "qw", "qi", "qj", "qk")
+
+
+# ---------- Wczytywanie i przygotowanie danych ----------
+
+def load_recording(path: str) -> Dict[str, np.ndarray]:
+    """Kolumny REQUIRED_COLS z CSV (imu_read) albo .imlog."""
+    if is_imu_log(path):
+        data = load_imu_log(path)
+        names = data.keys()
+    else:
+        arr = np.genfromtxt(path, delimiter=",", names=True, dtype=float, ndmin=1)
+        if arr.size == 0 or arr.dtype.names is None:
+            raise ValueError(f"{path}: pusty plik albo brak headera")
+        data = {name: arr[name] for name in arr.dtype.names}
+        names = arr.dtype.names
+    for col in REQUIRED_COLS:
+        if col not in names:
+            raise ValueError(f"{path}: nie znaleziono kolumny '{col}'")
+    out = {col: np.asarray(data[col], dtype=float) for col in REQUIRED_COLS}
+    if out["t"].shape[0] < 3:
+        raise ValueError(f"{path}: za mało próbek ({out['t'].shape[0]})")
+    return out
+
+
+def channels_on_grid(rec: Dict[str, np.ndarray]) -> np.ndarray:
+    """(6, M): a_dyn i ω w układzie świata, interpolowane liniowo na siatkę RATE_HZ."""
+    t = rec["t"]
+    q = (rec["qw"], rec["qi"], rec["qj"], rec["qk"])
+    awx, awy, awz = accel_world_from_sensor(rec["ax"], rec["ay"], rec["az"], *q)
+    gwx, gwy, gwz = accel_world_from_sensor(rec["gx"], rec["gy"], rec["gz"], *q)
+    b = estimate_baseline(t, awx, awy, awz)
+
+    # powtórzone t (imu_read pisze linię na raport) – zostaje ostatnia próbka
+    keep = np.append(np.diff(t) > 0, True)
+    t = t[keep]
+    grid = np.arange(t[0], t[-1], 1.0 / RATE_HZ)
+    cols = (awx - b[0], awy - b[1], awz - b[2], gwx, gwy, gwz)
+    return np.stack([np.interp(grid, t, c[keep]) for c in cols]).astype(np.float32)
+
+
+def label_from_path(path: str) -> str:
+    m = re.match(r"[A-Za-z_]+", os.path.basename(path))
+    return m.group(0).upper() if m else ""
+
+
+def windows_from_recording(x: np.ndarray, label: str, shifts: int) -> List[Tuple[np.ndarray, str]]:
+    """Okna gestu wokół piku |a_dyn| i okna tła z brzegów nagrania."""
+    n = int(round(RATE_HZ * WINDOW_S))
+    m = x.shape[1]
+    if m < n:
+        return []
+    out = []
+    peak = int(np.argmax(np.linalg.norm(x[:3], axis=0)))
+    step = max(1, n // (2 * shifts + 2))
+    for k in range(-shifts, shifts + 1):
+        start = min(max(peak - n // 2 + k * step, 0), m - n)
+        out.append((x[:, start:start + n], label))
+    # tło: okna całkiem poza ±n wokół piku
+    for start in (0, m - n):
+        if abs(start + n // 2 - peak) >= n:
+            out.append((x[:, start:start + n], NONE_LABEL))
+    return out
+
+
+def windows_from_corpus(prefix: str) -> List[Tuple[np.ndarray, str]]:
+    """Okna z shardów imu_augment: kolumna `window` numeruje okna w shardzie."""
+    with open(prefix + ".labels") as f:
+        names = [line.strip() for line in f if line.strip()]
+    n = int(round(RATE_HZ * WINDOW_S))
+    out = []
+    for path in sorted(glob.glob(glob.escape(prefix) + ".*.imlog")):
+        data = load_imu_log(path)
+        _, starts = np.unique(data["window"], return_index=True)
+        q = (data["qw"], data["qi"], data["qj"], data["qk"])
+        aw = accel_world_from_sensor(data["ax"], data["ay"], data["az"], *q)
+        gw = accel_world_from_sensor(data["gx"], data["gy"], data["gz"], *q)
+        for start in starts:
+            if start + n > data["t"].shape[0]:
+                continue
+            sl = slice(start, start + n)
+            a = np.stack([c[sl] for c in aw])
+            x = np.concatenate([a - a.mean(axis=1, keepdims=True),
+                                np.stack([c[sl] for c in gw])]).astype(np.float32)
+            out.append((x, names[int(data["label"][start])]))
+    if not out:
+        raise ValueError(f"{prefix}: no imu_augment windows")
+    return out
+
+
+# ---------- Sieć ----------
+
+def build_model(num_classes: int):
+    import torch.nn as nn
+
+    # Dylatacje 1, 2, 4 przy k=5: pole recepcji ~29 próbek (0.6 s przy 50 Hz).
+    # Padding "same" i globalne uśrednianie – to samo wyjście dla każdej długości N.
+    return nn.Sequential(
+        nn.Conv1d(CHANNELS, 16, kernel_size=5, padding=2),
+        nn.ReLU(),
+        nn.Conv1d(16, 16, kernel_size=5, padding=4, dilation=2),
+        nn.ReLU(),
+        nn.Conv1d(16, 24, kernel_size=5, padding=8, dilation=4),
+        nn.ReLU(),
+        nn.AdaptiveAvgPool1d(1),
+        nn.Flatten(),
+        nn.Linear(24, num_classes),
+    )
+
+
+def train(x: np.ndarray, y: np.ndarray, num_classes: int, epochs: int, seed: int):
+    import torch
+    import torch.nn as nn
+
+    torch.manual_seed(seed)
+    model = build_model(num_classes)
+    opt = torch.optim.Adam(model.parameters(), lr=3e-3, weight_decay=1e-4)
+    loss_fn = nn.CrossEntropyLoss()
+    xt = torch.from_numpy(x)
+    yt = torch.from_numpy(y)
+    for epoch in range(epochs):
+        model.train()
+        perm = torch.randperm(xt.shape[0])
+        total = 0.0
+        for i in range(0, xt.shape[0], 32):
+            idx = perm[i:i + 32]
+            # lekka augmentacja: skala amplitudy i szum
+            xb = xt[idx] * (1.0 + 0.1 * torch.randn(idx.shape[0], 1, 1))
+            xb = xb + 0.02 * torch.randn_like(xb)
+            opt.zero_grad()
+            loss = loss_fn(model(xb), yt[idx])
+            loss.backward()
+            opt.step()
+            total += float(loss) * idx.shape[0]
+        if (epoch + 1) % 10 == 0 or epoch + 1 == epochs:
+            print(f"epoch {epoch + 1}: loss {total / xt.shape[0]:.4f}")
+    model.eval()
+    return model
+
+
+def export_onnx(model, out_path: str, labels: List[str]) -> None:
+    import torch
+    import torch.nn as nn
+
+    n = int(round(RATE_HZ * WINDOW_S))
+    # softmax w sieci: imu_dir bierze wyjście wprost jako prawdopodobieństwa
+    net = nn.Sequential(model, nn.Softmax(dim=1)).eval()
+    dummy = torch.zeros(1, CHANNELS, n)
+    torch.onnx.export(net, dummy, out_path, input_names=["imu"], output_names=["prob"],
+                      opset_version=13, dynamo=False)
+    labels_path = os.path.splitext(out_path)[0] + ".labels"
+    with open(labels_path, "w") as f:
+        f.write("\n".join(labels) + "\n")
+    print(f"model: {out_path} ({len(labels)} classes), labels: {labels_path}")
+
+
+def export_calibration(x: np.ndarray, out_path: str, windows: int, seed: int) -> None:
+    """Próbka okien uczących (wszystkie klasy) do skal aktywacji int8."""
+    rng = np.random.default_rng(seed)
+    pick = np.sort(rng.choice(x.shape[0], size=min(windows, x.shape[0]), replace=False))
+    calib = np.ascontiguousarray(x[pick], dtype="<f4")
+    calib_path = os.path.splitext(out_path)[0] + ".calib"
+    with open(calib_path, "wb") as f:
+        f.write(CALIB_MAGIC)
+        f.write(np.array(calib.shape, dtype="<u4").tobytes())
+        f.write(calib.tobytes())
+    print(f"int8 calibration: {calib_path} ({calib.shape[0]} windows)")
+
+
+# ---------- Main ----------
+
+def main() -> None:
+    parser = argparse.ArgumentParser(
+        description="Uczenie 1D-CNN gestów (ONNX dla imu_dir --cnn)."
+    )
+    parser.add_argument("files", nargs="*",
+                        help="Nagrania CSV / .imlog, opcjonalnie LABEL=ścieżka")
+    parser.add_argument("--corpus", action="append", default=[], metavar="PREFIX",
+                        help="Okna z imu_augment --out PREFIX (można powtórzyć)")
+    parser.add_argument("--out", required=True, help="Plik wyjściowy .onnx")
+    parser.add_argument("--epochs", type=int, default=60)
+    parser.add_argument("--shifts", type=int, default=3,
+                        help="Przesunięcia okna gestu w każdą stronę (domyślnie 3)")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--calib-windows", type=int, default=64,
+                        help="Okna w <out>.calib do kalibracji int8 (domyślnie 64)")
+    args = parser.parse_args()
+
+    windows: List[Tuple[np.ndarray, str]] = []
+    for spec in args.files:
+        label, _, path = spec.rpartition("=")
+        label = label or label_from_path(path)
+        if not label:
+            print(f"{path}: brak etykiety (użyj LABEL=ścieżka)")
+            continue
+        try:
+            windows += windows_from_recording(channels_on_grid(load_recording(path)),
+                                              label, args.shifts)
+        except ValueError as e:
+            # uszkodzone / puste nagrania pomijamy, jak imu_train
+            print(f"skip {e}")
+    for prefix in args.corpus:
+        windows += windows_from_corpus(prefix)
+
+    labels = sorted({lab for _, lab in windows})
+    if len(labels) < 2:
+        raise SystemExit("za mało klas (potrzebne co najmniej dwie)")
+    index = {lab: i for i, lab in enumerate(labels)}
+    x = np.stack([w for w, _ in windows]).astype(np.float32)
+    y = np.array([index[lab] for _, lab in windows], dtype=np.int64)
+    counts = ", ".join(f"{lab} {int(np.sum(y == index[lab]))}" for lab in labels)
+    print(f"windows: {x.shape[0]} ({counts})")
+
+    model = train(x, y, len(labels), args.epochs, args.seed)
+    export_onnx(model, args.out, labels)
+    export_calibration(x, args.out, args.calib_windows, args.seed)
+
+
+if __name__ == "__main__":
+    main()
@@ -4,6 +4,9 @@ Offline'owy analizator kierunku ruchu dłoni na podstawie logów z imu_read_cpp.
 
 Wejście: pliki CSV z kolumnami:
     t,ax,ay,az,gx,gy,gz,qw,qi,qj,qk
+albo logi binarne (.imlog, imu_read --format bin) z tymi samymi kolumnami,
+albo "shm:/imu_samples" – ostatnie SHM_WINDOW_S sekund z pierścienia
+imu_daemon --shm (na żywo, bez pliku).
 
 Metoda (wersja z opcją A):
 1. Wczytujemy sygnał oraz kwaternion Game Rotation Vector.
@@ -15,6 +18,10 @@ Metoda (wersja z opcją A):
 6. Wycinamy okno [t_peak - 0.3s, t_peak + 0.3s].
 7. Na tym oknie integrujemy a_dyn -> przybliżone Δv_world na każdej osi.
 8. Dominująca oś + znak = kierunek gestu (UP/DOWN/LEFT/RIGHT/FORWARD/BACKWARD).
+
+--native: zamiast kroków 1–8 ten sam detektor, co w imu_dir (moduł bno,
+pybind11, cel bno_py w CMake). Nagranie idzie przez ReplayTransport i parser
+SH-2 – z kwantyzacją czujnika, jak na żywo.
 """
 
 import argparse
@@ -23,6 +30,12 @@ from typing import Tuple, Optional
 
 import numpy as np
 
+from imu_log import is_imu_log, load_imu_log
+from imu_shm import ImuShmReader
+
+SHM_PREFIX = "shm:"
+SHM_WINDOW_S = 4.0   # jak jedno nagranie runner.py
+
 
 # ---------- Wczytywanie danych ----------
 
@@ -36,8 +49,24 @@ def load_csv(path: str) -> Tuple[
     np.ndarray,  # qj
     np.ndarray,  # qk
 ]:
-    """Wczytaj kolumny t, ax, ay, az, qw, qi, qj, qk z pliku CSV."""
+    """Wczytaj kolumny t, ax, ay, az, qw, qi, qj, qk z pliku CSV lub .imlog."""
     required_cols = ("t", "ax", "ay", "az", "qw", "qi", "qj", "qk")
+    if path.startswith(SHM_PREFIX):
+        with ImuShmReader(path[len(SHM_PREFIX):]) as reader:
+            samples = reader.latest(int(SHM_WINDOW_S * reader.rate_hz))
+        if samples.shape[0] < 3:
+            raise ValueError(f"{path}: za mało próbek ({samples.shape[0]})")
+        return tuple(np.asarray(samples[col], dtype=float) for col in required_cols)  # type: ignore[return-value]
+
+    if is_imu_log(path):
+        log = load_imu_log(path)
+        for col in required_cols:
+            if col not in log:
+                raise ValueError(f"{path}: nie znaleziono kolumny '{col}' w logu")
+        if log["t"].shape[0] < 3:
+            raise ValueError(f"{path}: za mało próbek ({log['t'].shape[0]})")
+        return tuple(np.asarray(log[col], dtype=float) for col in required_cols)  # type: ignore[return-value]
+
     try:
         data = np.genfromtxt(
             path,
@@ -300,6 +329,27 @@ def analyze_file(path: str) -> None:
     print()
 
 
+def analyze_file_native(path: str) -> None:
+    import bno  # PYTHONPATH=<katalog build>
+
+    samples = bno.read_samples(bno.ReplayTransport(path))
+    detector = bno.GestureDirectionDetector(bno.imu_dir_config())
+    results = detector.add_samples(samples)
+    true_label = infer_true_label_from_filename(path)
+
+    print(f"=== {path} (native, {len(samples['t'])} samples) ===")
+    for g in results:
+        dvx, dvy, dvz = g.delta_v_world
+        mark = ""
+        if true_label:
+            mark = "  OK" if g.label == true_label else "  MISMATCH"
+        print(f"  t={g.t_center:.3f} {g.label:<9} dv=({dvx:.3f},{dvy:.3f},{dvz:.3f}) "
+              f"dur={g.duration:.3f}{mark}")
+    if not results:
+        print("  no gesture")
+    print()
+
+
 def main() -> None:
     parser = argparse.ArgumentParser(
         description="Offline analizator kierunku gestu z plików CSV z imu_read_cpp (world-frame)."
@@ -307,13 +357,22 @@ def main() -> None:
     parser.add_argument(
         "files",
         nargs="+",
-        help="Pliki CSV do analizy (np. data/up_*.csv data/down_*.csv)",
+        help="Pliki CSV lub .imlog do analizy (np. data/up_*.csv data/down_*.csv) "
+             "albo shm:/imu_samples (ostatnie 4 s z imu_daemon --shm)",
+    )
+    parser.add_argument(
+        "--native",
+        action="store_true",
+        help="Detektor C++ z imu_dir przez moduł bno (pybind11) zamiast numpy",
     )
     args = parser.parse_args()
 
     for path in args.files:
         try:
-            analyze_file(path)
+            if args.native:
+                analyze_file_native(path)
+            else:
+                analyze_file(path)
         except Exception as e:
             print(f"{path}: ERROR: {e}")
 
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+Czytnik binarnego logu kolumnowego (.imlog) z imu_read --format bin.
+
+Format opisany w include/bno/imu_log.hpp. Plik jest mapowany przez mmap,
+a kolumny każdego bloku to widoki numpy bez kopiowania; load_imu_log()
+skleja je w jedną tablicę na kolumnę.
+
+Jeśli brakuje stopki (imu_read przerwany), bloki są znajdowane skanem
+od początku – tak samo jak w ImuLogReader.
+"""
+
+import mmap
+import struct
+import zlib
+from typing import Dict, List, Tuple
+
+import numpy as np
+
+IMU_LOG_MAGIC = b"BNOIMU\x00\x01"
+IMU_LOG_FOOTER_MAGIC = b"BNOIDX\x00\x01"
+IMU_LOG_BLOCK_MAGIC = 0x314B4C42
+
+_FILE_HEADER = struct.Struct("<8sHHIQII")        # 32 B
+_COLUMN_DESC = struct.Struct("<16sB7x")          # 24 B
+_BLOCK_HEADER = struct.Struct("<IIQddII")        # 40 B
+_INDEX_ENTRY = struct.Struct("<QQdd")            # 32 B
+_FOOTER = struct.Struct("<QQQII8s")              # 40 B
+
+_DTYPES = {1: np.dtype("<f4"), 2: np.dtype("<f8")}
+
+
+def is_imu_log(path: str) -> bool:
+    with open(path, "rb") as f:
+        return f.read(len(IMU_LOG_MAGIC)) == IMU_LOG_MAGIC
+
+
+def _pad8(n: int) -> int:
+    return (n + 7) & ~7
+
+
+def _read_schema(buf) -> Tuple[List[Tuple[str, np.dtype]], int]:
+    magic, version, ncol, _block_rows, _created, schema_crc, _ = _FILE_HEADER.unpack_from(buf, 0)
+    if magic != IMU_LOG_MAGIC:
+        raise ValueError("to nie jest log .imlog")
+    if version != 1:
+        raise ValueError(f"nieobsługiwana wersja logu: {version}")
+
+    begin = _FILE_HEADER.size
+    end = begin + ncol * _COLUMN_DESC.size
+    if zlib.crc32(buf[begin:end]) != schema_crc:
+        raise ValueError("zły CRC schematu")
+
+    schema = []
+    for i in range(ncol):
+        raw_name, typ = _COLUMN_DESC.unpack_from(buf, begin + i * _COLUMN_DESC.size)
+        schema.append((raw_name.split(b"\x00", 1)[0].decode(), _DTYPES[typ]))
+    return schema, end
+
+
+def _blocks_from_footer(buf, data_begin: int) -> List[Tuple[int, int]]:
+    size = len(buf)
+    if size < data_begin + _FOOTER.size:
+        return []
+    index_offset, count, _total, index_crc, _, magic = _FOOTER.unpack_from(buf, size - _FOOTER.size)
+    if magic != IMU_LOG_FOOTER_MAGIC:
+        return []
+    index_end = index_offset + count * _INDEX_ENTRY.size
+    if index_offset < data_begin or index_end + _FOOTER.size != size:
+        return []
+    if zlib.crc32(buf[index_offset:index_end]) != index_crc:
+        return []
+    return [
+        (off + _BLOCK_HEADER.size, rows)
+        for off, rows, _t0, _t1 in _INDEX_ENTRY.iter_unpack(buf[index_offset:index_end])
+    ]
+
+
+def _blocks_from_scan(buf, data_begin: int, schema) -> List[Tuple[int, int]]:
+    blocks = []
+    pos = data_begin
+    while pos + _BLOCK_HEADER.size <= len(buf):
+        magic, rows, payload, _t0, _t1, payload_crc, header_crc = _BLOCK_HEADER.unpack_from(buf, pos)
+        if magic != IMU_LOG_BLOCK_MAGIC:
+            break
+        if zlib.crc32(buf[pos:pos + _BLOCK_HEADER.size - 4]) != header_crc:
+            break
+        expected = sum(_pad8(rows * dt.itemsize) for _, dt in schema)
+        begin = pos + _BLOCK_HEADER.size
+        if payload != expected or begin + expected > len(buf):
+            break
+        if zlib.crc32(buf[begin:begin + expected]) != payload_crc:
+            break
+        blocks.append((begin, rows))
+        pos = begin + expected
+    return blocks
+
+
+def load_imu_log(path: str) -> Dict[str, np.ndarray]:
+    """Wczytaj cały log: {nazwa kolumny: tablica numpy}."""
+    with open(path, "rb") as f:
+        buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+    schema, data_begin = _read_schema(buf)
+    blocks = _blocks_from_footer(buf, data_begin) or _blocks_from_scan(buf, data_begin, schema)
+
+    parts: Dict[str, list] = {name: [] for name, _ in schema}
+    for begin, rows in blocks:
+        off = begin
+        for name, dt in schema:
+            parts[name].append(np.frombuffer(buf, dtype=dt, count=rows, offset=off))
+            off += _pad8(rows * dt.itemsize)
+
+    # np.concatenate kopiuje – po tym mmap można zamknąć
+    return {
+        name: (np.concatenate(chunks) if chunks else np.empty(0, dtype=dt))
+        for (name, dt), chunks in zip(schema, parts.values())
+    }
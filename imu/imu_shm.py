@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+Czytelnik pierścienia próbek z imu_daemon --shm (pamięć współdzielona POSIX).
+
+Układ opisany w include/bno/imu_shm.hpp. Segment /dev/shm/<name> jest
+mapowany tylko do odczytu, a sloty to jedna tablica numpy (structured
+dtype) bez kopiowania. latest()/since() kopiują wybrane sloty i sprawdzają
+ich liczniki seq – sloty nadpisane w trakcie kopiowania są odrzucane.
+Bez wywołań systemowych, dopóki nie trzeba czekać na nowe dane.
+
+    reader = ImuShmReader("/imu_samples")
+    s = reader.latest(200)            # s["t"], s["ax"], ... (numpy)
+    seq = reader.write_seq
+    ...
+    s, seq = reader.since(seq)        # tylko nowe od ostatniego razu
+"""
+
+import mmap
+import os
+import struct
+import time
+from typing import Tuple
+
+import numpy as np
+
+IMU_SHM_MAGIC = b"BNOSHM\x00\x01"
+IMU_SHM_VERSION = 1
+IMU_SHM_DEFAULT_NAME = "/imu_samples"
+
+IMU_SHM_FLAG_LINEAR_ACCEL = 1 << 0
+IMU_SHM_FLAG_REPLAY = 1 << 1
+
+_HEADER = struct.Struct("<8sIIIIdI20x")          # pola do offsetu 64
+_WRITE_SEQ_OFFSET = 64
+_HEADER_SIZE = 128
+
+SLOT_DTYPE = np.dtype([
+    ("seq", "<u8"),
+    ("t", "<f8"),
+    ("ax", "<f4"), ("ay", "<f4"), ("az", "<f4"),
+    ("gx", "<f4"), ("gy", "<f4"), ("gz", "<f4"),
+    ("qw", "<f4"), ("qi", "<f4"), ("qj", "<f4"), ("qk", "<f4"),
+    ("flags", "<u4"),
+    ("_reserved", "<u4"),
+])
+assert SLOT_DTYPE.itemsize == 64
+
+
+class ImuShmReader:
+    def __init__(self, name: str = IMU_SHM_DEFAULT_NAME):
+        path = "/dev/shm/" + name.lstrip("/")
+        fd = os.open(path, os.O_RDONLY)
+        try:
+            self._buf = mmap.mmap(fd, 0, access=mmap.ACCESS_READ)
+        finally:
+            os.close(fd)
+
+        magic, version, slot_size, capacity, header_size, rate_hz, pid = \
+            _HEADER.unpack_from(self._buf, 0)
+        if magic != IMU_SHM_MAGIC or version != IMU_SHM_VERSION:
+            raise ValueError(f"{path}: to nie jest pierścień próbek IMU (v{IMU_SHM_VERSION})")
+        if slot_size != SLOT_DTYPE.itemsize or header_size != _HEADER_SIZE:
+            raise ValueError(f"{path}: nieobsługiwany układ slotów")
+        if capacity == 0 or capacity & (capacity - 1):
+            raise ValueError(f"{path}: pojemność {capacity} nie jest potęgą dwójki")
+
+        self.capacity = capacity
+        self.rate_hz = rate_hz
+        self.writer_pid = pid
+        self._mask = capacity - 1
+        # widoki prosto na mmap – bez kopii
+        self._write_seq = np.frombuffer(self._buf, dtype="<u8", count=1, offset=_WRITE_SEQ_OFFSET)
+        self.slots = np.frombuffer(self._buf, dtype=SLOT_DTYPE, count=capacity, offset=_HEADER_SIZE)
+
+    @property
+    def write_seq(self) -> int:
+        """Numer następnej próbki pisarza (= liczba wszystkich opublikowanych)."""
+        return int(self._write_seq[0])
+
+    def writer_alive(self) -> bool:
+        try:
+            os.kill(self.writer_pid, 0)
+        except ProcessLookupError:
+            return False
+        except PermissionError:
+            pass
+        return True
+
+    def _read_range(self, begin: int, end: int) -> np.ndarray:
+        """Kopia próbek [begin, end) – tylko te, których slot nie został nadpisany."""
+        if end <= begin:
+            return np.empty(0, dtype=SLOT_DTYPE)
+        seqs = np.arange(begin, end, dtype=np.uint64)
+        idx = (seqs & np.uint64(self._mask)).astype(np.intp)
+        expected = 2 * seqs + 2
+
+        out = self.slots[idx]                     # fancy indexing = kopia
+        after = self.slots["seq"][idx]            # seq po skopiowaniu
+        ok = (out["seq"] == expected) & (after == expected)
+        if not ok.all():
+            # nadpisane sloty to zawsze najstarsze – zostaw spójny ogon
+            bad = np.flatnonzero(~ok)
+            out = out[bad[-1] + 1:]
+        return out
+
+    def latest(self, n: int) -> np.ndarray:
+        """Najnowsze (do) n próbek, od najstarszej."""
+        end = self.write_seq
+        # jeden slot zapasu – najstarszy może być właśnie nadpisywany
+        n = min(n, end, self.capacity - 1)
+        return self._read_range(end - n, end)
+
+    def since(self, seq: int) -> Tuple[np.ndarray, int]:
+        """Próbki od numeru seq do teraz i numer następnej (do kolejnego since())."""
+        end = self.write_seq
+        begin = max(seq, end - (self.capacity - 1))
+        return self._read_range(begin, end), end
+
+    def wait(self, seq: int, timeout: float = 1.0, poll_s: float = 0.002) -> bool:
+        """Czekaj, aż write_seq > seq. Python nie ma futexa – krótkie drzemki."""
+        deadline = time.monotonic() + timeout
+        while self.write_seq <= seq:
+            if time.monotonic() >= deadline:
+                return False
+            time.sleep(poll_s)
+        return True
+
+    def close(self) -> None:
+        del self.slots, self._write_seq
+        self._buf.close()
+
+    def __enter__(self) -> "ImuShmReader":
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+
+def main() -> None:
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Podgląd pierścienia próbek imu_daemon --shm.")
+    parser.add_argument("--shm", default=IMU_SHM_DEFAULT_NAME, help="nazwa segmentu (domyślnie /imu_samples)")
+    parser.add_argument("--last", type=int, default=10, help="ile najnowszych próbek wypisać")
+    args = parser.parse_args()
+
+    with ImuShmReader(args.shm) as reader:
+        print(f"capacity={reader.capacity} rate_hz={reader.rate_hz:g} "
+              f"write_seq={reader.write_seq} writer_alive={reader.writer_alive()}")
+        s = reader.latest(args.last)
+        print("t,ax,ay,az,gx,gy,gz,qw,qi,qj,qk")
+        cols = ("t", "ax", "ay", "az", "gx", "gy", "gz", "qw", "qi", "qj", "qk")
+        for row in s:
+            print(",".join(f"{float(row[c]):.6f}" for c in cols))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bno {
+
+// Zapis do pliku w osobnym wątku, żeby przestój karty SD nie blokował
+// pętli akwizycji.
+//
+// Wątek akwizycji kopiuje dane do bieżącego bufora (append). Pełny bufor
+// trafia do kolejki, a wątek zapisu wysyła wszystko, co w niej czeka,
+// jednym batchem: io_uring (jeśli zbudowano z liburing), inaczej pwritev.
+// Pula buforów jest stała; gdy wszystkie czekają na zapis, append()
+// odrzuca dane (overrun) zamiast czekać.
+//
+// Z O_DIRECT zapisy mają offset i długość wyrównane do ASYNC_WRITER_ALIGN;
+// ogon pliku (< 4 KiB) jest dopisywany zwykłym pwrite przy close().
+
+constexpr std::size_t ASYNC_WRITER_ALIGN = 4096;
+
+struct AsyncWriterConfig {
+    std::size_t buffer_bytes = 256 * 1024;  // zaokrąglane w górę do ASYNC_WRITER_ALIGN
+    std::size_t buffer_count = 8;
+    bool direct_io = false;                 // O_DIRECT; bez wsparcia FS – zwykły zapis
+    bool use_io_uring = true;               // bez liburing ignorowane
+};
+
+struct AsyncWriterStats {
+    std::uint64_t bytes_accepted{0};
+    std::uint64_t bytes_written{0};
+    std::uint64_t overruns{0};          // odrzucone append() – brak wolnych buforów
+    std::uint64_t bytes_dropped{0};
+    std::uint64_t batches{0};           // pwritev / io_uring_submit
+    std::uint64_t buffers_written{0};
+    std::uint32_t queue_depth{0};       // bufory oddane do zapisu, jeszcze niezapisane
+    std::uint32_t queue_depth_max{0};
+    std::uint64_t write_us_max{0};      // najdłuższy batch
+    std::uint64_t write_us_total{0};
+    bool io_error{false};
+};
+
+/// Jeden producent (wątek akwizycji), jeden wątek zapisu.
+class AsyncFileWriter {
+public:
+    AsyncFileWriter() = default;
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    bool open(const std::string& path, const AsyncWriterConfig& cfg, std::string& err);
+
+    /// Dopisz `len` bajtów – całość albo nic. Nie blokuje: false przy
+    /// braku miejsca (overrun, liczony w stats()) albo po błędzie zapisu.
+    bool append(const void* data, std::size_t len);
+
+    /// Jak append(), ale czeka na wolne bufory (nagłówki, stopka pliku).
+    bool append_wait(const void* data, std::size_t len);
+
+    /// Oddaj bieżący niepełny bufor do zapisu (bez czekania i bez fsync).
+    void flush();
+
+    /// Dopisz wszystko, fdatasync, zamknij. Wołane też z destruktora.
+    bool close(std::string& err);
+
+    bool is_open() const { return fd_ >= 0; }
+    /// Ile bajtów przyjęto – offset następnego append() w pliku.
+    std::uint64_t offset() const { return offset_; }
+    bool direct_io() const { return direct_; }
+    const char* backend_name() const;
+
+    /// Bezpieczne z dowolnego wątku.
+    AsyncWriterStats stats() const;
+
+private:
+    struct Buffer {
+        unsigned char* data{nullptr};
+        std::size_t len{0};
+        std::uint64_t offset{0};
+    };
+
+    // Kolejka indeksów buforów, jeden producent / jeden konsument.
+    struct IndexRing {
+        std::vector<std::uint32_t> slots;
+        std::atomic<std::size_t> head{0};   // zapis
+        std::atomic<std::size_t> tail{0};   // odczyt
+
+        void reset(std::size_t capacity);
+        bool push(std::uint32_t v);
+        bool pop(std::uint32_t& v);
+        std::size_t size() const;
+    };
+
+    struct UringState;
+
+    static constexpr std::uint32_t NO_BUFFER = 0xFFFFFFFFu;
+
+    int fd_{-1};
+    bool direct_{false};
+    std::size_t buffer_bytes_{0};
+    std::vector<Buffer> buffers_;
+    IndexRing free_;
+    IndexRing filled_;
+    std::uint32_t cur_{NO_BUFFER};      // wypełniany bufor (tylko producent)
+    std::uint64_t offset_{0};
+
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<std::uint32_t> submitted_{0};   // budzi wątek zapisu
+    std::atomic<std::uint32_t> completed_{0};   // budzi producenta w append_wait()
+    UringState* uring_{nullptr};
+
+    // statystyki: producent
+    std::atomic<std::uint64_t> bytes_accepted_{0};
+    std::atomic<std::uint64_t> overruns_{0};
+    std::atomic<std::uint64_t> bytes_dropped_{0};
+    std::atomic<std::uint32_t> queue_depth_{0};
+    std::atomic<std::uint32_t> queue_depth_max_{0};
+    // statystyki: wątek zapisu
+    std::atomic<std::uint64_t> bytes_written_{0};
+    std::atomic<std::uint64_t> batches_{0};
+    std::atomic<std::uint64_t> buffers_written_{0};
+    std::atomic<std::uint64_t> write_us_max_{0};
+    std::atomic<std::uint64_t> write_us_total_{0};
+    std::atomic<bool> io_error_{false};
+    std::atomic<int> last_errno_{0};
+
+    bool append_impl(const void* data, std::size_t len, bool wait);
+    bool take_free_buffer();
+    void submit_current();
+    void writer_loop();
+    bool write_batch(const std::uint32_t* idx, std::size_t n);
+    bool write_batch_pwrite(const std::uint32_t* idx, std::size_t n);
+    bool write_batch_uring(const std::uint32_t* idx, std::size_t n);
+    void release_buffers();
+};
+
+} // namespace bno
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"   // Vec3, Quat
+#include "bno/imu_csv.hpp"
+
+namespace bno {
+
+/// Nagranie przygotowane do augmentacji: wiersze imu_read, chwila piku
+/// |a_dyn| i grawitacja w układzie świata (średnia z pierwszych 0.2 s,
+/// jak baseline detektora).
+struct AugmentSource {
+    std::vector<ImuCsvRow> rows;
+    int label{0};
+    double t_peak{0.0};
+    Vec3 gravity_world{};
+};
+
+/// false przy < 3 próbkach albo czasie, który nie rośnie.
+bool prepare_augment_source(std::vector<ImuCsvRow> rows, int label,
+                            AugmentSource& out, std::string& err);
+
+/// Okno wynikowe: `rows` próbek na stałej siatce, w układzie sensora
+/// (kolumny jak imu_read), t liczone od początku okna.
+struct AugmentWindow {
+    enum Column : std::size_t { AX, AY, AZ, GX, GY, GZ, QW, QI, QJ, QK, COLUMN_COUNT };
+
+    std::size_t rows{0};
+    std::vector<double> t;
+    std::array<std::vector<float>, COLUMN_COUNT> c;
+    int label{0};
+    bool background{false};   // okno z dala od piku (etykieta NONE)
+};
+
+/// Losowe przekształcenia okna nagrania – syntetyczne dane do uczenia
+/// (imu_augment → cnn_train.py --corpus). Kolejność:
+///
+///   1. okno wokół piku (± jitter_s) albo, z prawdopodobieństwem
+///      background_ratio, okno tła co najmniej window_s od piku;
+///   2. time warp: tempo ×[1/(1+w), 1+w] i gładka, monotoniczna zmiana
+///      tempa w oknie (sinus o amplitudzie warp_wobble);
+///   3. skala a_dyn (grawitacja zostaje) i ω;
+///   4. bias + liniowy dryf i biały szum, osobno dla a i ω (układ sensora);
+///   5. obrót montażu sensora m: q' = q ⊗ m, a' = m⁻¹ a m (a w świecie bez zmian);
+///   6. obrót świata r: q' = r ⊗ q – lekki przechył/odchylenie układu GRV.
+///
+/// Kąty obrotów są losowane do podanego maksimum (oś z rozkładu jednostajnego
+/// na sferze). Wszystkie amplitudy to połowy zakresów rozkładów jednostajnych,
+/// szum – odchylenia standardowe. Obiekt nie ma stanu poza konfiguracją;
+/// generator losowy podaje wołający (jeden na wątek).
+class WindowAugmenter {
+public:
+    struct Config {
+        double rate_hz = 50.0;          // siatka wyjścia (jak StreamingGestureCnn)
+        double window_s = 1.0;
+        double jitter_s = 0.2;
+        double background_ratio = 0.0;
+        double warp_speed = 0.15;
+        double warp_wobble = 0.1;       // < 1, inaczej czas mógłby się cofać
+        double scale_accel = 0.2;
+        double scale_gyro = 0.2;
+        double accel_bias = 0.05;       // m/s²
+        double accel_drift = 0.05;      // m/s² na s
+        double gyro_bias = 0.01;        // rad/s
+        double gyro_drift = 0.01;       // rad/s na s
+        double accel_noise = 0.03;      // σ, m/s²
+        double gyro_noise = 0.005;      // σ, rad/s
+        double mount_deg = 0.0;
+        double rot_deg = 10.0;
+    };
+
+    explicit WindowAugmenter(const Config& cfg);
+
+    const Config& config() const { return cfg_; }
+    std::size_t window_rows() const { return n_; }
+
+    /// Jedno okno z `src` do `out` (bufory `out` są używane ponownie).
+    void generate(const AugmentSource& src, std::mt19937_64& rng, AugmentWindow& out) const;
+
+private:
+    Config cfg_;
+    std::size_t n_;
+};
+
+} // namespace bno
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bno/live_config.hpp"
+
+namespace bno {
+
+// Gniazdo sterujące (imu_dir / imu_daemon --control): zmiany LiveConfig
+// bez restartu procesu. Własny wątek z poll() – pętla odczytu czujnika
+// o nim nie wie, widzi tylko nowe migawki w LiveConfigCell.
+//
+// Protokół liniowy, jedna odpowiedź na linię:
+//
+//   GET                         -> OK version=0 hz=100 gyro_hz=100 ... min_peak=1 ...
+//   SET min_peak=1.4 hz=50      -> OK version=1   (wszystko albo nic)
+//                               -> ERR unknown key: foo
+//
+// Odpowiedź OK na SET znaczy „opublikowane”; wątek próbek przykłada
+// wersję przy następnej ramce (do timeout_ms przy ciszy na szynie).
+
+class ControlServer {
+public:
+    struct Config {
+        LiveConfigLimits limits{};
+        std::size_t max_clients = 4;
+    };
+
+    ControlServer() = default;
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    /// Utwórz gniazdo `path` i uruchom wątek; `cell` musi żyć do close().
+    bool open(const std::string& path, LiveConfigCell& cell, const Config& cfg, std::string& err);
+    void close();
+
+    bool is_open() const { return thread_.joinable(); }
+
+private:
+    struct Client {
+        int fd{-1};
+        std::string in;   // niepełna linia
+    };
+
+    int listen_fd_{-1};
+    std::string path_;
+    Config cfg_;
+    LiveConfigCell* cell_{nullptr};
+    std::vector<Client> clients_;   // tylko wątek serwera
+    std::jthread thread_;
+
+    void run(std::stop_token stop);
+    void accept_clients();
+    bool read_commands(Client& c);
+    std::string handle(std::string_view line);
+};
+
+} // namespace bno
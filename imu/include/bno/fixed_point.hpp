@@ -0,0 +1,127 @@
+#pragma once
+
+// Liczby stałoprzecinkowe dla ścieżki parser -> detektor bez FPU.
+//
+// Nagłówek nie używa float/double w kodzie wykonywanym dla Fixed<F>
+// (poza to_double(), wołanym tylko na hoście), nie alokuje i nie
+// potrzebuje biblioteki poza <cstdint>/<type_traits> – da się go
+// skompilować -ffreestanding na MCU bez FPU.
+
+#include <cstdint>
+#include <type_traits>
+
+namespace bno {
+
+/// Qm.F na int32: wartość = raw / 2^F. Mnożenie przez int64 z zaokrągleniem.
+/// Przy F = 16 zakres ±32768, rozdzielczość 1.5e-5 – wystarcza na
+/// a (Q8 z czujnika, ±78 m/s² przy ±8 g), |a|² do ~180 m/s², Δv i kwaternion (Q14).
+template <int F>
+class Fixed {
+    static_assert(F > 0 && F < 31, "Fixed<F>: 0 < F < 31");
+
+public:
+    static constexpr int FRAC_BITS = F;
+
+    constexpr Fixed() = default;
+
+    static constexpr Fixed from_raw(std::int32_t raw)
+    {
+        Fixed f;
+        f.raw_ = raw;
+        return f;
+    }
+
+    /// Wartość Qq z czujnika (np. raw Q8 accel) – tylko przesunięcie.
+    static constexpr Fixed from_q(std::int32_t raw, int q)
+    {
+        return from_raw(q <= F ? static_cast<std::int32_t>(static_cast<std::uint32_t>(raw) << (F - q))
+                               : round_shift(raw, q - F));
+    }
+
+    /// m/1000 – progi konfiguracji bez liczb zmiennoprzecinkowych.
+    static constexpr Fixed from_milli(std::int32_t milli)
+    {
+        const std::int64_t num = static_cast<std::int64_t>(milli) * (std::int64_t{1} << F);
+        return from_raw(static_cast<std::int32_t>((num + (num >= 0 ? 500 : -500)) / 1000));
+    }
+
+    constexpr std::int32_t raw() const { return raw_; }
+
+    /// Tylko host (testy zgodności, wypisywanie).
+    double to_double() const { return static_cast<double>(raw_) / static_cast<double>(std::int64_t{1} << F); }
+
+    constexpr Fixed operator-() const { return from_raw(-raw_); }
+    constexpr Fixed& operator+=(Fixed o) { raw_ += o.raw_; return *this; }
+    constexpr Fixed& operator-=(Fixed o) { raw_ -= o.raw_; return *this; }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return from_raw(a.raw_ + b.raw_); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return from_raw(a.raw_ - b.raw_); }
+    friend constexpr Fixed operator*(Fixed a, Fixed b)
+    {
+        return from_raw(round_shift64(static_cast<std::int64_t>(a.raw_) * b.raw_, F));
+    }
+
+    friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw_ == b.raw_; }
+    friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw_ < b.raw_; }
+    friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw_ > b.raw_; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw_ <= b.raw_; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw_ >= b.raw_; }
+
+private:
+    std::int32_t raw_{0};
+
+    static constexpr std::int32_t round_shift(std::int32_t v, int s)
+    {
+        return round_shift64(v, s);
+    }
+    static constexpr std::int32_t round_shift64(std::int64_t v, int s)
+    {
+        return static_cast<std::int32_t>((v + (std::int64_t{1} << (s - 1))) >> s);
+    }
+};
+
+/// Wspólny interfejs typu liczbowego dla NumOps<float> i NumOps<Fixed<F>>:
+/// konwersje z formatów SH-2 i operacje, których nie da się zapisać
+/// samymi + - * (mnożenie przez czas w µs, dzielenie przez liczbę próbek).
+template <typename T>
+struct NumOps;
+
+template <>
+struct NumOps<float> {
+    static constexpr bool fixed = false;
+    static constexpr float from_q(std::int32_t raw, int q)
+    {
+        return static_cast<float>(raw) * (1.0f / static_cast<float>(std::int64_t{1} << q));
+    }
+    static constexpr float from_milli(std::int32_t milli) { return static_cast<float>(milli) * 1e-3f; }
+    static constexpr float mul_us(float a, std::uint32_t dt_us) { return a * (static_cast<float>(dt_us) * 1e-6f); }
+    static constexpr float div_int(float a, std::int32_t n) { return a / static_cast<float>(n); }
+    static constexpr float abs(float a) { return a < 0.0f ? -a : a; }
+    static double to_double(float a) { return static_cast<double>(a); }
+};
+
+template <int F>
+struct NumOps<Fixed<F>> {
+    using T = Fixed<F>;
+    static constexpr bool fixed = true;
+    static constexpr T from_q(std::int32_t raw, int q) { return T::from_q(raw, q); }
+    static constexpr T from_milli(std::int32_t milli) { return T::from_milli(milli); }
+    static constexpr T mul_us(T a, std::uint32_t dt_us)
+    {
+        // a · dt[µs] / 1e6; int64 mieści a do 2^15 i dt do ~2^32 µs
+        const std::int64_t num = static_cast<std::int64_t>(a.raw()) * dt_us;
+        return T::from_raw(static_cast<std::int32_t>((num + (num >= 0 ? 500000 : -500000)) / 1000000));
+    }
+    static constexpr T div_int(T a, std::int32_t n)
+    {
+        const std::int32_t r = a.raw();
+        return T::from_raw((r + (r >= 0 ? n / 2 : -n / 2)) / n);
+    }
+    static constexpr T abs(T a) { return a.raw() < 0 ? -a : a; }
+    static double to_double(T a) { return a.to_double(); }
+};
+
+/// Q16.16 – domyślny typ stałoprzecinkowy ścieżki MCU.
+using Q16 = Fixed<16>;
+
+} // namespace bno
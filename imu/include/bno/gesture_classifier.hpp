@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bno/gesture_features.hpp"
+
+namespace bno {
+
+/// Klasyfikator gestu uczony na nagraniach: las losowy (cv::ml::RTrees)
+/// na cechach okna z WindowFeatureExtractor.
+///
+/// Model to jeden plik cv::FileStorage (.yml / .xml, opcjonalnie .gz):
+/// etykiety, liczba cech i węzeł "rtrees" z drzewami. load() tylko go
+/// czyta – bez uczenia przy starcie.
+///
+/// Bez OpenCV (BNO_HAVE_OPENCV) klasa istnieje, ale available() == false,
+/// a train()/load() zwracają błąd – imu_train może wtedy tylko zapisać cechy
+/// do CSV. Wyjątki OpenCV nie wychodzą poza ten moduł (bool + err).
+class GestureClassifier {
+public:
+    struct TrainConfig {
+        int trees = 100;
+        int max_depth = 8;
+        int min_samples = 2;     // min. próbek w liściu
+        int active_vars = 0;     // cech losowanych w węźle; 0 = √FEATURE_COUNT
+    };
+
+    struct Prediction {
+        int label_index{-1};
+        float confidence{0.0f};  // ułamek drzew głosujących na label_index
+    };
+
+    GestureClassifier();
+    ~GestureClassifier();
+    GestureClassifier(GestureClassifier&&) noexcept;
+    GestureClassifier& operator=(GestureClassifier&&) noexcept;
+
+    /// Zbudowany z OpenCV ml.
+    static bool available();
+
+    /// labels[i] – etykieta okna x[i] (np. "LEFT"). Zastępuje bieżący model.
+    bool train(const std::vector<GestureFeatureVector>& x,
+               const std::vector<std::string>& labels,
+               const TrainConfig& cfg,
+               std::string& err);
+    bool save(const std::string& path, std::string& err) const;
+    bool load(const std::string& path, std::string& err);
+
+    bool loaded() const;
+    /// false, gdy brak modelu.
+    bool predict(const GestureFeatureVector& x, Prediction& out) const;
+
+    const std::vector<std::string>& labels() const { return labels_; }
+    const std::string& label(int index) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+    std::vector<std::string> labels_;
+};
+
+} // namespace bno
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"   // Vec3, Quat
+
+namespace bno {
+
+/// Mała sieć konwolucyjna 1D (TCN) nad ostatnią sekundą ruchu, z ONNX
+/// przez cv::dnn – dla gestów spoza sześciu kierunków (cnn_train.py).
+///
+/// Wejście sieci: tensor 1 x 6 x N (a_dyn xyz, ω xyz w układzie świata)
+/// na stałej siatce rate_hz, N = window_s * rate_hz. Wyjście: 1 x K
+/// wyników klas (logity albo prawdopodobieństwa); etykiety z pliku
+/// <model>.labels, po jednej w linii. Klasa NONE (tło) nie jest zgłaszana.
+///
+/// Strumieniowo: każda próbka od razu trafia na siatkę (interpolacja
+/// liniowa) do bufora pierścieniowego kanałów, a sieć liczy się co
+/// 1/eval_hz s. cv::dnn nie trzyma stanu między wywołaniami forward(),
+/// więc „przyrostowo” znaczy: bez kopiowania całego okna na próbkę
+/// i bez alokacji przy ewaluacji – blob wejściowy, wyjście i bufor są
+/// przydzielone raz w load().
+///
+/// int8: load() kwantyzuje sieć przez Net::quantize() (wagi i aktywacje int8,
+/// per-channel) na oknach uczących z pliku .calib od cnn_train.py – nic
+/// z tego nie dzieje się przy ewaluacji. Brak albo zły plik .calib to błąd
+/// load(); gdy sama kwantyzacja się nie uda (nieobsługiwana warstwa),
+/// zostaje float, a int8_error() mówi dlaczego.
+///
+/// Bez OpenCV dnn (BNO_HAVE_OPENCV_DNN) available() == false, load() zwraca błąd.
+class StreamingGestureCnn {
+public:
+    struct Config {
+        std::string model_path;          // .onnx
+        std::string labels_path;         // pusty = model_path z rozszerzeniem .labels
+        double rate_hz = 50.0;           // siatka wejścia (jak przy eksporcie)
+        double window_s = 1.0;
+        double eval_hz = 20.0;
+        double min_confidence = 0.8;     // próg prawdopodobieństwa klasy
+        double refractory_s = 1.0;       // po zgłoszeniu cisza (gest przechodzi przez okno)
+        bool int8 = false;
+        std::string calib_path;          // pusty = model_path z rozszerzeniem .calib
+    };
+
+    struct Result {
+        double t{0.0};           // czas ostatniej próbki okna
+        int label_index{-1};
+        float confidence{0.0f};
+    };
+
+    struct Stats {
+        std::uint64_t evaluations{0};
+        std::uint64_t detections{0};
+        double last_us{0.0};     // czas ostatniego forward()
+        double max_us{0.0};      // od ostatniego wyzerowania przez wołającego
+    };
+
+    StreamingGestureCnn();
+    ~StreamingGestureCnn();
+    StreamingGestureCnn(StreamingGestureCnn&&) noexcept;
+    StreamingGestureCnn& operator=(StreamingGestureCnn&&) noexcept;
+
+    static bool available();
+
+    bool load(const Config& cfg, std::string& err);
+    bool loaded() const;
+
+    /// Próbka jak do detektora + grawitacja w układzie świata
+    /// (GestureDirectionDetector::baseline_world()). true = wykryty gest w `out`
+    /// (klasa inna niż NONE, p >= min_confidence, poza refractory_s).
+    bool add_sample(double t, const Vec3& accel_sensor, const Vec3& gyro_sensor,
+                    const Quat& quat, const Vec3& gravity_world, Result& out);
+
+    const std::string& label(int index) const;
+    const std::vector<std::string>& labels() const { return labels_; }
+    bool int8_active() const { return int8_active_; }
+    const std::string& int8_error() const { return int8_error_; }
+    Stats& stats() { return stats_; }
+
+    static constexpr std::size_t CHANNELS = 6;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    Config cfg_{};
+    std::vector<std::string> labels_;
+    int none_index_{-1};
+
+    // siatka wejścia: pierścień CHANNELS x n_ (kanał-major)
+    std::vector<float> ring_;
+    std::size_t n_{0};
+    std::size_t head_{0};       // następny zapis
+    std::size_t filled_{0};
+    double grid_dt_{0.0};
+    double next_grid_t_{0.0};
+    double next_eval_t_{0.0};
+    bool have_prev_{false};
+    double prev_t_{0.0};
+    float prev_[CHANNELS]{};
+
+    bool int8_active_{false};
+    std::string int8_error_;
+    double last_detect_t_{-1e9};
+    Stats stats_;
+
+    void reset_grid();
+    void push_grid(const float* v);
+    bool evaluate(double t, Result& out);
+};
+
+} // namespace bno
@@ -4,10 +4,13 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <optional>
 #include <string>
 
+#include "bno/gesture_simd.hpp"
+#include "bno/peak_window.hpp"
+#include "bno/sample_store.hpp"
+
 namespace bno {
 
 struct Vec3 {
@@ -23,20 +26,59 @@ struct Quat {
     double z{0.0};
 };
 
-struct GestureSample {
-    double t;      // czas w sekundach (steady_clock od startu)
-    Vec3  accel;   // przyspieszenie w układzie (tutaj: WORLD, patrz add_sample)
-    Quat  quat;    // orientacja sensora (Game Rotation Vector)
+/// Paczka próbek w układzie sensora (SoA, float) – np. z odtwarzania nagrań.
+/// Obrót do układu świata idzie wtedy wektorowo po całej paczce.
+struct SampleBatch {
+    const double* t{nullptr};
+    const float* ax{nullptr};
+    const float* ay{nullptr};
+    const float* az{nullptr};
+    const float* gx{nullptr};   // gx/gy/gz mogą być nullptr (brak gyro)
+    const float* gy{nullptr};
+    const float* gz{nullptr};
+    const float* qw{nullptr};
+    const float* qx{nullptr};
+    const float* qy{nullptr};
+    const float* qz{nullptr};
+    std::size_t n{0};
+};
+
+/// Rodzaj rozpoznanego gestu.
+enum class GestureKind : std::uint8_t {
+    Translation, // ruch posuwisty (UP/DOWN/LEFT/RIGHT/FORWARD/BACKWARD)
+    Twist,       // obrót nadgarstka z trwałą zmianą orientacji
+    Flick,       // szybki obrót tam i z powrotem (mała zmiana netto)
+    Circle,      // zatoczenie koła – wektor a_dyn obraca się o ~360°
+};
+
+/// Cechy okna gestu liczone w jednym przejściu po buforze.
+struct GestureFeatures {
+    Vec3   delta_v{};         // ∫ a_dyn dt (m/s), WORLD
+    Vec3   peak_velocity{};   // Δv w chwili największej |Δv| (koniec fazy przyspieszania)
+    Vec3   gyro_integral{};   // ∫ ω dt (rad), WORLD – przybliżony wektor obrotu
+    double gyro_abs_integral{0.0}; // ∫ |ω| dt (rad) – całkowity „przebyty” kąt
+    double peak_accel{0.0};   // max |a_dyn| w oknie (m/s^2)
+    double peak_gyro{0.0};    // max |ω| w oknie (rad/s)
+    Vec3   peak_gyro_vec{};   // ω w chwili maksimum
+    Quat   quat_delta{};      // q_end * q_start^{-1} – obrót netto w oknie
+    double rotation_angle{0.0}; // kąt obrotu netto z quat_delta (rad)
+    Vec3   sweep{};           // skumulowany obrót kierunku a_dyn (rad), oś = normalna płaszczyzny
 };
 
 struct GestureResult {
     double t_center;      // czas środka okna gestu
+    double t_start{0.0};  // czas pierwszej próbki okna
     double duration;      // czas trwania okna (s)
     Vec3   delta_v_world; // zintegrowane a_dyn w układzie świata
     Vec3   baseline_world;// bazowy wektor grawitacji
     char   axis;          // 'X', 'Y', 'Z'
     char   sign;          // '+' lub '-'
-    std::string label;    // "UP"/"DOWN"/etc.
+    std::string label;    // "UP"/"DOWN"/"TWIST_CW"/etc.
+    GestureKind kind{GestureKind::Translation};
+    GestureFeatures features{};
+    double t_emit{0.0};        // czas próbki, przy której wynik został wyemitowany
+    std::uint32_t gesture_id{0}; // w trybie Segmented: wspólne dla wyniku wstępnego i końcowego
+    bool provisional{false};   // true = etykieta wstępna (koniec segmentu), będzie doprecyzowana
 };
 
 // Obrót wektora przez kwaternion (q * v * q^{-1})
@@ -65,14 +107,112 @@ inline double norm(const Vec3& v)
     return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
 }
 
+inline double dot(const Vec3& a, const Vec3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vec3 cross(const Vec3& a, const Vec3& b)
+{
+    return Vec3{
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x,
+    };
+}
+
+inline Quat quat_conj(const Quat& q)
+{
+    return Quat{q.w, -q.x, -q.y, -q.z};
+}
+
+// Iloczyn Hamiltona a * b
+inline Quat quat_mul(const Quat& a, const Quat& b)
+{
+    return Quat{
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+    };
+}
+
+// Kąt obrotu (0..π) reprezentowany przez kwaternion jednostkowy
+inline double quat_angle(const Quat& q)
+{
+    const double vn = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+    return 2.0 * std::atan2(vn, std::fabs(q.w));
+}
+
+// Wektor obrotu (rad, oś · kąt) kwaternionu jednostkowego; q i -q to ten
+// sam obrót, bierzemy krótszy
+inline Vec3 rotation_vector(Quat q)
+{
+    if (q.w < 0.0) {
+        q = Quat{-q.w, -q.x, -q.y, -q.z};
+    }
+    const double vn = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+    if (vn < 1e-12) {
+        return Vec3{2.0 * q.x, 2.0 * q.y, 2.0 * q.z};
+    }
+    const double k = 2.0 * std::atan2(vn, q.w) / vn;
+    return Vec3{q.x * k, q.y * k, q.z * k};
+}
+
+// Dominująca oś wektora: zwraca 'X'/'Y'/'Z', znak i wartość składowej
+inline char dominant_axis(const Vec3& v, char& sign, double& value)
+{
+    const int axis = peak_window::dominant_axis(v.x, v.y, v.z);
+    value = axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    sign = (value >= 0.0) ? '+' : '-';
+    return static_cast<char>('X' + axis);
+}
+
+// Mode::PeakWindow dzieli rdzeń (czas, bufor, baseline, pik, okno, oś
+// i kierunek z Δv) z BasicDirectionDetector (gesture_dir_t.hpp, float/Q16
+// dla MCU) przez peak_window.hpp; test ctest gesture_parity pilnuje, żeby
+// obie ścieżki dawały te same gesty posuwiste.
 class GestureDirectionDetector {
 public:
+    /// Tryb detekcji.
+    ///  - PeakWindow: czekamy, aż pik |a_dyn| będzie w środku okna ±half_window_s
+    ///    (jeden wynik, opóźnienie >= half_window_s).
+    ///  - Segmented: histereza na wygładzonej energii ruchu (|a_dyn| albo |ω|
+    ///    w skali min_gyro_peak ↔ seg_on_threshold) wyznacza początek
+    ///    i koniec ruchu; na końcu segmentu od razu idzie wynik wstępny
+    ///    (provisional). Jeśli przez seg_settle_s ruch nie wróci, idzie wynik
+    ///    końcowy o tym samym gesture_id; jeśli wróci – segment jest
+    ///    sklejany, a wynik końcowy liczony z całości. Kierunek bierzemy
+    ///    z Δv w chwili największej prędkości (faza przyspieszania), bo
+    ///    całka po pełnym ruchu start-stop wychodzi bliska zeru.
+    enum class Mode : std::uint8_t {
+        PeakWindow,
+        Segmented,
+    };
+
     struct Config {
         double baseline_window_s     = 0.2;  // ile s na estymację grawitacji
         double half_window_s         = 0.3;  // pół okna gestu (pełne ok. 0.6 s)
         double min_dyn_threshold     = 0.5;  // m/s^2 – próg dynamiki (odcina szum)
         double min_peak_magnitude    = 1.5;  // m/s^2 – min. norma a_dyn uznana za gest
-        double min_gesture_interval  = 0.8;  // s – minimalny odstęp między gestami
+        double min_gesture_interval  = 0.8;  // s – minimalny odstęp między gestami (PeakWindow)
+
+        // Gesty obrotowe (wymagają podawania gyro do add_sample)
+        double min_gyro_peak         = 3.0;  // rad/s – min. |ω| uznane za gest obrotowy
+        double min_twist_angle       = 0.8;  // rad – obrót netto dla TWIST (~45°)
+        double max_flick_net_angle   = 0.35; // rad – FLICK wraca prawie do orientacji startowej
+        double min_flick_travel      = 0.6;  // rad – min. ∫|ω| dt dla FLICK
+        double min_circle_sweep      = 5.0;  // rad – obrót kierunku a_dyn dla CIRCLE (~290°)
+
+        Mode   mode                  = Mode::PeakWindow;
+        // Segmentacja (tylko Mode::Segmented)
+        double seg_on_threshold      = 1.2;  // m/s^2 – energia powyżej: początek ruchu
+        double seg_off_threshold     = 0.6;  // m/s^2 – energia poniżej: kandydat na koniec
+        double seg_off_hold_s        = 0.04; // s – jak długo energia musi być pod progiem
+        double seg_energy_alpha      = 0.35; // współczynnik EMA energii
+        double seg_pre_roll_s        = 0.1;  // s – ile przed początkiem dołączyć do całki
+        double seg_settle_s          = 0.15; // s – cisza potwierdzająca koniec (wynik końcowy)
+        double seg_max_duration_s    = 1.2;  // s – dłuższy segment zamykamy na siłę
     };
 
     // UWAGA: bez domyślnego argumentu (= Config()), to powodowało błąd.
@@ -82,23 +222,73 @@ public:
 
     void add_sample(double t, const Vec3& accel_sensor, const Quat& quat)
     {
-        // sensor -> world
-        Vec3 accel_world = rotate_vector_by_quat(accel_sensor, quat);
-
-        GestureSample sample{t, accel_world, quat};
-        buffer_.push_back(sample);
+        add_sample(t, accel_sensor, Vec3{}, quat);
+    }
 
-        const double max_buffer_span = 2.5 * cfg_.half_window_s;
-        while (!buffer_.empty() && (t - buffer_.front().t) > max_buffer_span) {
-            buffer_.pop_front();
-        }
+    void add_sample(double t, const Vec3& accel_sensor, const Vec3& gyro_sensor, const Quat& quat)
+    {
+        // sensor -> world (float, jak w buforze)
+        const float qw = static_cast<float>(quat.w);
+        const float qx = static_cast<float>(quat.x);
+        const float qy = static_cast<float>(quat.y);
+        const float qz = static_cast<float>(quat.z);
+
+        float v[SampleStore::COLUMN_COUNT];
+        rotate_vector_by_quat_f(qw, qx, qy, qz,
+                                static_cast<float>(accel_sensor.x),
+                                static_cast<float>(accel_sensor.y),
+                                static_cast<float>(accel_sensor.z),
+                                v[SampleStore::AX], v[SampleStore::AY], v[SampleStore::AZ]);
+        rotate_vector_by_quat_f(qw, qx, qy, qz,
+                                static_cast<float>(gyro_sensor.x),
+                                static_cast<float>(gyro_sensor.y),
+                                static_cast<float>(gyro_sensor.z),
+                                v[SampleStore::GX], v[SampleStore::GY], v[SampleStore::GZ]);
+        v[SampleStore::QW] = qw;
+        v[SampleStore::QX] = qx;
+        v[SampleStore::QY] = qy;
+        v[SampleStore::QZ] = qz;
+        ingest_world(t, v);
+    }
 
-        if (!baseline_computed_) {
-            compute_baseline_if_ready();
-        }
+    /// Wiele próbek naraz: obrót sensor -> world jednym kernelem SIMD na blok,
+    /// potem detekcja próbka po próbce (wyniki jak przy add_sample).
+    /// Każdy wynik trafia do on_result(const GestureResult&) od razu po
+    /// próbce, która go wyzwoliła – nic nie ginie między poll_result().
+    template <typename OnResult>
+    void add_samples(const SampleBatch& b, OnResult&& on_result)
+    {
+        constexpr std::size_t BLOCK = 64;
+        float world[6][BLOCK];
+        const float zeros[BLOCK] = {};
+
+        for (std::size_t off = 0; off < b.n; off += BLOCK) {
+            const std::size_t n = std::min(BLOCK, b.n - off);
+            rotate_vectors_by_quats(b.qw + off, b.qx + off, b.qy + off, b.qz + off,
+                                    b.ax + off, b.ay + off, b.az + off,
+                                    world[0], world[1], world[2], n);
+            if (b.gx && b.gy && b.gz) {
+                rotate_vectors_by_quats(b.qw + off, b.qx + off, b.qy + off, b.qz + off,
+                                        b.gx + off, b.gy + off, b.gz + off,
+                                        world[3], world[4], world[5], n);
+            } else {
+                for (std::size_t c = 3; c < 6; ++c) {
+                    std::copy(zeros, zeros + n, world[c]);
+                }
+            }
 
-        if (baseline_computed_) {
-            maybe_detect_gesture();
+            for (std::size_t i = 0; i < n; ++i) {
+                const float v[SampleStore::COLUMN_COUNT] = {
+                    world[0][i], world[1][i], world[2][i],
+                    world[3][i], world[4][i], world[5][i],
+                    b.qw[off + i], b.qx[off + i], b.qy[off + i], b.qz[off + i],
+                    0.0f, 0.0f,
+                };
+                ingest_world(b.t[off + i], v);
+                if (auto res = poll_result()) {
+                    on_result(*res);
+                }
+            }
         }
     }
 
@@ -115,180 +305,524 @@ public:
     const Vec3& baseline_world() const { return a0_world_; }
     bool has_baseline() const { return baseline_computed_; }
 
+    const Config& config() const { return cfg_; }
+
+    /// Nowe progi między próbkami (--control): bufor, baseline i czas
+    /// ostatniego gestu zostają. Tryb się nie zmienia (cfg.mode jest
+    /// pomijane), a baseline_window_s działa tylko, dopóki baseline nie ma.
+    void set_config(const Config& cfg)
+    {
+        const Mode mode = cfg_.mode;
+        cfg_ = cfg;
+        cfg_.mode = mode;
+        scan_.scanned = 0;   // min_dyn_threshold zmienia sumy
+    }
+
 private:
+    using TimeOps = peak_window::TimeOps<double>;
+    static constexpr double MIN_AXIS_VELOCITY = peak_window::MIN_AXIS_VELOCITY_MILLI / 1000.0;
+
     Config cfg_;
-    std::deque<GestureSample> buffer_;
+    SampleStore store_;
     Vec3 a0_world_{0.0, 0.0, 0.0};
+    float a0_f_[3]{0.0f, 0.0f, 0.0f};
     bool baseline_computed_{false};
     double t_baseline_end_{0.0};
     double last_gesture_time_{-1e9};
     std::optional<GestureResult> pending_result_;
 
-    void compute_baseline_if_ready()
+    // Sumy bieżące okna [start, start + scanned) – kolejna próba detekcji
+    // z tym samym początkiem okna dolicza tylko nowe próbki
+    struct WindowScan {
+        GestureFeatures f;
+        Vec3 prev_dyn{};
+        Vec3 prev_gyro{};
+        double prev_dyn_mag{0.0};
+        double prev_rate{0.0};
+        double peak_speed{0.0};
+        double t_start{0.0};
+        std::size_t scanned{0};   // 0 = brak stanu
+    };
+    WindowScan scan_;
+
+    // Numer próbki = popped_ + indeks; indeksy przesuwa pop_front(), numery nie
+    std::uint64_t popped_{0};
+
+    // Piki |a_dyn| i |ω| od t_baseline_end_ w obecnym buforze (PeakWindow)
+    peak_window::RunningPeak<float> accel_peak_;
+    peak_window::RunningPeak<float> gyro_peak_;
+
+    // Stan segmentacji (Mode::Segmented)
+    enum class SegState : std::uint8_t {
+        Idle,      // cisza
+        Active,    // energia powyżej progu on (lub jeszcze nad off)
+        Ending,    // energia pod progiem off, czekamy seg_off_hold_s
+        Settling,  // wynik wstępny wysłany, czekamy seg_settle_s na potwierdzenie
+    };
+    SegState seg_state_{SegState::Idle};
+    double seg_energy_{0.0};
+    double seg_onset_t_{0.0};
+    double seg_below_since_{0.0};
+    double seg_end_t_{0.0};
+    double seg_peak_t_{0.0};
+    double seg_peak_mag_{0.0};
+    std::uint32_t seg_id_{0};
+
+    double buffer_span() const
     {
-        if (buffer_.empty()) {
-            return;
+        double span = peak_window::buffer_span(cfg_.half_window_s);
+        if (cfg_.mode == Mode::Segmented) {
+            span = std::max(span, cfg_.seg_pre_roll_s + cfg_.seg_max_duration_s +
+                                  cfg_.seg_off_hold_s + cfg_.seg_settle_s + 0.1);
         }
+        return span;
+    }
 
-        const double t0 = buffer_.front().t;
-        const double window_s = cfg_.baseline_window_s;
+    // Próbka w układzie świata (AX..QZ wypełnione) → bufor + detekcja.
+    void ingest_world(double t, const float* values)
+    {
+        float v[SampleStore::COLUMN_COUNT];
+        std::copy(values, values + SampleStore::COLUMN_COUNT, v);
 
-        double sumx = 0.0, sumy = 0.0, sumz = 0.0;
-        std::size_t count = 0;
+        const float gx = v[SampleStore::GX];
+        const float gy = v[SampleStore::GY];
+        const float gz = v[SampleStore::GZ];
+        v[SampleStore::GYRO_NORM] = std::sqrt(gx * gx + gy * gy + gz * gz);
+        if (baseline_computed_) {
+            const float dx = v[SampleStore::AX] - a0_f_[0];
+            const float dy = v[SampleStore::AY] - a0_f_[1];
+            const float dz = v[SampleStore::AZ] - a0_f_[2];
+            v[SampleStore::DYN] = std::sqrt(dx * dx + dy * dy + dz * dz);
+        } else {
+            v[SampleStore::DYN] = 0.0f;
+        }
+        store_.push_back(t, v);
 
-        for (const auto& s : buffer_) {
-            if ((s.t - t0) > window_s) {
-                break;
+        const double max_buffer_span = buffer_span();
+        while (!store_.empty() && TimeOps::longer(store_.front_t(), t, max_buffer_span)) {
+            store_.pop_front();
+            ++popped_;
+        }
+
+        if (!baseline_computed_) {
+            compute_baseline_if_ready();
+        }
+
+        if (baseline_computed_) {
+            if (cfg_.mode == Mode::Segmented) {
+                update_segmenter();
+            } else {
+                maybe_detect_gesture();
             }
-            sumx += s.accel.x;
-            sumy += s.accel.y;
-            sumz += s.accel.z;
-            ++count;
+        }
+    }
+
+    auto time_at() const
+    {
+        return [this](std::size_t i) { return store_.t(i); };
+    }
+
+    // Pierwszy indeks z t >= t_from (czasy w buforze nie maleją)
+    std::size_t index_at_or_after(double t_from) const
+    {
+        return peak_window::first_at_or_after(store_.size(), time_at(), t_from);
+    }
+
+    // Pierwszy indeks z t > t_to
+    std::size_t index_after(double t_to) const
+    {
+        return peak_window::first_after(store_.size(), time_at(), t_to);
+    }
+
+    void compute_baseline_if_ready()
+    {
+        if (store_.empty()) {
+            return;
         }
 
-        if (count < 3) {
+        const double t0 = store_.front_t();
+        const double window_s = cfg_.baseline_window_s;
+        const std::size_t count = peak_window::baseline_count(store_.size(), time_at(), window_s);
+        if (count < peak_window::BASELINE_MIN_SAMPLES) {
             return;
         }
 
+        const float* ax = store_.col(SampleStore::AX);
+        const float* ay = store_.col(SampleStore::AY);
+        const float* az = store_.col(SampleStore::AZ);
+
+        double sumx = 0.0, sumy = 0.0, sumz = 0.0;
+        for (std::size_t i = 0; i < count; ++i) {
+            sumx += static_cast<double>(ax[i]);
+            sumy += static_cast<double>(ay[i]);
+            sumz += static_cast<double>(az[i]);
+        }
+
         a0_world_.x = sumx / static_cast<double>(count);
         a0_world_.y = sumy / static_cast<double>(count);
         a0_world_.z = sumz / static_cast<double>(count);
+        a0_f_[0] = static_cast<float>(a0_world_.x);
+        a0_f_[1] = static_cast<float>(a0_world_.y);
+        a0_f_[2] = static_cast<float>(a0_world_.z);
         baseline_computed_ = true;
         t_baseline_end_ = t0 + window_s;
+
+        // |a_dyn| dla próbek zebranych przed estymacją – jednym przebiegiem SIMD
+        vector_norms(ax, ay, az, a0_f_[0], a0_f_[1], a0_f_[2],
+                     store_.col(SampleStore::DYN), store_.size());
+    }
+
+    Vec3 dyn_at(std::size_t i) const
+    {
+        return Vec3{
+            static_cast<double>(store_.at(SampleStore::AX, i)) - a0_world_.x,
+            static_cast<double>(store_.at(SampleStore::AY, i)) - a0_world_.y,
+            static_cast<double>(store_.at(SampleStore::AZ, i)) - a0_world_.z,
+        };
     }
 
     void maybe_detect_gesture()
     {
-        if (buffer_.size() < 3) {
+        if (store_.size() < 3) {
             return;
         }
 
-        const double t_now = buffer_.back().t;
-        if ((t_now - last_gesture_time_) < cfg_.min_gesture_interval) {
+        const double t_now = store_.back_t();
+        if (TimeOps::shorter(last_gesture_time_, t_now, cfg_.min_gesture_interval)) {
+            accel_peak_.invalidate();   // próbek w przerwie nie śledzimy
+            gyro_peak_.invalidate();
             return;
         }
 
-        // 1) peak |a_dyn|
-        double max_mag = -1.0;
-        std::size_t i_peak = 0;
-
-        for (std::size_t i = 0; i < buffer_.size(); ++i) {
-            const auto& s = buffer_[i];
-            if (s.t < t_baseline_end_) {
-                continue;
-            }
-            Vec3 dyn{
-                s.accel.x - a0_world_.x,
-                s.accel.y - a0_world_.y,
-                s.accel.z - a0_world_.z,
-            };
-            const double mag = norm(dyn);
-            if (mag > max_mag) {
-                max_mag = mag;
-                i_peak = i;
-            }
-        }
-
-        if (max_mag < cfg_.min_peak_magnitude) {
+        // 1) peak |a_dyn| oraz peak |ω| – normy są już policzone w kolumnach.
+        //    Cały bufor przeglądamy tylko, gdy pik wypadł z bufora; inaczej
+        //    wystarczy porównać nową próbkę (przy remisie zostaje starszy pik).
+        const float* dyn_norm = store_.col(SampleStore::DYN);
+        const float* gyro_norm = store_.col(SampleStore::GYRO_NORM);
+        const bool last_in_range = TimeOps::not_after(t_baseline_end_, t_now);
+        const auto range_start = [this] { return index_at_or_after(t_baseline_end_); };
+        accel_peak_.track(store_.size(), popped_, last_in_range, range_start,
+                          [dyn_norm](std::size_t i) { return dyn_norm[i]; });
+        gyro_peak_.track(store_.size(), popped_, last_in_range, range_start,
+                         [gyro_norm](std::size_t i) { return gyro_norm[i]; });
+
+        const bool accel_trigger =
+            accel_peak_.have && static_cast<double>(accel_peak_.value) >= cfg_.min_peak_magnitude;
+        const bool gyro_trigger =
+            gyro_peak_.have && static_cast<double>(gyro_peak_.value) >= cfg_.min_gyro_peak;
+        if (!accel_trigger && !gyro_trigger) {
             return;
         }
 
-        const double t_peak = buffer_[i_peak].t;
-        const double t_start = t_peak - cfg_.half_window_s;
-        const double t_end   = t_peak + cfg_.half_window_s;
+        // Okno centrujemy na piku, który wyzwolił detekcję (przy obu – na akcelerometrze)
+        const double t_peak = store_.t(accel_trigger ? accel_peak_.index(popped_)
+                                                     : gyro_peak_.index(popped_));
 
         // 2) indeksy okna
         std::size_t start_idx = 0;
-        while (start_idx < buffer_.size() && buffer_[start_idx].t < t_start) {
-            ++start_idx;
+        std::size_t end_idx = 0;
+        if (!peak_window::window_around(store_.size(), time_at(), t_peak, cfg_.half_window_s,
+                                        start_idx, end_idx)) {
+            return;
+        }
+
+        // 3) cechy okna (Δv, ∫ω, peak ω, Δq, sweep). Dopóki pik się nie
+        //    zmienia, początek okna stoi, a z każdą próbką dochodzi jedna na
+        //    końcu – przedłużamy sumy z poprzedniej próby zamiast liczyć od zera.
+        if (scan_.scanned == 0 || scan_.t_start != store_.t(start_idx) ||
+            start_idx + scan_.scanned > end_idx) {
+            scan_begin(scan_, start_idx);
         }
-        std::size_t end_idx = start_idx;
-        while (end_idx < buffer_.size() && buffer_[end_idx].t <= t_end) {
-            ++end_idx;
+        scan_extend(scan_, start_idx + scan_.scanned, end_idx);
+        scan_.scanned = end_idx - start_idx;
+        const GestureFeatures f = scan_finish(scan_, start_idx, end_idx);
+        const double duration = store_.t(end_idx - 1) - store_.t(start_idx);
+
+        GestureResult res;
+        res.t_center       = t_peak;
+        res.t_start        = store_.t(start_idx);
+        res.duration       = duration;
+        res.delta_v_world  = f.delta_v;
+        res.baseline_world = a0_world_;
+        res.features       = f;
+        res.t_emit         = t_now;
+
+        if (!classify(f, f.delta_v, res)) {
+            return;
         }
 
+        pending_result_    = res;
+        last_gesture_time_ = t_now;
+    }
+
+    // Segment [t_from, t_to] → cechy + klasyfikacja po peak_velocity. false = brak gestu.
+    bool classify_segment(double t_from, double t_to, GestureResult& res) const
+    {
+        const std::size_t start_idx = index_at_or_after(t_from);
+        const std::size_t end_idx = std::max(start_idx, index_after(t_to));
         if (end_idx <= start_idx + 2) {
+            return false;
+        }
+
+        const GestureFeatures f = compute_window_features(start_idx, end_idx);
+        res.t_center       = seg_peak_t_;
+        res.t_start        = store_.t(start_idx);
+        res.duration       = store_.t(end_idx - 1) - store_.t(start_idx);
+        res.delta_v_world  = f.peak_velocity;
+        res.baseline_world = a0_world_;
+        res.features       = f;
+        return classify(f, f.peak_velocity, res);
+    }
+
+    void emit_segment_result(double t_now, bool provisional)
+    {
+        GestureResult res;
+        if (classify_segment(seg_onset_t_ - cfg_.seg_pre_roll_s, seg_end_t_, res)) {
+            res.t_emit      = t_now;
+            res.gesture_id  = seg_id_;
+            res.provisional = provisional;
+            pending_result_ = res;
+        }
+    }
+
+    void update_segmenter()
+    {
+        const double t = store_.back_t();
+        if (t < t_baseline_end_) {
             return;
         }
 
-        // 3) integracja a_dyn
-        Vec3 dv{0.0, 0.0, 0.0};
-        const double duration = buffer_[end_idx - 1].t - buffer_[start_idx].t;
+        // Energia z |a_dyn| albo z |ω| przeskalowanego tak, że min_gyro_peak
+        // odpowiada seg_on_threshold – inaczej TWIST/FLICK/CIRCLE z małym
+        // przyspieszeniem liniowym nigdy nie otwierają segmentu. Przy
+        // min_gyro_peak <= 0 (np. z pliku) skali nie ma – tylko |a_dyn|.
+        const std::size_t last = store_.size() - 1;
+        const double accel_mag = static_cast<double>(store_.at(SampleStore::DYN, last));
+        const double gyro_scale =
+            cfg_.min_gyro_peak > 0.0 ? cfg_.seg_on_threshold / cfg_.min_gyro_peak : 0.0;
+        const double gyro_mag =
+            static_cast<double>(store_.at(SampleStore::GYRO_NORM, last)) * gyro_scale;
+        const double mag = std::max(accel_mag, gyro_mag);
+        seg_energy_ += cfg_.seg_energy_alpha * (mag - seg_energy_);
+
+        switch (seg_state_) {
+        case SegState::Idle:
+            // bez min_gesture_interval – rozdzielenie gestów załatwia seg_settle_s
+            if (seg_energy_ >= cfg_.seg_on_threshold) {
+                seg_state_    = SegState::Active;
+                seg_onset_t_  = t;
+                seg_peak_t_   = t;
+                seg_peak_mag_ = mag;
+                ++seg_id_;
+            }
+            break;
 
-        for (std::size_t i = start_idx + 1; i < end_idx; ++i) {
-            const auto& prev = buffer_[i - 1];
-            const auto& curr = buffer_[i];
-            const double dt = curr.t - prev.t;
-            if (dt <= 0.0) {
-                continue;
+        case SegState::Active:
+        case SegState::Ending:
+            if (mag > seg_peak_mag_) {
+                seg_peak_mag_ = mag;
+                seg_peak_t_   = t;
+            }
+            if (seg_energy_ >= cfg_.seg_off_threshold) {
+                seg_state_ = SegState::Active;
+            } else if (seg_state_ == SegState::Active) {
+                seg_state_       = SegState::Ending;
+                seg_below_since_ = t;
             }
 
-            Vec3 dyn{
-                curr.accel.x - a0_world_.x,
-                curr.accel.y - a0_world_.y,
-                curr.accel.z - a0_world_.z,
-            };
+            if ((seg_state_ == SegState::Ending && (t - seg_below_since_) >= cfg_.seg_off_hold_s) ||
+                (t - seg_onset_t_) >= cfg_.seg_max_duration_s) {
+                // koniec segmentu: wynik wstępny od razu
+                seg_end_t_ = t;
+                seg_state_ = SegState::Settling;
+                emit_segment_result(t, true);
+            }
+            break;
+
+        case SegState::Settling:
+            if (seg_energy_ >= cfg_.seg_on_threshold &&
+                (t - seg_onset_t_) < cfg_.seg_max_duration_s) {
+                // ruch wrócił – to była tylko pauza, sklejamy segment
+                seg_state_ = SegState::Active;
+                if (mag > seg_peak_mag_) {
+                    seg_peak_mag_ = mag;
+                    seg_peak_t_   = t;
+                }
+            } else if ((t - seg_end_t_) >= cfg_.seg_settle_s) {
+                emit_segment_result(t, false);
+                seg_state_ = SegState::Idle;
+            }
+            break;
+        }
+    }
 
-            const double mag = norm(dyn);
-            if (mag < cfg_.min_dyn_threshold) {
-                continue;
+    GestureFeatures compute_window_features(std::size_t start_idx, std::size_t end_idx) const
+    {
+        WindowScan s;
+        scan_begin(s, start_idx);
+        scan_extend(s, start_idx + 1, end_idx);
+        return scan_finish(s, start_idx, end_idx);
+    }
+
+    Vec3 gyro_at(std::size_t i) const
+    {
+        return Vec3{static_cast<double>(store_.at(SampleStore::GX, i)),
+                    static_cast<double>(store_.at(SampleStore::GY, i)),
+                    static_cast<double>(store_.at(SampleStore::GZ, i))};
+    }
+
+    void scan_begin(WindowScan& s, std::size_t start_idx) const
+    {
+        s = WindowScan{};
+        s.prev_dyn = dyn_at(start_idx);
+        s.prev_gyro = gyro_at(start_idx);
+        s.prev_dyn_mag = static_cast<double>(store_.at(SampleStore::DYN, start_idx));
+        s.prev_rate = static_cast<double>(store_.at(SampleStore::GYRO_NORM, start_idx));
+        s.f.peak_accel = s.prev_dyn_mag;
+        s.f.peak_gyro = s.prev_rate;
+        s.f.peak_gyro_vec = s.prev_gyro;
+        s.t_start = store_.t(start_idx);
+        s.scanned = 1;
+    }
+
+    // Dolicza próbki [from, end_idx) do sum okna (from > początek okna)
+    void scan_extend(WindowScan& s, std::size_t from, std::size_t end_idx) const
+    {
+        const float* dyn_norm = store_.col(SampleStore::DYN);
+        const float* gyro_norm = store_.col(SampleStore::GYRO_NORM);
+        GestureFeatures& f = s.f;
+
+        for (std::size_t i = from; i < end_idx; ++i) {
+            const Vec3 dyn = dyn_at(i);
+            const Vec3 gyro = gyro_at(i);
+            const double mag = static_cast<double>(dyn_norm[i]);
+            const double rate = static_cast<double>(gyro_norm[i]);
+
+            if (mag > f.peak_accel) {
+                f.peak_accel = mag;
+            }
+            if (rate > f.peak_gyro) {
+                f.peak_gyro = rate;
+                f.peak_gyro_vec = gyro;
             }
 
-            dv.x += dyn.x * dt;
-            dv.y += dyn.y * dt;
-            dv.z += dyn.z * dt;
-        }
+            const double dt = store_.t(i) - store_.t(i - 1);
+            if (dt > 0.0) {
+                // ∫ω – trapezy, żeby krótki FLICK nie gubił połowy energii
+                f.gyro_integral.x += 0.5 * (s.prev_gyro.x + gyro.x) * dt;
+                f.gyro_integral.y += 0.5 * (s.prev_gyro.y + gyro.y) * dt;
+                f.gyro_integral.z += 0.5 * (s.prev_gyro.z + gyro.z) * dt;
+                f.gyro_abs_integral += 0.5 * (s.prev_rate + rate) * dt;
+
+                if (mag >= cfg_.min_dyn_threshold) {
+                    f.delta_v.x += dyn.x * dt;
+                    f.delta_v.y += dyn.y * dt;
+                    f.delta_v.z += dyn.z * dt;
+                    const double speed = norm(f.delta_v);
+                    if (speed > s.peak_speed) {
+                        s.peak_speed = speed;
+                        f.peak_velocity = f.delta_v;
+                    }
+                }
+            }
 
-        const double absx = std::fabs(dv.x);
-        const double absy = std::fabs(dv.y);
-        const double absz = std::fabs(dv.z);
-
-        char axis;
-        double axis_val;
-        if (absx >= absy && absx >= absz) {
-            axis = 'X';
-            axis_val = dv.x;
-        } else if (absy >= absx && absy >= absz) {
-            axis = 'Y';
-            axis_val = dv.y;
-        } else {
-            axis = 'Z';
-            axis_val = dv.z;
+            // Sweep: obrót kierunku a_dyn między kolejnymi próbkami. Pomijamy
+            // przejścia przez zero (|a_dyn| pod progiem) i zmiany zwrotu (> 90°),
+            // które są typowe dla ruchu tam-i-z-powrotem, a nie dla okręgu.
+            if (mag >= cfg_.min_dyn_threshold && s.prev_dyn_mag >= cfg_.min_dyn_threshold) {
+                const Vec3 c = cross(s.prev_dyn, dyn);
+                const double cn = norm(c);
+                const double d = dot(s.prev_dyn, dyn);
+                if (d > 0.0 && cn > 0.0) {
+                    const double angle = std::atan2(cn, d);
+                    f.sweep.x += angle * c.x / cn;
+                    f.sweep.y += angle * c.y / cn;
+                    f.sweep.z += angle * c.z / cn;
+                }
+            }
+
+            s.prev_dyn = dyn;
+            s.prev_gyro = gyro;
+            s.prev_dyn_mag = mag;
+            s.prev_rate = rate;
         }
+    }
 
-        const char sign = (axis_val >= 0.0) ? '+' : '-';
+    // Δq liczymy z końców okna – to dwie próbki, nie suma
+    GestureFeatures scan_finish(const WindowScan& s, std::size_t start_idx, std::size_t end_idx) const
+    {
+        auto quat_at = [&](std::size_t i) {
+            return Quat{static_cast<double>(store_.at(SampleStore::QW, i)),
+                        static_cast<double>(store_.at(SampleStore::QX, i)),
+                        static_cast<double>(store_.at(SampleStore::QY, i)),
+                        static_cast<double>(store_.at(SampleStore::QZ, i))};
+        };
+        GestureFeatures f = s.f;
+        const Quat q0 = quat_at(start_idx);
+        const Quat q1 = quat_at(end_idx - 1);
+        f.quat_delta = quat_mul(q1, quat_conj(q0));
+        f.rotation_angle = quat_angle(f.quat_delta);
+        return f;
+    }
 
-        const double mag_axis = std::max(absx, std::max(absy, absz));
-        if (mag_axis < 0.5) {
-            return;
+    // Zwraca false, jeśli okno nie przypomina żadnego gestu.
+    // `velocity` – wektor, z którego bierzemy kierunek ruchu posuwistego.
+    bool classify(const GestureFeatures& f, const Vec3& velocity, GestureResult& res) const
+    {
+        double value = 0.0;
+
+        if (norm(f.sweep) >= cfg_.min_circle_sweep) {
+            res.kind  = GestureKind::Circle;
+            res.axis  = dominant_axis(f.sweep, res.sign, value);
+            res.label = (res.sign == '+') ? "CIRCLE_CCW" : "CIRCLE_CW";
+            return true;
         }
 
-        GestureResult res;
-        res.t_center       = t_peak;
-        res.duration       = duration;
-        res.delta_v_world  = dv;
-        res.baseline_world = a0_world_;
-        res.axis           = axis;
-        res.sign           = sign;
-        res.label          = axis_sign_to_label(axis, sign);
+        if (f.peak_gyro >= cfg_.min_gyro_peak) {
+            if (f.rotation_angle >= cfg_.min_twist_angle) {
+                // oś obrotu netto z ∫ω (ten sam układ co Δq, ale bez kłopotu ze znakiem w)
+                res.kind  = GestureKind::Twist;
+                res.axis  = dominant_axis(f.gyro_integral, res.sign, value);
+                res.label = (res.sign == '+') ? "TWIST_CCW" : "TWIST_CW";
+                return true;
+            }
+            if (f.rotation_angle <= cfg_.max_flick_net_angle &&
+                f.gyro_abs_integral >= cfg_.min_flick_travel) {
+                res.kind  = GestureKind::Flick;
+                res.axis  = dominant_axis(f.peak_gyro_vec, res.sign, value);
+                res.label = (res.sign == '+') ? "FLICK_CCW" : "FLICK_CW";
+                return true;
+            }
+        }
 
-        pending_result_    = res;
-        last_gesture_time_ = t_now;
-    }
+        // Ruch posuwisty wymaga piku przyspieszenia – sam pik gyro nie wystarczy
+        if (f.peak_accel < cfg_.min_peak_magnitude) {
+            return false;
+        }
 
-    static std::string axis_sign_to_label(char axis, char sign)
-    {
-        switch (axis) {
-        case 'X':
-            return (sign == '+') ? "UP" : "DOWN";
-        case 'Z':
-            return (sign == '+') ? "RIGHT" : "LEFT";
-        case 'Y':
-            return (sign == '+') ? "FORWARD" : "BACKWARD";
-        default:
-            return "UNKNOWN";
+        peak_window::Translation tr;
+        if (!peak_window::translation_from_delta_v(velocity.x, velocity.y, velocity.z,
+                                                   MIN_AXIS_VELOCITY, tr)) {
+            return false;
         }
+        res.kind  = GestureKind::Translation;
+        res.axis  = tr.axis_char();
+        res.sign  = tr.sign_char();
+        res.label = gesture_direction_label(tr.direction);
+        return true;
     }
 };
 
+// Domyślne progi PeakWindow muszą być te same co w BasicDirectionDetector
+static_assert(GestureDirectionDetector::Config{}.baseline_window_s ==
+              peak_window::DEFAULT_BASELINE_WINDOW_MS / 1000.0);
+static_assert(GestureDirectionDetector::Config{}.half_window_s ==
+              peak_window::DEFAULT_HALF_WINDOW_MS / 1000.0);
+static_assert(GestureDirectionDetector::Config{}.min_gesture_interval ==
+              peak_window::DEFAULT_MIN_INTERVAL_MS / 1000.0);
+static_assert(GestureDirectionDetector::Config{}.min_dyn_threshold ==
+              peak_window::DEFAULT_MIN_DYN_MILLI / 1000.0);
+static_assert(GestureDirectionDetector::Config{}.min_peak_magnitude ==
+              peak_window::DEFAULT_MIN_PEAK_MILLI / 1000.0);
+
 } // namespace bno
@@ -0,0 +1,339 @@
+#pragma once
+
+// Detektor kierunku gestu szablonowany typem liczbowym – wariant ścieżki
+// parser -> detektor dla mikrokontrolera obok czujnika.
+//
+// Z float liczy to samo co GestureDirectionDetector (Mode::PeakWindow,
+// gesty posuwiste); z Fixed<F> cała ścieżka od bajtów SH-2 do etykiety
+// zostaje w arytmetyce Q: raw Q8/Q14 -> Q16.16, obrót kwaternionem,
+// |a_dyn|² zamiast |a_dyn| (bez sqrt), Δv z czasem w µs (uint32).
+// Bez sterty, bez std::string/optional, bez wyjątków – tylko <cstdint>,
+// <cstddef> i <type_traits>, więc kompiluje się -ffreestanding na MCU bez FPU.
+//
+// Czego tu nie ma względem detektora hosta: gestów obrotowych (TWIST, FLICK,
+// CIRCLE – atan2 i normy ω), trybu Segmented, SIMD i bufora SampleStore.
+// Bufor to pierścień N próbek: przy domyślnym oknie (0.75 s) N = 128
+// wystarcza do ~170 Hz; 400 Hz potrzebuje N = 512.
+//
+// Kroki wspólne z GestureDirectionDetector (porównania czasu, bufor, okno
+// baseline, pik |a_dyn|, okno wokół piku, oś i kierunek z Δv, domyślne
+// progi) są w peak_window.hpp i oba detektory ich używają; tu zostaje
+// pierścień, |a_dyn|² w typie Num i całka Δv. Zgodność z hostem sprawdza
+// test ctest gesture_parity (imu_fixed_bench --check) na nagraniach z data/
+// i na symulatorze.
+//
+// Wybór typu przy kompilacji: -DBNO_GESTURE_FIXED=1 (np. w firmware MCU)
+// przestawia GestureNum, McuDirectionDetector i McuGestureFrontEnd na Q16.
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "bno/fixed_point.hpp"
+#include "bno/peak_window.hpp"
+#include "bno/sh2_decode.hpp"
+
+#ifndef BNO_GESTURE_FIXED
+#define BNO_GESTURE_FIXED 0
+#endif
+
+namespace bno {
+
+template <typename Num>
+struct BasicDirectionResult {
+    std::uint32_t t_center_us{0};   ///< czas piku |a_dyn|
+    std::uint32_t t_start_us{0};    ///< pierwsza próbka okna
+    std::uint32_t t_emit_us{0};     ///< próbka, przy której wynik powstał
+    GestureDirection direction{GestureDirection::Up};
+    char axis{'X'};
+    char sign{'+'};
+    Num delta_v[3]{};               ///< ∫ a_dyn dt w oknie (m/s), WORLD
+    Num peak_dyn2{};                ///< max |a_dyn|² w oknie
+};
+
+template <typename Num, std::size_t N = 128>
+class BasicDirectionDetector {
+    using Ops = NumOps<Num>;
+    using Time = std::uint32_t;
+    using TimeOps = peak_window::TimeOps<Time>;
+
+public:
+    using Result = BasicDirectionResult<Num>;
+
+    /// Te same wartości domyślne co GestureDirectionDetector::Config
+    /// (peak_window::DEFAULT_*); progi w tysięcznych, żeby Fixed<F> nie
+    /// potrzebował liczb zmiennoprzecinkowych.
+    struct Config {
+        std::uint32_t baseline_window_us = peak_window::DEFAULT_BASELINE_WINDOW_MS * 1000u;
+        std::uint32_t half_window_us     = peak_window::DEFAULT_HALF_WINDOW_MS * 1000u;
+        std::uint32_t min_interval_us    = peak_window::DEFAULT_MIN_INTERVAL_MS * 1000u;
+        Num min_dyn_threshold  = Ops::from_milli(peak_window::DEFAULT_MIN_DYN_MILLI);    // m/s²
+        Num min_peak_magnitude = Ops::from_milli(peak_window::DEFAULT_MIN_PEAK_MILLI);   // m/s²
+        Num min_axis_velocity  = Ops::from_milli(peak_window::MIN_AXIS_VELOCITY_MILLI);  // m/s
+    };
+
+    explicit BasicDirectionDetector(const Config& cfg)
+        : cfg_(cfg)
+        , min_dyn2_(cfg.min_dyn_threshold * cfg.min_dyn_threshold)
+        , min_peak2_(cfg.min_peak_magnitude * cfg.min_peak_magnitude)
+        , span_us_(peak_window::buffer_span(cfg.half_window_us))
+    {}
+
+    /// Próbka: a w układzie sensora (x, y, z), kwaternion GRV (w, x, y, z).
+    void add_sample(std::uint32_t t_us, const Num* accel, const Num* quat)
+    {
+        Entry e;
+        e.t = t_us;
+        rotate(quat, accel, e.a);
+        e.dyn2 = baseline_ ? dyn2(e.a) : Num{};
+        push(e);
+
+        while (size_ > 0 && TimeOps::longer(at(0).t, t_us, span_us_)) {
+            pop_front();
+        }
+
+        if (!baseline_) {
+            compute_baseline_if_ready();
+        }
+        if (baseline_) {
+            maybe_detect();
+        }
+    }
+
+    /// Wynik z ostatniej próbki (jeden naraz, jak poll_result() hosta).
+    bool poll_result(Result& out)
+    {
+        if (!pending_) {
+            return false;
+        }
+        out = result_;
+        pending_ = false;
+        return true;
+    }
+
+    bool has_baseline() const { return baseline_; }
+    const Num* baseline_world() const { return a0_; }
+
+private:
+    struct Entry {
+        std::uint32_t t{0};
+        Num a[3]{};     // WORLD
+        Num dyn2{};     // |a - a0|²
+    };
+
+    Config cfg_;
+    Num min_dyn2_;
+    Num min_peak2_;
+    std::uint32_t span_us_;
+
+    Entry ring_[N]{};
+    std::size_t head_{0};
+    std::size_t size_{0};
+    std::uint64_t popped_{0};   // numer próbki = popped_ + indeks
+
+    Num a0_[3]{};
+    bool baseline_{false};
+    std::uint32_t t_baseline_end_{0};
+    bool have_last_{false};
+    std::uint32_t last_gesture_t_{0};
+    peak_window::RunningPeak<Num> peak_;   // max |a_dyn|² od t_baseline_end_
+
+    bool pending_{false};
+    Result result_{};
+
+    const Entry& at(std::size_t i) const { return ring_[(head_ + i) % N]; }
+    Entry& at(std::size_t i) { return ring_[(head_ + i) % N]; }
+
+    auto time_at() const
+    {
+        return [this](std::size_t i) { return at(i).t; };
+    }
+
+    void push(const Entry& e)
+    {
+        if (size_ == N) {
+            pop_front();   // za mały bufor na częstość – okno się skraca
+        }
+        ring_[(head_ + size_) % N] = e;
+        ++size_;
+    }
+
+    void pop_front()
+    {
+        head_ = (head_ + 1) % N;
+        --size_;
+        ++popped_;
+    }
+
+    // v' = v + w·t + q_vec × t, t = 2·(q_vec × v) – jak rotate_vector_by_quat_f
+    static void rotate(const Num* q, const Num* v, Num* out)
+    {
+        const Num qw = q[0], qx = q[1], qy = q[2], qz = q[3];
+        Num tx = qy * v[2] - qz * v[1];
+        Num ty = qz * v[0] - qx * v[2];
+        Num tz = qx * v[1] - qy * v[0];
+        tx += tx;
+        ty += ty;
+        tz += tz;
+        out[0] = v[0] + qw * tx + (qy * tz - qz * ty);
+        out[1] = v[1] + qw * ty + (qz * tx - qx * tz);
+        out[2] = v[2] + qw * tz + (qx * ty - qy * tx);
+    }
+
+    Num dyn2(const Num* a) const
+    {
+        const Num dx = a[0] - a0_[0];
+        const Num dy = a[1] - a0_[1];
+        const Num dz = a[2] - a0_[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // Średnia próbek okna baseline, jak na hoście
+    void compute_baseline_if_ready()
+    {
+        const std::size_t count = peak_window::baseline_count(size_, time_at(), cfg_.baseline_window_us);
+        if (count < peak_window::BASELINE_MIN_SAMPLES) {
+            return;
+        }
+        Num sum[3]{};
+        for (std::size_t i = 0; i < count; ++i) {
+            for (int k = 0; k < 3; ++k) {
+                sum[k] += at(i).a[k];
+            }
+        }
+        for (int k = 0; k < 3; ++k) {
+            a0_[k] = Ops::div_int(sum[k], static_cast<std::int32_t>(count));
+        }
+        baseline_ = true;
+        t_baseline_end_ = at(0).t + cfg_.baseline_window_us;
+        for (std::size_t i = 0; i < size_; ++i) {
+            at(i).dyn2 = dyn2(at(i).a);
+        }
+    }
+
+    void maybe_detect()
+    {
+        if (size_ < 3) {
+            return;
+        }
+        const std::uint32_t t_now = at(size_ - 1).t;
+        if (have_last_ && TimeOps::shorter(last_gesture_t_, t_now, cfg_.min_interval_us)) {
+            peak_.invalidate();   // próbek w przerwie nie śledzimy
+            return;
+        }
+
+        // 1) pik |a_dyn|² po końcu okna baseline
+        peak_.track(size_, popped_, TimeOps::not_after(t_baseline_end_, t_now),
+                    [this] { return peak_window::first_at_or_after(size_, time_at(), t_baseline_end_); },
+                    [this](std::size_t i) { return at(i).dyn2; });
+        if (!peak_.have || peak_.value < min_peak2_) {
+            return;
+        }
+
+        // 2) okno ±half_window wokół piku
+        const std::uint32_t t_peak = at(peak_.index(popped_)).t;
+        std::size_t start = 0;
+        std::size_t end = 0;
+        if (!peak_window::window_around(size_, time_at(), t_peak, cfg_.half_window_us, start, end)) {
+            return;
+        }
+
+        // 3) Δv = Σ a_dyn·dt po próbkach nad progiem dynamiki
+        Num dv[3]{};
+        Num peak2 = at(start).dyn2;
+        for (std::size_t i = start + 1; i < end; ++i) {
+            const Entry& e = at(i);
+            if (e.dyn2 > peak2) {
+                peak2 = e.dyn2;
+            }
+            const std::uint32_t dt = e.t - at(i - 1).t;
+            if (static_cast<std::int32_t>(dt) > 0 && e.dyn2 >= min_dyn2_) {
+                for (int k = 0; k < 3; ++k) {
+                    dv[k] += Ops::mul_us(e.a[k] - a0_[k], dt);
+                }
+            }
+        }
+        if (peak2 < min_peak2_) {
+            return;
+        }
+
+        // 4) oś dominująca Δv
+        peak_window::Translation tr;
+        if (!peak_window::translation_from_delta_v(dv[0], dv[1], dv[2], cfg_.min_axis_velocity, tr)) {
+            return;
+        }
+
+        Result& r = result_;
+        r.t_center_us = t_peak;
+        r.t_start_us = at(start).t;
+        r.t_emit_us = t_now;
+        r.axis = tr.axis_char();
+        r.sign = tr.sign_char();
+        r.direction = tr.direction;
+        for (int k = 0; k < 3; ++k) {
+            r.delta_v[k] = dv[k];
+        }
+        r.peak_dyn2 = peak2;
+        pending_ = true;
+        have_last_ = true;
+        last_gesture_t_ = t_now;
+    }
+};
+
+/// Ramka SH-2 -> próbki -> BasicDirectionDetector, jak pętla imu_dir:
+/// kwaternion z ostatniego GRV, próbka na każdy raport akcelerometru.
+template <typename Num, std::size_t N = 128>
+class BasicGestureFrontEnd {
+public:
+    using Detector = BasicDirectionDetector<Num, N>;
+    using Result = typename Detector::Result;
+
+    explicit BasicGestureFrontEnd(const typename Detector::Config& cfg)
+        : detector_(cfg)
+    {}
+
+    /// Payload kanału 3/4 odczytany w chwili `t_read_us` (zegar MCU).
+    /// Każdy wynik idzie do on_result(const Result&). Zwraca liczbę próbek.
+    template <typename OnResult>
+    std::size_t feed(const std::uint8_t* payload, std::size_t len, std::uint32_t t_read_us,
+                     OnResult&& on_result)
+    {
+        Sh2Reading<Num> readings[MAX_READINGS];
+        const std::size_t n = decode_sh2_readings(payload, len, readings, MAX_READINGS);
+        std::size_t samples = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const Sh2Reading<Num>& r = readings[i];
+            if (r.id == 0x08) {
+                for (int k = 0; k < 4; ++k) {
+                    quat_[k] = r.v[k];
+                }
+                have_quat_ = true;
+            } else if ((r.id == 0x04 || r.id == 0x01) && have_quat_) {
+                detector_.add_sample(t_read_us + static_cast<std::uint32_t>(r.host_offset_us),
+                                     r.v, quat_);
+                ++samples;
+                Result res;
+                if (detector_.poll_result(res)) {
+                    on_result(res);
+                }
+            }
+        }
+        return samples;
+    }
+
+    Detector& detector() { return detector_; }
+
+private:
+    static constexpr std::size_t MAX_READINGS = 16;
+
+    Detector detector_;
+    Num quat_[4]{};
+    bool have_quat_{false};
+};
+
+/// Typ ścieżki MCU wybierany przy kompilacji (BNO_GESTURE_FIXED).
+using GestureNum = std::conditional_t<BNO_GESTURE_FIXED != 0, Q16, float>;
+using McuDirectionDetector = BasicDirectionDetector<GestureNum>;
+using McuGestureFrontEnd = BasicGestureFrontEnd<GestureNum>;
+
+} // namespace bno
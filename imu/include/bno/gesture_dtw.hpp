@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"   // Vec3, Quat, rotate_vector_by_quat
+#include "bno/imu_csv.hpp"
+
+namespace bno {
+
+/// Liczba wymiarów cechy na próbkę: a_dyn (x,y,z) + gyro (x,y,z), WORLD.
+constexpr std::size_t DTW_DIMS = 6;
+
+/// Wzorzec gestu użytkownika, przechowywany jako SoA:
+/// `series[d * stride + j]` = wymiar d, ramka j. `stride` jest wielokrotnością
+/// szerokości wektora SIMD, a ogon jest wyzerowany – kernel może czytać
+/// pełne wektory bez sprawdzania końca.
+struct DtwTemplate {
+    std::string label;
+    std::size_t length{0};
+    std::size_t stride{0};
+    std::vector<float> series;
+    std::vector<float> upper;   // obwiednia LB_Keogh (max w pasie Sakoe-Chiba)
+    std::vector<float> lower;   // obwiednia LB_Keogh (min w pasie Sakoe-Chiba)
+};
+
+struct DtwMatch {
+    double t_end;             // czas ostatniej próbki dopasowanego okna
+    double duration;          // długość okna (s)
+    std::string label;
+    float distance;           // DTW / długość wzorca
+    std::size_t template_index;
+};
+
+/// Statystyki ostatniej ewaluacji – do pilnowania budżetu czasu.
+struct DtwStats {
+    std::uint64_t evaluations{0};
+    std::uint64_t lb_pruned{0};     // wzorce odrzucone przez LB_Keogh
+    std::uint64_t abandoned{0};     // DTW przerwane wcześnie (wiersz > best)
+    std::uint64_t full_dtw{0};
+};
+
+/// Rozpoznawanie gestów użytkownika przez Dynamic Time Warping.
+///
+/// Strumień próbek jest sprowadzany do tych samych cech co wzorce
+/// (a_dyn i gyro w układzie świata), a co `eval_stride` próbek ostatnie
+/// `length` ramek jest porównywane z każdym wzorcem. Kolejność tanich
+/// testów: LB_Keogh na obwiedni wzorca, potem DTW w pasie Sakoe-Chiba
+/// z wczesnym przerwaniem. Koszt lokalny liczy kernel SIMD (AVX2/NEON)
+/// wzdłuż pasa, a sama rekurencja DP jest skalarna.
+///
+/// Po dodaniu wzorców add_sample() nie alokuje pamięci.
+class DtwRecognizer {
+public:
+    struct Config {
+        double baseline_window_s    = 0.2;  // estymacja grawitacji (jak w detektorze)
+        double band_ratio           = 0.15; // szerokość pasa jako ułamek długości wzorca
+        float  gyro_weight          = 0.5f; // waga gyro względem a_dyn
+        float  max_distance         = 1.0f; // próg DTW/długość dla dopasowania
+        double min_peak_magnitude   = 1.0;  // m/s^2 – okno musi zawierać aktywność
+        double min_gesture_interval = 0.8;  // s
+        std::size_t eval_stride     = 5;    // co ile próbek oceniamy wzorce
+        double template_pad_s       = 0.1;  // margines wokół aktywnej części nagrania
+        double template_dyn_threshold = 0.5;// m/s^2 – próg aktywności przy przycinaniu
+        std::size_t max_template_len = 256; // ramek
+    };
+
+    explicit DtwRecognizer(const Config& cfg);
+
+    /// Zbuduj wzorzec z nagrania imu_read (przycina ciszę na brzegach).
+    /// add_template_from_csv() przyjmuje też log binarny (.imlog).
+    bool add_template(const std::string& label,
+                      const std::vector<ImuCsvRow>& rows,
+                      std::string& err);
+
+    bool add_template_from_csv(const std::string& label,
+                               const std::string& path,
+                               std::string& err);
+
+    void add_sample(double t, const Vec3& accel_sensor, const Vec3& gyro_sensor, const Quat& quat);
+
+    std::optional<DtwMatch> poll_result();
+
+    std::size_t template_count() const { return templates_.size(); }
+    const DtwTemplate& template_at(std::size_t i) const { return templates_[i]; }
+    const DtwStats& stats() const { return stats_; }
+
+    /// Odległość DTW (niepodzielona przez długość) między oknem zapytania
+    /// w SoA (`query[d * query_stride + j]`, `len` ramek) a wzorcem.
+    /// Zwraca +inf, jeśli przekroczono `abandon_above`.
+    float distance(const float* query, std::size_t query_stride,
+                   const DtwTemplate& tmpl, float abandon_above);
+
+private:
+    Config cfg_;
+    std::vector<DtwTemplate> templates_;
+
+    // Lustrzany bufor cech zapytania: ramka zapisywana pod w i w + cap,
+    // więc ostatnie `n <= cap` ramek jest zawsze ciągłe w pamięci.
+    std::vector<float> ring_;   // DTW_DIMS * ring_stride_
+    std::vector<double> ring_t_;
+    std::size_t ring_cap_{0};
+    std::size_t ring_stride_{0};
+    std::size_t ring_pos_{0};
+    std::size_t ring_count_{0};
+
+    // Bazowa grawitacja
+    double baseline_sum_[3]{0.0, 0.0, 0.0};
+    std::size_t baseline_n_{0};
+    double t_first_{-1.0};
+    bool baseline_ready_{false};
+    Vec3 a0_world_{};
+
+    double last_active_t_{-1e9};
+    double last_match_t_{-1e9};
+    std::size_t since_eval_{0};
+
+    // Bufory DP (alokowane przy dodawaniu wzorców)
+    std::vector<float> dp_prev_;
+    std::vector<float> dp_curr_;
+    std::vector<float> cost_row_;
+
+    DtwStats stats_{};
+    std::optional<DtwMatch> pending_;
+
+    void resize_ring(std::size_t cap);
+    void evaluate(double t_now);
+};
+
+/// Kernele SIMD (src/gesture_dtw.cpp); publiczne dla benchmarków.
+namespace dtw_kernels {
+
+/// out[k] = Σ_d (q[d] - c[d * stride + k])^2 dla k = 0..count-1.
+/// Czyta pełne wektory SIMD – `c` musi mieć zaokrąglony, wyzerowany ogon.
+void band_cost(const float* q, const float* c, std::size_t stride,
+               std::size_t count, float* out);
+
+/// LB_Keogh: Σ_d Σ_j odległość q[d][j] od obwiedni [lower, upper].
+float lb_keogh(const float* q, std::size_t q_stride,
+               const float* upper, const float* lower, std::size_t stride,
+               std::size_t len);
+
+/// Nazwa wybranego wariantu kernela ("avx2", "neon", "scalar").
+const char* active_isa();
+
+} // namespace dtw_kernels
+
+} // namespace bno
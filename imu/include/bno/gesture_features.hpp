@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"   // Vec3, Quat
+
+namespace bno {
+
+/// Cechy okna gestu dla klasyfikatora uczonego (GestureClassifier).
+/// Kolejność jest częścią formatu modelu – nowe cechy tylko na końcu
+/// i z nowym FEATURE_COUNT (model zapisuje liczbę cech i sprawdza ją przy load).
+enum GestureFeature : std::size_t {
+    F_MEAN_AX, F_MEAN_AY, F_MEAN_AZ,        // średnie a_dyn (świat, m/s²)
+    F_STD_AX, F_STD_AY, F_STD_AZ,
+    F_MEAN_GX, F_MEAN_GY, F_MEAN_GZ,        // średnie ω (świat, rad/s)
+    F_STD_GX, F_STD_GY, F_STD_GZ,
+    F_ACCEL_ENERGY,                         // średnie |a_dyn|²
+    F_GYRO_ENERGY,                          // średnie |ω|²
+    F_DV_X, F_DV_Y, F_DV_Z,                 // ∫ a_dyn dt (m/s)
+    F_PEAK_ACCEL,                           // max |a_dyn|
+    F_PEAK_GYRO,                            // max |ω|
+    F_T_PEAK_ACCEL,                         // chwila max |a_dyn|, 0..1 w oknie
+    F_T_PEAK_GYRO,
+    F_T_MAX_AX, F_T_MAX_AY, F_T_MAX_AZ,     // chwile max / min każdej osi a_dyn:
+    F_T_MIN_AX, F_T_MIN_AY, F_T_MIN_AZ,     // kolejność rozpędzanie/hamowanie
+    F_ROT_X, F_ROT_Y, F_ROT_Z,              // wektor obrotu q_end ⊗ q_start⁻¹ (rad)
+    F_DURATION,                             // s
+    FEATURE_COUNT
+};
+
+using GestureFeatureVector = std::array<float, FEATURE_COUNT>;
+
+/// Nazwy cech (nagłówek CSV z imu_train --features).
+const char* gesture_feature_name(std::size_t i);
+
+/// Bufor ostatnich próbek w układzie świata i liczenie cech dla dowolnego
+/// okna [t_from, t_to] – np. okna, które wyznaczył GestureDirectionDetector.
+/// Próbki podaje się tak samo jak do detektora; a_dyn liczy się względem
+/// przekazanej grawitacji (GestureDirectionDetector::baseline_world()).
+class WindowFeatureExtractor {
+public:
+    explicit WindowFeatureExtractor(std::size_t capacity = 2048);
+
+    void clear();
+    void add_sample(double t, const Vec3& accel_sensor, const Vec3& gyro_sensor, const Quat& quat);
+
+    /// false, gdy w oknie są mniej niż 3 próbki (albo wypadło z bufora).
+    bool extract(double t_from, double t_to, const Vec3& gravity_world,
+                 GestureFeatureVector& out) const;
+
+    std::size_t size() const { return size_; }
+
+private:
+    struct Sample {
+        double t;
+        Vec3 a;   // świat, z grawitacją
+        Vec3 g;   // świat
+        Quat q;
+    };
+
+    std::vector<Sample> ring_;
+    std::size_t head_{0};   // najstarsza
+    std::size_t size_{0};
+
+    const Sample& at(std::size_t i) const { return ring_[(head_ + i) % ring_.size()]; }
+    std::size_t first_at_or_after(double t) const;
+};
+
+} // namespace bno
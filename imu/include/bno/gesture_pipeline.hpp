@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bno/gesture_classifier.hpp"
+#include "bno/gesture_cnn.hpp"
+#include "bno/gesture_dir.hpp"
+#include "bno/gesture_dtw.hpp"
+#include "bno/gesture_features.hpp"
+#include "bno/gesture_seq.hpp"
+#include "bno/motion_tracker.hpp"
+#include "bno/row_format.hpp"
+
+namespace bno {
+
+/// Detektor kierunku + wzorce DTW + sekwencje gestów, karmione jedną
+/// próbką na raport akcelerometru. Wspólne dla imu_dir i imu_daemon;
+/// wyniki wychodzą jako gotowe linie tekstu w formacie imu_dir.
+class GesturePipeline {
+public:
+    struct Config {
+        bool segmented = false;
+        double min_interval_s = 0.5;
+        double combo_gap_s = 0.8;
+        std::vector<std::pair<std::string, std::string>> templates; // (label, path)
+        std::vector<ComboPattern> combos;
+        bool track = false;   // MotionTracker: tor ruchu (path=, shape=) w liniach gestów
+        std::string model_path;   // GestureClassifier (imu_train): ml=, conf= w liniach gestów
+        std::string cnn_model;    // StreamingGestureCnn (.onnx, cnn_train.py): linie cnn=
+        bool cnn_int8 = false;
+    };
+
+    struct Counters {
+        std::uint64_t samples{0};
+        std::uint64_t gestures{0};
+        std::uint64_t dtw_matches{0};
+        std::uint64_t combo_matches{0};
+        std::uint64_t cnn_matches{0};
+        double dtw_max_us{0.0};   // od ostatniego wyzerowania przez wołającego
+        double ml_max_us{0.0};    // cechy okna + predict, jak wyżej
+        double cnn_max_us{0.0};   // próbka + ewentualny forward() sieci, jak wyżej
+    };
+
+    explicit GesturePipeline(const Config& cfg)
+        : cfg_(cfg)
+        , detector_(detector_config(cfg))
+        , dtw_(DtwRecognizer::Config{})
+        , combos_(combo_config(cfg))
+        , window_(cfg.model_path.empty() ? 0 : 2048)   // bufor tylko z modelem
+        , out_(1024)
+    {}
+
+    /// Wczytaj wzorce DTW i skompiluj sekwencje.
+    bool load(std::string& err)
+    {
+        for (const auto& [label, path] : cfg_.templates) {
+            std::string terr;
+            if (!dtw_.add_template_from_csv(label, path, terr)) {
+                err = "Failed to load template " + label + ": " + terr;
+                return false;
+            }
+        }
+        for (const auto& pattern : cfg_.combos) {
+            if (!combos_.add_pattern(pattern, err)) {
+                return false;
+            }
+        }
+        if (has_combos() && !combos_.compile(err)) {
+            err = "combo compile failed: " + err;
+            return false;
+        }
+        if (!cfg_.model_path.empty() && !classifier_.load(cfg_.model_path, err)) {
+            err = "Failed to load model: " + err;
+            return false;
+        }
+        if (!cfg_.cnn_model.empty()) {
+            StreamingGestureCnn::Config cnn;
+            cnn.model_path = cfg_.cnn_model;
+            cnn.int8 = cfg_.cnn_int8;
+            if (!cnn_.load(cnn, err)) {
+                err = "Failed to load CNN: " + err;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// `emit(std::string_view line)` – linia z '\n', ważna tylko w wywołaniu.
+    template <typename Emit>
+    void add_sample(double t, const Vec3& accel, const Vec3& gyro, const Quat& quat, Emit&& emit)
+    {
+        detector_.add_sample(t, accel, gyro, quat);
+        if (cfg_.track) {
+            tracker_.add_sample(t, accel, gyro, quat);
+        }
+        if (classifier_.loaded()) {
+            window_.add_sample(t, accel, gyro, quat);
+        }
+        ++counters_.samples;
+
+        if (auto res_opt = detector_.poll_result()) {
+            ++counters_.gestures;
+            const auto& res = *res_opt;
+
+            out_.clear();
+            out_.put_kv("t=", res.t_center, 3);
+            out_.put_kv(" dir=", res.label);
+            out_.put(" axis=");
+            out_.put(res.axis);
+            out_.put(res.sign);
+            out_.put_kv(" dv=(", res.delta_v_world.x, 3);
+            out_.put_kv(",", res.delta_v_world.y, 3);
+            out_.put_kv(",", res.delta_v_world.z, 3);
+            out_.put(')');
+            out_.put_kv(" dur=", res.duration, 3);
+            out_.put_kv(" rot=", res.features.rotation_angle, 3);
+            out_.put_kv(" wpk=", res.features.peak_gyro, 3);
+            if (cfg_.track) {
+                // detektor emituje po końcu okna, więc tor całego okna jest już w historii
+                const PathFeatures pf = tracker_.path_features(res.t_start, res.t_start + res.duration);
+                out_.put_kv(" path=(", pf.displacement.x, 3);
+                out_.put_kv(",", pf.displacement.y, 3);
+                out_.put_kv(",", pf.displacement.z, 3);
+                out_.put(')');
+                out_.put_kv(" len=", pf.length, 3);
+                out_.put_kv(" straight=", pf.straightness, 2);
+                out_.put_kv(" round=", pf.roundness, 2);
+                out_.put_kv(" shape=", path_shape_name(classify_path(pf)));
+            }
+            if (classifier_.loaded()) {
+                put_learned_label(res);
+            }
+            if (cfg_.segmented) {
+                out_.put(" id=");
+                out_.put_uint(res.gesture_id);
+                out_.put_kv(" stage=", res.provisional ? "provisional" : "final");
+            }
+            out_.put('\n');
+            last_event_t_ = res.t_center;
+            emit(out_.view());
+
+            // wynik wstępny może się jeszcze zmienić – sekwencje tylko z końcowych
+            if (has_combos() && !res.provisional) {
+                emit_combos(combos_.feed(res.label, res.t_center), emit);
+            }
+        }
+
+        if (cnn_.loaded()) {
+            add_cnn_sample(t, accel, gyro, quat, emit);
+        }
+
+        if (dtw_.template_count() > 0) {
+            const auto dtw_t0 = std::chrono::steady_clock::now();
+            dtw_.add_sample(t, accel, gyro, quat);
+            const double us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - dtw_t0).count();
+            counters_.dtw_max_us = std::max(counters_.dtw_max_us, us);
+
+            if (auto m = dtw_.poll_result()) {
+                ++counters_.dtw_matches;
+                out_.clear();
+                out_.put_kv("t=", m->t_end, 3);
+                out_.put_kv(" tmpl=", m->label);
+                out_.put_kv(" dist=", static_cast<double>(m->distance), 3);
+                out_.put_kv(" dur=", m->duration, 3);
+                out_.put('\n');
+                last_event_t_ = m->t_end;
+                emit(out_.view());
+
+                if (has_combos()) {
+                    emit_combos(combos_.feed(m->label, m->t_end), emit);
+                }
+            }
+        }
+    }
+
+    bool has_combos() const { return !cfg_.combos.empty(); }
+    const GestureDirectionDetector& detector() const { return detector_; }
+    /// Progi detektora kierunku w locie (LiveConfig z --control).
+    void set_detector_config(const GestureDirectionDetector::Config& det) { detector_.set_config(det); }
+    const DtwRecognizer& dtw() const { return dtw_; }
+    const GestureSequenceMatcher& combos() const { return combos_; }
+    const MotionTracker& tracker() const { return tracker_; }
+    const GestureClassifier& classifier() const { return classifier_; }
+    StreamingGestureCnn& cnn() { return cnn_; }
+    Counters& counters() { return counters_; }
+    /// Czas zdarzenia (t z linii) dla linii właśnie przekazanej do `emit`.
+    double last_event_t() const { return last_event_t_; }
+
+    // Progi trochę poluzowane względem domyślnych – jak dotąd w imu_dir.
+    // Publiczne, bo imu_train wycina okna uczące tym samym detektorem.
+    static GestureDirectionDetector::Config detector_config(const Config& cfg)
+    {
+        GestureDirectionDetector::Config det;
+        det.baseline_window_s    = 0.2;
+        det.half_window_s        = 0.3;
+        det.min_dyn_threshold    = 0.3; // było 0.5
+        det.min_peak_magnitude   = 1.0; // było 1.5
+        det.min_gesture_interval = cfg.min_interval_s; // było 0.8
+        if (cfg.segmented) {
+            det.mode = GestureDirectionDetector::Mode::Segmented;
+        }
+        return det;
+    }
+
+private:
+    Config cfg_;
+    GestureDirectionDetector detector_;
+    DtwRecognizer dtw_;
+    GestureSequenceMatcher combos_;
+    MotionTracker tracker_;
+    WindowFeatureExtractor window_;
+    GestureClassifier classifier_;
+    StreamingGestureCnn cnn_;
+    GestureFeatureVector features_{};
+    RowFormatter out_;
+    Counters counters_;
+    double last_event_t_{0.0};
+
+    // Okno wyniku detektora → cechy → las losowy; etykieta obok reguł
+    void put_learned_label(const GestureResult& res)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        GestureClassifier::Prediction pred;
+        const bool ok = window_.extract(res.t_start, res.t_start + res.duration,
+                                        detector_.baseline_world(), features_) &&
+                        classifier_.predict(features_, pred);
+        const double us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - t0).count();
+        counters_.ml_max_us = std::max(counters_.ml_max_us, us);
+        if (ok) {
+            out_.put_kv(" ml=", classifier_.label(pred.label_index));
+            out_.put_kv(" conf=", static_cast<double>(pred.confidence), 2);
+        }
+    }
+
+    // Sieć liczy się co 1/eval_hz na własnym oknie, niezależnie od detektora
+    template <typename Emit>
+    void add_cnn_sample(double t, const Vec3& accel, const Vec3& gyro, const Quat& quat, Emit& emit)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        StreamingGestureCnn::Result r;
+        const bool hit = cnn_.add_sample(t, accel, gyro, quat, detector_.baseline_world(), r);
+        const double us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - t0).count();
+        counters_.cnn_max_us = std::max(counters_.cnn_max_us, us);
+        if (!hit) {
+            return;
+        }
+        ++counters_.cnn_matches;
+        out_.clear();
+        out_.put_kv("t=", r.t, 3);
+        out_.put_kv(" cnn=", cnn_.label(r.label_index));
+        out_.put_kv(" p=", static_cast<double>(r.confidence), 2);
+        out_.put('\n');
+        last_event_t_ = r.t;
+        emit(out_.view());
+
+        if (has_combos()) {
+            emit_combos(combos_.feed(cnn_.label(r.label_index), r.t), emit);
+        }
+    }
+
+    static GestureSequenceMatcher::Config combo_config(const Config& cfg)
+    {
+        GestureSequenceMatcher::Config seq;
+        seq.max_gap_s = cfg.combo_gap_s;
+        return seq;
+    }
+
+    template <typename Emit>
+    void emit_combos(std::size_t n, Emit& emit)
+    {
+        counters_.combo_matches += n;
+        for (std::size_t k = 0; k < n; ++k) {
+            const auto& m = combos_.match(k);
+            out_.clear();
+            out_.put_kv("t=", m.t_end, 3);
+            out_.put_kv(" combo=", combos_.pattern_at(m.pattern_index).name);
+            out_.put_kv(" dur=", m.t_end - m.t_start, 3);
+            out_.put('\n');
+            last_event_t_ = m.t_end;
+            emit(out_.view());
+        }
+    }
+};
+
+} // namespace bno
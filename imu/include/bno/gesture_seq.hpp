@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bno {
+
+/// Wzorzec sekwencji gestów, np. "SWIPE_LR" = LEFT, RIGHT.
+struct ComboPattern {
+    std::string name;
+    std::vector<std::string> steps;   // etykiety GestureResult / DtwMatch
+    double max_gap_s{0.0};            // maks. przerwa między krokami (0 = z Config)
+};
+
+struct ComboMatch {
+    std::size_t pattern_index;
+    double t_start;   // czas pierwszego kroku
+    double t_end;     // czas ostatniego kroku
+};
+
+/// Rozpoznawanie sekwencji gestów (kombinacji) w strumieniu etykiet.
+///
+/// Wszystkie wzorce są kompilowane do jednego automatu Aho-Corasick nad
+/// alfabetem etykiet: gęsta tablica przejść [stan][symbol] z wbudowanymi
+/// przejściami awaryjnymi, więc feed() to jedno przejście w tablicy plus
+/// sprawdzenie wyjść danego stanu – koszt nie zależy od liczby wzorców.
+///
+/// Czas: jeśli od poprzedniego zdarzenia minęło więcej niż timeout stanu
+/// (największy max_gap_s wzorców przechodzących przez ten stan), automat
+/// wraca do korzenia. Przy dopasowaniu każdy wzorzec sprawdza jeszcze
+/// swoje własne przerwy na historii czasów (długość <= najdłuższy wzorzec).
+///
+/// Po compile() feed() nie alokuje pamięci.
+class GestureSequenceMatcher {
+public:
+    struct Config {
+        double max_gap_s      = 0.8;   // domyślna maks. przerwa między krokami
+        bool   reset_on_match = true;  // po dopasowaniu zaczynamy od zera
+                                       // (3x FLICK != dwa podwójne FLICK)
+    };
+
+    explicit GestureSequenceMatcher(const Config& cfg);
+
+    /// Dodaj wzorzec (przed compile()). false przy pustej nazwie lub krokach.
+    bool add_pattern(const ComboPattern& pattern, std::string& err);
+
+    /// Zbuduj automat. Po compile() można dodać kolejne wzorce i
+    /// skompilować ponownie (stan dopasowania jest zerowany).
+    bool compile(std::string& err);
+
+    /// Symbol etykiety (0 = etykieta spoza wszystkich wzorców).
+    /// Wynik można zapamiętać i wołać feed_symbol() bez haszowania.
+    std::uint16_t symbol_of(const std::string& label) const;
+
+    /// Kolejne zdarzenie. Zwraca liczbę dopasowań; są dostępne przez
+    /// match(i) do następnego wywołania feed().
+    std::size_t feed(const std::string& label, double t)
+    {
+        return feed_symbol(symbol_of(label), t);
+    }
+
+    std::size_t feed_symbol(std::uint16_t symbol, double t);
+
+    const ComboMatch& match(std::size_t i) const { return matches_[i]; }
+    const ComboPattern& pattern_at(std::size_t i) const { return patterns_[i]; }
+    std::size_t pattern_count() const { return patterns_.size(); }
+    std::size_t state_count() const { return state_count_; }
+
+    void reset();
+
+private:
+    Config cfg_;
+    std::vector<ComboPattern> patterns_;
+
+    std::unordered_map<std::string, std::uint16_t> symbols_;
+    std::size_t alphabet_{1};          // z symbolem 0 ("inne")
+    std::size_t state_count_{0};
+    std::vector<std::uint32_t> next_;  // state_count_ * alphabet_
+    std::vector<double> timeout_;      // per stan
+    std::vector<std::uint32_t> out_begin_;   // per stan + 1, indeksy do out_
+    std::vector<std::uint32_t> out_;         // indeksy wzorców
+    std::size_t max_len_{0};
+
+    // Stan dopasowania
+    std::uint32_t state_{0};
+    double last_t_{0.0};
+    std::vector<double> history_t_;    // pierścień czasów ostatnich zdarzeń
+    std::size_t history_pos_{0};
+    std::size_t history_count_{0};
+    std::vector<ComboMatch> matches_;  // pojemność = maks. wyjść stanu
+
+    bool pattern_gaps_ok(const ComboPattern& p) const;
+};
+
+/// "NAME=A,B,C" -> ComboPattern (max_gap_s = 0). false przy złym formacie.
+bool parse_combo_spec(const std::string& spec, ComboPattern& out, std::string& err);
+
+} // namespace bno
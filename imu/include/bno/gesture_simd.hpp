@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+namespace bno {
+
+/// Obrót jednego wektora (float) przez kwaternion jednostkowy (q * v * q^{-1}).
+/// Ta sama formuła co rotate_vector_by_quat, używana też jako ogon kerneli SIMD.
+inline void rotate_vector_by_quat_f(float qw, float qx, float qy, float qz,
+                                    float vx, float vy, float vz,
+                                    float& ox, float& oy, float& oz)
+{
+    // t = 2 * (q_vec x v)
+    const float tx = 2.0f * (qy * vz - qz * vy);
+    const float ty = 2.0f * (qz * vx - qx * vz);
+    const float tz = 2.0f * (qx * vy - qy * vx);
+
+    // v' = v + w * t + (q_vec x t)
+    ox = vx + qw * tx + (qy * tz - qz * ty);
+    oy = vy + qw * ty + (qz * tx - qx * tz);
+    oz = vz + qw * tz + (qx * ty - qy * tx);
+}
+
+/// Obrót n wektorów przez n kwaternionów, wszystko w SoA (float).
+/// Wyjście może wskazywać na wejście (obrót w miejscu).
+/// SSE na x86, NEON na ARM, skalarny ogon.
+void rotate_vectors_by_quats(const float* qw, const float* qx,
+                             const float* qy, const float* qz,
+                             const float* vx, const float* vy, const float* vz,
+                             float* ox, float* oy, float* oz,
+                             std::size_t n);
+
+/// out[i] = |(x[i], y[i], z[i]) - (bx, by, bz)|
+void vector_norms(const float* x, const float* y, const float* z,
+                  float bx, float by, float bz,
+                  float* out, std::size_t n);
+
+} // namespace bno
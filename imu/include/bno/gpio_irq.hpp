@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "bno/shtp.hpp"
+
+namespace bno {
+
+/// Linia H_INTN z BNO085 (aktywna niska: czujnik ma ramkę do odczytu)
+/// przez znakowe GPIO Linuksa (linux/gpio.h, uAPI v2).
+///
+/// Bez niej ShtpI2cTransport może tylko pytać szynę – poll() na i2c-dev
+/// wraca od razu, więc każde "czy jest ramka?" to transakcja I2C. Z linią
+/// wątek śpi w poll() na deskryptorze zdarzeń, aż czujnik ją ściągnie –
+/// tak imu_dir czeka w trybie idle na raport budzący.
+class GpioInterrupt {
+public:
+    GpioInterrupt() = default;
+    ~GpioInterrupt();
+
+    GpioInterrupt(const GpioInterrupt&) = delete;
+    GpioInterrupt& operator=(const GpioInterrupt&) = delete;
+
+    /// `spec`: "<chip>:<line>" albo sam numer linii na /dev/gpiochip0,
+    /// np. "gpiochip0:17", "/dev/gpiochip4:17", "17".
+    bool open(const std::string& spec, std::string& err);
+    void close() noexcept;
+    bool is_open() const noexcept { return fd_ >= 0; }
+
+    /// Czekaj, aż linia będzie aktywna – od razu, jeśli już jest.
+    /// true = aktywna; false bez błędu = timeout albo sygnał (EINTR);
+    /// false z ustawionym `err` = błąd.
+    bool wait_active(int timeout_ms, ShtpError& err);
+
+    /// Zbocza zgłoszone przez jądro (statystyka).
+    std::uint64_t edges() const { return edges_; }
+
+private:
+    int fd_{-1};
+    std::uint64_t edges_{0};
+
+    bool line_active(bool& active, ShtpError& err) const;
+    void drain_events();
+};
+
+} // namespace bno
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "bno/gesture_dir.hpp"   // Vec3, Quat
+#include "bno/sh2_reports.hpp"
+
+namespace bno {
+
+/// Tryb idle imu_dir (--idle-after): kiedy zatrzymać strumień z czujnika,
+/// co go budzi i jak po wybudzeniu nie zgubić początku gestu.
+///
+///   aktywny ── cisza przez idle_after_s ──▶ idle ── tap / significant motion ──▶ aktywny
+///
+/// Ciszę liczymy na hoście: |a − średnia krocząca| < accel_threshold
+/// i |ω| < gyro_threshold, bez wyników z pipeline'u (note_activity()).
+/// W idle czujnik liczy raporty budzące, a strumień idzie dalej z małą
+/// częstością i dużym batch interval: raporty czekają w FIFO czujnika, host
+/// śpi na linii H_INTN albo rzadko pyta szynę. Te próbki trafiają tylko do
+/// pierścienia gate'u (add_idle_sample()), nie do pipeline'u.
+///
+/// Przełączenie z powrotem na pełną częstość (Set Feature, rozgrzewka
+/// czujnika) trwa, a gest już trwa. Po wybudzeniu host opróżnia FIFO, więc
+/// ma prawdziwe próbki sprzed i z chwili wybudzenia; replay_preroll() oddaje
+/// pierścień przy pierwszej nowej próbce z ich własnym czasem. Gdy próbek
+/// z idle nie było (czujnik bez batchowania), oddaje ostatnie preroll_s
+/// spokojnych próbek sprzed uśpienia z czasem przesuniętym tak, że kończą się
+/// tuż przed nową próbką – wtedy ruch z czasu wybudzania przepada.
+class IdleGate {
+public:
+    enum class Wake : std::uint8_t {
+        Tap,
+        SignificantMotion,
+        Any,
+    };
+
+    struct Config {
+        double idle_after_s = 10.0;
+        double accel_threshold = 0.4;   // m/s² – odchylenie od średniej kroczącej
+        double gyro_threshold = 0.3;    // rad/s
+        double mean_tau_s = 1.0;        // stała czasowa średniej a
+        double preroll_s = 1.0;         // ≥ okno sieci (StreamingGestureCnn::Config::window_s)
+        Wake wake = Wake::Any;
+    };
+
+    struct Sample {
+        double t{0.0};
+        Vec3 accel{};
+        Vec3 gyro{};
+        Quat quat{};
+    };
+
+    struct Stats {
+        std::uint64_t idle_entries{0};
+        std::uint64_t wakes{0};
+        std::uint64_t preroll_samples{0};
+        std::uint64_t idle_samples{0};  // próbki strumienia odebrane w idle
+        double idle_s{0.0};             // łączny czas w idle
+        double last_wake_ms{0.0};       // zdarzenie budzące → pierwsza próbka po nim
+                                        // (z FIFO: może być ≤ 0 – bez dziury)
+        double max_wake_ms{0.0};
+    };
+
+    explicit IdleGate(const Config& cfg) : cfg_(cfg) {}
+
+    const Config& config() const { return cfg_; }
+    bool idle() const { return idle_; }
+
+    /// Próbka strumienia (tryb aktywny). true = od idle_after_s cisza – pora na idle.
+    bool add_sample(const Sample& s);
+    /// Aktywność spoza progów (np. linia wyniku) – licznik ciszy od nowa.
+    void note_activity(double t);
+
+    void enter_idle(double t);
+    /// Próbka strumienia w idle (mała częstość, z FIFO) – tylko do pre-roll.
+    void add_idle_sample(const Sample& s);
+    /// Czy zdarzenie SH-2 budzi w trybie Config::wake.
+    bool is_wake_event(const Sh2SensorEvent& evt) const;
+    /// `t` – czas zdarzenia budzącego (ta sama skala co próbki).
+    void wake(double t);
+
+    /// Po wake(): pre-roll czeka na pierwszą próbkę strumienia.
+    bool preroll_pending() const { return preroll_pending_; }
+
+    /// Próbki pre-roll do `feed(const Sample&)`, wszystkie przed `t_first`
+    /// (czas pierwszej próbki po wybudzeniu).
+    template <typename Feed>
+    void replay_preroll(double t_first, Feed&& feed)
+    {
+        preroll_pending_ = false;
+        stats_.last_wake_ms = (t_first - t_wake_) * 1e3;
+        stats_.max_wake_ms = std::max(stats_.max_wake_ms, stats_.last_wake_ms);
+        if (idle_stream_) {
+            // prawdziwe próbki z idle – czas bez zmian; te sprzed uśpienia
+            // pipeline już widział
+            for (const Sample& s : ring_) {
+                if (s.t >= t_first) {
+                    break;
+                }
+                if (s.t <= t_idle_) {
+                    continue;
+                }
+                feed(s);
+                ++stats_.preroll_samples;
+            }
+        } else if (ring_.size() >= 2) {
+            const double dt = (ring_.back().t - ring_.front().t) /
+                              static_cast<double>(ring_.size() - 1);
+            const double shift = t_first - dt - ring_.back().t;
+            for (Sample s : ring_) {
+                s.t += shift;
+                feed(s);
+            }
+            stats_.preroll_samples += ring_.size();
+        }
+        // pierścień zbiera dalej od nowej próbki; stare czasy nie pasują
+        ring_.clear();
+        have_mean_ = false;
+        quiet_since_ = t_first;
+    }
+
+    const Stats& stats() const { return stats_; }
+
+    static bool parse_wake(const std::string& name, Wake& out);
+    static const char* wake_name(Wake w);
+
+private:
+    Config cfg_;
+    bool idle_{false};
+    bool preroll_pending_{false};
+    bool idle_stream_{false};   // w ostatnim idle przyszły próbki (add_idle_sample)
+    double t_idle_{0.0};
+    double t_wake_{0.0};
+    double quiet_since_{0.0};
+    bool have_mean_{false};
+    double last_t_{0.0};
+    Vec3 mean_{};
+    std::deque<Sample> ring_;   // ostatnie preroll_s próbek
+    Stats stats_{};
+
+    void push_ring(const Sample& s);
+};
+
+} // namespace bno
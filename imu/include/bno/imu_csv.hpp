@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace bno {
+
+/// Jeden wiersz CSV z imu_read: t,ax,ay,az,gx,gy,gz,qw,qi,qj,qk
+struct ImuCsvRow {
+    double t{0.0};
+    double ax{0.0}, ay{0.0}, az{0.0};
+    double gx{0.0}, gy{0.0}, gz{0.0};
+    double qw{1.0}, qi{0.0}, qj{0.0}, qk{0.0};
+};
+
+/// Nagłówek pliku CSV zgodny z imu_read.
+constexpr const char* IMU_CSV_HEADER = "t,ax,ay,az,gx,gy,gz,qw,qi,qj,qk";
+
+/// Wczytaj plik CSV z imu_read do `out` (nadpisuje zawartość).
+/// Nagłówek jest opcjonalny; puste linie są pomijane.
+/// Przy błędzie zwraca false i wpisuje opis do `err`.
+bool read_imu_csv(const std::string& path,
+                  std::vector<ImuCsvRow>& out,
+                  std::string& err);
+
+/// Sparsuj jedną linię CSV (bez '\n'). Zwraca false przy złej liczbie kolumn.
+bool parse_imu_csv_line(const char* begin, const char* end, ImuCsvRow& row);
+
+/// Etykieta nagrania z nazwy pliku: litery (i '_') z początku, wielkimi –
+/// left3.csv → LEFT. Pusta, jeśli nazwa nie zaczyna się od litery.
+std::string recording_label(const std::string& path);
+
+} // namespace bno
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bno/async_writer.hpp"
+#include "bno/imu_csv.hpp"
+
+namespace bno {
+
+// Binarny, kolumnowy log próbek (.imlog).
+//
+// Układ pliku (little-endian, wszystko wyrównane do 8 bajtów):
+//
+//   ImuLogFileHeader | ImuLogColumnDesc x column_count
+//   { ImuLogBlockHeader | kolumna 0 | kolumna 1 | ... }  x N
+//   ImuLogIndexEntry x N | ImuLogFooter                  (tylko po close())
+//
+// Bloki są dopisywane w całości (jeden write), każdy z własnym CRC32.
+// Indeks na końcu powstaje dopiero przy zamknięciu – jeśli proces padnie,
+// czytnik przechodzi bloki od początku i zatrzymuje się na pierwszym
+// uciętym/uszkodzonym. Tracimy najwyżej niezapisany, bieżący blok.
+//
+// Kolumna w bloku to `rows` wartości jednego typu, dopełniona do 8 bajtów,
+// więc po mmap można ją czytać wprost jako const float* / const double*.
+
+constexpr char IMU_LOG_MAGIC[8]        = {'B', 'N', 'O', 'I', 'M', 'U', '\0', '\1'};
+constexpr char IMU_LOG_FOOTER_MAGIC[8] = {'B', 'N', 'O', 'I', 'D', 'X', '\0', '\1'};
+constexpr std::uint32_t IMU_LOG_BLOCK_MAGIC = 0x314B4C42u;  // "BLK1"
+constexpr std::uint16_t IMU_LOG_VERSION = 1;
+constexpr std::size_t IMU_LOG_NAME_LEN = 16;
+
+enum class ImuLogType : std::uint8_t {
+    F32 = 1,
+    F64 = 2,
+};
+
+struct ImuLogFileHeader {
+    char magic[8];
+    std::uint16_t version;
+    std::uint16_t column_count;
+    std::uint32_t block_rows;       // maks. wierszy w bloku (informacyjnie)
+    std::uint64_t created_unix_ns;
+    std::uint32_t schema_crc;       // CRC32 opisów kolumn
+    std::uint32_t reserved;
+};
+
+struct ImuLogColumnDesc {
+    char name[IMU_LOG_NAME_LEN];    // zakończone zerem, jeśli krótsze
+    std::uint8_t type;              // ImuLogType
+    std::uint8_t reserved[7];
+};
+
+struct ImuLogBlockHeader {
+    std::uint32_t magic;            // IMU_LOG_BLOCK_MAGIC
+    std::uint32_t rows;
+    std::uint64_t payload_bytes;    // suma kolumn (z dopełnieniem)
+    double t_first;
+    double t_last;
+    std::uint32_t payload_crc;      // CRC32 payloadu
+    std::uint32_t header_crc;       // CRC32 pól powyżej
+};
+
+struct ImuLogIndexEntry {
+    std::uint64_t offset;           // offset ImuLogBlockHeader w pliku
+    std::uint64_t rows;
+    double t_first;
+    double t_last;
+};
+
+struct ImuLogFooter {
+    std::uint64_t index_offset;
+    std::uint64_t block_count;
+    std::uint64_t total_rows;
+    std::uint32_t index_crc;
+    std::uint32_t reserved;
+    char magic[8];                  // IMU_LOG_FOOTER_MAGIC
+};
+
+static_assert(sizeof(ImuLogFileHeader) == 32, "ImuLogFileHeader layout");
+static_assert(sizeof(ImuLogColumnDesc) == 24, "ImuLogColumnDesc layout");
+static_assert(sizeof(ImuLogBlockHeader) == 40, "ImuLogBlockHeader layout");
+static_assert(sizeof(ImuLogIndexEntry) == 32, "ImuLogIndexEntry layout");
+static_assert(sizeof(ImuLogFooter) == 40, "ImuLogFooter layout");
+
+struct ImuLogColumn {
+    std::string name;
+    ImuLogType type{ImuLogType::F32};
+};
+
+/// Schemat imu_read: t jako double (pełna rozdzielczość czasu),
+/// reszta jako float – raporty SH-2 to Q8/Q9/Q14, float wystarcza z zapasem.
+std::vector<ImuLogColumn> imu_log_default_schema();
+
+/// CRC32 (IEEE, jak zlib.crc32).
+std::uint32_t imu_log_crc32(const void* data, std::size_t len, std::uint32_t crc = 0);
+
+/// Zapis logu: tylko dopisywanie, blok po `block_rows` wierszach.
+class ImuLogWriter {
+public:
+    ImuLogWriter() = default;
+    ~ImuLogWriter();
+
+    ImuLogWriter(const ImuLogWriter&) = delete;
+    ImuLogWriter& operator=(const ImuLogWriter&) = delete;
+
+    bool open(const std::string& path,
+              const std::vector<ImuLogColumn>& schema,
+              std::string& err,
+              std::uint32_t block_rows = 1024);
+
+    /// Jak open(), ale bloki idą przez AsyncFileWriter (osobny wątek).
+    /// Blok, który nie zmieści się w buforach, jest pomijany w całości
+    /// (rows_dropped()) – plik zostaje spójny, akwizycja nie czeka.
+    bool open_async(const std::string& path,
+                    const std::vector<ImuLogColumn>& schema,
+                    const AsyncWriterConfig& async_cfg,
+                    std::string& err,
+                    std::uint32_t block_rows = 1024);
+
+    /// Jeden wiersz; `values` ma tyle elementów, ile kolumn (kolumna 0 = czas).
+    bool append(const double* values, std::string& err);
+    bool append(const ImuCsvRow& row, std::string& err);   // schemat domyślny
+
+    /// Zapisz bieżący (niepełny) blok – np. co kilka sekund nagrania.
+    /// `sync` = także fdatasync (tylko w trybie synchronicznym).
+    bool flush(bool sync, std::string& err);
+
+    /// Ostatni blok + indeks + stopka. Wołane też z destruktora.
+    bool close(std::string& err);
+
+    bool is_open() const { return fd_ >= 0 || (async_ && async_->is_open()); }
+    std::uint64_t rows_written() const { return total_rows_; }
+    std::uint64_t rows_dropped() const { return rows_dropped_; }
+    /// nullptr w trybie synchronicznym; statystyki zostają dostępne po close().
+    const AsyncFileWriter* async_writer() const { return async_.get(); }
+
+private:
+    int fd_{-1};
+    std::unique_ptr<AsyncFileWriter> async_;
+    std::vector<ImuLogColumn> schema_;
+    std::uint32_t block_rows_{0};
+    std::uint64_t offset_{0};
+    std::uint64_t total_rows_{0};
+    std::uint64_t rows_dropped_{0};
+
+    std::vector<std::vector<unsigned char>> cols_;  // bieżący blok, per kolumna
+    std::uint32_t rows_{0};
+    double t_first_{0.0};
+    double t_last_{0.0};
+    std::vector<unsigned char> block_buf_;
+    std::vector<ImuLogIndexEntry> index_;
+
+    bool begin(const std::vector<ImuLogColumn>& schema,
+               const std::vector<ImuLogColumnDesc>& descs,
+               std::uint32_t block_rows,
+               std::string& err);
+    bool write_all(const void* data, std::size_t len, std::string& err);
+    bool write_block(std::string& err);
+};
+
+/// Widok jednego bloku w zmapowanym pliku (bez kopiowania).
+struct ImuLogBlockView {
+    std::size_t rows{0};
+    double t_first{0.0};
+    double t_last{0.0};
+    const unsigned char* data{nullptr};   // początek payloadu
+};
+
+/// Odczyt logu przez mmap. Wskaźniki z column_*() są ważne do close().
+class ImuLogReader {
+public:
+    ImuLogReader() = default;
+    ~ImuLogReader();
+
+    ImuLogReader(const ImuLogReader&) = delete;
+    ImuLogReader& operator=(const ImuLogReader&) = delete;
+
+    bool open(const std::string& path, std::string& err);
+    void close();
+
+    const std::vector<ImuLogColumn>& schema() const { return schema_; }
+    /// Indeks kolumny po nazwie albo -1.
+    int column_index(const std::string& name) const;
+
+    std::size_t block_count() const { return blocks_.size(); }
+    const ImuLogBlockView& block(std::size_t i) const { return blocks_[i]; }
+    std::uint64_t total_rows() const { return total_rows_; }
+
+    /// true, jeśli stopka albo indeks nie zgadzały się z plikiem (np. plik
+    /// po awarii, uszkodzony nagłówek bloku) i bloki znaleziono skanowaniem;
+    /// `dropped_bytes` – ile bajtów na końcu pominięto.
+    bool recovered() const { return recovered_; }
+    std::uint64_t dropped_bytes() const { return dropped_bytes_; }
+
+    /// Czy payload bloku `b` zgadza się z CRC z jego nagłówka. Przy odczycie
+    /// przez indeks open() sprawdza nagłówki bloków, a CRC payloadu liczone
+    /// jest tu, przy pierwszym dostępie do bloku (wynik zapamiętany). Bloki
+    /// ze skanowania są już sprawdzone. Nie jest bezpieczne wątkowo.
+    bool block_valid(std::size_t b) const;
+
+    /// Kolumna `col` w bloku `b`; nullptr przy złym typie albo !block_valid(b).
+    const float* column_f32(std::size_t b, std::size_t col) const;
+    const double* column_f64(std::size_t b, std::size_t col) const;
+
+    /// Wartość jako double (wygodne, ale wolniejsze niż column_*());
+    /// NaN, jeśli !block_valid(b).
+    double value(std::size_t b, std::size_t col, std::size_t row) const;
+
+private:
+    const unsigned char* base_{nullptr};
+    std::size_t size_{0};
+    std::vector<ImuLogColumn> schema_;
+    std::vector<std::size_t> col_offsets_;  // [blok * kolumny + k] – offset kolumny w payloadzie
+    std::vector<ImuLogBlockView> blocks_;
+    std::uint64_t total_rows_{0};
+
+    // CRC payloadu bloku z jego nagłówka i wynik sprawdzenia
+    enum class PayloadCheck : std::uint8_t { Unchecked, Ok, Bad };
+    struct BlockCheck {
+        std::uint64_t bytes{0};
+        std::uint32_t crc{0};
+        PayloadCheck state{PayloadCheck::Unchecked};
+    };
+    mutable std::vector<BlockCheck> checks_;   // równolegle do blocks_
+    bool recovered_{false};
+    std::uint64_t dropped_bytes_{0};
+
+    const unsigned char* column_ptr(std::size_t b, std::size_t col) const;
+    bool load_index(std::size_t data_begin);
+    void scan_blocks(std::size_t data_begin);
+};
+
+/// Czy plik zaczyna się od IMU_LOG_MAGIC.
+bool is_imu_log(const std::string& path);
+
+/// Log -> wiersze imu_read (kolumny dopasowane po nazwie, brakujące = domyślne).
+bool read_imu_log(const std::string& path, std::vector<ImuCsvRow>& out, std::string& err);
+
+/// Wiersze -> log w schemacie domyślnym.
+bool write_imu_log(const std::string& path, const std::vector<ImuCsvRow>& rows,
+                   std::string& err);
+
+/// CSV albo .imlog – rozpoznane po nagłówku pliku.
+bool read_imu_samples(const std::string& path, std::vector<ImuCsvRow>& out, std::string& err);
+
+} // namespace bno
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "bno/imu_csv.hpp"
+
+namespace bno {
+
+// Pierścień próbek IMU w pamięci współdzielonej POSIX (/dev/shm/<name>).
+//
+// Jeden pisarz (imu_daemon --shm), dowolnie wielu czytelników, którzy
+// mapują segment tylko do odczytu i nie wykonują żadnych wywołań systemowych
+// przy czytaniu. Każdy slot ma własny licznik sekwencji (seqlock):
+//
+//   seq = 2n + 1  – pisarz właśnie nadpisuje slot próbką nr n
+//   seq = 2n + 2  – próbka nr n kompletna
+//
+// Czytelnik porównuje seq przed i po skopiowaniu slotu; różnica oznacza,
+// że pisarz go w międzyczasie nadpisał (czytelnik nie nadążył).
+// Pisarz nigdy nie czeka na czytelników.
+//
+// Układ (little-endian, odczytywany też przez imu_shm.py):
+//
+//   [0, 128)                     ImuShmHeader
+//   [128, 128 + 64 * capacity)   ImuShmSlot[capacity], capacity = 2^k
+
+constexpr char IMU_SHM_MAGIC[8] = {'B', 'N', 'O', 'S', 'H', 'M', '\0', '\1'};
+constexpr std::uint32_t IMU_SHM_VERSION = 1;
+constexpr const char* IMU_SHM_DEFAULT_NAME = "/imu_samples";
+
+/// Próbka w slocie – kolumny jak w CSV imu_read, wartości w float.
+struct ImuShmSample {
+    double t{0.0};
+    float ax{0.0f}, ay{0.0f}, az{0.0f};
+    float gx{0.0f}, gy{0.0f}, gz{0.0f};
+    float qw{1.0f}, qi{0.0f}, qj{0.0f}, qk{0.0f};
+    std::uint32_t flags{0};
+    std::uint32_t reserved{0};
+};
+
+enum : std::uint32_t {
+    IMU_SHM_FLAG_LINEAR_ACCEL = 1u << 0,   // ax/ay/az bez grawitacji
+    IMU_SHM_FLAG_REPLAY       = 1u << 1,   // z nagrania (imu_daemon --replay)
+};
+
+struct alignas(64) ImuShmSlot {
+    std::atomic<std::uint64_t> seq{0};
+    ImuShmSample sample;
+};
+
+struct ImuShmHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slot_size;
+    std::uint32_t capacity;
+    std::uint32_t header_size;
+    double rate_hz;                 // nominalne tempo pisarza
+    std::uint32_t writer_pid;
+    std::uint32_t reserved[5];
+
+    /// Liczba opublikowanych próbek (numer następnej). Osobna linia cache.
+    alignas(64) std::atomic<std::uint64_t> write_seq;
+    /// Słowo futex do czekania na nowe dane (ImuShmReader::wait).
+    std::atomic<std::uint32_t> notify;
+};
+
+static_assert(sizeof(ImuShmSample) == 56, "ImuShmSample layout");
+static_assert(sizeof(ImuShmSlot) == 64, "ImuShmSlot layout");
+static_assert(sizeof(ImuShmHeader) == 128, "ImuShmHeader layout");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shm needs lock-free u64");
+
+ImuShmSample to_shm_sample(const ImuCsvRow& row, std::uint32_t flags = 0);
+ImuCsvRow from_shm_sample(const ImuShmSample& s);
+
+class ImuShmWriter {
+public:
+    ImuShmWriter() = default;
+    ~ImuShmWriter();
+
+    ImuShmWriter(const ImuShmWriter&) = delete;
+    ImuShmWriter& operator=(const ImuShmWriter&) = delete;
+
+    /// Utwórz segment od nowa (stary o tej nazwie jest usuwany – czytelnicy
+    /// starego widzą wtedy, że pisarz zniknął). `capacity` zaokrąglane w górę
+    /// do potęgi dwójki.
+    bool open(const std::string& name, std::size_t capacity, double rate_hz, std::string& err);
+    /// Odmapuj i usuń segment.
+    void close();
+    bool is_open() const { return hdr_ != nullptr; }
+
+    /// Wstaw próbkę. Bez wywołań systemowych.
+    void publish(const ImuShmSample& s);
+    /// Obudź czytelników czekających w wait() – raz po paczce publish().
+    void notify();
+
+    std::uint64_t published() const { return next_; }
+
+private:
+    std::string name_;
+    ImuShmHeader* hdr_{nullptr};
+    ImuShmSlot* slots_{nullptr};
+    std::size_t map_size_{0};
+    std::uint64_t mask_{0};
+    std::uint64_t next_{0};
+    bool dirty_{false};
+};
+
+class ImuShmReader {
+public:
+    ImuShmReader() = default;
+    ~ImuShmReader();
+
+    ImuShmReader(const ImuShmReader&) = delete;
+    ImuShmReader& operator=(const ImuShmReader&) = delete;
+
+    /// Zmapuj istniejący segment tylko do odczytu.
+    bool open(const std::string& name, std::string& err);
+    void close();
+
+    std::size_t capacity() const { return static_cast<std::size_t>(mask_ + 1); }
+    double rate_hz() const { return hdr_->rate_hz; }
+
+    /// Numer następnej próbki pisarza (= liczba wszystkich opublikowanych).
+    std::uint64_t write_seq() const { return hdr_->write_seq.load(std::memory_order_acquire); }
+
+    /// Próbka nr `n`; false, jeśli jeszcze jej nie ma albo została nadpisana.
+    bool read(std::uint64_t n, ImuShmSample& out) const;
+
+    /// Najnowsze (do) `max` próbek, od najstarszej. Zwraca liczbę wpisanych
+    /// do `out`; numer pierwszej w `first_seq`.
+    std::size_t latest(std::size_t max, ImuShmSample* out, std::uint64_t& first_seq) const;
+
+    /// Czekaj, aż write_seq() > `seq` (futex), najwyżej `timeout_ms`.
+    bool wait(std::uint64_t seq, int timeout_ms) const;
+
+    /// Proces pisarza jeszcze żyje (segment nie jest osierocony).
+    bool writer_alive() const;
+
+private:
+    const ImuShmHeader* hdr_{nullptr};
+    const ImuShmSlot* slots_{nullptr};
+    std::size_t map_size_{0};
+    std::uint64_t mask_{0};
+};
+
+} // namespace bno
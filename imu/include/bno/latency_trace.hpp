@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace bno {
+
+/// Histogram opóźnień w µs w stylu HDR: wartości < 32 µs dokładnie, wyżej
+/// 32 kubełki na oktawę (błąd względny ≤ 1/32 ≈ 3%), zakres do ~71 min.
+/// Stała pamięć (7 KiB), record() to kilka instrukcji – można wołać
+/// w pętli odczytu przy każdej próbce.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int MAX_BITS = 32;
+    static constexpr std::size_t BUCKETS =
+        static_cast<std::size_t>(MAX_BITS - SUB_BITS + 1) << SUB_BITS;
+
+    void record_us(std::int64_t us);
+    void record_s(double seconds);
+
+    std::uint64_t count() const { return count_; }
+    std::int64_t min_us() const { return count_ > 0 ? min_ : 0; }
+    std::int64_t max_us() const { return max_; }
+    double mean_us() const;
+
+    /// Wartość, poniżej której jest `p` (0..1) próbek – górna granica kubełka.
+    std::int64_t percentile_us(double p) const;
+
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+private:
+    std::array<std::uint64_t, BUCKETS> counts_{};
+    std::uint64_t count_{0};
+    std::int64_t min_{0};
+    std::int64_t max_{0};
+    double sum_{0.0};
+
+    static std::size_t bucket_of(std::uint64_t v);
+    static std::int64_t bucket_high(std::size_t i);
+};
+
+/// Opóźnienia kolejnych etapów ścieżki próbka -> linia gestu.
+///
+/// Czasy to sekundy steady_clock liczone od wspólnego t0 (jak t w imu_dir):
+///   sensor – czas próbki wg SH-2 (t odczytu + delay raportu, ujemny)
+///   read   – koniec read_frame()
+///   parse  – koniec parse_sh2_input_reports()
+///   ingest – wejście do GesturePipeline::add_sample()
+///   emit   – wypisanie linii wyniku
+class LatencyTrace {
+public:
+    enum Stage : std::size_t {
+        SensorToRead,    // delay w czujniku + kolejka SHTP + I2C
+        ReadToParse,     // dekodowanie ramki
+        ParseToIngest,   // od końca parsowania do detektora
+        Detector,        // czas add_sample() (każda próbka)
+        IngestToEmit,    // próbka, która domknęła gest -> linia
+        SensorToEmit,    // całość: czas próbki -> linia
+        EventToEmit,     // środek / koniec gestu -> linia (okno detektora)
+        STAGE_COUNT,
+    };
+
+    struct SampleStamps {
+        double sensor{0.0};
+        double read{0.0};
+        double parse{0.0};
+        double ingest{0.0};
+    };
+
+    static const char* stage_name(Stage s);
+
+    void record(Stage s, double seconds) { hist_[s].record_s(seconds); }
+
+    /// Etapy jednej próbki do wejścia w detektor (bez Detector / *ToEmit).
+    void record_ingest(const SampleStamps& st)
+    {
+        record(SensorToRead, st.read - st.sensor);
+        record(ParseToIngest, st.ingest - st.parse);
+    }
+
+    /// Linia wyniku wypisana w chwili `now` dla próbki `st`;
+    /// `event_t` – czas zdarzenia wg wyniku (t_center / t_end).
+    void record_emit(const SampleStamps& st, double event_t, double now)
+    {
+        record(IngestToEmit, now - st.ingest);
+        record(SensorToEmit, now - st.sensor);
+        record(EventToEmit, now - event_t);
+    }
+
+    const LatencyHistogram& histogram(Stage s) const { return hist_[s]; }
+
+    /// Tabela n / p50 / p90 / p99 / p99.9 / max w µs.
+    void dump(std::FILE* out, const char* title) const;
+    /// Dołącza histogramy innego śladu (np. z innego wątku).
+    void merge(const LatencyTrace& other);
+    void reset();
+
+private:
+    std::array<LatencyHistogram, STAGE_COUNT> hist_{};
+};
+
+} // namespace bno
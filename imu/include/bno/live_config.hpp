@@ -0,0 +1,91 @@
+#pragma once
+
+// Konfiguracja zmieniana w locie (imu_dir / imu_daemon --control): progi
+// detektora kierunku i częstości raportów SH-2, bez restartu procesu.
+//
+// Zmiany idą jak w RCU. Wątek sterujący (ControlServer) kopiuje bieżącą
+// migawkę, zmienia kopię i publikuje wskaźnik na nową, niezmienną wersję.
+// Wątek próbek raz na ramkę woła refresh(): jedno load(acquire), bez
+// blokad i bez alokacji. Nową wersję przykłada między próbkami. Starą
+// migawkę zwalnia dopiero wątek sterujący, gdy czytelnik potwierdzi nowszą.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"
+
+namespace bno {
+
+struct LiveConfig {
+    std::uint64_t version{0};
+    GestureDirectionDetector::Config detector{};
+    int accel_hz{100};   // Linear Acceleration (i Accelerometer strumienia raw demona); 0 = wył.
+    int gyro_hz{100};
+    int grv_hz{100};     // Game Rotation Vector
+};
+
+/// Dozwolone częstości: 0 (raport wyłączony) albo [min_hz, max_*].
+struct LiveConfigLimits {
+    int min_hz = 50;
+    int max_hz = 100;
+    int max_gyro_hz = 100;
+};
+
+/// Przypisania "klucz=wartość" oddzielone spacjami (komenda SET), na kopii
+/// `cfg`: wszystkie albo żadne. Klucze: hz, gyro_hz, grv_hz i progi
+/// detektora (min_dyn, min_peak, min_interval, half_window, ...).
+bool apply_live_config_assignments(LiveConfig& cfg,
+                                   std::string_view assignments,
+                                   const LiveConfigLimits& limits,
+                                   std::string& err);
+
+/// "version=3 hz=100 gyro_hz=100 ..." – wszystkie klucze, jedna linia bez '\n'.
+std::string format_live_config(const LiveConfig& cfg);
+
+class LiveConfigCell {
+public:
+    explicit LiveConfigCell(const LiveConfig& initial);
+
+    LiveConfigCell(const LiveConfigCell&) = delete;
+    LiveConfigCell& operator=(const LiveConfigCell&) = delete;
+
+    /// Tylko wątek próbek (jeden czytelnik). Nowa wersja -> true i `snapshot`
+    /// na nią; migawka z poprzedniego refresh() przestaje być ważna.
+    /// Bez zmian -> false, `snapshot` nieruszony.
+    bool refresh(const LiveConfig*& snapshot)
+    {
+        const LiveConfig* p = current_.load(std::memory_order_acquire);
+        if (p == reader_last_) {
+            return false;
+        }
+        reader_last_ = p;
+        reader_version_.store(p->version, std::memory_order_release);
+        snapshot = p;
+        return true;
+    }
+
+    /// Wątki sterujące: kopia bieżącej wersji do zmiany.
+    LiveConfig copy() const;
+
+    /// Opublikuj `next` (version nadawane tu); zwraca numer nowej wersji.
+    std::uint64_t publish(LiveConfig next);
+
+    /// Migawki czekające na potwierdzenie czytelnika (z bieżącą).
+    std::size_t snapshot_count() const;
+
+private:
+    std::atomic<const LiveConfig*> current_{nullptr};
+    std::atomic<std::uint64_t> reader_version_{0};
+    const LiveConfig* reader_last_{nullptr};   // tylko wątek próbek
+
+    mutable std::mutex writer_mutex_;          // tylko między wątkami sterującymi
+    std::vector<std::unique_ptr<const LiveConfig>> snapshots_;
+};
+
+} // namespace bno
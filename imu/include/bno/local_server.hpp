@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bno {
+
+// Serwer strumieni tekstowych na gnieździe Unix (SOCK_STREAM), jednowątkowy,
+// obsługiwany z pętli głównej imu_daemon przez poll().
+//
+// Protokół: klient po połączeniu wysyła jedną linię "SUB <temat>\n"
+// (raw | gestures | status) i od tej chwili dostaje linie tego tematu:
+//
+//   raw       – CSV jak imu_read (najpierw nagłówek)
+//   gestures  – linie jak imu_dir
+//   status    – NDJSON ze statystykami demona, co sekundę
+//
+// Wolny klient nie blokuje demona: linie, które nie mieszczą się w jego
+// kolejce (max_pending_bytes), są pomijane w całości i liczone.
+
+enum class StreamTopic : std::uint8_t {
+    Raw,
+    Gestures,
+    Status,
+};
+
+constexpr std::size_t STREAM_TOPIC_COUNT = 3;
+
+/// "raw" / "gestures" / "status"
+const char* stream_topic_name(StreamTopic topic);
+bool parse_stream_topic(std::string_view name, StreamTopic& topic);
+
+/// Nieblokujące gniazdo nasłuchujące AF_UNIX pod `path` (też dla
+/// ControlServer). Martwe gniazdo po zabitym procesie jest usuwane,
+/// żywe to błąd. Zwraca fd albo -1 i `err` z prefiksem `who`.
+int listen_unix_socket(const std::string& path, const char* who, std::string& err);
+
+struct LocalServerStats {
+    std::uint64_t accepted{0};
+    std::uint64_t lines_sent{0};
+    std::uint64_t lines_dropped{0};   // kolejka klienta pełna
+    std::uint64_t rejected{0};        // zły SUB albo za dużo klientów
+};
+
+class LocalStreamServer {
+public:
+    struct Config {
+        std::size_t max_clients = 16;
+        std::size_t max_pending_bytes = 512 * 1024;
+    };
+
+    LocalStreamServer() = default;
+    ~LocalStreamServer();
+
+    LocalStreamServer(const LocalStreamServer&) = delete;
+    LocalStreamServer& operator=(const LocalStreamServer&) = delete;
+
+    /// Utwórz gniazdo `path` (stare, nieużywane jest usuwane).
+    bool open(const std::string& path, const Config& cfg, std::string& err);
+    void close();
+
+    /// Linia wysyłana raz, zaraz po SUB (np. nagłówek CSV dla raw).
+    void set_greeting(StreamTopic topic, std::string line);
+
+    /// Nowe połączenia, komendy, dosyłanie zaległych danych.
+    /// Czeka najwyżej `timeout_ms` (0 = tylko sprawdź).
+    void poll(int timeout_ms);
+
+    bool has_subscribers(StreamTopic topic) const
+    {
+        return subscribers_[static_cast<std::size_t>(topic)] > 0;
+    }
+
+    /// Wyślij linię (z '\n') do wszystkich subskrybentów tematu.
+    void publish(StreamTopic topic, std::string_view line);
+
+    std::size_t client_count() const { return clients_.size(); }
+    const LocalServerStats& stats() const { return stats_; }
+
+private:
+    struct Client {
+        int fd{-1};
+        bool subscribed{false};
+        StreamTopic topic{StreamTopic::Raw};
+        std::string in;           // niepełna linia komendy
+        std::string pending;      // niewysłane dane
+        std::size_t pending_off{0};
+        std::uint64_t dropped{0};
+    };
+
+    int listen_fd_{-1};
+    std::string path_;
+    Config cfg_;
+    std::vector<Client> clients_;
+    std::size_t subscribers_[STREAM_TOPIC_COUNT]{};
+    std::string greetings_[STREAM_TOPIC_COUNT];
+    LocalServerStats stats_;
+
+    void accept_clients();
+    bool read_commands(Client& c);
+    bool flush_pending(Client& c);
+    void enqueue(Client& c, std::string_view data);
+    void drop_client(std::size_t i);
+};
+
+} // namespace bno
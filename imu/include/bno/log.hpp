@@ -0,0 +1,270 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Logowanie i śledzenie dla libbno_shtp.
+//
+// Wywołanie BNO_LOG_* nie formatuje tekstu: zapisuje do pierścienia
+// bieżącego wątku binarny rekord (czas, wskaźnik na literał formatu,
+// do 4 argumentów liczbowych / literałów). Tekst składa osobny wątek
+// (drain), który co kilka ms opróżnia pierścienie wszystkich wątków.
+// Pełny pierścień = rekord odrzucony i policzony, nigdy czekanie.
+//
+//   BNO_LOG_WARN("shtp: length mismatch header={} frame={}", len1, len2);
+//   BNO_TRACE_SPAN("read_frame");   // czas do końca zakresu, przy --trace
+//
+// "{}" w formacie zastępowane są kolejnymi argumentami. Argumenty const char*
+// muszą żyć do końca programu (literały) – są czytane dopiero przez drain.
+//
+// Poziomy poniżej BNO_LOG_MIN_LEVEL znikają w czasie kompilacji;
+// pozostałe filtruje jeszcze poziom ustawiony w runtime (set_level).
+
+#ifndef BNO_LOG_MIN_LEVEL
+#define BNO_LOG_MIN_LEVEL 1   // 0 = trace, 1 = debug, 2 = info, 3 = warn, 4 = error
+#endif
+
+#ifndef BNO_TRACE_ENABLED
+#define BNO_TRACE_ENABLED 1
+#endif
+
+namespace bno::log {
+
+enum class Level : std::uint8_t {
+    Trace = 0,
+    Debug = 1,
+    Info  = 2,
+    Warn  = 3,
+    Error = 4,
+    Off   = 5,
+};
+
+struct Stats {
+    std::uint64_t written{0};   // rekordy wypisane przez drain
+    std::uint64_t dropped{0};   // odrzucone przy pełnym pierścieniu
+    std::uint32_t threads{0};   // wątki z własnym pierścieniem
+};
+
+/// Uruchom wątek drain z wyjściem `sink` (domyślnie stderr) i zarejestruj
+/// pierścień wątku wołającego – jego pierwszy log nie płaci za alokację.
+/// Bez start() drain rusza sam przy pierwszym logu. Wołać przed logowaniem
+/// z wielu wątków.
+void start(std::FILE* sink = stderr, Level runtime_level = Level::Info);
+/// Opróżnij wszystkie pierścienie i zatrzymaj drain (też przy wyjściu z programu).
+void stop();
+
+void set_level(Level level);
+void set_trace(bool on);
+Stats stats();
+
+namespace detail {
+
+enum class ArgType : std::uint8_t { None, Int, Uint, Double, Str };
+
+union ArgValue {
+    std::int64_t i;
+    std::uint64_t u;
+    double d;
+    const char* s;
+};
+
+constexpr std::size_t MAX_ARGS = 4;
+
+enum class Kind : std::uint8_t { Log, Span };
+
+/// 64 B – jedna linia cache na rekord
+struct alignas(64) Record {
+    std::uint64_t ticks;        // now_ticks(); na ns przelicza drain
+    const char* fmt;            // literał formatu albo nazwa zakresu
+    Level level;
+    Kind kind;
+    std::uint8_t nargs;
+    ArgType types[MAX_ARGS];
+    ArgValue args[MAX_ARGS];    // Span: args[0].u = czas trwania w tickach
+};
+static_assert(sizeof(Record) == 64, "log record layout");
+
+extern std::atomic<std::uint8_t> g_level;
+extern std::atomic<bool> g_trace;
+
+inline std::uint64_t now_ns()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// Znacznik czasu rekordu: licznik cykli procesora tam, gdzie jest dostępny
+/// z przestrzeni użytkownika (kilka ns zamiast ~20–50 ns clock_gettime).
+/// Drain przelicza ticki na ns, kalibrując je względem steady_clock.
+inline std::uint64_t now_ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t v;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return now_ns();
+#endif
+}
+
+constexpr std::size_t RING_RECORDS = 1024;   // 64 KiB na wątek
+
+// Pierścień SPSC: producent = wątek właściciel, konsument = drain
+struct ThreadRing {
+    alignas(64) std::atomic<std::uint64_t> head{0};   // zapis (producent)
+    std::uint64_t tail_cached{0};                     // kopia tail producenta
+    alignas(64) std::atomic<std::uint64_t> tail{0};   // odczyt (drain)
+    alignas(64) std::atomic<std::uint64_t> dropped{0};
+    std::atomic<bool> retired{false};                 // wątek się skończył
+    std::uint32_t id{0};
+    Record records[RING_RECORDS];
+};
+
+/// Pierścień bieżącego wątku; nullptr przed rejestracją i po końcu wątku.
+/// constinit: dostęp bez wywołania inicjalizacji TLS.
+extern constinit thread_local ThreadRing* t_ring;
+
+/// Wolny slot w pierścieniu bieżącego wątku. rec == nullptr: pierścień pełny
+/// albo wątek już się kończy (rekord odrzucony i policzony). Rekord wypełnia
+/// się na miejscu – bez kopii z lokalnej zmiennej, której świeżo zapisane
+/// bajty procesor musiałby czytać szerszymi ładunkami (store forwarding).
+struct Slot {
+    Record* rec;
+    std::atomic<std::uint64_t>* head;   // licznik producenta pierścienia
+};
+
+/// Wolna ścieżka reserve(): rejestracja pierścienia wątku albo pierścień
+/// wyglądający na pełny (świeży tail drainu, odrzucenie).
+Slot reserve_slow();
+
+/// Szybka ścieżka w miejscu wywołania: jeden odczyt TLS, bez wywołania
+/// funkcji z biblioteki.
+inline Slot reserve()
+{
+    ThreadRing* r = t_ring;
+    if (r != nullptr) {
+        const std::uint64_t head = r->head.load(std::memory_order_relaxed);
+        // tail drainu czytamy tylko, gdy pierścień wygląda na pełny – bez
+        // przerzucania linii cache między rdzeniami przy każdym rekordzie
+        if (head - r->tail_cached < RING_RECORDS) {
+            // następny slot do zapisu z wyprzedzeniem: linia zwykle wypadła z L1
+            // od czasu, gdy czytał ją drain, a miss przy zapisie wydłuża wywołanie
+            __builtin_prefetch(&r->records[(head + 1) % RING_RECORDS], 1);
+            return Slot{&r->records[head % RING_RECORDS], &r->head};
+        }
+    }
+    return reserve_slow();
+}
+
+/// Publikuje rekord z reserve(); head zmienia tylko ten wątek.
+inline void commit(const Slot& slot)
+{
+    slot.head->store(slot.head->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <typename T>
+void set_arg(Record& rec, std::size_t i, T v)
+{
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        rec.types[i] = ArgType::Uint;
+        rec.args[i].u = v ? 1u : 0u;
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        rec.types[i] = ArgType::Int;
+        rec.args[i].i = static_cast<std::int64_t>(v);
+    } else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+        rec.types[i] = ArgType::Uint;
+        rec.args[i].u = static_cast<std::uint64_t>(v);
+    } else if constexpr (std::is_floating_point_v<U>) {
+        rec.types[i] = ArgType::Double;
+        rec.args[i].d = static_cast<double>(v);
+    } else {
+        static_assert(std::is_same_v<U, const char*> || std::is_same_v<U, char*>,
+                      "log args: integers, floats or string literals");
+        rec.types[i] = ArgType::Str;
+        rec.args[i].s = v;
+    }
+}
+
+template <typename... Args>
+void write(Level level, const char* fmt, Args... args)
+{
+    static_assert(sizeof...(Args) <= MAX_ARGS, "log: at most 4 arguments");
+    const Slot slot = reserve();
+    Record* rec = slot.rec;
+    if (rec == nullptr) {
+        return;
+    }
+    rec->ticks = now_ticks();
+    rec->fmt = fmt;
+    rec->level = level;
+    rec->kind = Kind::Log;
+    rec->nargs = static_cast<std::uint8_t>(sizeof...(Args));
+    std::size_t i = 0;
+    (set_arg(*rec, i++, args), ...);
+    commit(slot);
+}
+
+inline bool enabled(Level level)
+{
+    return static_cast<std::uint8_t>(level) >= g_level.load(std::memory_order_relaxed);
+}
+
+/// Zakres mierzony od konstrukcji do destrukcji (BNO_TRACE_SPAN).
+class Span {
+public:
+    explicit Span(const char* name)
+        : name_(name)
+        , t0_(g_trace.load(std::memory_order_relaxed) ? now_ticks() : 0)
+    {}
+    ~Span()
+    {
+        if (t0_ != 0) {
+            end();
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name_;
+    std::uint64_t t0_;
+
+    void end();
+};
+
+} // namespace detail
+} // namespace bno::log
+
+#define BNO_LOG_AT(lvl, num, fmt, ...)                                             \
+    do {                                                                           \
+        if constexpr ((num) >= BNO_LOG_MIN_LEVEL) {                                \
+            if (::bno::log::detail::enabled(lvl)) {                                \
+                ::bno::log::detail::write(lvl, fmt __VA_OPT__(, ) __VA_ARGS__);    \
+            }                                                                      \
+        }                                                                          \
+    } while (0)
+
+#define BNO_LOG_DEBUG(fmt, ...) BNO_LOG_AT(::bno::log::Level::Debug, 1, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define BNO_LOG_INFO(fmt, ...)  BNO_LOG_AT(::bno::log::Level::Info,  2, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define BNO_LOG_WARN(fmt, ...)  BNO_LOG_AT(::bno::log::Level::Warn,  3, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define BNO_LOG_ERROR(fmt, ...) BNO_LOG_AT(::bno::log::Level::Error, 4, fmt __VA_OPT__(, ) __VA_ARGS__)
+
+#define BNO_LOG_CONCAT_(a, b) a##b
+#define BNO_LOG_CONCAT(a, b) BNO_LOG_CONCAT_(a, b)
+
+#if BNO_TRACE_ENABLED
+#define BNO_TRACE_SPAN(name) ::bno::log::detail::Span BNO_LOG_CONCAT(bno_span_, __LINE__)(name)
+#else
+#define BNO_TRACE_SPAN(name) ((void)0)
+#endif
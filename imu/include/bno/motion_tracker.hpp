@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"   // Vec3, Quat
+
+namespace bno {
+
+/// Punkt trajektorii (układ świata, względem pozycji z chwili startu trackera).
+struct TrackPoint {
+    double t{0.0};
+    Vec3 p{};        // m
+    Vec3 v{};        // m/s
+    bool still{false};
+};
+
+/// Kształt fragmentu trajektorii – do klasyfikacji gestu po torze ruchu,
+/// a nie tylko po dominującej osi Δv.
+struct PathFeatures {
+    Vec3 displacement{};     // p(koniec) - p(początek), m
+    double length{0.0};      // droga wzdłuż toru, m
+    double straightness{0.0};// |displacement| / length (1 = prosta)
+    Vec3 area{};             // ½ Σ r_i × r_{i+1} (m²), oś = normalna płaszczyzny toru
+    double roundness{0.0};   // 4π|area| / length² (1 = okrąg, 0 = odcinek)
+    double peak_speed{0.0};  // m/s
+    std::size_t points{0};
+};
+
+enum class PathShape : std::uint8_t {
+    None,   // za krótki tor (< min_length) albo brak historii
+    Line,   // straightness >= 0.8
+    Loop,   // roundness >= 0.5 – tor zamknięty (CIRCLE)
+    Arc,    // pozostałe
+};
+
+PathShape classify_path(const PathFeatures& f, double min_length = 0.03);
+const char* path_shape_name(PathShape s);
+
+/// Prędkość i pozycja w układzie świata z filtrem Kalmana i ZUPT
+/// (zero-velocity update) w chwilach bezruchu.
+///
+/// Stan na oś świata: [p, v, b] – pozycja, prędkość i bias przyspieszenia
+/// (resztka grawitacji / offset Linear Acceleration). Przyspieszenie idzie
+/// jako sterowanie, więc osie są niezależne i zamiast jednego filtra 9x9
+/// są trzy filtry 3x3 – te same równania co cv::KalmanFilter (predict:
+/// x = F x + B u, P = F P Fᵀ + Q; correct: K = P Hᵀ (H P Hᵀ + R)⁻¹),
+/// ale na tablicach stałego rozmiaru i z jednym pomiarem skalarnym.
+///
+/// Bezruch: rozrzut a wokół średniej kroczącej < still_accel i |ω| < still_gyro
+/// przez still_hold_s.
+/// Wtedy każda próbka koryguje v = 0, co przy okazji estymuje bias.
+/// Trajektoria (ostatnie TRAJECTORY punktów) jest dostępna przez
+/// trajectory() / path_features().
+class MotionTracker {
+public:
+    struct Config {
+        double init_window_s = 0.2;    // s – średnia a z tego okna to początkowy bias
+        double accel_noise   = 0.3;    // m/s² – σ szumu przyspieszenia
+        double bias_walk     = 0.02;   // m/s³/√Hz – dryf biasu
+        double zupt_noise    = 0.01;   // m/s – σ pomiaru v = 0
+        double still_accel   = 0.25;   // m/s²
+        double still_gyro    = 0.15;   // rad/s
+        double still_hold_s  = 0.08;   // s
+        double max_dt        = 0.05;   // s – dłuższa przerwa nie jest całkowana
+    };
+
+    struct Stats {
+        std::uint64_t samples{0};
+        std::uint64_t zupt_updates{0};
+        std::uint64_t still_periods{0};
+        std::uint64_t gaps{0};          // przerwy > max_dt
+    };
+
+    static constexpr std::size_t TRAJECTORY = 2048;   // ~5 s przy 400 Hz
+
+    MotionTracker() : MotionTracker(Config{}) {}
+    explicit MotionTracker(const Config& cfg);
+
+    void reset();
+
+    /// Próbka jak dla GestureDirectionDetector: a i ω w układzie czujnika.
+    void add_sample(double t, const Vec3& accel_sensor, const Vec3& gyro_sensor, const Quat& quat);
+
+    bool initialized() const { return initialized_; }
+    bool still() const { return still_; }
+    Vec3 position() const { return Vec3{axes_[0].x[0], axes_[1].x[0], axes_[2].x[0]}; }
+    Vec3 velocity() const { return Vec3{axes_[0].x[1], axes_[1].x[1], axes_[2].x[1]}; }
+    Vec3 accel_bias() const { return Vec3{axes_[0].x[2], axes_[1].x[2], axes_[2].x[2]}; }
+    const Stats& stats() const { return stats_; }
+
+    /// Liczba punktów w historii; point(0) najstarszy.
+    std::size_t trajectory_size() const { return size_; }
+    const TrackPoint& point(std::size_t i) const;
+
+    /// Punkty z t w [t_from, t_to] (dopisywane do `out` po wyczyszczeniu).
+    void trajectory(double t_from, double t_to, std::vector<TrackPoint>& out) const;
+    /// Kształt toru w [t_from, t_to]; points = 0, gdy historia go nie obejmuje.
+    PathFeatures path_features(double t_from, double t_to) const;
+
+private:
+    // Jedna oś: stan [p, v, b] i kowariancja 3x3
+    struct Axis {
+        std::array<double, 3> x{};
+        std::array<double, 9> P{};
+
+        void predict(double a_meas, double dt, double q_acc, double q_bias);
+        void zero_velocity(double r);
+    };
+
+    Config cfg_;
+    std::array<Axis, 3> axes_{};
+    double t_{0.0};
+    bool initialized_{false};
+    bool still_{false};
+    double moving_since_{0.0};   // ostatnia próbka z ruchem
+    std::array<double, 3> still_mean_{};   // średnia krocząca a (stała czasowa still_hold_s)
+    double still_var_{0.0};                // i rozrzut wokół niej (m²/s⁴)
+    double init_t0_{0.0};
+    Vec3 init_sum_{};
+    std::size_t init_count_{0};
+
+    std::vector<TrackPoint> ring_;
+    std::size_t head_{0};   // indeks najstarszego
+    std::size_t size_{0};
+
+    Stats stats_;
+
+    void push_point(double t);
+    std::size_t first_at_or_after(double t) const;
+};
+
+} // namespace bno
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "bno/gesture_dir.hpp"   // Vec3, Quat
+
+namespace bno {
+
+enum class FusionMethod : std::uint8_t {
+    Madgwick,   // krok gradientowy w stronę orientacji z czujnika
+    Mahony,     // PI na błędzie orientacji, całka = bias gyro
+    Ekf,        // error-state EKF: błąd orientacji + bias gyro (6 stanów)
+};
+
+const char* fusion_method_name(FusionMethod m);
+bool parse_fusion_method(std::string_view name, FusionMethod& out);
+
+/// Orientacja liczona na hoście z gyro (do 1 kHz), korygowana kwaternionem
+/// z czujnika (Game Rotation Vector, 100–400 Hz, z własnym opóźnieniem).
+///
+/// update_gyro() całkuje każdą próbkę gyro, więc orientacja jest świeża
+/// przy każdej próbce, a nie dopiero przy następnym GRV. correct_quat()
+/// przyjmuje pomiar z czasem próbki wg czujnika – zwykle starszym niż
+/// ostatnie gyro. Pomiar jest przenoszony do „teraz” obrotem z samego gyro
+/// między tymi chwilami (historia ostatnich HISTORY kroków), więc opóźnienie
+/// GRV nie ciągnie orientacji wstecz.
+///
+/// Stały koszt na próbkę, bez alokacji: historia to tablica pierścieniowa,
+/// EKF ma macierze 6x6 na stosie obiektu.
+class OrientationFusion {
+public:
+    struct Config {
+        FusionMethod method = FusionMethod::Mahony;
+        double madgwick_beta = 0.5;    // 1/s – szybkość zbiegania do pomiaru
+        double mahony_kp = 2.0;        // 1/s – część proporcjonalna
+        double mahony_ki = 1.0;        // 1/s^2 – całka (estymacja biasu gyro), ~kp²/4
+        double ekf_gyro_noise = 0.01;  // rad/s/√Hz – szum gyro
+        double ekf_bias_walk = 1e-4;   // rad/s^2/√Hz – dryf biasu
+        double ekf_quat_noise = 0.02;  // rad – σ orientacji z czujnika
+        double max_dt = 0.05;          // s – dłuższe przerwy w gyro nie są całkowane
+    };
+
+    struct Stats {
+        std::uint64_t gyro_samples{0};
+        std::uint64_t corrections{0};
+        std::uint64_t stale_corrections{0};   // pomiar starszy niż cała historia
+    };
+
+    static constexpr std::size_t HISTORY = 512;   // 0.5 s przy 1 kHz
+
+    OrientationFusion() : OrientationFusion(Config{}) {}
+    explicit OrientationFusion(const Config& cfg);
+
+    void reset();
+
+    /// Próbka gyro (rad/s, układ czujnika) z czasem t (s). Zwraca orientację po kroku.
+    const Quat& update_gyro(double t, const Vec3& gyro);
+
+    /// Orientacja z czujnika z czasem próbki t (s). Pierwszy pomiar
+    /// ustawia orientację; kolejne ją korygują wg Config::method.
+    void correct_quat(double t, const Quat& q_sensor);
+
+    const Quat& quat() const { return q_; }
+    /// Estymowany bias gyro (rad/s); Madgwick go nie estymuje (zawsze 0).
+    const Vec3& gyro_bias() const { return bias_; }
+    bool initialized() const { return initialized_; }
+    FusionMethod method() const { return cfg_.method; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct HistoryEntry {
+        double t;
+        Quat g;   // orientacja z samego gyro (bez korekt)
+    };
+
+    Config cfg_;
+    Quat q_{};
+    Quat g_{};          // całka gyro bez korekt – do przenoszenia pomiarów w czasie
+    Quat align_{};      // pomiar = align_ ⊗ g_ (odniesienie dla Madgwick / Mahony)
+    Vec3 bias_{};
+    double t_{0.0};
+    bool have_t_{false};
+    bool initialized_{false};
+
+    std::array<HistoryEntry, HISTORY> hist_{};
+    std::size_t hist_head_{0};   // indeks najnowszego wpisu
+    std::size_t hist_size_{0};
+
+    std::array<double, 36> P_{};   // kowariancja EKF, 6x6 wierszami
+
+    Stats stats_;
+
+    void push_history();
+    Quat gyro_quat_at(double t);
+
+    void ekf_predict(const Vec3& w, double dt);
+    void ekf_update(const Quat& measured_now);
+};
+
+} // namespace bno
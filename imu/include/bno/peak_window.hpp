@@ -0,0 +1,261 @@
+#pragma once
+
+// Rdzeń trybu PeakWindow wspólny dla obu detektorów kierunku:
+//   GestureDirectionDetector (gesture_dir.hpp) – host: czas w s (double),
+//     bufor SampleStore, do tego gesty obrotowe i tryb Segmented,
+//   BasicDirectionDetector<Num> (gesture_dir_t.hpp) – MCU: float/Q16,
+//     czas w µs zegara MCU (uint32), pierścień N próbek.
+//
+// Tu są kroki, które po obu stronach muszą dać ten sam wynik: porównania
+// czasu (także remisy na granicach), zakres bufora i okna baseline, pik
+// |a_dyn| od końca baseline, okno ±half_window wokół piku, oś i kierunek
+// z Δv oraz domyślne progi. Całka Δv zostaje w detektorach – host liczy ją
+// w tym samym przejściu co cechy gestów obrotowych. Zgodność całości
+// sprawdza test ctest gesture_parity (imu_fixed_bench --check).
+//
+// Tylko <cstddef> i <cstdint> – kompiluje się -ffreestanding.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bno {
+
+/// Kierunek gestu posuwistego: oś dominująca Δv i jej znak.
+enum class GestureDirection : std::uint8_t {
+    Up,         // X+
+    Down,       // X-
+    Forward,    // Y+
+    Backward,   // Y-
+    Right,      // Z+
+    Left,       // Z-
+};
+
+inline constexpr const char* gesture_direction_label(GestureDirection d)
+{
+    switch (d) {
+    case GestureDirection::Up:       return "UP";
+    case GestureDirection::Down:     return "DOWN";
+    case GestureDirection::Forward:  return "FORWARD";
+    case GestureDirection::Backward: return "BACKWARD";
+    case GestureDirection::Right:    return "RIGHT";
+    case GestureDirection::Left:     return "LEFT";
+    }
+    return "UNKNOWN";
+}
+
+namespace peak_window {
+
+// Domyślne progi obu detektorów, w tysięcznych (ms, m/s², m/s), żeby
+// Fixed<F> nie potrzebował stałych zmiennoprzecinkowych
+inline constexpr std::int32_t DEFAULT_BASELINE_WINDOW_MS = 200;
+inline constexpr std::int32_t DEFAULT_HALF_WINDOW_MS     = 300;
+inline constexpr std::int32_t DEFAULT_MIN_INTERVAL_MS    = 800;
+inline constexpr std::int32_t DEFAULT_MIN_DYN_MILLI      = 500;    // m/s²
+inline constexpr std::int32_t DEFAULT_MIN_PEAK_MILLI     = 1500;   // m/s²
+inline constexpr std::int32_t MIN_AXIS_VELOCITY_MILLI    = 500;    // m/s – |Δv| na osi dominującej
+
+/// Baseline wymaga co najmniej tylu próbek w oknie baseline_window.
+inline constexpr std::size_t BASELINE_MIN_SAMPLES = 3;
+
+/// Porównania czasu próbek. Host trzyma sekundy w double z tolerancją pół
+/// µs – remis na granicy (np. 2.32 - 1.57 wobec 0.75) rozstrzyga się wtedy
+/// jak na zegarze µs MCU, a nie według błędu zaokrąglenia.
+template <typename Time>
+struct TimeOps;
+
+template <>
+struct TimeOps<double> {
+    static constexpr double EPS = 0.5e-6;
+
+    /// a <= b
+    static constexpr bool not_after(double a, double b) { return a <= b + EPS; }
+    /// b - a > span
+    static constexpr bool longer(double a, double b, double span) { return b - a > span + EPS; }
+    /// b - a < span
+    static constexpr bool shorter(double a, double b, double span) { return b - a < span - EPS; }
+};
+
+/// µs zegara MCU – licznik uint32 przekręca się co ~71 min.
+template <>
+struct TimeOps<std::uint32_t> {
+    static constexpr bool not_after(std::uint32_t a, std::uint32_t b)
+    {
+        return static_cast<std::int32_t>(b - a) >= 0;
+    }
+    static constexpr bool longer(std::uint32_t a, std::uint32_t b, std::uint32_t span)
+    {
+        return b - a > span;
+    }
+    static constexpr bool shorter(std::uint32_t a, std::uint32_t b, std::uint32_t span)
+    {
+        return b - a < span;
+    }
+};
+
+/// Ile czasu bufor trzyma próbki: 2.5 × half_window (okno + zapas na pik).
+template <typename Time>
+constexpr Time buffer_span(Time half_window)
+{
+    return half_window * 5 / 2;
+}
+
+/// Wyszukiwanie binarne w [0, n): pierwszy indeks, dla którego before(i) = false.
+template <typename Before>
+std::size_t partition_index(std::size_t n, Before before)
+{
+    std::size_t lo = 0;
+    std::size_t hi = n;
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (before(mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/// Pierwsza próbka z t >= t_from (czasy w buforze nie maleją).
+template <typename Time, typename TimeAt>
+std::size_t first_at_or_after(std::size_t n, TimeAt t_at, Time t_from)
+{
+    return partition_index(n, [&](std::size_t i) { return !TimeOps<Time>::not_after(t_from, t_at(i)); });
+}
+
+/// Pierwsza próbka z t > t_to.
+template <typename Time, typename TimeAt>
+std::size_t first_after(std::size_t n, TimeAt t_at, Time t_to)
+{
+    return partition_index(n, [&](std::size_t i) { return TimeOps<Time>::not_after(t_at(i), t_to); });
+}
+
+/// Liczba próbek okna baseline: od pierwszej, dopóki t - t0 <= window.
+/// Baseline jest gotowy, gdy to co najmniej BASELINE_MIN_SAMPLES.
+template <typename Time, typename TimeAt>
+std::size_t baseline_count(std::size_t n, TimeAt t_at, Time window)
+{
+    if (n == 0) {
+        return 0;
+    }
+    const Time t0 = t_at(0);
+    std::size_t i = 0;
+    while (i < n && !TimeOps<Time>::longer(t0, t_at(i), window)) {
+        ++i;
+    }
+    return i;
+}
+
+/// Okno ±half wokół piku: [pierwsza z t >= t_peak - half, pierwsza z
+/// t > t_peak + half). false, gdy ma mniej niż 3 próbki.
+template <typename Time, typename TimeAt>
+bool window_around(std::size_t n, TimeAt t_at, Time t_peak, Time half,
+                   std::size_t& start, std::size_t& end)
+{
+    start = first_at_or_after(n, t_at, t_peak - half);
+    end = first_after(n, t_at, t_peak + half);
+    if (end < start) {
+        end = start;
+    }
+    return end > start + 2;
+}
+
+/// Maksimum wartości od końca baseline do końca bufora wraz z numerem
+/// próbki (numer = liczba zdjętych z bufora + indeks). Pełny przegląd tylko,
+/// gdy stan jest nieważny albo pik wypadł z bufora; inaczej wystarczy nowa
+/// próbka. Przy remisie zostaje starszy pik.
+template <typename Value>
+struct RunningPeak {
+    Value value{};
+    std::uint64_t seq{0};
+    bool have{false};    // zakres niepusty
+    bool valid{false};
+
+    void invalidate() { valid = false; }
+
+    void update(Value v, std::uint64_t s)
+    {
+        if (!have || v > value) {
+            value = v;
+            seq = s;
+            have = true;
+        }
+    }
+
+    /// Po dodaniu próbki n - 1. first() – początek zakresu (liczony tylko
+    /// przy pełnym przeglądzie), last_in_range – czy nowa próbka do niego należy.
+    template <typename First, typename ValueAt>
+    void track(std::size_t n, std::uint64_t popped, bool last_in_range, First first,
+               ValueAt value_at)
+    {
+        if (!valid || (have && seq < popped)) {
+            have = false;
+            for (std::size_t i = first(); i < n; ++i) {
+                update(value_at(i), popped + i);
+            }
+            valid = true;
+        } else if (last_in_range && n > 0) {
+            update(value_at(n - 1), popped + n - 1);
+        }
+    }
+
+    /// Indeks piku w obecnym buforze (have musi być true).
+    std::size_t index(std::uint64_t popped) const { return static_cast<std::size_t>(seq - popped); }
+};
+
+template <typename Num>
+constexpr Num abs_of(Num v)
+{
+    return v < Num{} ? -v : v;
+}
+
+/// Oś dominująca wektora: 0 = X, 1 = Y, 2 = Z; przy remisie X przed Y przed Z.
+template <typename Num>
+constexpr int dominant_axis(Num x, Num y, Num z)
+{
+    const Num ax = abs_of(x);
+    const Num ay = abs_of(y);
+    const Num az = abs_of(z);
+    if (ax >= ay && ax >= az) {
+        return 0;
+    }
+    if (ay >= ax && ay >= az) {
+        return 1;
+    }
+    return 2;
+}
+
+struct Translation {
+    int axis{0};          // 0 = X, 1 = Y, 2 = Z
+    bool positive{true};
+    GestureDirection direction{GestureDirection::Up};
+
+    char axis_char() const { return static_cast<char>('X' + axis); }
+    char sign_char() const { return positive ? '+' : '-'; }
+};
+
+/// Ruch posuwisty z Δv: oś dominująca i jej znak. false, gdy |Δv| na tej
+/// osi < min_axis_velocity.
+template <typename Num>
+constexpr bool translation_from_delta_v(Num x, Num y, Num z, Num min_axis_velocity,
+                                        Translation& out)
+{
+    const int axis = dominant_axis(x, y, z);
+    const Num value = axis == 0 ? x : (axis == 1 ? y : z);
+    if (abs_of(value) < min_axis_velocity) {
+        return false;
+    }
+    constexpr GestureDirection DIRS[3][2] = {
+        {GestureDirection::Down, GestureDirection::Up},
+        {GestureDirection::Backward, GestureDirection::Forward},
+        {GestureDirection::Left, GestureDirection::Right},
+    };
+    out.axis = axis;
+    out.positive = value >= Num{};
+    out.direction = DIRS[axis][out.positive ? 1 : 0];
+    return true;
+}
+
+} // namespace peak_window
+
+} // namespace bno
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "bno/imu_csv.hpp"
+
+namespace bno {
+
+/// Tryb wyjścia imu_read.
+///  - Event:  wiersz na każdy raport (stan pozostałych kanałów = ostatni znany),
+///            czas = czas próbki z SH-2.
+///  - Hold:   stała siatka `rate_hz`, wartości z ostatniego raportu przed
+///            punktem siatki (zero-order hold). Bez dodatkowego opóźnienia.
+///  - Linear: stała siatka, accel/gyro interpolowane liniowo, kwaternion
+///            SLERP-em między sąsiednimi raportami tego samego kanału.
+///            Punkt siatki wychodzi, gdy każdy aktywny kanał ma już raport
+///            za nim (opóźnienie ~ jeden okres raportu).
+enum class ResampleMode : std::uint8_t {
+    Event,
+    Hold,
+    Linear,
+};
+
+enum class ImuChannel : std::uint8_t {
+    Accel,
+    Gyro,
+    Quat,
+};
+
+/// Etap wyjściowy po parserze: zamienia strumień raportów (każdy kanał
+/// z własnym czasem) na wiersze ImuCsvRow. Nie alokuje pamięci.
+class ImuResampler {
+public:
+    struct Config {
+        ResampleMode mode = ResampleMode::Event;
+        double rate_hz    = 100.0;  // siatka dla Hold/Linear
+        double max_wait_s = 0.1;    // Linear: kanał bez raportu dłużej niż to
+                                    // przestaje wstrzymywać siatkę (trzymamy
+                                    // jego ostatnią wartość)
+    };
+
+    explicit ImuResampler(const Config& cfg)
+        : cfg_(cfg)
+    {}
+
+    /// Nowy raport kanału `ch` z czasu `t`; `v` ma 3 wartości (accel/gyro)
+    /// albo 4 (kwaternion w,i,j,k). `emit(const ImuCsvRow&)` dostaje gotowe wiersze.
+    template <typename Emit>
+    void push(ImuChannel ch, double t, const double* v, Emit&& emit)
+    {
+        Channel& c = channels_[static_cast<std::size_t>(ch)];
+        const std::size_t dims = (ch == ImuChannel::Quat) ? 4 : 3;
+
+        if (c.count > 0 && t < c.newest_t()) {
+            t = c.newest_t();   // raporty z jednego kanału nie cofają się w czasie
+        }
+
+        if (cfg_.mode == ResampleMode::Hold && started_) {
+            // wszystko przed t dostaje stan sprzed tego raportu
+            emit_grid_before(t, emit);
+        }
+
+        c.push(t, v, dims);
+        t_latest_ = std::max(t_latest_, t);
+
+        if (!started_) {
+            started_ = true;
+            next_k_ = 0;
+            t_grid0_ = t;
+        }
+
+        switch (cfg_.mode) {
+        case ResampleMode::Event:
+            emit(current_row(t));
+            break;
+        case ResampleMode::Hold:
+            break;
+        case ResampleMode::Linear:
+            emit_linear_ready(emit);
+            break;
+        }
+    }
+
+    std::uint64_t rows_emitted() const { return rows_; }
+
+private:
+    // Krótka historia kanału: gdy siatkę wstrzymuje wolniejszy kanał,
+    // szybszy może w tym czasie przysłać kilka raportów – interpolujemy
+    // i tak między właściwą parą.
+    static constexpr std::size_t HISTORY = 16;
+
+    struct Channel {
+        double t[HISTORY]{};
+        double v[HISTORY][4]{};
+        std::size_t head{0};    // indeks najnowszego
+        std::size_t count{0};
+
+        double newest_t() const { return t[head]; }
+        const double* newest_v() const { return v[head]; }
+
+        void push(double ts, const double* values, std::size_t dims)
+        {
+            head = (count == 0) ? 0 : (head + 1) % HISTORY;
+            t[head] = ts;
+            std::copy(values, values + dims, v[head]);
+            count = std::min(count + 1, HISTORY);
+        }
+
+        // Para (starszy, nowszy) otaczająca ts (ts < newest_t()). Przed
+        // początkiem historii – najstarsza próbka (a == b, u = 0).
+        void bracket(double ts, const double*& a, const double*& b, double& u) const
+        {
+            std::size_t newer = head;
+            for (std::size_t k = 1; k < count; ++k) {
+                const std::size_t older = (head + HISTORY - k) % HISTORY;
+                if (t[older] <= ts) {
+                    a = v[older];
+                    b = v[newer];
+                    const double span = t[newer] - t[older];
+                    u = (span > 0.0) ? (ts - t[older]) / span : 1.0;
+                    return;
+                }
+                newer = older;
+            }
+            a = b = v[newer];
+            u = 0.0;
+        }
+    };
+
+    Config cfg_;
+    Channel channels_[3];
+    bool started_{false};
+    double t_grid0_{0.0};
+    std::uint64_t next_k_{0};
+    double t_latest_{0.0};
+    std::uint64_t rows_{0};
+
+    double grid_t(std::uint64_t k) const
+    {
+        // t0 + k/rate zamiast sumowania okresów – bez dryfu
+        return t_grid0_ + static_cast<double>(k) / cfg_.rate_hz;
+    }
+
+    ImuCsvRow current_row(double t)
+    {
+        ++rows_;
+        ImuCsvRow row;   // kanał bez raportów zostaje przy wartościach domyślnych
+        row.t = t;
+        if (channels_[0].count > 0) {
+            const double* a = channels_[0].newest_v();
+            row.ax = a[0]; row.ay = a[1]; row.az = a[2];
+        }
+        if (channels_[1].count > 0) {
+            const double* g = channels_[1].newest_v();
+            row.gx = g[0]; row.gy = g[1]; row.gz = g[2];
+        }
+        if (channels_[2].count > 0) {
+            const double* q = channels_[2].newest_v();
+            row.qw = q[0]; row.qi = q[1]; row.qj = q[2]; row.qk = q[3];
+        }
+        return row;
+    }
+
+    template <typename Emit>
+    void emit_grid_before(double t, Emit& emit)
+    {
+        for (double tk = grid_t(next_k_); tk < t; tk = grid_t(++next_k_)) {
+            emit(current_row(tk));
+        }
+    }
+
+    static bool lerp3(const Channel& c, double t, double* out)
+    {
+        if (c.count == 0) {
+            return false;
+        }
+        const double* a = nullptr;
+        const double* b = nullptr;
+        double u = 0.0;
+        if (t >= c.newest_t()) {
+            std::copy(c.newest_v(), c.newest_v() + 3, out);
+            return true;
+        }
+        c.bracket(t, a, b, u);
+        for (std::size_t i = 0; i < 3; ++i) {
+            out[i] = a[i] + u * (b[i] - a[i]);
+        }
+        return true;
+    }
+
+    static bool slerp(const Channel& c, double t, double* out)
+    {
+        if (c.count == 0) {
+            return false;
+        }
+        const double* a = nullptr;
+        const double* q1 = nullptr;
+        double u = 0.0;
+        if (t >= c.newest_t()) {
+            std::copy(c.newest_v(), c.newest_v() + 4, out);
+            return true;
+        }
+        c.bracket(t, a, q1, u);
+
+        double b[4] = {q1[0], q1[1], q1[2], q1[3]};
+        double d = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+        if (d < 0.0) {
+            // q i -q to ta sama orientacja – idziemy krótszą drogą
+            d = -d;
+            for (double& x : b) {
+                x = -x;
+            }
+        }
+
+        double wa = 1.0 - u;
+        double wb = u;
+        if (d < 0.9995) {
+            const double theta = std::acos(d);
+            const double s = std::sin(theta);
+            wa = std::sin((1.0 - u) * theta) / s;
+            wb = std::sin(u * theta) / s;
+        }
+        double n2 = 0.0;
+        for (std::size_t i = 0; i < 4; ++i) {
+            out[i] = wa * a[i] + wb * b[i];
+            n2 += out[i] * out[i];
+        }
+        // przy małym kącie to nlerp – normalizujemy zawsze
+        const double inv = (n2 > 0.0) ? 1.0 / std::sqrt(n2) : 1.0;
+        for (std::size_t i = 0; i < 4; ++i) {
+            out[i] *= inv;
+        }
+        return true;
+    }
+
+    template <typename Emit>
+    void emit_linear_ready(Emit& emit)
+    {
+        // Siatkę wstrzymuje najwolniejszy aktywny kanał (poza tymi, które
+        // od max_wait_s nic nie przysłały – np. gyro wyłączone).
+        double ready = t_latest_;
+        for (const Channel& c : channels_) {
+            if (c.count > 0 && (t_latest_ - c.newest_t()) <= cfg_.max_wait_s) {
+                ready = std::min(ready, c.newest_t());
+            }
+        }
+
+        for (double tk = grid_t(next_k_); tk <= ready; tk = grid_t(++next_k_)) {
+            ImuCsvRow row;
+            row.t = tk;
+            double a[3];
+            double g[3];
+            double q[4];
+            if (lerp3(channels_[0], tk, a)) {
+                row.ax = a[0]; row.ay = a[1]; row.az = a[2];
+            }
+            if (lerp3(channels_[1], tk, g)) {
+                row.gx = g[0]; row.gy = g[1]; row.gz = g[2];
+            }
+            if (slerp(channels_[2], tk, q)) {
+                row.qw = q[0]; row.qi = q[1]; row.qj = q[2]; row.qk = q[3];
+            }
+            ++rows_;
+            emit(row);
+        }
+    }
+};
+
+} // namespace bno
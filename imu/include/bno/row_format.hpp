@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include "bno/imu_csv.hpp"
+
+namespace bno {
+
+/// Miejsca po przecinku w CSV z imu_read: 1e-6 to mniej niż rozdzielczość
+/// najdrobniejszego raportu SH-2 (Q14 ≈ 6e-5), a t ma dokładność 1 µs.
+constexpr int IMU_CSV_DECIMALS = 6;
+
+/// Bufor wyjścia tekstowego (CSV / NDJSON / linie imu_dir).
+///
+/// Liczby przez std::to_chars – bez locale i bez iostream. Bufor rośnie
+/// tylko na początku, potem jest używany ponownie, więc wiersz nie alokuje.
+/// Kilka wierszy można zebrać i wypisać jednym write_to().
+class RowFormatter {
+public:
+    explicit RowFormatter(std::size_t capacity = 16 * 1024);
+
+    void put(char c)
+    {
+        reserve_more(1);
+        buf_[size_++] = c;
+    }
+    void put(std::string_view s);
+
+    /// Stała liczba miejsc po przecinku (jak printf "%.*f").
+    void put_fixed(double v, int decimals);
+    void put_int(std::int64_t v);
+    void put_uint(std::uint64_t v);
+
+    /// Wiersz CSV imu_read (z '\n').
+    void put_imu_row(const ImuCsvRow& row, int decimals = IMU_CSV_DECIMALS);
+
+    /// "key=" + wartość, np. put_kv(" dur=", 0.25, 3) – linie imu_dir.
+    void put_kv(std::string_view key, double v, int decimals)
+    {
+        put(key);
+        put_fixed(v, decimals);
+    }
+    void put_kv(std::string_view key, std::string_view v)
+    {
+        put(key);
+        put(v);
+    }
+
+    const char* data() const { return buf_.data(); }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::string_view view() const { return {buf_.data(), size_}; }
+    void clear() { size_ = 0; }
+
+    /// Wypisz całość do `f` (fwrite + opcjonalnie fflush) i wyczyść bufor.
+    bool write_to(std::FILE* f, bool flush = true);
+
+private:
+    std::vector<char> buf_;
+    std::size_t size_{0};
+
+    void reserve_more(std::size_t n)
+    {
+        if (size_ + n > buf_.size()) {
+            grow(n);
+        }
+    }
+    void grow(std::size_t n);
+};
+
+} // namespace bno
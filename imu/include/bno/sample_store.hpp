@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace bno {
+
+/// Bufor próbek detektora w układzie SoA (float).
+///
+/// Każda kolumna to osobna, ciągła tablica, a próbki [head_, tail_) są
+/// zawsze spójnym zakresem – pętle okna idą po kilku strumieniach floatów
+/// zamiast po tablicy struktur z double. Czas zostaje w double, żeby nie
+/// tracić rozdzielczości przy długich sesjach.
+///
+/// Usuwanie z początku to tylko ++head_. Gdy zabraknie miejsca na końcu,
+/// żywe próbki są przesuwane na początek (zamortyzowane O(1)), a jeśli
+/// zajmują ponad połowę pojemności – bufor rośnie dwukrotnie.
+class SampleStore {
+public:
+    enum Column : std::size_t {
+        AX, AY, AZ,          // przyspieszenie, WORLD (m/s^2)
+        GX, GY, GZ,          // prędkość kątowa, WORLD (rad/s)
+        QW, QX, QY, QZ,      // orientacja sensora
+        DYN,                 // |a - a0| (0, dopóki nie ma bazowej grawitacji)
+        GYRO_NORM,           // |ω|
+        COLUMN_COUNT,
+    };
+
+    explicit SampleStore(std::size_t initial_capacity = 256)
+    {
+        grow(initial_capacity);
+    }
+
+    std::size_t size() const { return tail_ - head_; }
+    bool empty() const { return tail_ == head_; }
+
+    double t(std::size_t i) const { return t_[head_ + i]; }
+    double front_t() const { return t_[head_]; }
+    double back_t() const { return t_[tail_ - 1]; }
+
+    /// Wskaźnik na najstarszą próbkę kolumny; ważny dla size() elementów
+    /// do następnego push_back().
+    const float* col(Column c) const { return cols_[c].data() + head_; }
+    float* col(Column c) { return cols_[c].data() + head_; }
+
+    float at(Column c, std::size_t i) const { return cols_[c][head_ + i]; }
+
+    /// Dodaj próbkę; `values` ma COLUMN_COUNT elementów w kolejności Column.
+    void push_back(double t, const float* values)
+    {
+        if (tail_ == capacity_) {
+            make_room();
+        }
+        t_[tail_] = t;
+        for (std::size_t c = 0; c < COLUMN_COUNT; ++c) {
+            cols_[c][tail_] = values[c];
+        }
+        ++tail_;
+    }
+
+    void pop_front()
+    {
+        ++head_;
+        if (head_ == tail_) {
+            head_ = tail_ = 0;
+        }
+    }
+
+    void clear() { head_ = tail_ = 0; }
+
+private:
+    std::vector<double> t_;
+    std::array<std::vector<float>, COLUMN_COUNT> cols_;
+    std::size_t head_{0};
+    std::size_t tail_{0};
+    std::size_t capacity_{0};
+
+    void grow(std::size_t capacity)
+    {
+        capacity_ = capacity;
+        t_.resize(capacity_);
+        for (auto& c : cols_) {
+            c.resize(capacity_);
+        }
+    }
+
+    void make_room()
+    {
+        const std::size_t n = size();
+        if (n * 2 > capacity_) {
+            grow(capacity_ > 0 ? capacity_ * 2 : 256);
+        }
+        if (head_ > 0) {
+            std::memmove(t_.data(), t_.data() + head_, n * sizeof(double));
+            for (auto& c : cols_) {
+                std::memmove(c.data(), c.data() + head_, n * sizeof(float));
+            }
+            head_ = 0;
+            tail_ = n;
+        }
+    }
+};
+
+} // namespace bno
@@ -0,0 +1,183 @@
+#pragma once
+
+// Dekodowanie raportów SH-2 bez std::optional/std::string i bez alokacji –
+// wspólne dla parsera hosta (sh2_parser.cpp) i ścieżki MCU
+// (decode_sh2_readings<Num>, gesture_dir_t.hpp).
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bno/fixed_point.hpp"
+
+namespace bno {
+namespace sh2 {
+
+inline constexpr std::int16_t le_i16(const std::uint8_t* p)
+{
+    return static_cast<std::int16_t>(static_cast<std::uint16_t>(p[0] | (p[1] << 8)));
+}
+
+inline constexpr std::int32_t le_i32(const std::uint8_t* p)
+{
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(p[0]) |
+                                     (static_cast<std::uint32_t>(p[1]) << 8) |
+                                     (static_cast<std::uint32_t>(p[2]) << 16) |
+                                     (static_cast<std::uint32_t>(p[3]) << 24));
+}
+
+/// Delay raportu (jednostki 100 µs): górne 6 bitów statusu + bajt 3.
+inline constexpr std::int32_t decode_delay(const std::uint8_t* report)
+{
+    return static_cast<std::int32_t>(((report[2] >> 2) << 8) | report[3]);
+}
+
+/// Długości raportów wejściowych wg SH-2 RM (tabela raportów sensorów); 0 = nieznany.
+inline constexpr std::size_t report_length(std::uint8_t report_id)
+{
+    switch (report_id) {
+    case 0x01: return 10;  // Accelerometer
+    case 0x02: return 10;  // Gyroscope Calibrated
+    case 0x03: return 10;  // Magnetic Field Calibrated
+    case 0x04: return 10;  // Linear Acceleration
+    case 0x05: return 14;  // Rotation Vector
+    case 0x06: return 10;  // Gravity
+    case 0x07: return 16;  // Gyroscope Uncalibrated
+    case 0x08: return 12;  // Game Rotation Vector
+    case 0x09: return 14;  // Geomagnetic Rotation Vector
+    case 0x0A: return 8;   // Pressure
+    case 0x0B: return 8;   // Ambient Light
+    case 0x0C: return 6;   // Humidity
+    case 0x0D: return 6;   // Proximity
+    case 0x0E: return 6;   // Temperature
+    case 0x0F: return 16;  // Magnetic Field Uncalibrated
+    case 0x10: return 5;   // Tap Detector
+    case 0x11: return 12;  // Step Counter
+    case 0x12: return 6;   // Significant Motion
+    case 0x13: return 6;   // Stability Classifier
+    case 0x14: return 16;  // Raw Accelerometer
+    case 0x15: return 16;  // Raw Gyroscope
+    case 0x16: return 16;  // Raw Magnetometer
+    case 0x18: return 8;   // Step Detector
+    case 0x19: return 6;   // Shake Detector
+    case 0x1A: return 6;   // Flip Detector
+    case 0x1B: return 6;   // Pickup Detector
+    case 0x1C: return 6;   // Stability Detector
+    case 0x1E: return 16;  // Personal Activity Classifier
+    case 0x1F: return 6;   // Sleep Detector
+    case 0x20: return 6;   // Tilt Detector
+    case 0x21: return 6;   // Pocket Detector
+    case 0x22: return 6;   // Circle Detector
+    case 0x28: return 14;  // ARVR Stabilized Rotation Vector
+    case 0x29: return 12;  // ARVR Stabilized Game Rotation Vector
+    case 0x2A: return 14;  // Gyro Integrated Rotation Vector
+    default:   return 0;
+    }
+}
+
+/// Format Q wartości raportu (SH-2 RM, Q point); 0 = raport bez wektora.
+inline constexpr int report_q(std::uint8_t report_id)
+{
+    switch (report_id) {
+    case 0x01: return 8;    // Accelerometer, m/s²
+    case 0x04: return 8;    // Linear Acceleration, m/s²
+    case 0x02: return 9;    // Gyroscope Calibrated, rad/s
+    case 0x07: return 9;    // Gyroscope Uncalibrated, rad/s
+    case 0x08: return 14;   // Game Rotation Vector
+    default:   return 0;
+    }
+}
+
+/// Przejście po raportach wejściowych jednej ramki (kanał 3). 0xFB (Base
+/// Timestamp Reference) i 0xFA (Timestamp Rebase) ustawiają odniesienie
+/// czasu; każdy raport o znanej długości trafia do
+/// on_report(report, rlen, host_offset_us), gdzie host_offset_us = czas
+/// próbki względem odczytu ramki. on_report zwraca false, gdy wyjście jest
+/// pełne. Na nieznanym ID albo uciętym raporcie kończymy – bez długości
+/// nie wiadomo, gdzie zaczyna się następny.
+template <typename OnReport>
+void walk_reports(const std::uint8_t* data, std::size_t len, OnReport&& on_report)
+{
+    std::size_t pos = 0;
+    std::int32_t reference_delta = 0;   // 100 µs, względem odczytu ramki
+
+    while (pos < len) {
+        const std::uint8_t id = data[pos];
+        if (id == 0xFB || id == 0xFA) {
+            // 0xFB: czas raportów = odczyt - base delta
+            // 0xFA: dodatkowe przesunięcie w tej samej ramce
+            if (pos + 5 > len) {
+                return;
+            }
+            const std::int32_t delta = le_i32(&data[pos + 1]);
+            reference_delta = (id == 0xFB) ? -delta : reference_delta + delta;
+            pos += 5;
+            continue;
+        }
+
+        const std::size_t rlen = report_length(id);
+        if (rlen == 0 || pos + rlen > len) {
+            return;
+        }
+        const std::uint8_t* r = &data[pos];
+        pos += rlen;
+        if (!on_report(r, rlen, (reference_delta + decode_delay(r)) * 100)) {
+            return;
+        }
+    }
+}
+
+} // namespace sh2
+
+/// Jeden raport wektorowy SH-2 w typie Num (float albo Fixed<F>).
+///   - 0x01 / 0x04 (accel), 0x02 / 0x07 (gyro): v[0..2] = x, y, z
+///   - 0x08 (Game Rotation Vector): v[0..3] = w, x, y, z (na drucie: i, j, k, real)
+template <typename Num>
+struct Sh2Reading {
+    std::uint8_t id{0};
+    std::int32_t host_offset_us{0};   ///< jak Sh2SensorEvent::host_offset_us
+    Num v[4]{};
+};
+
+/// Odpowiednik parse_sh2_input_reports() dla raportów accel / gyro / GRV,
+/// z wartościami w typie Num: float daje dokładnie te same liczby co
+/// parser hosta, Fixed<F> – surowe Qn przesunięte do Q F, bez zaokrągleń.
+/// Inne raporty są pomijane (o ile znamy ich długość); na nieznanym ID kończymy.
+/// Pętla po ramce (sh2::walk_reports) jest ta sama co w parserze hosta.
+template <typename Num>
+std::size_t decode_sh2_readings(const std::uint8_t* data,
+                                std::size_t len,
+                                Sh2Reading<Num>* out,
+                                std::size_t max_out)
+{
+    using Ops = NumOps<Num>;
+    if (!data || !out || max_out == 0) {
+        return 0;
+    }
+
+    std::size_t n = 0;
+    sh2::walk_reports(data, len, [&](const std::uint8_t* r, std::size_t, std::int32_t offset_us) {
+        const std::uint8_t id = r[0];
+        const int q = sh2::report_q(id);
+        if (q == 0) {
+            return true;
+        }
+        Sh2Reading<Num>& o = out[n++];
+        o.id = id;
+        o.host_offset_us = offset_us;
+        if (id == 0x08) {
+            o.v[0] = Ops::from_q(sh2::le_i16(&r[10]), q);
+            o.v[1] = Ops::from_q(sh2::le_i16(&r[4]), q);
+            o.v[2] = Ops::from_q(sh2::le_i16(&r[6]), q);
+            o.v[3] = Ops::from_q(sh2::le_i16(&r[8]), q);
+        } else {
+            o.v[0] = Ops::from_q(sh2::le_i16(&r[4]), q);
+            o.v[1] = Ops::from_q(sh2::le_i16(&r[6]), q);
+            o.v[2] = Ops::from_q(sh2::le_i16(&r[8]), q);
+            o.v[3] = Num{};
+        }
+        return n < max_out;
+    });
+    return n;
+}
+
+} // namespace bno
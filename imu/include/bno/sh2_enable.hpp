@@ -1,84 +1,65 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "bno/shtp.hpp"      // transport
 #include "bno/sh2_reports.hpp"
 
 namespace bno {
 
 // Set Feature Command ID
-constexpr uint8_t SHTP_REPORT_SET_FEATURE_CMD = 0xFD;
-
-// Funkcja pomocnicza: send SET_FEATURE command
-inline bool sh2_set_feature(
-        ShtpI2cTransport& transport,
-        Sh2SensorId sensorId,
-        uint16_t interval_us,    // period = 1e6 / hz
-        ShtpError& err)
+constexpr std::uint8_t SHTP_REPORT_SET_FEATURE_CMD = 0xFD;
+// Force Sensor Flush (SH-2 RM): raporty z FIFO czujnika idą od razu,
+// na końcu Flush Completed (0xEF) na kanale kontrolnym
+constexpr std::uint8_t SHTP_REPORT_FORCE_FLUSH = 0xF0;
+
+/// Set Feature Command dla raportu `sensor` z okresem 1/hz (kanał kontrolny
+/// SH-2). Wspólne dla imu_read, imu_dir i imu_daemon. hz = 0 wyłącza raport.
+/// batch_interval_us > 0 pozwala czujnikowi zbierać raporty w FIFO (host
+/// budzi się rzadziej), aż do Force Flush albo raportu budzącego.
+inline bool enable_sensor_report(ShtpTransport& transport,
+                                 Sh2SensorId sensor,
+                                 int hz,
+                                 ShtpError& err,
+                                 std::uint8_t flags = 0,
+                                 std::uint32_t batch_interval_us = 0)
 {
-    uint8_t payload[17] = {};
-
-    payload[0]  = SHTP_REPORT_SET_FEATURE_CMD;  // raport 0xFD
-    payload[1]  = static_cast<uint8_t>(sensorId);                     // sensor ID
-    payload[2]  = 0;                             // feature flags LSB
-    payload[3]  = 0;                             // feature flags MSB
-
-    // report interval w mikrosekundach
-    payload[4]  = static_cast<uint8_t>(interval_us) & 0xFF;
-    payload[5]  = (static_cast<uint8_t>(interval_us) >> 8) & 0xFF;
-    payload[6]  = 0;
-    payload[7]  = 0;
-
-    // batch interval = 0
-    payload[8]  = 0;
-    payload[9]  = 0;
-    payload[10] = 0;
-    payload[11] = 0;
-
-    // sensor-specific config (unused)
-    payload[12] = payload[13] = payload[14] = payload[15] = payload[16] = 0;
-
-    bool ok = transport.write_frame(
-        ShtpChannel::Control,
-        payload,
-        sizeof(payload),
-        err
-    );
-
-    return ok;
+    const auto interval_us = hz > 0 ? static_cast<std::uint32_t>(1'000'000 / hz) : 0u;
+
+    std::uint8_t buf[32];
+    std::size_t len = 0;
+    if (!build_enable_report_command(sensor, interval_us, buf, len, sizeof(buf), flags,
+                                     batch_interval_us)) {
+        err.code = ShtpError::Code::Unknown;
+        err.message = "build_enable_report_command failed";
+        return false;
+    }
+    return transport.write_frame(ShtpChannel::Control, buf, len, err);
 }
 
-
-// Enable Accelerometer (raw accel)
-inline bool enable_report_accel(
-    ShtpI2cTransport& transport,
-    int hz,
-    ShtpError& err)
+/// Force Sensor Flush: zebrane w FIFO raporty `sensor` przychodzą od razu.
+inline bool flush_sensor_reports(ShtpTransport& transport, Sh2SensorId sensor, ShtpError& err)
 {
-    const int period_us = 1000000 / hz;
+    const std::uint8_t cmd[2] = {SHTP_REPORT_FORCE_FLUSH, static_cast<std::uint8_t>(sensor)};
+    return transport.write_frame(ShtpChannel::Control, cmd, sizeof(cmd), err);
+}
 
-    return sh2_set_feature(
-        transport,
-        Sh2SensorId::LinearAcceleration,       // from sh2_reports.hpp
-        static_cast<uint16_t>(period_us),
-        err
-    );
+inline bool disable_sensor_report(ShtpTransport& transport, Sh2SensorId sensor, ShtpError& err)
+{
+    return enable_sensor_report(transport, sensor, 0, err);
 }
 
+// Enable Linear Acceleration (bez grawitacji – tego używa imu_dir)
+inline bool enable_report_accel(ShtpTransport& transport, int hz, ShtpError& err)
+{
+    return enable_sensor_report(transport, Sh2SensorId::LinearAcceleration, hz, err);
+}
 
 // Enable Game Rotation Vector (quaternion)
-inline bool enable_report_game_rv(
-    ShtpI2cTransport& transport,
-    int hz,
-    ShtpError& err)
+inline bool enable_report_game_rv(ShtpTransport& transport, int hz, ShtpError& err)
 {
-    const int period_us = 1000000 / hz;
-
-    return sh2_set_feature(
-        transport,
-        Sh2SensorId::GameRotationVector,  // from sh2_reports.hpp
-        static_cast<uint16_t>(period_us),
-        err
-    );
+    return enable_sensor_report(transport, Sh2SensorId::GameRotationVector, hz, err);
 }
 
 } // namespace bno
@@ -18,8 +18,13 @@ enum class Sh2SensorId : std::uint8_t {
     GyroscopeCalibrated    = 0x02,
     LinearAcceleration     = 0x04,
     Gravity                = 0x06,
+    GyroscopeUncalibrated  = 0x07,
     GameRotationVector     = 0x08,
 
+    // zdarzenia liczone w czujniku – budzenie z trybu idle (imu_dir --idle-after)
+    TapDetector            = 0x10,
+    SignificantMotion      = 0x12,
+
     // opcjonalne statusowe (na później):
     StepDetector           = 0x18,
     StepCounter            = 0x11,
@@ -55,6 +60,9 @@ enum class Sh2Accuracy : std::uint8_t {
 struct Sh2SensorEvent {
     Sh2SensorId sensor_id{};
     std::uint32_t timestamp_us{0};  ///< dla większości raportów przetworzonych = 0
+    /// Czas próbki względem chwili odczytu ramki (µs, zwykle ujemny):
+    /// delay raportu + base delta z 0xFB/0xFA. Wypełnia parse_sh2_input_reports().
+    std::int32_t host_offset_us{0};
     Sh2Accuracy accuracy{Sh2Accuracy::Unreliable};
 
     // Dane numeryczne:
@@ -68,6 +76,10 @@ struct Sh2SensorEvent {
     std::optional<std::uint32_t> steps_total;
     std::optional<bool> step_event;
     std::optional<std::string> stability_state;
+
+    // Zdarzenia budzące:
+    std::optional<std::uint8_t> tap_flags;  ///< Tap Detector: bity osi/znaku, 0x40 = double tap
+    bool significant_motion{false};         ///< Significant Motion (one-shot, trzeba włączyć ponownie)
 };
 
 /// Dekoder SH-2 z payloadu SHTP → Sh2SensorEvent.
@@ -75,22 +87,47 @@ struct Sh2SensorEvent {
 ///   0x01 – Accelerometer (Q8, m/s^2)
 ///   0x04 – Linear Acceleration (Q8, m/s^2)
 ///   0x02 – Gyroscope Calibrated (Q9, rad/s)
+///   0x07 – Gyroscope Uncalibrated (Q9, rad/s, bez odjętego biasu) → gyro
 ///   0x08 – Game Rotation Vector (kwaternion Q14) :contentReference[oaicite:3]{index=3}
+///   0x10 – Tap Detector → tap_flags
+///   0x12 – Significant Motion → significant_motion
 std::optional<Sh2SensorEvent> parse_sh2_sensor_event(const std::uint8_t* data,
                                                      std::size_t len);
 
+/// Długość raportu wejściowego SH-2 po jego ID (0 = nieznany).
+std::size_t sh2_report_length(std::uint8_t report_id);
+
+/// Wszystkie raporty z jednego payloadu SHTP. Kanał 3 niesie zwykle kilka
+/// raportów naraz, poprzedzonych 0xFB (Base Timestamp Reference) i
+/// ewentualnie 0xFA (Timestamp Rebase). Dla każdego zdekodowanego raportu
+/// liczymy host_offset_us = (delay - base_delta [+ rebase]) * 100 µs.
+/// Raporty nieobsługiwane przez parse_sh2_sensor_event() są pomijane
+/// (o ile znamy ich długość); na nieznanym ID kończymy.
+/// Zwraca liczbę zapisanych do `out` (maks. `max_out`).
+std::size_t parse_sh2_input_reports(const std::uint8_t* data,
+                                    std::size_t len,
+                                    Sh2SensorEvent* out,
+                                    std::size_t max_out);
+
+/// Feature flags w Set Feature: bit 2 – raport budzący (idzie kanałem 4,
+/// wake input, także gdy host uśpił raporty zwykłe).
+constexpr std::uint8_t SH2_FEATURE_WAKE_UP = 0x04;
+
 /// Zbuduj komendę "Set Feature" (0xFD) dla danego raportu.
 /// Wg SH-2: Set Feature Command = 0xFD + Common Dynamic Feature Report. :contentReference[oaicite:4]{index=4}
 ///   - featureReportId   = report ID (np. 0x04 dla Linear Accel)
-///   - featureFlags      = 0 (non-wakeup)
+///   - featureFlags      = `flags` (domyślnie 0 – non-wakeup)
 ///   - changeSensitivity = 0
-///   - reportInterval    = interval_us (uint32 LE)
-///   - batchInterval     = 0
+///   - reportInterval    = interval_us (uint32 LE; 0 wyłącza raport)
+///   - batchInterval     = batch_interval_us (0 = raport od razu; inaczej
+///                         czujnik może trzymać go w FIFO tyle µs)
 ///   - sensorConfigWord  = 0
 bool build_enable_report_command(Sh2SensorId sensor,
                                  std::uint32_t interval_us,
                                  std::uint8_t* out_buf,
                                  std::size_t& out_len,
-                                 std::size_t max_len);
+                                 std::size_t max_len,
+                                 std::uint8_t flags = 0,
+                                 std::uint32_t batch_interval_us = 0);
 
 } // namespace bno
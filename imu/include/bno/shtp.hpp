@@ -76,6 +76,8 @@ public:
     virtual bool is_open() const noexcept = 0;
 };
 
+class GpioInterrupt;
+
 /// Implementacja SHTP przez Linux i2c-dev (`/dev/i2c-N`).
 /// Zaprojektowana pod Raspberry Pi 3, zgodnie z notami Adafruit
 /// rekomendującymi 400 kHz I2C dla BNO08x. :contentReference[oaicite:0]{index=0}
@@ -101,12 +103,18 @@ public:
     /// Ustaw maksymalny rozmiar ramki (łącznie z nagłówkiem).
     void set_max_frame_size(std::size_t bytes) { max_frame_size_ = bytes; }
 
+    /// Linia H_INTN (nullptr = bez niej). Z linią read_frame() czeka na nią
+    /// do timeout_ms i czyta szynę dopiero, gdy czujnik ma ramkę.
+    /// Obiekt musi żyć dłużej niż transport.
+    void set_interrupt(GpioInterrupt* irq) { irq_ = irq; }
+
 private:
     int fd_{-1};
     std::uint8_t addr_{0};
     std::array<std::uint8_t, SHTP_MAX_FRAME> rx_buf_{};
     std::array<std::uint8_t, SHTP_MAX_FRAME> tx_buf_{};
     std::size_t max_frame_size_{SHTP_MAX_FRAME};
+    GpioInterrupt* irq_{nullptr};
 
     std::array<std::uint8_t, 8> sequence_per_channel_{}; // sequence++ per channel
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bno/imu_csv.hpp"
+#include "bno/shtp.hpp"
+
+namespace bno {
+
+/// Transport SHTP odtwarzający nagranie imu_read (CSV / .imlog) bez I2C.
+///
+/// Każdy wiersz to jedna ramka kanału 3, jak z BNO085 przy włączonych
+/// raportach: 0xFB (base delta 0) + Game Rotation Vector (Q14) + Gyroscope
+/// Calibrated (Q9) + Linear Acceleration (Q8). Akcelerometr idzie ostatni,
+/// więc czytelnik ma już kwaternion i gyro tej próbki. Wartości są
+/// kwantowane tak samo jak w czujniku, więc parser i detektor widzą
+/// to, co zobaczyłyby z prawdziwego urządzenia.
+///
+/// speed = 0 – ramki bez czekania (PGO, testy); 1 – tempo nagrania.
+/// write_frame() przyjmuje i ignoruje komendy (Set Feature itd.).
+class ShtpReplayTransport final : public ShtpTransport {
+public:
+    struct Config {
+        double speed = 1.0;
+        bool loop = false;
+    };
+
+    ShtpReplayTransport() = default;
+    explicit ShtpReplayTransport(const Config& cfg) : cfg_(cfg) {}
+
+    /// Wczytaj nagranie (read_imu_samples). Pusty plik to też błąd.
+    bool open(const std::string& path, ShtpError& err);
+    /// Odtwarzaj gotowe wiersze (np. syntetyczne).
+    void open_rows(std::vector<ImuCsvRow> rows);
+
+    bool is_open() const noexcept override { return !rows_.empty(); }
+
+    /// Następna ramka; std::nullopt bez błędu = timeout albo koniec nagrania.
+    std::optional<ShtpFrame> read_frame(ShtpError& err, int timeout_ms) override;
+    bool write_frame(ShtpChannel channel,
+                     const std::uint8_t* data,
+                     std::size_t len,
+                     ShtpError& err) override;
+
+    /// Koniec nagrania (bez Config::loop).
+    bool finished() const { return !cfg_.loop && pos_ >= rows_.size(); }
+    /// Czas nagrania (s) wiersza z ostatniej ramki; przy loop rośnie dalej.
+    double frame_time() const { return frame_t_; }
+    std::uint64_t frames_sent() const { return frames_sent_; }
+
+private:
+    Config cfg_{};
+    std::vector<ImuCsvRow> rows_;
+    std::size_t pos_{0};
+    double t_offset_{0.0};       // przesunięcie czasu kolejnych przebiegów (loop)
+    double frame_t_{0.0};
+    std::uint64_t frames_sent_{0};
+    std::uint8_t sequence_{0};
+    std::chrono::steady_clock::time_point wall_start_{};
+};
+
+/// Payload kanału 3 z jednym wierszem nagrania (format opisany wyżej).
+void encode_sh2_input_payload(const ImuCsvRow& row, std::uint8_t report_seq,
+                              std::vector<std::uint8_t>& out);
+
+} // namespace bno
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"   // Vec3, Quat
+#include "bno/shtp.hpp"
+
+namespace bno {
+
+/// Grupa jednakowych urządzeń ze scenariusza symulacji.
+struct SimDeviceConfig {
+    std::size_t count = 1;
+
+    // Raporty, które host włącza (Set Feature) – symulator wysyła tylko to,
+    // co włączono, z okresem z komendy. 0 = host nie włącza.
+    int accel_hz = 100;             // Linear Acceleration
+    int gyro_hz = 100;              // Gyroscope Calibrated
+    int grv_hz = 100;               // Game Rotation Vector
+
+    std::size_t batch = 1;          // raportów w jednej ramce (0xFB + delay na raport)
+
+    // Ruch: spoczynek z szumem i co gesture_every_s impuls start-stop
+    // wzdłuż losowej osi świata; orientacja urządzenia losowa, stała.
+    double gesture_every_s = 2.0;   // 0 = sam spoczynek
+    double gesture_peak = 8.0;      // m/s²
+    double noise = 0.05;            // σ szumu a (m/s²) i ω (rad/s)
+
+    // Błędy – prawdopodobieństwo na ramkę
+    double corrupt = 0.0;           // jeden losowy bajt payloadu zmieniony
+    double truncate = 0.0;          // payload ucięty w losowym miejscu
+    double drop = 0.0;              // ramka zgubiona bez śladu
+    double io_error = 0.0;          // read_frame() zwraca IoError, ramka stracona
+    double reset_every_s = 0.0;     // reset czujnika: ramka "reset complete", raporty wyłączone
+};
+
+/// Scenariusz: parametry przebiegu i grupy urządzeń.
+///
+/// Plik tekstowy, jedna dyrektywa na linię, `#` – komentarz:
+///
+///     duration 30          # s czasu wirtualnego na urządzenie
+///     speed 0              # 0 = najszybciej, 1 = czas rzeczywisty
+///     seed 7
+///     threads 4            # wątki akwizycji (imu_sim_stress)
+///     device count=200 accel=100 gyro=200 grv=100 batch=4
+///     device count=8 accel=400 corrupt=0.01 truncate=0.001 reset_every=5
+///
+/// Klucze `device` to pola SimDeviceConfig: count, accel, gyro, grv, batch,
+/// gesture_every, gesture_peak, noise, corrupt, truncate, drop, io_error,
+/// reset_every.
+struct SimScenario {
+    double duration_s = 10.0;
+    double speed = 0.0;
+    std::uint64_t seed = 1;
+    unsigned threads = 1;
+    std::vector<SimDeviceConfig> groups;
+
+    std::size_t device_count() const;
+    /// Konfiguracja urządzenia o numerze `index` (0..device_count()-1).
+    const SimDeviceConfig& device(std::size_t index) const;
+};
+
+bool parse_sim_scenario(std::string_view text, SimScenario& out, std::string& err);
+bool load_sim_scenario(const std::string& path, SimScenario& out, std::string& err);
+
+/// Deterministyczny, wirtualny BNO08x za interfejsem ShtpTransport.
+///
+/// Czas jest wirtualny: ramki powstają w kolejności czasu raportów, a ruch,
+/// szum i błędy biorą się z generatora o ziarnie `seed` – ten sam scenariusz
+/// daje te same bajty. Przy speed > 0 read_frame() wydaje ramki w tempie
+/// zegara ściennym (jak ShtpReplayTransport), przy speed = 0 od razu.
+///
+/// Symulator odpowiada na to, co host pisze:
+///   - Set Feature (0xFD, kanał 2) ustawia okres raportu, 0 go wyłącza;
+///     obsługiwane: Linear Acceleration, Gyroscope Calibrated, Game Rotation
+///     Vector oraz Tap Detector i Significant Motion (kanał 4, na początku
+///     każdego gestu; Significant Motion jest one-shot),
+///   - reset (0x01 na kanale 1) – jak reset_every_s.
+/// Po resecie przychodzi ramka kanału 1 z 0x01 (reset complete) i żaden
+/// raport nie jest włączony – host musi je włączyć ponownie.
+class ShtpSimTransport final : public ShtpTransport {
+public:
+    struct Stats {
+        std::uint64_t frames{0};
+        std::uint64_t reports{0};
+        std::uint64_t corrupted{0};
+        std::uint64_t truncated{0};
+        std::uint64_t dropped{0};
+        std::uint64_t io_errors{0};
+        std::uint64_t resets{0};
+        std::uint64_t commands{0};
+        std::uint64_t gestures{0};     // impulsy ruchu, które już się zaczęły
+    };
+
+    ShtpSimTransport(const SimDeviceConfig& cfg, std::uint64_t seed, double speed = 0.0);
+
+    std::optional<ShtpFrame> read_frame(ShtpError& err, int timeout_ms) override;
+    bool write_frame(ShtpChannel channel,
+                     const std::uint8_t* data,
+                     std::size_t len,
+                     ShtpError& err) override;
+    bool is_open() const noexcept override { return true; }
+
+    /// Czas wirtualny (s) ostatniej wydanej ramki.
+    double frame_time() const { return frame_t_; }
+    /// Czas wirtualny, do którego urządzenie wygenerowało dane.
+    double now() const { return now_; }
+    const SimDeviceConfig& config() const { return cfg_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    enum Slot : std::size_t { GRV, GYRO, ACCEL, TAP, SIG_MOTION, SLOT_COUNT };
+
+    struct Report {
+        std::uint32_t interval_us{0};   // 0 = wyłączony
+        double next_t{0.0};
+        std::uint8_t seq{0};
+    };
+
+    SimDeviceConfig cfg_;
+    std::mt19937_64 rng_;
+    double speed_;
+    std::chrono::steady_clock::time_point wall_start_{};
+    bool wall_started_{false};
+
+    double now_{0.0};
+    double frame_t_{0.0};
+    std::array<Report, SLOT_COUNT> reports_{};
+    std::array<std::uint8_t, 8> channel_seq_{};
+    double next_reset_t_{0.0};
+
+    // ruch: orientacja stała; gest k – czas startu i oś z hasha (gesture_seed_, k),
+    // więc harmonogram nie zależy od tego, które raporty host włączył
+    Quat orientation_{};
+    std::uint64_t gesture_seed_{0};
+
+    std::optional<ShtpFrame> ready_;    // gotowa ramka czekająca na swój czas (speed > 0)
+    double ready_t_{0.0};
+    std::vector<std::pair<Slot, double>> picks_;   // raporty bieżącej ramki
+    Stats stats_{};
+
+    double gesture_start(std::uint64_t k) const;
+    Vec3 gesture_axis(std::uint64_t k) const;
+    std::uint64_t first_gesture_at_or_after(double t) const;
+    Vec3 world_accel(double t) const;
+    void schedule_wake(Slot slot, double after);
+    void reset_device(double t);
+    bool build_frame(ShtpFrame& frame, double& t_frame, double horizon);
+    void put_report(std::vector<std::uint8_t>& out, Slot slot, double t, double t_first);
+    bool apply_faults(ShtpFrame& frame, ShtpError& err);
+};
+
+} // namespace bno
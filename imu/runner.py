@@ -1,9 +1,32 @@
 import argparse
+import socket
 import subprocess
 import time
 import os
 from datetime import datetime
 
+def record_from_daemon(sock_path, out_path, seconds):
+    """SUB raw do imu_daemon i zapis linii CSV przez `seconds` sekund."""
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock, open(out_path, "wb") as out:
+        sock.connect(sock_path)
+        sock.sendall(b"SUB raw\n")
+        sock.settimeout(0.2)
+        end = time.monotonic() + seconds
+        tail = b""
+        while time.monotonic() < end:
+            try:
+                chunk = sock.recv(65536)
+            except socket.timeout:
+                continue
+            if not chunk:
+                break
+            # tylko pełne linie – plik zawsze kończy się na '\n'
+            data = tail + chunk
+            cut = data.rfind(b"\n") + 1
+            out.write(data[:cut])
+            tail = data[cut:]
+
+
 def main():
     parser = argparse.ArgumentParser(description="Odpal ./build/imu_read X razy z różnymi plikami wyjściowymi.")
     parser.add_argument(
@@ -19,6 +42,12 @@ def main():
         help="Ile razy powtórzyć cykl"
     )
 
+    parser.add_argument(
+        "--daemon",
+        metavar="SOCK",
+        help="Nagrywaj z działającego imu_daemon (gniazdo Unix) zamiast odpalać imu_read"
+    )
+
     args = parser.parse_args()
 
     # Tworzymy folder data + datetime
@@ -32,31 +61,36 @@ def main():
         index = i + 1
         out_path = f"{base_dir}/{args.direction}{index}.csv"
 
-        cmd = [
-            "./build/imu_read",
-            "--bus", "1",
-            "--addr", "0x4A",
-            "--hz", "100",
-            "--timeout-ms", "50",
-            "--out", out_path
-        ]
+        if args.daemon:
+            # demon już trzyma czujnik – nagranie to tylko subskrypcja
+            print(f"[{index}/{args.count}] Nagrywanie z {args.daemon} -> {out_path}")
+            record_from_daemon(args.daemon, out_path, 4.0)
+        else:
+            cmd = [
+                "./build/imu_read",
+                "--bus", "1",
+                "--addr", "0x4A",
+                "--hz", "100",
+                "--timeout-ms", "50",
+                "--out", out_path
+            ]
 
-        print(f"[{index}/{args.count}] Start: {' '.join(cmd)}")
+            print(f"[{index}/{args.count}] Start: {' '.join(cmd)}")
 
-        # start programu
-        proc = subprocess.Popen(cmd)
+            # start programu
+            proc = subprocess.Popen(cmd)
 
-        # działa 2 sekundy
-        time.sleep(4)
+            # działa 2 sekundy
+            time.sleep(4)
 
-        # zamykanie jeśli nadal działa
-        if proc.poll() is None:
-            print("  → Zamykanie procesu...")
-            proc.terminate()
-            time.sleep(0.5)
+            # zamykanie jeśli nadal działa
             if proc.poll() is None:
-                print("  → Kill procesu...")
-                proc.kill()
+                print("  → Zamykanie procesu...")
+                proc.terminate()
+                time.sleep(0.5)
+                if proc.poll() is None:
+                    print("  → Kill procesu...")
+                    proc.kill()
 
         print("  → Czekam 2 sekundy...\n")
         time.sleep(2)
@@ -0,0 +1,564 @@
+#include "bno/async_writer.hpp"
+#include "bno/log.hpp"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+namespace bno {
+
+#ifdef HAVE_LIBURING
+struct AsyncFileWriter::UringState {
+    io_uring ring;
+};
+#else
+struct AsyncFileWriter::UringState {};
+#endif
+
+namespace {
+
+constexpr std::size_t MAX_IOV = 64;
+
+bool pwrite_all(int fd, const unsigned char* p, std::size_t len, std::uint64_t off)
+{
+    while (len > 0) {
+        const ssize_t n = ::pwrite(fd, p, len, static_cast<off_t>(off));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        len -= static_cast<std::size_t>(n);
+        off += static_cast<std::uint64_t>(n);
+    }
+    return true;
+}
+
+void update_max(std::atomic<std::uint64_t>& m, std::uint64_t v)
+{
+    std::uint64_t cur = m.load(std::memory_order_relaxed);
+    while (v > cur && !m.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+// ---------- IndexRing ----------
+
+void AsyncFileWriter::IndexRing::reset(std::size_t capacity)
+{
+    slots.assign(capacity, 0);
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+}
+
+bool AsyncFileWriter::IndexRing::push(std::uint32_t v)
+{
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    const std::size_t next = (h + 1) % slots.size();
+    if (next == tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    slots[h] = v;
+    head.store(next, std::memory_order_release);
+    return true;
+}
+
+bool AsyncFileWriter::IndexRing::pop(std::uint32_t& v)
+{
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    v = slots[t];
+    tail.store((t + 1) % slots.size(), std::memory_order_release);
+    return true;
+}
+
+std::size_t AsyncFileWriter::IndexRing::size() const
+{
+    const std::size_t h = head.load(std::memory_order_acquire);
+    const std::size_t t = tail.load(std::memory_order_acquire);
+    return (h + slots.size() - t) % slots.size();
+}
+
+// ---------- AsyncFileWriter ----------
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    std::string err;
+    close(err);
+}
+
+bool AsyncFileWriter::open(const std::string& path, const AsyncWriterConfig& cfg, std::string& err)
+{
+    if (is_open()) {
+        err = "async_writer: already open";
+        return false;
+    }
+    if (cfg.buffer_count < 2 || cfg.buffer_count > 1024 || cfg.buffer_bytes == 0) {
+        err = "async_writer: need 2..1024 buffers of non-zero size";
+        return false;
+    }
+
+    buffer_bytes_ = (cfg.buffer_bytes + ASYNC_WRITER_ALIGN - 1) / ASYNC_WRITER_ALIGN
+                    * ASYNC_WRITER_ALIGN;
+
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    direct_ = false;
+    if (cfg.direct_io) {
+        fd_ = ::open(path.c_str(), flags | O_DIRECT, 0644);
+        direct_ = (fd_ >= 0);
+    }
+    if (fd_ < 0) {
+        // tmpfs itp. nie znają O_DIRECT – zapis przez page cache
+        fd_ = ::open(path.c_str(), flags, 0644);
+    }
+    if (fd_ < 0) {
+        err = "async_writer: open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    buffers_.assign(cfg.buffer_count, Buffer{});
+    for (auto& b : buffers_) {
+        b.data = static_cast<unsigned char*>(std::aligned_alloc(ASYNC_WRITER_ALIGN, buffer_bytes_));
+        if (b.data == nullptr) {
+            release_buffers();
+            ::close(fd_);
+            fd_ = -1;
+            err = "async_writer: out of memory";
+            return false;
+        }
+    }
+
+    free_.reset(buffers_.size() + 1);
+    filled_.reset(buffers_.size() + 1);
+    for (std::size_t i = 0; i < buffers_.size(); ++i) {
+        free_.push(static_cast<std::uint32_t>(i));
+    }
+    cur_ = NO_BUFFER;
+    offset_ = 0;
+
+    stop_.store(false);
+    io_error_.store(false);
+    last_errno_.store(0);
+    bytes_accepted_.store(0);
+    overruns_.store(0);
+    bytes_dropped_.store(0);
+    queue_depth_.store(0);
+    queue_depth_max_.store(0);
+    bytes_written_.store(0);
+    batches_.store(0);
+    buffers_written_.store(0);
+    write_us_max_.store(0);
+    write_us_total_.store(0);
+
+#ifdef HAVE_LIBURING
+    if (cfg.use_io_uring) {
+        uring_ = new UringState;
+        if (io_uring_queue_init(static_cast<unsigned>(buffers_.size()), &uring_->ring, 0) < 0) {
+            // stare jądro albo seccomp – zostaje pwritev
+            delete uring_;
+            uring_ = nullptr;
+        }
+    }
+#endif
+
+    thread_ = std::thread([this] { writer_loop(); });
+    return true;
+}
+
+const char* AsyncFileWriter::backend_name() const
+{
+    return (uring_ != nullptr) ? "io_uring" : "pwritev";
+}
+
+bool AsyncFileWriter::take_free_buffer()
+{
+    std::uint32_t i = 0;
+    if (!free_.pop(i)) {
+        return false;
+    }
+    cur_ = i;
+    buffers_[i].len = 0;
+    buffers_[i].offset = offset_;
+    return true;
+}
+
+void AsyncFileWriter::submit_current()
+{
+    filled_.push(cur_);   // pojemność = liczba buforów, zawsze się mieści
+    cur_ = NO_BUFFER;
+
+    const std::uint32_t depth = queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+    std::uint32_t prev = queue_depth_max_.load(std::memory_order_relaxed);
+    while (depth > prev &&
+           !queue_depth_max_.compare_exchange_weak(prev, depth, std::memory_order_relaxed)) {
+    }
+
+    submitted_.fetch_add(1, std::memory_order_release);
+    submitted_.notify_one();
+}
+
+bool AsyncFileWriter::append(const void* data, std::size_t len)
+{
+    return append_impl(data, len, false);
+}
+
+bool AsyncFileWriter::append_wait(const void* data, std::size_t len)
+{
+    // po kawałku, żeby nigdy nie potrzebować więcej buforów, niż jest w puli
+    const auto* p = static_cast<const unsigned char*>(data);
+    while (len > 0) {
+        const std::size_t n = std::min(len, buffer_bytes_);
+        if (!append_impl(p, n, true)) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool AsyncFileWriter::append_impl(const void* data, std::size_t len, bool wait)
+{
+    if (!is_open() || io_error_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (len == 0) {
+        return true;
+    }
+
+    const std::size_t room = (cur_ != NO_BUFFER) ? buffer_bytes_ - buffers_[cur_].len : 0;
+    if (len > room) {
+        const std::size_t need = (len - room + buffer_bytes_ - 1) / buffer_bytes_;
+        for (;;) {
+            const std::uint32_t seen = completed_.load(std::memory_order_acquire);
+            if (free_.size() >= need) {
+                break;
+            }
+            if (!wait || need >= buffers_.size()) {
+                overruns_.fetch_add(1, std::memory_order_relaxed);
+                bytes_dropped_.fetch_add(len, std::memory_order_relaxed);
+                return false;
+            }
+            if (io_error_.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            completed_.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    const auto* src = static_cast<const unsigned char*>(data);
+    std::size_t left = len;
+    while (left > 0) {
+        if (cur_ == NO_BUFFER) {
+            take_free_buffer();   // sprawdzone wyżej
+        }
+        Buffer& b = buffers_[cur_];
+        const std::size_t n = std::min(left, buffer_bytes_ - b.len);
+        std::memcpy(b.data + b.len, src, n);
+        b.len += n;
+        src += n;
+        left -= n;
+        offset_ += n;
+        if (b.len == buffer_bytes_) {
+            submit_current();
+        }
+    }
+
+    bytes_accepted_.fetch_add(len, std::memory_order_relaxed);
+    return true;
+}
+
+void AsyncFileWriter::flush()
+{
+    if (!is_open() || cur_ == NO_BUFFER || buffers_[cur_].len == 0) {
+        return;
+    }
+    if (!direct_) {
+        submit_current();
+        return;
+    }
+
+    // O_DIRECT: oddajemy wyrównaną część, ogon przechodzi do kolejnego bufora
+    Buffer& b = buffers_[cur_];
+    const std::size_t aligned = b.len & ~(ASYNC_WRITER_ALIGN - 1);
+    const std::size_t tail = b.len - aligned;
+    if (aligned == 0) {
+        return;
+    }
+    if (tail == 0) {
+        submit_current();
+        return;
+    }
+
+    std::uint32_t next = 0;
+    if (!free_.pop(next)) {
+        return;   // wszystko w zapisie – spróbujemy przy następnym flush()
+    }
+    Buffer& nb = buffers_[next];
+    std::memcpy(nb.data, b.data + aligned, tail);
+    nb.len = tail;
+    nb.offset = b.offset + aligned;
+    b.len = aligned;
+    submit_current();
+    cur_ = next;
+}
+
+void AsyncFileWriter::writer_loop()
+{
+    std::vector<std::uint32_t> batch(buffers_.size());
+
+    for (;;) {
+        const std::uint32_t seen = submitted_.load(std::memory_order_acquire);
+
+        std::size_t n = 0;
+        std::uint32_t i = 0;
+        while (n < batch.size() && filled_.pop(i)) {
+            batch[n++] = i;
+        }
+
+        if (n == 0) {
+            if (stop_.load(std::memory_order_acquire)) {
+                if (filled_.size() == 0) {
+                    break;
+                }
+                continue;
+            }
+            submitted_.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool ok = write_batch(batch.data(), n);
+        const auto us = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - t0).count());
+
+        std::uint64_t bytes = 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            bytes += buffers_[batch[k]].len;
+        }
+        if (ok) {
+            bytes_written_.fetch_add(bytes, std::memory_order_relaxed);
+        } else {
+            last_errno_.store(errno, std::memory_order_relaxed);
+            io_error_.store(true, std::memory_order_relaxed);
+            BNO_LOG_ERROR("async_writer: write of {} buffers failed, errno={}", n, errno);
+        }
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        buffers_written_.fetch_add(n, std::memory_order_relaxed);
+        write_us_total_.fetch_add(us, std::memory_order_relaxed);
+        update_max(write_us_max_, us);
+
+        for (std::size_t k = 0; k < n; ++k) {
+            buffers_[batch[k]].len = 0;
+            free_.push(batch[k]);
+        }
+        queue_depth_.fetch_sub(static_cast<std::uint32_t>(n), std::memory_order_relaxed);
+        completed_.fetch_add(1, std::memory_order_release);
+        completed_.notify_all();
+    }
+}
+
+bool AsyncFileWriter::write_batch(const std::uint32_t* idx, std::size_t n)
+{
+    return (uring_ != nullptr) ? write_batch_uring(idx, n) : write_batch_pwrite(idx, n);
+}
+
+bool AsyncFileWriter::write_batch_pwrite(const std::uint32_t* idx, std::size_t n)
+{
+    // Bufory z kolejki mają kolejne offsety – sklejamy je w jeden pwritev.
+    std::size_t i = 0;
+    while (i < n) {
+        iovec iov[MAX_IOV];
+        std::size_t cnt = 0;
+        std::size_t total = 0;
+        const std::uint64_t off = buffers_[idx[i]].offset;
+        while (i + cnt < n && cnt < MAX_IOV &&
+               buffers_[idx[i + cnt]].offset == off + total) {
+            const Buffer& b = buffers_[idx[i + cnt]];
+            iov[cnt].iov_base = b.data;
+            iov[cnt].iov_len = b.len;
+            total += b.len;
+            ++cnt;
+        }
+
+        ssize_t w = -1;
+        do {
+            w = ::pwritev(fd_, iov, static_cast<int>(cnt), static_cast<off_t>(off));
+        } while (w < 0 && errno == EINTR);
+        if (w < 0) {
+            return false;
+        }
+
+        // krótki zapis (np. pełny dysk w trakcie) – resztę dopisujemy po kawałku
+        std::size_t done = static_cast<std::size_t>(w);
+        for (std::size_t k = 0; k < cnt && done < total; ++k) {
+            const Buffer& b = buffers_[idx[i + k]];
+            const std::size_t start = b.offset - off;
+            if (done >= start + b.len) {
+                continue;
+            }
+            const std::size_t skip = done - start;
+            if (!pwrite_all(fd_, b.data + skip, b.len - skip, b.offset + skip)) {
+                return false;
+            }
+            done = start + b.len;
+        }
+        i += cnt;
+    }
+    return true;
+}
+
+bool AsyncFileWriter::write_batch_uring(const std::uint32_t* idx, std::size_t n)
+{
+#ifdef HAVE_LIBURING
+    io_uring* ring = &uring_->ring;
+
+    std::size_t queued = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        io_uring_sqe* sqe = io_uring_get_sqe(ring);
+        if (sqe == nullptr) {
+            break;   // kolejka ma buffer_count wpisów – nie powinno się zdarzyć
+        }
+        Buffer& b = buffers_[idx[k]];
+        io_uring_prep_write(sqe, fd_, b.data, static_cast<unsigned>(b.len), b.offset);
+        io_uring_sqe_set_data(sqe, &b);
+        ++queued;
+    }
+
+    const int r = io_uring_submit_and_wait(ring, static_cast<unsigned>(queued));
+    if (r < 0) {
+        errno = -r;
+        return false;
+    }
+
+    bool ok = true;
+    for (std::size_t k = 0; k < queued; ++k) {
+        io_uring_cqe* cqe = nullptr;
+        const int w = io_uring_wait_cqe(ring, &cqe);
+        if (w < 0) {
+            errno = -w;
+            return false;
+        }
+        const Buffer* b = static_cast<const Buffer*>(io_uring_cqe_get_data(cqe));
+        const int res = cqe->res;
+        io_uring_cqe_seen(ring, cqe);
+
+        if (res < 0) {
+            errno = -res;
+            ok = false;
+        } else if (static_cast<std::size_t>(res) < b->len) {
+            const auto done = static_cast<std::size_t>(res);
+            ok = pwrite_all(fd_, b->data + done, b->len - done, b->offset + done) && ok;
+        }
+    }
+
+    // to, co nie zmieściło się w SQ, idzie zwykłą ścieżką
+    if (queued < n) {
+        ok = write_batch_pwrite(idx + queued, n - queued) && ok;
+    }
+    return ok;
+#else
+    return write_batch_pwrite(idx, n);
+#endif
+}
+
+bool AsyncFileWriter::close(std::string& err)
+{
+    if (!is_open()) {
+        return true;
+    }
+
+    if (!direct_ && cur_ != NO_BUFFER && buffers_[cur_].len > 0) {
+        submit_current();
+    }
+
+    stop_.store(true, std::memory_order_release);
+    submitted_.fetch_add(1, std::memory_order_release);
+    submitted_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    bool ok = !io_error_.load();
+    if (!ok) {
+        err = std::string("async_writer: write failed: ") + std::strerror(last_errno_.load());
+    }
+
+    // O_DIRECT: niewyrównany ogon piszemy już bez O_DIRECT
+    if (cur_ != NO_BUFFER && buffers_[cur_].len > 0) {
+        const Buffer& b = buffers_[cur_];
+        const int fl = ::fcntl(fd_, F_GETFL);
+        if (fl >= 0) {
+            ::fcntl(fd_, F_SETFL, fl & ~O_DIRECT);
+        }
+        if (pwrite_all(fd_, b.data, b.len, b.offset)) {
+            bytes_written_.fetch_add(b.len, std::memory_order_relaxed);
+        } else if (ok) {
+            err = std::string("async_writer: write failed: ") + std::strerror(errno);
+            ok = false;
+        }
+    }
+    cur_ = NO_BUFFER;
+
+    if (::fdatasync(fd_) != 0 && ok) {
+        err = std::string("async_writer: fdatasync: ") + std::strerror(errno);
+        ok = false;
+    }
+    ::close(fd_);
+    fd_ = -1;
+
+#ifdef HAVE_LIBURING
+    if (uring_ != nullptr) {
+        io_uring_queue_exit(&uring_->ring);
+    }
+#endif
+    delete uring_;
+    uring_ = nullptr;
+
+    release_buffers();
+    return ok;
+}
+
+void AsyncFileWriter::release_buffers()
+{
+    for (auto& b : buffers_) {
+        std::free(b.data);
+        b.data = nullptr;
+    }
+    buffers_.clear();
+}
+
+AsyncWriterStats AsyncFileWriter::stats() const
+{
+    AsyncWriterStats s;
+    s.bytes_accepted = bytes_accepted_.load(std::memory_order_relaxed);
+    s.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    s.overruns = overruns_.load(std::memory_order_relaxed);
+    s.bytes_dropped = bytes_dropped_.load(std::memory_order_relaxed);
+    s.batches = batches_.load(std::memory_order_relaxed);
+    s.buffers_written = buffers_written_.load(std::memory_order_relaxed);
+    s.queue_depth = queue_depth_.load(std::memory_order_relaxed);
+    s.queue_depth_max = queue_depth_max_.load(std::memory_order_relaxed);
+    s.write_us_max = write_us_max_.load(std::memory_order_relaxed);
+    s.write_us_total = write_us_total_.load(std::memory_order_relaxed);
+    s.io_error = io_error_.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace bno
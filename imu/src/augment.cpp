@@ -0,0 +1,242 @@
+#include "bno/augment.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace bno {
+
+namespace {
+
+// Baseline grawitacji – jak estimate_baseline() w dir_offline.py
+constexpr double BASELINE_S = 0.2;
+
+Quat quat_from_row(const ImuCsvRow& r)
+{
+    return Quat{r.qw, r.qi, r.qj, r.qk};
+}
+
+// Obrót o losowy kąt z [0, max_deg] wokół osi jednostajnej na sferze
+Quat random_rotation(double max_deg, std::mt19937_64& rng)
+{
+    if (max_deg <= 0.0) {
+        return Quat{};
+    }
+    std::normal_distribution<double> normal(0.0, 1.0);
+    Vec3 axis{normal(rng), normal(rng), normal(rng)};
+    const double len = norm(axis);
+    if (len < 1e-12) {
+        return Quat{};
+    }
+    std::uniform_real_distribution<double> angle(0.0, max_deg * std::numbers::pi / 180.0);
+    const double half = 0.5 * angle(rng);
+    const double s = std::sin(half) / len;
+    return Quat{std::cos(half), axis.x * s, axis.y * s, axis.z * s};
+}
+
+Vec3 random_vec(double amplitude, std::mt19937_64& rng)
+{
+    if (amplitude <= 0.0) {
+        return Vec3{};
+    }
+    std::uniform_real_distribution<double> u(-amplitude, amplitude);
+    return Vec3{u(rng), u(rng), u(rng)};
+}
+
+double random_scale(double amplitude, std::mt19937_64& rng)
+{
+    if (amplitude <= 0.0) {
+        return 1.0;
+    }
+    std::uniform_real_distribution<double> u(1.0 - amplitude, 1.0 + amplitude);
+    return u(rng);
+}
+
+} // namespace
+
+bool prepare_augment_source(std::vector<ImuCsvRow> rows, int label,
+                            AugmentSource& out, std::string& err)
+{
+    // powtórzone t (imu_read pisze linię na raport) – zostaje ostatnia próbka
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (kept > 0 && rows[i].t < rows[kept - 1].t) {
+            err = "time goes back at row " + std::to_string(i);
+            return false;
+        }
+        if (kept > 0 && rows[i].t == rows[kept - 1].t) {
+            rows[kept - 1] = rows[i];
+        } else {
+            rows[kept++] = rows[i];
+        }
+    }
+    rows.resize(kept);
+    if (rows.size() < 3) {
+        err = "too few samples (" + std::to_string(rows.size()) + ")";
+        return false;
+    }
+
+    Vec3 g{};
+    std::size_t count = 0;
+    for (const ImuCsvRow& r : rows) {
+        if (count > 0 && r.t - rows.front().t > BASELINE_S) {
+            break;
+        }
+        const Vec3 aw = rotate_vector_by_quat(Vec3{r.ax, r.ay, r.az}, quat_from_row(r));
+        g.x += aw.x;
+        g.y += aw.y;
+        g.z += aw.z;
+        ++count;
+    }
+    const double inv = 1.0 / static_cast<double>(count);
+    g = Vec3{g.x * inv, g.y * inv, g.z * inv};
+
+    double peak = -1.0;
+    double t_peak = rows.front().t;
+    for (const ImuCsvRow& r : rows) {
+        const Vec3 aw = rotate_vector_by_quat(Vec3{r.ax, r.ay, r.az}, quat_from_row(r));
+        const double m = norm(Vec3{aw.x - g.x, aw.y - g.y, aw.z - g.z});
+        if (m > peak) {
+            peak = m;
+            t_peak = r.t;
+        }
+    }
+
+    out.rows = std::move(rows);
+    out.label = label;
+    out.t_peak = t_peak;
+    out.gravity_world = g;
+    return true;
+}
+
+WindowAugmenter::WindowAugmenter(const Config& cfg)
+    : cfg_(cfg),
+      n_(static_cast<std::size_t>(std::max(1L, std::lround(cfg.rate_hz * cfg.window_s))))
+{
+    cfg_.warp_wobble = std::clamp(cfg_.warp_wobble, 0.0, 0.95);
+    cfg_.warp_speed = std::max(cfg_.warp_speed, 0.0);
+}
+
+void WindowAugmenter::generate(const AugmentSource& src, std::mt19937_64& rng,
+                               AugmentWindow& out) const
+{
+    constexpr double two_pi = 2.0 * std::numbers::pi;
+    const std::vector<ImuCsvRow>& rows = src.rows;
+    const double t_first = rows.front().t;
+    const double t_last = rows.back().t;
+    const double w = cfg_.window_s;
+    const double dt = 1.0 / cfg_.rate_hz;
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // --- 2. time warp: s(u) = s0 + speed·(u + a·W/2π·(sin(2πu/W + φ) − sin φ)) ---
+    // s'(u) = speed·(1 + a·cos(…)) > 0 dla |a| < 1 – czas nie cofa się.
+    double speed = 1.0;
+    if (cfg_.warp_speed > 0.0) {
+        const double l = std::log1p(cfg_.warp_speed);
+        speed = std::exp(l * (2.0 * unit(rng) - 1.0));
+    }
+    const double wobble = cfg_.warp_wobble * (2.0 * unit(rng) - 1.0);
+    const double phase = two_pi * unit(rng);
+    const double sin_phase = std::sin(phase);
+    auto warp = [&](double u) {
+        return speed * (u + wobble * w / two_pi * (std::sin(two_pi * u / w + phase) - sin_phase));
+    };
+
+    // --- 1. środek okna w czasie nagrania ---
+    const double span = warp(w) - warp(0.0);
+    out.background = false;
+    double centre = src.t_peak;
+    if (cfg_.background_ratio > 0.0 && unit(rng) < cfg_.background_ratio) {
+        // tło: środek w [lo, pik − W] ∪ [pik + W, hi] – całe okno w nagraniu
+        const double lo = t_first + 0.5 * span;
+        const double hi = t_last - 0.5 * span;
+        const double after_lo = std::max(lo, src.t_peak + w);
+        const double before = std::max(std::min(hi, src.t_peak - w) - lo, 0.0);
+        const double after = std::max(hi - after_lo, 0.0);
+        if (before + after > 0.0) {
+            const double x = (before + after) * unit(rng);
+            centre = x < before ? lo + x : after_lo + (x - before);
+            out.background = true;
+        }
+    }
+    if (!out.background && cfg_.jitter_s > 0.0) {
+        centre += cfg_.jitter_s * (2.0 * unit(rng) - 1.0);
+    }
+    const double s0 = centre - warp(0.5 * w);
+
+    // --- 3.–6. parametry jednego okna ---
+    const double k_accel = random_scale(cfg_.scale_accel, rng);
+    const double k_gyro = random_scale(cfg_.scale_gyro, rng);
+    const Vec3 a_bias = random_vec(cfg_.accel_bias, rng);
+    const Vec3 a_drift = random_vec(cfg_.accel_drift, rng);
+    const Vec3 g_bias = random_vec(cfg_.gyro_bias, rng);
+    const Vec3 g_drift = random_vec(cfg_.gyro_drift, rng);
+    const Quat mount = random_rotation(cfg_.mount_deg, rng);
+    const Quat mount_inv = quat_conj(mount);
+    const Quat world = random_rotation(cfg_.rot_deg, rng);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    const double sa = cfg_.accel_noise;
+    const double sg = cfg_.gyro_noise;
+
+    out.rows = n_;
+    out.label = src.label;
+    out.t.resize(n_);
+    for (auto& col : out.c) {
+        col.resize(n_);
+    }
+
+    // s(u) rośnie – indeks w nagraniu tylko idzie do przodu
+    std::size_t j = 0;
+    for (std::size_t k = 0; k < n_; ++k) {
+        const double u = static_cast<double>(k) * dt;
+        const double s = std::clamp(s0 + warp(u), t_first, t_last);
+        while (j + 2 < rows.size() && rows[j + 1].t < s) {
+            ++j;
+        }
+        const ImuCsvRow& r0 = rows[j];
+        const ImuCsvRow& r1 = rows[j + 1];
+        const double f = std::clamp((s - r0.t) / (r1.t - r0.t), 0.0, 1.0);
+        auto lerp = [f](double x0, double x1) { return x0 + f * (x1 - x0); };
+
+        Vec3 a{lerp(r0.ax, r1.ax), lerp(r0.ay, r1.ay), lerp(r0.az, r1.az)};
+        Vec3 g{lerp(r0.gx, r1.gx), lerp(r0.gy, r1.gy), lerp(r0.gz, r1.gz)};
+        // nlerp po krótszym łuku
+        const double sgn = r0.qw * r1.qw + r0.qi * r1.qi + r0.qj * r1.qj + r0.qk * r1.qk < 0.0 ? -1.0 : 1.0;
+        Quat q{lerp(r0.qw, sgn * r1.qw), lerp(r0.qi, sgn * r1.qi),
+               lerp(r0.qj, sgn * r1.qj), lerp(r0.qk, sgn * r1.qk)};
+        const double qn = 1.0 / std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+        q = Quat{q.w * qn, q.x * qn, q.y * qn, q.z * qn};
+
+        // 3. skala części dynamicznej; grawitacja w układzie sensora zostaje
+        const Vec3 gs = rotate_vector_by_quat(src.gravity_world, quat_conj(q));
+        a = Vec3{gs.x + k_accel * (a.x - gs.x), gs.y + k_accel * (a.y - gs.y),
+                 gs.z + k_accel * (a.z - gs.z)};
+        g = Vec3{k_gyro * g.x, k_gyro * g.y, k_gyro * g.z};
+
+        // 4. bias + dryf + szum
+        a = Vec3{a.x + a_bias.x + a_drift.x * u, a.y + a_bias.y + a_drift.y * u,
+                 a.z + a_bias.z + a_drift.z * u};
+        g = Vec3{g.x + g_bias.x + g_drift.x * u, g.y + g_bias.y + g_drift.y * u,
+                 g.z + g_bias.z + g_drift.z * u};
+        if (sa > 0.0) {
+            a = Vec3{a.x + sa * normal(rng), a.y + sa * normal(rng), a.z + sa * normal(rng)};
+        }
+        if (sg > 0.0) {
+            g = Vec3{g.x + sg * normal(rng), g.y + sg * normal(rng), g.z + sg * normal(rng)};
+        }
+
+        // 5. montaż: sensor obrócony o m względem ciała, 6. obrót świata
+        a = rotate_vector_by_quat(a, mount_inv);
+        g = rotate_vector_by_quat(g, mount_inv);
+        q = quat_mul(world, quat_mul(q, mount));
+
+        out.t[k] = u;
+        const double v[AugmentWindow::COLUMN_COUNT] = {a.x, a.y, a.z, g.x, g.y, g.z, q.w, q.x, q.y, q.z};
+        for (std::size_t c = 0; c < AugmentWindow::COLUMN_COUNT; ++c) {
+            out.c[c][k] = static_cast<float>(v[c]);
+        }
+    }
+}
+
+} // namespace bno
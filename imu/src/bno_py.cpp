@@ -0,0 +1,475 @@
+// Moduł Pythona "bno" (pybind11): detektor kierunku, parser SH-2 i transporty
+// SHTP z kodu produkcyjnego, zamiast reimplementacji w numpy.
+//
+//   import bno
+//   tr = bno.ReplayTransport("data/left3.csv")        # albo bno.I2cTransport(1, 0x4A)
+//   s = bno.read_samples(tr)                          # dict kolumn numpy
+//   det = bno.GestureDirectionDetector(bno.imu_dir_config())
+//   for g in det.add_samples(s): print(g.t_center, g.label)
+//
+// Kolumny (t, ax..az, gx..gz, qw, qi, qj, qk) to tablice 1D: t float64,
+// reszta float32 – w tym układzie (imu_log.load_imu_log, read_samples)
+// add_samples() czyta je bez kopiowania. Inne dtype numpy konwertuje raz.
+// read_samples() oddaje bufory C++ jako tablice numpy, też bez kopii.
+// Pętle C++ idą bez GIL.
+//
+// Plik budowany z -fexceptions (CMake): błędy wychodzą jako wyjątki Pythona.
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bno/gesture_dir.hpp"
+#include "bno/gesture_pipeline.hpp"
+#include "bno/sh2_enable.hpp"
+#include "bno/sh2_reports.hpp"
+#include "bno/shtp.hpp"
+#include "bno/shtp_replay.hpp"
+
+namespace py = pybind11;
+
+namespace {
+
+using FloatColumn = py::array_t<float, py::array::c_style | py::array::forcecast>;
+using TimeColumn = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+using Vec3Tuple = std::array<double, 3>;
+using QuatTuple = std::array<double, 4>;
+
+Vec3Tuple to_tuple(const bno::Vec3& v)
+{
+    return {v.x, v.y, v.z};
+}
+
+QuatTuple to_tuple(const bno::Quat& q)
+{
+    return {q.w, q.x, q.y, q.z};
+}
+
+// std::vector → numpy bez kopii: tablica trzyma wektor przez kapsułę
+template <typename T>
+py::array_t<T> to_numpy(std::vector<T>&& v)
+{
+    auto* owner = new std::vector<T>(std::move(v));
+    py::capsule free_owner(owner, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(static_cast<py::ssize_t>(owner->size()), owner->data(), free_owner);
+}
+
+[[noreturn]] void throw_shtp(const char* what, const bno::ShtpError& err)
+{
+    throw std::runtime_error(std::string(what) + ": " + err.message);
+}
+
+// ---------- Detektor ----------
+
+std::vector<bno::GestureResult> add_samples(bno::GestureDirectionDetector& det,
+                                            const py::object& cols)
+{
+    const auto t = cols["t"].cast<TimeColumn>();
+    const char* names[] = {"ax", "ay", "az", "qw", "qi", "qj", "qk", "gx", "gy", "gz"};
+    const bool have_gyro = cols.contains("gx") && cols.contains("gy") && cols.contains("gz");
+    const std::size_t count = have_gyro ? 10 : 7;
+
+    // tablice muszą żyć do końca pętli – batch trzyma tylko wskaźniki
+    std::vector<FloatColumn> arrays;
+    arrays.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        arrays.push_back(cols[names[i]].cast<FloatColumn>());
+        if (arrays.back().ndim() != 1 || arrays.back().size() != t.size()) {
+            throw py::value_error(std::string("column '") + names[i] +
+                                  "' must be 1-D with the length of 't'");
+        }
+    }
+    if (t.ndim() != 1) {
+        throw py::value_error("column 't' must be 1-D");
+    }
+
+    bno::SampleBatch b;
+    b.t = t.data();
+    b.ax = arrays[0].data();
+    b.ay = arrays[1].data();
+    b.az = arrays[2].data();
+    b.qw = arrays[3].data();
+    b.qx = arrays[4].data();
+    b.qy = arrays[5].data();
+    b.qz = arrays[6].data();
+    if (have_gyro) {
+        b.gx = arrays[7].data();
+        b.gy = arrays[8].data();
+        b.gz = arrays[9].data();
+    }
+    b.n = static_cast<std::size_t>(t.size());
+
+    std::vector<bno::GestureResult> out;
+    {
+        py::gil_scoped_release nogil;
+        det.add_samples(b, [&out](const bno::GestureResult& r) { out.push_back(r); });
+    }
+    return out;
+}
+
+// ---------- Odczyt próbek z transportu ----------
+
+// Jak pętla imu_dir: jedna próbka na raport akcelerometru, z ostatnim gyro
+// i kwaternionem. Czas: z nagrania (replay) albo steady_clock (I2C).
+struct SampleColumns {
+    std::vector<double> t;
+    std::vector<float> c[10];   // ax ay az gx gy gz qw qi qj qk
+
+    void push(double ts, const bno::Vec3f& a, const bno::Vec3f& g, const bno::Quaternion& q)
+    {
+        t.push_back(ts);
+        const float v[10] = {a.x, a.y, a.z, g.x, g.y, g.z, q.real, q.i, q.j, q.k};
+        for (std::size_t i = 0; i < 10; ++i) {
+            c[i].push_back(v[i]);
+        }
+    }
+};
+
+template <typename Transport>
+py::dict read_samples(Transport& transport, std::size_t max_samples, double duration_s,
+                      int timeout_ms)
+{
+    constexpr bool replay = std::is_same_v<Transport, bno::ShtpReplayTransport>;
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+    const auto elapsed = [&t0] {
+        return std::chrono::duration<double>(clock::now() - t0).count();
+    };
+    if constexpr (!replay) {
+        if (max_samples == 0 && duration_s <= 0.0) {
+            throw py::value_error("live transport: give max_samples or duration_s");
+        }
+    }
+
+    SampleColumns s;
+    bno::Vec3f gyro{};
+    bno::Quaternion quat{1.0f, 0.0f, 0.0f, 0.0f};
+    bool have_quat = false;
+    bno::Sh2SensorEvent events[16];
+    bno::ShtpError err;
+    std::size_t polls = 0;
+    bool interrupted = false;
+
+    {
+        py::gil_scoped_release nogil;
+        while ((max_samples == 0 || s.t.size() < max_samples) &&
+               (duration_s <= 0.0 || elapsed() < duration_s)) {
+            // Ctrl+C w notatniku: co jakiś czas sprawdź sygnały (wymaga GIL)
+            if (++polls % 256 == 0) {
+                py::gil_scoped_acquire gil;
+                if (PyErr_CheckSignals() != 0) {
+                    interrupted = true;
+                    break;
+                }
+            }
+            auto frame = transport.read_frame(err, timeout_ms);
+            if (err) {
+                break;
+            }
+            if (!frame) {
+                if constexpr (replay) {
+                    if (transport.finished()) {
+                        break;
+                    }
+                }
+                continue;
+            }
+            const auto ch = frame->header.channel;
+            if (ch < 2 || ch > 5) {
+                continue;
+            }
+            double t_base;
+            if constexpr (replay) {
+                t_base = transport.frame_time();
+            } else {
+                t_base = elapsed();
+            }
+            const std::size_t n = bno::parse_sh2_input_reports(
+                frame->payload.data(), frame->payload.size(), events, std::size(events));
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto& evt = events[i];
+                if (evt.gyro) {
+                    gyro = *evt.gyro;
+                }
+                if (evt.game_quat) {
+                    quat = *evt.game_quat;
+                    have_quat = true;
+                }
+                if (evt.accel && have_quat) {
+                    s.push(t_base + evt.host_offset_us * 1e-6, *evt.accel, gyro, quat);
+                }
+            }
+        }
+    }
+    if (interrupted) {
+        throw py::error_already_set();
+    }
+    if (err) {
+        throw_shtp("read_frame", err);
+    }
+
+    py::dict out;
+    out["t"] = to_numpy(std::move(s.t));
+    const char* names[] = {"ax", "ay", "az", "gx", "gy", "gz", "qw", "qi", "qj", "qk"};
+    for (std::size_t i = 0; i < 10; ++i) {
+        out[names[i]] = to_numpy(std::move(s.c[i]));
+    }
+    return out;
+}
+
+void enable_reports(bno::ShtpTransport& transport, int hz, int gyro_hz)
+{
+    if (hz <= 0 || gyro_hz < 0) {
+        throw py::value_error("hz must be > 0, gyro_hz >= 0");
+    }
+    bno::ShtpError err;
+    const bool ok =
+        bno::enable_sensor_report(transport, bno::Sh2SensorId::LinearAcceleration, hz, err) &&
+        bno::enable_sensor_report(transport, bno::Sh2SensorId::GyroscopeCalibrated,
+                                  gyro_hz > 0 ? gyro_hz : hz, err) &&
+        bno::enable_sensor_report(transport, bno::Sh2SensorId::GameRotationVector, hz, err);
+    if (!ok) {
+        throw_shtp("enable_reports", err);
+    }
+}
+
+std::optional<py::tuple> read_frame(bno::ShtpTransport& transport, int timeout_ms)
+{
+    bno::ShtpError err;
+    std::optional<bno::ShtpFrame> frame;
+    {
+        py::gil_scoped_release nogil;
+        frame = transport.read_frame(err, timeout_ms);
+    }
+    if (err) {
+        throw_shtp("read_frame", err);
+    }
+    if (!frame) {
+        return std::nullopt;
+    }
+    const auto& p = frame->payload;
+    return py::make_tuple(static_cast<int>(frame->header.channel),
+                          py::bytes(reinterpret_cast<const char*>(p.data()), p.size()));
+}
+
+// ---------- Parser SH-2 ----------
+
+std::vector<bno::Sh2SensorEvent> parse_payload(const py::buffer& payload)
+{
+    const py::buffer_info info = payload.request();
+    if (info.ndim != 1 || info.itemsize != 1 || info.strides[0] != 1) {
+        throw py::value_error("payload must be contiguous bytes");
+    }
+    bno::Sh2SensorEvent events[64];
+    std::size_t n;
+    {
+        py::gil_scoped_release nogil;
+        n = bno::parse_sh2_input_reports(static_cast<const std::uint8_t*>(info.ptr),
+                                         static_cast<std::size_t>(info.size),
+                                         events, std::size(events));
+    }
+    return std::vector<bno::Sh2SensorEvent>(events, events + n);
+}
+
+std::optional<Vec3Tuple> vec_or_none(const std::optional<bno::Vec3f>& v)
+{
+    if (!v) {
+        return std::nullopt;
+    }
+    return Vec3Tuple{v->x, v->y, v->z};
+}
+
+} // namespace
+
+PYBIND11_MODULE(bno, m)
+{
+    m.doc() = "BNO08x gesture engine: direction detector, SH-2 parser, SHTP replay/I2C";
+
+    // --- detektor ---
+    using Det = bno::GestureDirectionDetector;
+
+    py::enum_<Det::Mode>(m, "DetectorMode")
+        .value("PeakWindow", Det::Mode::PeakWindow)
+        .value("Segmented", Det::Mode::Segmented);
+
+    py::enum_<bno::GestureKind>(m, "GestureKind")
+        .value("Translation", bno::GestureKind::Translation)
+        .value("Twist", bno::GestureKind::Twist)
+        .value("Flick", bno::GestureKind::Flick)
+        .value("Circle", bno::GestureKind::Circle);
+
+    py::class_<Det::Config>(m, "DetectorConfig")
+        .def(py::init<>())
+        .def_readwrite("baseline_window_s", &Det::Config::baseline_window_s)
+        .def_readwrite("half_window_s", &Det::Config::half_window_s)
+        .def_readwrite("min_dyn_threshold", &Det::Config::min_dyn_threshold)
+        .def_readwrite("min_peak_magnitude", &Det::Config::min_peak_magnitude)
+        .def_readwrite("min_gesture_interval", &Det::Config::min_gesture_interval)
+        .def_readwrite("min_gyro_peak", &Det::Config::min_gyro_peak)
+        .def_readwrite("min_twist_angle", &Det::Config::min_twist_angle)
+        .def_readwrite("max_flick_net_angle", &Det::Config::max_flick_net_angle)
+        .def_readwrite("min_flick_travel", &Det::Config::min_flick_travel)
+        .def_readwrite("min_circle_sweep", &Det::Config::min_circle_sweep)
+        .def_readwrite("mode", &Det::Config::mode)
+        .def_readwrite("seg_on_threshold", &Det::Config::seg_on_threshold)
+        .def_readwrite("seg_off_threshold", &Det::Config::seg_off_threshold)
+        .def_readwrite("seg_off_hold_s", &Det::Config::seg_off_hold_s)
+        .def_readwrite("seg_energy_alpha", &Det::Config::seg_energy_alpha)
+        .def_readwrite("seg_pre_roll_s", &Det::Config::seg_pre_roll_s)
+        .def_readwrite("seg_settle_s", &Det::Config::seg_settle_s)
+        .def_readwrite("seg_max_duration_s", &Det::Config::seg_max_duration_s);
+
+    m.def("imu_dir_config",
+          [](bool segmented, double min_interval_s) {
+              bno::GesturePipeline::Config cfg;
+              cfg.segmented = segmented;
+              cfg.min_interval_s = min_interval_s;
+              return bno::GesturePipeline::detector_config(cfg);
+          },
+          py::arg("segmented") = false, py::arg("min_interval_s") = 0.5,
+          "Detector thresholds used by imu_dir / imu_daemon / imu_train");
+
+    py::class_<bno::GestureFeatures>(m, "GestureFeatures")
+        .def_property_readonly("delta_v", [](const bno::GestureFeatures& f) { return to_tuple(f.delta_v); })
+        .def_property_readonly("peak_velocity", [](const bno::GestureFeatures& f) { return to_tuple(f.peak_velocity); })
+        .def_property_readonly("gyro_integral", [](const bno::GestureFeatures& f) { return to_tuple(f.gyro_integral); })
+        .def_readonly("gyro_abs_integral", &bno::GestureFeatures::gyro_abs_integral)
+        .def_readonly("peak_accel", &bno::GestureFeatures::peak_accel)
+        .def_readonly("peak_gyro", &bno::GestureFeatures::peak_gyro)
+        .def_property_readonly("peak_gyro_vec", [](const bno::GestureFeatures& f) { return to_tuple(f.peak_gyro_vec); })
+        .def_property_readonly("quat_delta", [](const bno::GestureFeatures& f) { return to_tuple(f.quat_delta); })
+        .def_readonly("rotation_angle", &bno::GestureFeatures::rotation_angle)
+        .def_property_readonly("sweep", [](const bno::GestureFeatures& f) { return to_tuple(f.sweep); });
+
+    py::class_<bno::GestureResult>(m, "GestureResult")
+        .def_readonly("t_center", &bno::GestureResult::t_center)
+        .def_readonly("t_start", &bno::GestureResult::t_start)
+        .def_readonly("duration", &bno::GestureResult::duration)
+        .def_property_readonly("delta_v_world", [](const bno::GestureResult& r) { return to_tuple(r.delta_v_world); })
+        .def_property_readonly("baseline_world", [](const bno::GestureResult& r) { return to_tuple(r.baseline_world); })
+        .def_property_readonly("axis", [](const bno::GestureResult& r) { return std::string(1, r.axis); })
+        .def_property_readonly("sign", [](const bno::GestureResult& r) { return std::string(1, r.sign); })
+        .def_readonly("label", &bno::GestureResult::label)
+        .def_readonly("kind", &bno::GestureResult::kind)
+        .def_readonly("features", &bno::GestureResult::features)
+        .def_readonly("t_emit", &bno::GestureResult::t_emit)
+        .def_readonly("gesture_id", &bno::GestureResult::gesture_id)
+        .def_readonly("provisional", &bno::GestureResult::provisional)
+        .def("__repr__", [](const bno::GestureResult& r) {
+            return "<GestureResult t=" + std::to_string(r.t_center) + " " + r.label +
+                   (r.provisional ? " provisional>" : ">");
+        });
+
+    py::class_<Det>(m, "GestureDirectionDetector")
+        .def(py::init<const Det::Config&>(), py::arg("config") = Det::Config{})
+        .def("add_sample",
+             [](Det& det, double t, const Vec3Tuple& accel, const Vec3Tuple& gyro,
+                const QuatTuple& quat) {
+                 det.add_sample(t, bno::Vec3{accel[0], accel[1], accel[2]},
+                                bno::Vec3{gyro[0], gyro[1], gyro[2]},
+                                bno::Quat{quat[0], quat[1], quat[2], quat[3]});
+                 return det.poll_result();
+             },
+             py::arg("t"), py::arg("accel"), py::arg("gyro"), py::arg("quat"),
+             "One sample in the sensor frame; returns a GestureResult or None")
+        .def("add_samples", &add_samples, py::arg("columns"),
+             "Columns t, ax..az, qw, qi, qj, qk (gx..gz optional) as a dict of 1-D arrays; "
+             "returns every result in order")
+        .def_property_readonly("baseline_world", [](const Det& det) { return to_tuple(det.baseline_world()); })
+        .def_property_readonly("has_baseline", &Det::has_baseline);
+
+    // --- SH-2 ---
+    py::enum_<bno::Sh2SensorId>(m, "Sh2SensorId")
+        .value("Accelerometer", bno::Sh2SensorId::Accelerometer)
+        .value("GyroscopeCalibrated", bno::Sh2SensorId::GyroscopeCalibrated)
+        .value("LinearAcceleration", bno::Sh2SensorId::LinearAcceleration)
+        .value("Gravity", bno::Sh2SensorId::Gravity)
+        .value("GyroscopeUncalibrated", bno::Sh2SensorId::GyroscopeUncalibrated)
+        .value("GameRotationVector", bno::Sh2SensorId::GameRotationVector)
+        .value("StepDetector", bno::Sh2SensorId::StepDetector)
+        .value("StepCounter", bno::Sh2SensorId::StepCounter)
+        .value("StabilityClassifier", bno::Sh2SensorId::StabilityClassifier)
+        .value("ActivityClassifier", bno::Sh2SensorId::ActivityClassifier);
+
+    py::class_<bno::Sh2SensorEvent>(m, "Sh2SensorEvent")
+        .def_readonly("sensor_id", &bno::Sh2SensorEvent::sensor_id)
+        .def_readonly("timestamp_us", &bno::Sh2SensorEvent::timestamp_us)
+        .def_readonly("host_offset_us", &bno::Sh2SensorEvent::host_offset_us)
+        .def_property_readonly("accuracy", [](const bno::Sh2SensorEvent& e) { return static_cast<int>(e.accuracy); })
+        .def_property_readonly("accel", [](const bno::Sh2SensorEvent& e) { return vec_or_none(e.accel); })
+        .def_property_readonly("gyro", [](const bno::Sh2SensorEvent& e) { return vec_or_none(e.gyro); })
+        .def_property_readonly("game_quat", [](const bno::Sh2SensorEvent& e) -> std::optional<QuatTuple> {
+            if (!e.game_quat) {
+                return std::nullopt;
+            }
+            return QuatTuple{e.game_quat->real, e.game_quat->i, e.game_quat->j, e.game_quat->k};
+        })
+        .def_readonly("activity_label", &bno::Sh2SensorEvent::activity_label)
+        .def_readonly("activity_confidence", &bno::Sh2SensorEvent::activity_confidence)
+        .def_readonly("steps_total", &bno::Sh2SensorEvent::steps_total)
+        .def_readonly("step_event", &bno::Sh2SensorEvent::step_event)
+        .def_readonly("stability_state", &bno::Sh2SensorEvent::stability_state);
+
+    m.def("parse_sh2_input_reports", &parse_payload, py::arg("payload"),
+          "All SH-2 input reports of one SHTP payload (channels 2..5)");
+
+    // --- transporty ---
+    py::class_<bno::ShtpTransport>(m, "ShtpTransport")
+        .def("read_frame", &read_frame, py::arg("timeout_ms") = 50,
+             "(channel, payload bytes) or None on timeout / end of recording")
+        .def_property_readonly("is_open", &bno::ShtpTransport::is_open);
+
+    py::class_<bno::ShtpReplayTransport, bno::ShtpTransport>(m, "ReplayTransport")
+        .def(py::init([](const std::string& path, double speed, bool loop) {
+                 bno::ShtpReplayTransport::Config cfg;
+                 cfg.speed = speed;
+                 cfg.loop = loop;
+                 auto tr = std::make_unique<bno::ShtpReplayTransport>(cfg);
+                 bno::ShtpError err;
+                 if (!tr->open(path, err)) {
+                     throw_shtp("open", err);
+                 }
+                 return tr;
+             }),
+             py::arg("path"), py::arg("speed") = 0.0, py::arg("loop") = false,
+             "Recording (CSV / .imlog) as SHTP frames; speed 0 = no waiting")
+        .def_property_readonly("finished", &bno::ShtpReplayTransport::finished)
+        .def_property_readonly("frame_time", &bno::ShtpReplayTransport::frame_time)
+        .def_property_readonly("frames_sent", &bno::ShtpReplayTransport::frames_sent);
+
+    py::class_<bno::ShtpI2cTransport, bno::ShtpTransport>(m, "I2cTransport")
+        .def(py::init([](int bus, std::uint8_t addr) {
+                 auto tr = std::make_unique<bno::ShtpI2cTransport>();
+                 bno::ShtpError err;
+                 if (!tr->open(bus, addr, err)) {
+                     throw_shtp("open", err);
+                 }
+                 return tr;
+             }),
+             py::arg("bus") = 1, py::arg("addr") = 0x4A)
+        .def("close", &bno::ShtpI2cTransport::close);
+
+    m.def("enable_reports", &enable_reports, py::arg("transport"), py::arg("hz") = 100,
+          py::arg("gyro_hz") = 0,
+          "Enable linear accel, calibrated gyro and game rotation vector (as imu_dir)");
+
+    m.def("read_samples", &read_samples<bno::ShtpReplayTransport>, py::arg("transport"),
+          py::arg("max_samples") = 0, py::arg("duration_s") = 0.0, py::arg("timeout_ms") = 50,
+          "Decode frames into sample columns (dict of numpy arrays); replay: to the end");
+    m.def("read_samples", &read_samples<bno::ShtpI2cTransport>, py::arg("transport"),
+          py::arg("max_samples") = 0, py::arg("duration_s") = 0.0, py::arg("timeout_ms") = 50,
+          "Live: needs max_samples or duration_s; call enable_reports() first");
+}
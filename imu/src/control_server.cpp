@@ -0,0 +1,177 @@
+#include "bno/control_server.hpp"
+#include "bno/local_server.hpp"
+#include "bno/log.hpp"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+namespace bno {
+
+namespace {
+
+constexpr std::size_t MAX_COMMAND_LINE = 1024;
+constexpr std::size_t MAX_CONTROL_CLIENTS = 16;
+
+// Odpowiedzi są krótkie – bez kolejki: całość albo rozłączenie
+bool send_all(int fd, std::string_view data)
+{
+    while (!data.empty()) {
+        const ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(n));
+    }
+    return true;
+}
+
+} // namespace
+
+ControlServer::~ControlServer()
+{
+    close();
+}
+
+bool ControlServer::open(const std::string& path, LiveConfigCell& cell, const Config& cfg,
+                         std::string& err)
+{
+    close();
+    listen_fd_ = listen_unix_socket(path, "control", err);
+    if (listen_fd_ < 0) {
+        return false;
+    }
+    path_ = path;
+    cfg_ = cfg;
+    cell_ = &cell;
+    thread_ = std::jthread([this](std::stop_token stop) { run(stop); });
+    return true;
+}
+
+void ControlServer::close()
+{
+    if (thread_.joinable()) {
+        thread_.request_stop();
+        thread_.join();
+    }
+    for (const auto& c : clients_) {
+        ::close(c.fd);
+    }
+    clients_.clear();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        ::unlink(path_.c_str());
+    }
+    path_.clear();
+}
+
+void ControlServer::run(std::stop_token stop)
+{
+    // [0] = gniazdo nasłuchujące, [1 + i] = clients_[i]
+    pollfd fds[1 + MAX_CONTROL_CLIENTS];
+    while (!stop.stop_requested()) {
+        const std::size_t n_clients = clients_.size();
+        fds[0] = pollfd{listen_fd_, POLLIN, 0};
+        for (std::size_t i = 0; i < n_clients; ++i) {
+            fds[1 + i] = pollfd{clients_[i].fd, POLLIN, 0};
+        }
+        // co 200 ms sprawdzamy stop – close() nie musi budzić wątku
+        if (::poll(fds, static_cast<nfds_t>(1 + n_clients), 200) <= 0) {
+            continue;
+        }
+        for (std::size_t i = n_clients; i-- > 0;) {
+            const short re = fds[1 + i].revents;
+            if (re == 0) {
+                continue;
+            }
+            if ((re & (POLLERR | POLLNVAL)) || !read_commands(clients_[i])) {
+                ::close(clients_[i].fd);
+                clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            accept_clients();
+        }
+    }
+}
+
+void ControlServer::accept_clients()
+{
+    for (;;) {
+        const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (clients_.size() >= std::min(cfg_.max_clients, MAX_CONTROL_CLIENTS)) {
+            send_all(fd, "ERR too many clients\n");
+            ::close(fd);
+            BNO_LOG_WARN("control: rejected client, {} already connected", clients_.size());
+            continue;
+        }
+        clients_.push_back(Client{fd, {}});
+    }
+}
+
+bool ControlServer::read_commands(Client& c)
+{
+    char buf[256];
+    for (;;) {
+        const ssize_t n = ::recv(c.fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n == 0) {
+            return false;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        c.in.append(buf, static_cast<std::size_t>(n));
+
+        std::size_t nl;
+        while ((nl = c.in.find('\n')) != std::string::npos) {
+            std::string_view line(c.in.data(), nl);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            const std::string reply = handle(line) + "\n";
+            c.in.erase(0, nl + 1);
+            if (!send_all(c.fd, reply)) {
+                return false;
+            }
+        }
+        if (c.in.size() > MAX_COMMAND_LINE) {
+            send_all(c.fd, "ERR line too long\n");
+            return false;
+        }
+    }
+}
+
+std::string ControlServer::handle(std::string_view line)
+{
+    if (line == "GET") {
+        return "OK " + format_live_config(cell_->copy());
+    }
+    if (line.substr(0, 4) == "SET ") {
+        // Kopia bieżącej wersji, zmiana, publikacja. Dwa SET naraz z różnych
+        // klientów nie grożą – obsługuje je jeden wątek.
+        LiveConfig next = cell_->copy();
+        std::string err;
+        if (!apply_live_config_assignments(next, line.substr(4), cfg_.limits, err)) {
+            return "ERR " + err;
+        }
+        const std::uint64_t version = cell_->publish(next);
+        BNO_LOG_INFO("control: published config version {}", version);
+        return "OK version=" + std::to_string(version);
+    }
+    return "ERR expected: GET | SET key=value ...";
+}
+
+} // namespace bno
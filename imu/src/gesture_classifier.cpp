@@ -0,0 +1,228 @@
+#include "bno/gesture_classifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if BNO_HAVE_OPENCV
+#include <opencv2/core.hpp>
+#include <opencv2/ml.hpp>
+#endif
+
+namespace bno {
+
+// Ten plik jest budowany z -fexceptions (CMake): OpenCV zgłasza błędy
+// wyjątkami cv::Exception, tu zamieniamy je na bool + err.
+struct GestureClassifier::Impl {
+#if BNO_HAVE_OPENCV
+    cv::Ptr<cv::ml::RTrees> model;
+    // nawiasy, nie {}: Mat(initializer_list<int>) to wymiary, nie (rows, cols, type)
+    mutable cv::Mat sample = cv::Mat(1, static_cast<int>(FEATURE_COUNT), CV_32F);
+    mutable cv::Mat votes;
+#endif
+};
+
+GestureClassifier::GestureClassifier() : impl_(std::make_unique<Impl>()) {}
+GestureClassifier::~GestureClassifier() = default;
+GestureClassifier::GestureClassifier(GestureClassifier&&) noexcept = default;
+GestureClassifier& GestureClassifier::operator=(GestureClassifier&&) noexcept = default;
+
+const std::string& GestureClassifier::label(int index) const
+{
+    static const std::string unknown = "UNKNOWN";
+    if (index < 0 || static_cast<std::size_t>(index) >= labels_.size()) {
+        return unknown;
+    }
+    return labels_[static_cast<std::size_t>(index)];
+}
+
+#if BNO_HAVE_OPENCV
+
+bool GestureClassifier::available()
+{
+    return true;
+}
+
+bool GestureClassifier::loaded() const
+{
+    return !impl_->model.empty() && impl_->model->isTrained();
+}
+
+bool GestureClassifier::train(const std::vector<GestureFeatureVector>& x,
+                              const std::vector<std::string>& labels,
+                              const TrainConfig& cfg,
+                              std::string& err)
+{
+    if (x.empty() || x.size() != labels.size()) {
+        err = "train: need one label per feature vector";
+        return false;
+    }
+
+    // etykiety → indeksy 0..K-1 (kolejność alfabetyczna, stała między przebiegami)
+    std::vector<std::string> names(labels);
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    if (names.size() < 2) {
+        err = "train: need at least two labels";
+        return false;
+    }
+
+    const int n = static_cast<int>(x.size());
+    cv::Mat samples(n, static_cast<int>(FEATURE_COUNT), CV_32F);
+    cv::Mat responses(n, 1, CV_32S);
+    for (int i = 0; i < n; ++i) {
+        const auto& row = x[static_cast<std::size_t>(i)];
+        std::copy(row.begin(), row.end(), samples.ptr<float>(i));
+        const auto it = std::lower_bound(names.begin(), names.end(),
+                                         labels[static_cast<std::size_t>(i)]);
+        responses.at<int>(i) = static_cast<int>(it - names.begin());
+    }
+
+    try {
+        auto model = cv::ml::RTrees::create();
+        model->setMaxDepth(cfg.max_depth);
+        model->setMinSampleCount(cfg.min_samples);
+        model->setRegressionAccuracy(0.0f);
+        model->setUseSurrogates(false);
+        model->setCalculateVarImportance(false);
+        model->setActiveVarCount(cfg.active_vars > 0
+            ? cfg.active_vars
+            : static_cast<int>(std::sqrt(static_cast<double>(FEATURE_COUNT))));
+        model->setTermCriteria(cv::TermCriteria(cv::TermCriteria::MAX_ITER, cfg.trees, 0.0));
+        // odpowiedzi CV_32S → klasyfikacja
+        if (!model->train(cv::ml::TrainData::create(samples, cv::ml::ROW_SAMPLE, responses))) {
+            err = "train: RTrees::train failed";
+            return false;
+        }
+        impl_->model = model;
+    } catch (const cv::Exception& e) {
+        err = std::string("train: ") + e.what();
+        return false;
+    }
+    labels_ = std::move(names);
+    return true;
+}
+
+bool GestureClassifier::save(const std::string& path, std::string& err) const
+{
+    if (!loaded()) {
+        err = "save: no model";
+        return false;
+    }
+    try {
+        cv::FileStorage fs(path, cv::FileStorage::WRITE);
+        if (!fs.isOpened()) {
+            err = "save: cannot open " + path;
+            return false;
+        }
+        fs << "feature_count" << static_cast<int>(FEATURE_COUNT);
+        fs << "labels" << labels_;
+        fs << "rtrees" << "{";
+        impl_->model->write(fs);
+        fs << "}";
+    } catch (const cv::Exception& e) {
+        err = "save " + path + ": " + e.what();
+        return false;
+    }
+    return true;
+}
+
+bool GestureClassifier::load(const std::string& path, std::string& err)
+{
+    try {
+        cv::FileStorage fs(path, cv::FileStorage::READ);
+        if (!fs.isOpened()) {
+            err = "load: cannot open " + path;
+            return false;
+        }
+        if (static_cast<int>(fs["feature_count"]) != static_cast<int>(FEATURE_COUNT)) {
+            err = "load " + path + ": model built for a different feature set";
+            return false;
+        }
+        std::vector<std::string> names;
+        fs["labels"] >> names;
+        auto model = cv::ml::RTrees::create();
+        model->read(fs["rtrees"]);
+        if (names.size() < 2 || !model->isTrained()) {
+            err = "load " + path + ": no trained model";
+            return false;
+        }
+        impl_->model = model;
+        labels_ = std::move(names);
+    } catch (const cv::Exception& e) {
+        err = "load " + path + ": " + e.what();
+        return false;
+    }
+    return true;
+}
+
+bool GestureClassifier::predict(const GestureFeatureVector& x, Prediction& out) const
+{
+    if (!loaded()) {
+        return false;
+    }
+    std::copy(x.begin(), x.end(), impl_->sample.ptr<float>(0));
+    try {
+        // wiersz 0: indeksy klas, wiersz 1: liczba głosów drzew
+        impl_->model->getVotes(impl_->sample, impl_->votes, 0);
+    } catch (const cv::Exception&) {
+        return false;
+    }
+    const cv::Mat& v = impl_->votes;
+    int best = -1;
+    int best_votes = -1;
+    int total = 0;
+    for (int j = 0; j < v.cols; ++j) {
+        const int c = v.at<int>(1, j);
+        total += c;
+        if (c > best_votes) {
+            best_votes = c;
+            best = v.at<int>(0, j);
+        }
+    }
+    out.label_index = best;
+    out.confidence = total > 0 ? static_cast<float>(best_votes) / static_cast<float>(total) : 0.0f;
+    return best >= 0;
+}
+
+#else // !BNO_HAVE_OPENCV
+
+bool GestureClassifier::available()
+{
+    return false;
+}
+
+bool GestureClassifier::loaded() const
+{
+    return false;
+}
+
+bool GestureClassifier::train(const std::vector<GestureFeatureVector>&,
+                              const std::vector<std::string>&,
+                              const TrainConfig&,
+                              std::string& err)
+{
+    err = "built without OpenCV (ml)";
+    return false;
+}
+
+bool GestureClassifier::save(const std::string&, std::string& err) const
+{
+    err = "built without OpenCV (ml)";
+    return false;
+}
+
+bool GestureClassifier::load(const std::string&, std::string& err)
+{
+    err = "built without OpenCV (ml)";
+    return false;
+}
+
+bool GestureClassifier::predict(const GestureFeatureVector&, Prediction&) const
+{
+    return false;
+}
+
+#endif
+
+} // namespace bno
@@ -0,0 +1,390 @@
+#include "bno/gesture_cnn.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#if BNO_HAVE_OPENCV_DNN
+#include <opencv2/core.hpp>
+#include <opencv2/dnn.hpp>
+#endif
+
+namespace bno {
+
+namespace {
+
+// Przerwa w danych dłuższa niż to gubi okno – siatka startuje od nowa
+constexpr double MAX_GAP_S = 0.25;
+
+} // namespace
+
+// Jak gesture_classifier.cpp: plik z -fexceptions, cv::Exception → bool + err.
+struct StreamingGestureCnn::Impl {
+#if BNO_HAVE_OPENCV_DNN
+    cv::dnn::Net net;
+    cv::Mat blob;                  // 1 x CHANNELS x N, przydzielony w load()
+    cv::Mat out;
+    std::vector<float> probs;
+#endif
+};
+
+StreamingGestureCnn::StreamingGestureCnn() : impl_(std::make_unique<Impl>()) {}
+StreamingGestureCnn::~StreamingGestureCnn() = default;
+StreamingGestureCnn::StreamingGestureCnn(StreamingGestureCnn&&) noexcept = default;
+StreamingGestureCnn& StreamingGestureCnn::operator=(StreamingGestureCnn&&) noexcept = default;
+
+const std::string& StreamingGestureCnn::label(int index) const
+{
+    static const std::string unknown = "UNKNOWN";
+    if (index < 0 || static_cast<std::size_t>(index) >= labels_.size()) {
+        return unknown;
+    }
+    return labels_[static_cast<std::size_t>(index)];
+}
+
+void StreamingGestureCnn::reset_grid()
+{
+    head_ = 0;
+    filled_ = 0;
+    have_prev_ = false;
+}
+
+void StreamingGestureCnn::push_grid(const float* v)
+{
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        ring_[c * n_ + head_] = v[c];
+    }
+    head_ = head_ + 1 == n_ ? 0 : head_ + 1;
+    if (filled_ < n_) {
+        ++filled_;
+    }
+}
+
+bool StreamingGestureCnn::add_sample(double t, const Vec3& accel_sensor, const Vec3& gyro_sensor,
+                                     const Quat& quat, const Vec3& gravity_world, Result& out)
+{
+    if (!loaded()) {
+        return false;
+    }
+    const Vec3 aw = rotate_vector_by_quat(accel_sensor, quat);
+    const Vec3 gw = rotate_vector_by_quat(gyro_sensor, quat);
+    const float v[CHANNELS] = {
+        static_cast<float>(aw.x - gravity_world.x),
+        static_cast<float>(aw.y - gravity_world.y),
+        static_cast<float>(aw.z - gravity_world.z),
+        static_cast<float>(gw.x),
+        static_cast<float>(gw.y),
+        static_cast<float>(gw.z),
+    };
+
+    if (have_prev_ && (t <= prev_t_ || t - prev_t_ > MAX_GAP_S)) {
+        reset_grid();
+    }
+    if (!have_prev_) {
+        push_grid(v);
+        next_grid_t_ = t + grid_dt_;
+        next_eval_t_ = t;
+    } else {
+        // punkty siatki między poprzednią a tą próbką – interpolacja liniowa
+        const double span = t - prev_t_;
+        float g[CHANNELS];
+        while (next_grid_t_ <= t) {
+            const auto a = static_cast<float>((next_grid_t_ - prev_t_) / span);
+            for (std::size_t c = 0; c < CHANNELS; ++c) {
+                g[c] = prev_[c] + a * (v[c] - prev_[c]);
+            }
+            push_grid(g);
+            next_grid_t_ += grid_dt_;
+        }
+    }
+    have_prev_ = true;
+    prev_t_ = t;
+    std::copy(v, v + CHANNELS, prev_);
+
+    if (filled_ < n_ || t < next_eval_t_) {
+        return false;
+    }
+    next_eval_t_ += 1.0 / cfg_.eval_hz;
+    if (next_eval_t_ < t) {
+        next_eval_t_ = t + 1.0 / cfg_.eval_hz;   // po zaległościach nie nadrabiamy serią
+    }
+    return evaluate(t, out);
+}
+
+#if BNO_HAVE_OPENCV_DNN
+
+namespace {
+
+// Plik obok modelu: gestures.onnx -> gestures.labels / gestures.calib
+std::string sibling_path(const std::string& model_path, const char* ext)
+{
+    const auto dot = model_path.find_last_of('.');
+    const auto slash = model_path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return model_path + ext;
+    }
+    return model_path.substr(0, dot) + ext;
+}
+
+// Nagłówek .calib z cnn_train.py (export_calibration): magic, potem uint32 LE
+// okna, kanały, N; dalej float32 LE [okna][kanały][N]
+constexpr char CALIB_MAGIC[8] = {'B', 'N', 'O', 'C', 'A', 'L', 'I', 'B'};
+constexpr std::uint32_t MAX_CALIB_WINDOWS = 4096;
+
+std::uint32_t le_u32(const unsigned char* p)
+{
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+// Okna kalibracji jako jeden blob windows x channels x n – quantize() chce
+// jednego bloba na wejście sieci, więc okna idą jako batch
+bool read_calibration(const std::string& path, std::size_t channels, std::size_t n,
+                      cv::Mat& out, std::string& err)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        err = "cannot open " + path + " (written by cnn_train.py next to the model)";
+        return false;
+    }
+    unsigned char header[sizeof(CALIB_MAGIC) + 12];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        std::memcmp(header, CALIB_MAGIC, sizeof(CALIB_MAGIC)) != 0) {
+        err = path + ": not a calibration file";
+        return false;
+    }
+    const std::uint32_t windows = le_u32(header + 8);
+    if (windows == 0 || windows > MAX_CALIB_WINDOWS || le_u32(header + 12) != channels ||
+        le_u32(header + 16) != n) {
+        err = path + ": " + std::to_string(windows) + " windows of " +
+              std::to_string(le_u32(header + 12)) + " x " + std::to_string(le_u32(header + 16)) +
+              ", model needs 1.." + std::to_string(MAX_CALIB_WINDOWS) + " of " +
+              std::to_string(channels) + " x " + std::to_string(n);
+        return false;
+    }
+    const int shape[] = {static_cast<int>(windows), static_cast<int>(channels), static_cast<int>(n)};
+    out.create(3, shape, CV_32F);
+    const auto bytes = static_cast<std::streamsize>(out.total() * sizeof(float));
+    if (!in.read(reinterpret_cast<char*>(out.ptr<float>()), bytes) || in.peek() != EOF) {
+        err = path + ": size does not match the header";
+        return false;
+    }
+    return true;
+}
+
+bool read_labels(const std::string& path, std::vector<std::string>& out, std::string& err)
+{
+    std::ifstream in(path);
+    if (!in) {
+        err = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            out.push_back(line);
+        }
+    }
+    if (out.size() < 2) {
+        err = path + ": need at least two labels";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool StreamingGestureCnn::available()
+{
+    return true;
+}
+
+bool StreamingGestureCnn::loaded() const
+{
+    return !impl_->net.empty();
+}
+
+bool StreamingGestureCnn::load(const Config& cfg, std::string& err)
+{
+    if (cfg.rate_hz <= 0.0 || cfg.window_s <= 0.0 || cfg.eval_hz <= 0.0) {
+        err = "cnn: rate, window and eval rate must be > 0";
+        return false;
+    }
+    const auto n = static_cast<std::size_t>(std::lround(cfg.rate_hz * cfg.window_s));
+    if (n < 4) {
+        err = "cnn: window shorter than 4 samples";
+        return false;
+    }
+
+    std::vector<std::string> names;
+    const std::string labels_path = cfg.labels_path.empty()
+        ? sibling_path(cfg.model_path, ".labels") : cfg.labels_path;
+    if (!read_labels(labels_path, names, err)) {
+        err = "cnn: " + err;
+        return false;
+    }
+
+    cv::Mat calib;
+    if (cfg.int8) {
+        const std::string calib_path = cfg.calib_path.empty()
+            ? sibling_path(cfg.model_path, ".calib") : cfg.calib_path;
+        if (!read_calibration(calib_path, CHANNELS, n, calib, err)) {
+            err = "cnn int8: " + err;
+            return false;
+        }
+    }
+
+    Impl impl;
+    std::string int8_error;
+    try {
+        impl.net = cv::dnn::readNetFromONNX(cfg.model_path);
+        if (impl.net.empty()) {
+            err = "cnn: no network in " + cfg.model_path;
+            return false;
+        }
+        impl.net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        impl.net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        const int shape[] = {1, static_cast<int>(CHANNELS), static_cast<int>(n)};
+        impl.blob.create(3, shape, CV_32F);
+        impl.blob.setTo(0.0f);
+        if (!calib.empty()) {
+            // skale aktywacji z okien uczących, raz tutaj – nie w evaluate()
+            try {
+                cv::dnn::Net q = impl.net.quantize(calib, CV_32F, CV_32F, true);
+                q.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+                q.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+                impl.net = std::move(q);
+            } catch (const cv::Exception& e) {
+                int8_error = e.what();
+            }
+        }
+        // pierwszy forward() przydziela bufory warstw – tu, nie na pierwszym gescie
+        impl.net.setInput(impl.blob);
+        impl.net.forward(impl.out);
+    } catch (const cv::Exception& e) {
+        err = "cnn " + cfg.model_path + ": " + e.what();
+        return false;
+    }
+    if (impl.out.total() != names.size()) {
+        err = "cnn " + cfg.model_path + ": " + std::to_string(impl.out.total()) +
+              " outputs, " + std::to_string(names.size()) + " labels in " + labels_path;
+        return false;
+    }
+    impl.probs.resize(names.size());
+
+    *impl_ = std::move(impl);
+    cfg_ = cfg;
+    labels_ = std::move(names);
+    none_index_ = -1;
+    for (std::size_t i = 0; i < labels_.size(); ++i) {
+        if (labels_[i] == "NONE") {
+            none_index_ = static_cast<int>(i);
+        }
+    }
+    n_ = n;
+    grid_dt_ = 1.0 / cfg.rate_hz;
+    ring_.assign(CHANNELS * n_, 0.0f);
+    reset_grid();
+    int8_active_ = cfg.int8 && int8_error.empty();
+    int8_error_ = std::move(int8_error);
+    last_detect_t_ = -1e9;
+    stats_ = Stats{};
+    return true;
+}
+
+bool StreamingGestureCnn::evaluate(double t, Result& out)
+{
+    Impl& im = *impl_;
+
+    // pierścień → blob w kolejności czasu (najstarsza próbka pierwsza)
+    float* dst = im.blob.ptr<float>();
+    const std::size_t tail = n_ - head_;
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        const float* src = &ring_[c * n_];
+        std::copy(src + head_, src + n_, dst);
+        std::copy(src, src + head_, dst + tail);
+        dst += n_;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    try {
+        im.net.setInput(im.blob);
+        im.net.forward(im.out);
+    } catch (const cv::Exception&) {
+        return false;
+    }
+    const double us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - t0).count();
+    ++stats_.evaluations;
+    stats_.last_us = us;
+    stats_.max_us = std::max(stats_.max_us, us);
+
+    // wyjście: logity albo już softmax (eksport z cnn_train.py ma softmax na końcu)
+    const float* o = im.out.ptr<float>();
+    const std::size_t k = im.probs.size();
+    float sum = 0.0f;
+    bool probs = true;
+    for (std::size_t i = 0; i < k; ++i) {
+        probs = probs && o[i] >= 0.0f && o[i] <= 1.0f;
+        sum += o[i];
+    }
+    if (probs && std::fabs(sum - 1.0f) < 1e-3f) {
+        std::copy(o, o + k, im.probs.begin());
+    } else {
+        const float mx = *std::max_element(o, o + k);
+        sum = 0.0f;
+        for (std::size_t i = 0; i < k; ++i) {
+            im.probs[i] = std::exp(o[i] - mx);
+            sum += im.probs[i];
+        }
+        for (float& p : im.probs) {
+            p /= sum;
+        }
+    }
+
+    const auto best = std::max_element(im.probs.begin(), im.probs.end()) - im.probs.begin();
+    const float p = im.probs[static_cast<std::size_t>(best)];
+    if (static_cast<int>(best) == none_index_ || static_cast<double>(p) < cfg_.min_confidence ||
+        t - last_detect_t_ < cfg_.refractory_s) {
+        return false;
+    }
+    last_detect_t_ = t;
+    ++stats_.detections;
+    out.t = t;
+    out.label_index = static_cast<int>(best);
+    out.confidence = p;
+    return true;
+}
+
+#else // !BNO_HAVE_OPENCV_DNN
+
+bool StreamingGestureCnn::available()
+{
+    return false;
+}
+
+bool StreamingGestureCnn::loaded() const
+{
+    return false;
+}
+
+bool StreamingGestureCnn::load(const Config&, std::string& err)
+{
+    err = "built without OpenCV (dnn)";
+    return false;
+}
+
+bool StreamingGestureCnn::evaluate(double, Result&)
+{
+    return false;
+}
+
+#endif
+
+} // namespace bno
@@ -0,0 +1,561 @@
+#include "bno/gesture_dtw.hpp"
+#include "bno/imu_log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BNO_DTW_X86 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BNO_DTW_NEON 1
+#endif
+
+namespace bno {
+
+namespace {
+
+// Szerokość, do której zaokrąglamy serie (AVX2 = 8 floatów, NEON = 4).
+constexpr std::size_t SIMD_PAD = 8;
+
+constexpr float INF = std::numeric_limits<float>::infinity();
+
+std::size_t round_up(std::size_t n, std::size_t m) {
+    return (n + m - 1) / m * m;
+}
+
+// Stride serii: zaokrąglony + jeden pełny wektor zapasu, żeby kernel
+// mógł zacząć od dowolnego przesunięcia i dalej czytać pełne wektory.
+std::size_t series_stride(std::size_t len) {
+    return round_up(len, SIMD_PAD) + SIMD_PAD;
+}
+
+// ---------- kernele skalarne (fallback i ogony) ----------
+
+#if !defined(BNO_DTW_NEON)
+void band_cost_scalar(const float* q, const float* c, std::size_t stride,
+                      std::size_t count, float* out) {
+    for (std::size_t k = 0; k < count; ++k) {
+        float acc = 0.0f;
+        for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+            const float diff = q[d] - c[d * stride + k];
+            acc += diff * diff;
+        }
+        out[k] = acc;
+    }
+}
+#endif
+
+float lb_keogh_tail(const float* q, std::size_t q_stride,
+                    const float* upper, const float* lower, std::size_t stride,
+                    std::size_t from, std::size_t len) {
+    float acc = 0.0f;
+    for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+        const float* qd = q + d * q_stride;
+        const float* ud = upper + d * stride;
+        const float* ld = lower + d * stride;
+        for (std::size_t j = from; j < len; ++j) {
+            float e = 0.0f;
+            if (qd[j] > ud[j]) {
+                e = qd[j] - ud[j];
+            } else if (qd[j] < ld[j]) {
+                e = ld[j] - qd[j];
+            }
+            acc += e * e;
+        }
+    }
+    return acc;
+}
+
+#if !defined(BNO_DTW_NEON)
+float lb_keogh_scalar(const float* q, std::size_t q_stride,
+                      const float* upper, const float* lower, std::size_t stride,
+                      std::size_t len) {
+    return lb_keogh_tail(q, q_stride, upper, lower, stride, 0, len);
+}
+#endif
+
+// ---------- AVX2 ----------
+
+#if defined(BNO_DTW_X86)
+
+__attribute__((target("avx2,fma")))
+void band_cost_avx2(const float* q, const float* c, std::size_t stride,
+                    std::size_t count, float* out) {
+    __m256 qv[DTW_DIMS];
+    for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+        qv[d] = _mm256_set1_ps(q[d]);
+    }
+    for (std::size_t k = 0; k < count; k += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+            const __m256 diff = _mm256_sub_ps(qv[d], _mm256_loadu_ps(c + d * stride + k));
+            acc = _mm256_fmadd_ps(diff, diff, acc);
+        }
+        _mm256_storeu_ps(out + k, acc);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+float lb_keogh_avx2(const float* q, std::size_t q_stride,
+                    const float* upper, const float* lower, std::size_t stride,
+                    std::size_t len) {
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 acc = zero;
+    const std::size_t full = len / 8 * 8;
+    for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+        const float* qd = q + d * q_stride;
+        const float* ud = upper + d * stride;
+        const float* ld = lower + d * stride;
+        for (std::size_t j = 0; j < full; j += 8) {
+            const __m256 v = _mm256_loadu_ps(qd + j);
+            const __m256 above = _mm256_max_ps(_mm256_sub_ps(v, _mm256_loadu_ps(ud + j)), zero);
+            const __m256 below = _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(ld + j), v), zero);
+            const __m256 e = _mm256_add_ps(above, below);
+            acc = _mm256_fmadd_ps(e, e, acc);
+        }
+    }
+    const __m128 lo = _mm256_castps256_ps128(acc);
+    const __m128 hi = _mm256_extractf128_ps(acc, 1);
+    __m128 s = _mm_add_ps(lo, hi);
+    s = _mm_hadd_ps(s, s);
+    s = _mm_hadd_ps(s, s);
+    return _mm_cvtss_f32(s) + lb_keogh_tail(q, q_stride, upper, lower, stride, full, len);
+}
+
+#endif
+
+// ---------- NEON ----------
+
+#if defined(BNO_DTW_NEON)
+
+inline float32x4_t fma4(float32x4_t acc, float32x4_t a, float32x4_t b) {
+#if defined(__aarch64__)
+    return vfmaq_f32(acc, a, b);
+#else
+    return vmlaq_f32(acc, a, b);
+#endif
+}
+
+void band_cost_neon(const float* q, const float* c, std::size_t stride,
+                    std::size_t count, float* out) {
+    float32x4_t qv[DTW_DIMS];
+    for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+        qv[d] = vdupq_n_f32(q[d]);
+    }
+    for (std::size_t k = 0; k < count; k += 4) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+            const float32x4_t diff = vsubq_f32(qv[d], vld1q_f32(c + d * stride + k));
+            acc = fma4(acc, diff, diff);
+        }
+        vst1q_f32(out + k, acc);
+    }
+}
+
+float lb_keogh_neon(const float* q, std::size_t q_stride,
+                    const float* upper, const float* lower, std::size_t stride,
+                    std::size_t len) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t acc = zero;
+    const std::size_t full = len / 4 * 4;
+    for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+        const float* qd = q + d * q_stride;
+        const float* ud = upper + d * stride;
+        const float* ld = lower + d * stride;
+        for (std::size_t j = 0; j < full; j += 4) {
+            const float32x4_t v = vld1q_f32(qd + j);
+            const float32x4_t above = vmaxq_f32(vsubq_f32(v, vld1q_f32(ud + j)), zero);
+            const float32x4_t below = vmaxq_f32(vsubq_f32(vld1q_f32(ld + j), v), zero);
+            const float32x4_t e = vaddq_f32(above, below);
+            acc = fma4(acc, e, e);
+        }
+    }
+#if defined(__aarch64__)
+    const float sum = vaddvq_f32(acc);
+#else
+    const float32x2_t p = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    const float sum = vget_lane_f32(vpadd_f32(p, p), 0);
+#endif
+    return sum + lb_keogh_tail(q, q_stride, upper, lower, stride, full, len);
+}
+
+#endif
+
+// ---------- wybór wariantu (raz, przy pierwszym użyciu) ----------
+
+using BandCostFn = void (*)(const float*, const float*, std::size_t, std::size_t, float*);
+using LbKeoghFn  = float (*)(const float*, std::size_t, const float*, const float*,
+                             std::size_t, std::size_t);
+
+struct KernelTable {
+    BandCostFn band_cost;
+    LbKeoghFn  lb_keogh;
+    const char* isa;
+};
+
+KernelTable select_kernels() {
+#if defined(BNO_DTW_NEON)
+    return KernelTable{band_cost_neon, lb_keogh_neon, "neon"};
+#else
+#if defined(BNO_DTW_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return KernelTable{band_cost_avx2, lb_keogh_avx2, "avx2"};
+    }
+#endif
+    return KernelTable{band_cost_scalar, lb_keogh_scalar, "scalar"};
+#endif
+}
+
+const KernelTable& kernels() {
+    static const KernelTable table = select_kernels();
+    return table;
+}
+
+// Obwiednia LB_Keogh dla pasa o promieniu w (naiwnie O(n*w) – tylko przy dodawaniu wzorca).
+void build_envelope(DtwTemplate& tmpl, std::size_t w) {
+    tmpl.upper.assign(tmpl.series.size(), 0.0f);
+    tmpl.lower.assign(tmpl.series.size(), 0.0f);
+    for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+        const float* s = tmpl.series.data() + d * tmpl.stride;
+        for (std::size_t j = 0; j < tmpl.length; ++j) {
+            const std::size_t lo = (j > w) ? j - w : 0;
+            const std::size_t hi = std::min(tmpl.length - 1, j + w);
+            float mx = s[lo];
+            float mn = s[lo];
+            for (std::size_t k = lo + 1; k <= hi; ++k) {
+                mx = std::max(mx, s[k]);
+                mn = std::min(mn, s[k]);
+            }
+            tmpl.upper[d * tmpl.stride + j] = mx;
+            tmpl.lower[d * tmpl.stride + j] = mn;
+        }
+    }
+}
+
+} // namespace
+
+namespace dtw_kernels {
+
+void band_cost(const float* q, const float* c, std::size_t stride,
+               std::size_t count, float* out) {
+    kernels().band_cost(q, c, stride, count, out);
+}
+
+float lb_keogh(const float* q, std::size_t q_stride,
+               const float* upper, const float* lower, std::size_t stride,
+               std::size_t len) {
+    return kernels().lb_keogh(q, q_stride, upper, lower, stride, len);
+}
+
+const char* active_isa() {
+    return kernels().isa;
+}
+
+} // namespace dtw_kernels
+
+DtwRecognizer::DtwRecognizer(const Config& cfg)
+    : cfg_(cfg)
+{}
+
+bool DtwRecognizer::add_template(const std::string& label,
+                                 const std::vector<ImuCsvRow>& rows,
+                                 std::string& err) {
+    if (rows.size() < 3) {
+        err = label + ": too few samples";
+        return false;
+    }
+
+    // 1) grawitacja z początku nagrania – tak samo jak w strumieniu na żywo
+    const double t0 = rows.front().t;
+    Vec3 a0{};
+    std::size_t n0 = 0;
+    for (const auto& r : rows) {
+        if (r.t - t0 > cfg_.baseline_window_s) {
+            break;
+        }
+        const Quat q{r.qw, r.qi, r.qj, r.qk};
+        const Vec3 aw = rotate_vector_by_quat(Vec3{r.ax, r.ay, r.az}, q);
+        a0.x += aw.x;
+        a0.y += aw.y;
+        a0.z += aw.z;
+        ++n0;
+    }
+    a0.x /= static_cast<double>(n0);
+    a0.y /= static_cast<double>(n0);
+    a0.z /= static_cast<double>(n0);
+
+    // 2) cechy wszystkich próbek
+    std::vector<float> feat(rows.size() * DTW_DIMS);
+    std::vector<double> mag(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        const Quat q{r.qw, r.qi, r.qj, r.qk};
+        const Vec3 aw = rotate_vector_by_quat(Vec3{r.ax, r.ay, r.az}, q);
+        const Vec3 gw = rotate_vector_by_quat(Vec3{r.gx, r.gy, r.gz}, q);
+        const Vec3 dyn{aw.x - a0.x, aw.y - a0.y, aw.z - a0.z};
+        float* f = &feat[i * DTW_DIMS];
+        f[0] = static_cast<float>(dyn.x);
+        f[1] = static_cast<float>(dyn.y);
+        f[2] = static_cast<float>(dyn.z);
+        f[3] = cfg_.gyro_weight * static_cast<float>(gw.x);
+        f[4] = cfg_.gyro_weight * static_cast<float>(gw.y);
+        f[5] = cfg_.gyro_weight * static_cast<float>(gw.z);
+        mag[i] = norm(dyn);
+    }
+
+    // 3) przycięcie do aktywnej części (+ margines)
+    std::size_t first = rows.size();
+    std::size_t last = 0;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i].t - t0 <= cfg_.baseline_window_s) {
+            continue;
+        }
+        if (mag[i] >= cfg_.template_dyn_threshold) {
+            first = std::min(first, i);
+            last = i;
+        }
+    }
+    if (first == rows.size()) {
+        err = label + ": no motion above threshold";
+        return false;
+    }
+    const double t_active_begin = rows[first].t;
+    const double t_active_end = rows[last].t;
+    while (first > 0 && rows[first - 1].t >= t_active_begin - cfg_.template_pad_s) {
+        --first;
+    }
+    while (last + 1 < rows.size() && rows[last + 1].t <= t_active_end + cfg_.template_pad_s) {
+        ++last;
+    }
+
+    std::size_t len = last - first + 1;
+    if (len > cfg_.max_template_len) {
+        err = label + ": active part too long (" + std::to_string(len) + " samples)";
+        return false;
+    }
+    if (len < 3) {
+        err = label + ": active part too short";
+        return false;
+    }
+
+    // 4) SoA + obwiednia
+    DtwTemplate tmpl;
+    tmpl.label = label;
+    tmpl.length = len;
+    tmpl.stride = series_stride(len);
+    tmpl.series.assign(DTW_DIMS * tmpl.stride, 0.0f);
+    for (std::size_t j = 0; j < len; ++j) {
+        for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+            tmpl.series[d * tmpl.stride + j] = feat[(first + j) * DTW_DIMS + d];
+        }
+    }
+    const std::size_t w = std::max<std::size_t>(1, static_cast<std::size_t>(
+        std::lround(cfg_.band_ratio * static_cast<double>(len))));
+    build_envelope(tmpl, w);
+
+    templates_.push_back(std::move(tmpl));
+
+    // bufory DP i ring dopasowane do najdłuższego wzorca
+    std::size_t max_len = 0;
+    for (const auto& t : templates_) {
+        max_len = std::max(max_len, t.length);
+    }
+    dp_prev_.assign(max_len + 1, INF);
+    dp_curr_.assign(max_len + 1, INF);
+    cost_row_.assign(series_stride(max_len), 0.0f);
+    if (max_len > ring_cap_) {
+        resize_ring(max_len);
+    }
+    return true;
+}
+
+bool DtwRecognizer::add_template_from_csv(const std::string& label,
+                                          const std::string& path,
+                                          std::string& err) {
+    std::vector<ImuCsvRow> rows;
+    if (!read_imu_samples(path, rows, err)) {
+        return false;
+    }
+    return add_template(label, rows, err);
+}
+
+void DtwRecognizer::resize_ring(std::size_t cap) {
+    ring_cap_ = cap;
+    ring_stride_ = series_stride(2 * cap);
+    ring_.assign(DTW_DIMS * ring_stride_, 0.0f);
+    ring_t_.assign(2 * cap, 0.0);
+    ring_pos_ = 0;
+    ring_count_ = 0;
+}
+
+void DtwRecognizer::add_sample(double t, const Vec3& accel_sensor,
+                               const Vec3& gyro_sensor, const Quat& quat) {
+    const Vec3 aw = rotate_vector_by_quat(accel_sensor, quat);
+
+    if (!baseline_ready_) {
+        if (t_first_ < 0.0) {
+            t_first_ = t;
+        }
+        if (t - t_first_ <= cfg_.baseline_window_s || baseline_n_ < 3) {
+            baseline_sum_[0] += aw.x;
+            baseline_sum_[1] += aw.y;
+            baseline_sum_[2] += aw.z;
+            ++baseline_n_;
+            return;
+        }
+        const double n = static_cast<double>(baseline_n_);
+        a0_world_ = Vec3{baseline_sum_[0] / n, baseline_sum_[1] / n, baseline_sum_[2] / n};
+        baseline_ready_ = true;
+    }
+
+    if (ring_cap_ == 0) {
+        return;  // brak wzorców
+    }
+
+    const Vec3 gw = rotate_vector_by_quat(gyro_sensor, quat);
+    const Vec3 dyn{aw.x - a0_world_.x, aw.y - a0_world_.y, aw.z - a0_world_.z};
+    const float f[DTW_DIMS] = {
+        static_cast<float>(dyn.x),
+        static_cast<float>(dyn.y),
+        static_cast<float>(dyn.z),
+        cfg_.gyro_weight * static_cast<float>(gw.x),
+        cfg_.gyro_weight * static_cast<float>(gw.y),
+        cfg_.gyro_weight * static_cast<float>(gw.z),
+    };
+
+    for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+        ring_[d * ring_stride_ + ring_pos_] = f[d];
+        ring_[d * ring_stride_ + ring_pos_ + ring_cap_] = f[d];
+    }
+    ring_t_[ring_pos_] = t;
+    ring_t_[ring_pos_ + ring_cap_] = t;
+    ring_pos_ = (ring_pos_ + 1) % ring_cap_;
+    ring_count_ = std::min(ring_count_ + 1, ring_cap_);
+
+    if (norm(dyn) >= cfg_.min_peak_magnitude) {
+        last_active_t_ = t;
+    }
+
+    if (++since_eval_ >= cfg_.eval_stride) {
+        since_eval_ = 0;
+        evaluate(t);
+    }
+}
+
+std::optional<DtwMatch> DtwRecognizer::poll_result() {
+    if (!pending_) {
+        return std::nullopt;
+    }
+    auto out = pending_;
+    pending_.reset();
+    return out;
+}
+
+float DtwRecognizer::distance(const float* query, std::size_t query_stride,
+                              const DtwTemplate& tmpl, float abandon_above) {
+    const std::size_t n = tmpl.length;
+    const std::size_t w = std::max<std::size_t>(1, static_cast<std::size_t>(
+        std::lround(cfg_.band_ratio * static_cast<double>(n))));
+
+    std::fill(dp_prev_.begin(), dp_prev_.begin() + static_cast<std::ptrdiff_t>(n + 1), INF);
+    dp_prev_[0] = 0.0f;
+
+    float qv[DTW_DIMS];
+    for (std::size_t i = 1; i <= n; ++i) {
+        const std::size_t lo = (i > w) ? i - w : 1;
+        const std::size_t hi = std::min(n, i + w);
+
+        for (std::size_t d = 0; d < DTW_DIMS; ++d) {
+            qv[d] = query[d * query_stride + (i - 1)];
+        }
+        dtw_kernels::band_cost(qv, tmpl.series.data() + (lo - 1), tmpl.stride,
+                               hi - lo + 1, cost_row_.data());
+
+        dp_curr_[lo - 1] = INF;
+        float row_min = INF;
+        for (std::size_t j = lo; j <= hi; ++j) {
+            const float best = std::min(std::min(dp_prev_[j - 1], dp_prev_[j]), dp_curr_[j - 1]);
+            const float v = cost_row_[j - lo] + best;
+            dp_curr_[j] = v;
+            row_min = std::min(row_min, v);
+        }
+        if (hi < n) {
+            dp_curr_[hi + 1] = INF;
+        }
+
+        if (row_min > abandon_above) {
+            return INF;
+        }
+        std::swap(dp_prev_, dp_curr_);
+    }
+    return dp_prev_[n];
+}
+
+void DtwRecognizer::evaluate(double t_now) {
+    if ((t_now - last_match_t_) < cfg_.min_gesture_interval) {
+        return;
+    }
+    ++stats_.evaluations;
+
+    float best_norm = cfg_.max_distance;
+    std::size_t best_idx = templates_.size();
+    std::size_t best_start = 0;
+
+    for (std::size_t k = 0; k < templates_.size(); ++k) {
+        const DtwTemplate& tmpl = templates_[k];
+        if (tmpl.length > ring_count_) {
+            continue;
+        }
+        const std::size_t start = ring_pos_ + ring_cap_ - tmpl.length;
+        if (last_active_t_ < ring_t_[start]) {
+            continue;  // w oknie nie było ruchu
+        }
+
+        const float len = static_cast<float>(tmpl.length);
+        const float abandon_above = best_norm * len;
+        const float* query = ring_.data() + start;
+
+        const float lb = dtw_kernels::lb_keogh(query, ring_stride_,
+                                               tmpl.upper.data(), tmpl.lower.data(),
+                                               tmpl.stride, tmpl.length);
+        if (lb >= abandon_above) {
+            ++stats_.lb_pruned;
+            continue;
+        }
+
+        const float d = distance(query, ring_stride_, tmpl, abandon_above);
+        if (!std::isfinite(d)) {
+            ++stats_.abandoned;
+            continue;
+        }
+        ++stats_.full_dtw;
+
+        const float dn = d / len;
+        if (dn < best_norm) {
+            best_norm = dn;
+            best_idx = k;
+            best_start = start;
+        }
+    }
+
+    if (best_idx == templates_.size()) {
+        return;
+    }
+
+    DtwMatch m;
+    m.t_end = t_now;
+    m.duration = t_now - ring_t_[best_start];
+    m.label = templates_[best_idx].label;
+    m.distance = best_norm;
+    m.template_index = best_idx;
+    pending_ = m;
+    last_match_t_ = t_now;
+}
+
+} // namespace bno
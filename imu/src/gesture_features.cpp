@@ -0,0 +1,163 @@
+#include "bno/gesture_features.hpp"
+
+#include <cmath>
+
+namespace bno {
+
+namespace {
+
+constexpr const char* FEATURE_NAMES[FEATURE_COUNT] = {
+    "mean_ax", "mean_ay", "mean_az",
+    "std_ax", "std_ay", "std_az",
+    "mean_gx", "mean_gy", "mean_gz",
+    "std_gx", "std_gy", "std_gz",
+    "accel_energy", "gyro_energy",
+    "dv_x", "dv_y", "dv_z",
+    "peak_accel", "peak_gyro",
+    "t_peak_accel", "t_peak_gyro",
+    "t_max_ax", "t_max_ay", "t_max_az",
+    "t_min_ax", "t_min_ay", "t_min_az",
+    "rot_x", "rot_y", "rot_z",
+    "duration",
+};
+
+} // namespace
+
+const char* gesture_feature_name(std::size_t i)
+{
+    return i < FEATURE_COUNT ? FEATURE_NAMES[i] : "?";
+}
+
+WindowFeatureExtractor::WindowFeatureExtractor(std::size_t capacity)
+    : ring_(capacity < 16 ? 16 : capacity)
+{}
+
+void WindowFeatureExtractor::clear()
+{
+    head_ = 0;
+    size_ = 0;
+}
+
+void WindowFeatureExtractor::add_sample(double t, const Vec3& accel_sensor,
+                                        const Vec3& gyro_sensor, const Quat& quat)
+{
+    std::size_t idx;
+    if (size_ < ring_.size()) {
+        idx = (head_ + size_) % ring_.size();
+        ++size_;
+    } else {
+        idx = head_;
+        head_ = (head_ + 1) % ring_.size();
+    }
+    ring_[idx] = Sample{t, rotate_vector_by_quat(accel_sensor, quat),
+                        rotate_vector_by_quat(gyro_sensor, quat), quat};
+}
+
+std::size_t WindowFeatureExtractor::first_at_or_after(double t) const
+{
+    std::size_t lo = 0;
+    std::size_t hi = size_;
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (at(mid).t < t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool WindowFeatureExtractor::extract(double t_from, double t_to, const Vec3& gravity_world,
+                                     GestureFeatureVector& out) const
+{
+    const std::size_t i0 = first_at_or_after(t_from);
+    std::size_t i1 = i0;
+    while (i1 < size_ && at(i1).t <= t_to) {
+        ++i1;
+    }
+    if (i1 < i0 + 3) {
+        return false;
+    }
+
+    const double t0 = at(i0).t;
+    const double span = at(i1 - 1).t - t0;
+    const double inv_span = span > 0.0 ? 1.0 / span : 0.0;
+    const double n = static_cast<double>(i1 - i0);
+
+    // Jedno przejście: sumy, sumy kwadratów, ekstrema z chwilami
+    double sa[3] = {}, sa2[3] = {}, sg[3] = {}, sg2[3] = {};
+    double dv[3] = {};
+    double amax[3], amin[3], tmax[3] = {}, tmin[3] = {};
+    double e_acc = 0.0, e_gyro = 0.0;
+    double peak_a = -1.0, peak_g = -1.0, t_peak_a = 0.0, t_peak_g = 0.0;
+    for (std::size_t k = 0; k < 3; ++k) {
+        amax[k] = -1e300;
+        amin[k] = 1e300;
+    }
+
+    for (std::size_t i = i0; i < i1; ++i) {
+        const Sample& s = at(i);
+        const double a[3] = {s.a.x - gravity_world.x, s.a.y - gravity_world.y,
+                             s.a.z - gravity_world.z};
+        const double g[3] = {s.g.x, s.g.y, s.g.z};
+        const double rel = (s.t - t0) * inv_span;
+        const double dt = i > i0 ? s.t - at(i - 1).t : 0.0;
+
+        double a2 = 0.0, g2 = 0.0;
+        for (std::size_t k = 0; k < 3; ++k) {
+            sa[k] += a[k];
+            sa2[k] += a[k] * a[k];
+            sg[k] += g[k];
+            sg2[k] += g[k] * g[k];
+            dv[k] += a[k] * dt;
+            a2 += a[k] * a[k];
+            g2 += g[k] * g[k];
+            if (a[k] > amax[k]) {
+                amax[k] = a[k];
+                tmax[k] = rel;
+            }
+            if (a[k] < amin[k]) {
+                amin[k] = a[k];
+                tmin[k] = rel;
+            }
+        }
+        e_acc += a2;
+        e_gyro += g2;
+        if (a2 > peak_a) {
+            peak_a = a2;
+            t_peak_a = rel;
+        }
+        if (g2 > peak_g) {
+            peak_g = g2;
+            t_peak_g = rel;
+        }
+    }
+
+    auto stddev = [n](double sum, double sum2) {
+        const double m = sum / n;
+        return std::sqrt(std::fmax(0.0, sum2 / n - m * m));
+    };
+    const Vec3 rot = rotation_vector(quat_mul(at(i1 - 1).q, quat_conj(at(i0).q)));
+
+    const double f[FEATURE_COUNT] = {
+        sa[0] / n, sa[1] / n, sa[2] / n,
+        stddev(sa[0], sa2[0]), stddev(sa[1], sa2[1]), stddev(sa[2], sa2[2]),
+        sg[0] / n, sg[1] / n, sg[2] / n,
+        stddev(sg[0], sg2[0]), stddev(sg[1], sg2[1]), stddev(sg[2], sg2[2]),
+        e_acc / n, e_gyro / n,
+        dv[0], dv[1], dv[2],
+        std::sqrt(peak_a), std::sqrt(peak_g),
+        t_peak_a, t_peak_g,
+        tmax[0], tmax[1], tmax[2],
+        tmin[0], tmin[1], tmin[2],
+        rot.x, rot.y, rot.z,
+        span,
+    };
+    for (std::size_t k = 0; k < FEATURE_COUNT; ++k) {
+        out[k] = static_cast<float>(f[k]);
+    }
+    return true;
+}
+
+} // namespace bno
@@ -0,0 +1,234 @@
+#include "bno/gesture_seq.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace bno {
+
+namespace {
+
+constexpr std::uint32_t NO_STATE = std::numeric_limits<std::uint32_t>::max();
+
+} // namespace
+
+GestureSequenceMatcher::GestureSequenceMatcher(const Config& cfg)
+    : cfg_(cfg)
+{}
+
+bool GestureSequenceMatcher::add_pattern(const ComboPattern& pattern, std::string& err)
+{
+    if (pattern.name.empty()) {
+        err = "combo pattern without name";
+        return false;
+    }
+    if (pattern.steps.empty()) {
+        err = "combo " + pattern.name + ": no steps";
+        return false;
+    }
+    for (const auto& s : pattern.steps) {
+        if (s.empty()) {
+            err = "combo " + pattern.name + ": empty step";
+            return false;
+        }
+    }
+    patterns_.push_back(pattern);
+    if (patterns_.back().max_gap_s <= 0.0) {
+        patterns_.back().max_gap_s = cfg_.max_gap_s;
+    }
+    return true;
+}
+
+bool GestureSequenceMatcher::compile(std::string& err)
+{
+    if (patterns_.empty()) {
+        err = "no combo patterns";
+        return false;
+    }
+
+    // 1) alfabet
+    symbols_.clear();
+    alphabet_ = 1;
+    max_len_ = 0;
+    for (const auto& p : patterns_) {
+        for (const auto& s : p.steps) {
+            if (symbols_.find(s) == symbols_.end()) {
+                if (alphabet_ > std::numeric_limits<std::uint16_t>::max()) {
+                    err = "too many distinct combo labels";
+                    return false;
+                }
+                symbols_.emplace(s, static_cast<std::uint16_t>(alphabet_));
+                ++alphabet_;
+            }
+        }
+        max_len_ = std::max(max_len_, p.steps.size());
+    }
+
+    // 2) trie (NO_STATE = brak krawędzi)
+    next_.assign(alphabet_, NO_STATE);
+    timeout_.assign(1, 0.0);
+    std::vector<std::vector<std::uint32_t>> own_out(1);
+    state_count_ = 1;
+
+    for (std::size_t pi = 0; pi < patterns_.size(); ++pi) {
+        const auto& p = patterns_[pi];
+        std::uint32_t s = 0;
+        for (const auto& step : p.steps) {
+            const std::size_t sym = symbols_.at(step);
+            std::uint32_t& edge = next_[s * alphabet_ + sym];
+            if (edge == NO_STATE) {
+                edge = static_cast<std::uint32_t>(state_count_++);
+                next_.resize(state_count_ * alphabet_, NO_STATE);
+                timeout_.push_back(0.0);
+                own_out.emplace_back();
+            }
+            s = next_[s * alphabet_ + sym];
+            // z tego stanu czekamy na kolejny krok najdłużej, jak pozwala
+            // którykolwiek wzorzec przez niego przechodzący
+            timeout_[s] = std::max(timeout_[s], p.max_gap_s);
+        }
+        own_out[s].push_back(static_cast<std::uint32_t>(pi));
+    }
+
+    // 3) BFS: przejścia awaryjne wpisane wprost w tablicę + wyjścia z sufiksów
+    std::vector<std::uint32_t> fail(state_count_, 0);
+    std::vector<std::uint32_t> order;
+    order.reserve(state_count_);
+
+    for (std::size_t sym = 0; sym < alphabet_; ++sym) {
+        std::uint32_t& edge = next_[sym];
+        if (edge == NO_STATE) {
+            edge = 0;
+        } else {
+            fail[edge] = 0;
+            order.push_back(edge);
+        }
+    }
+    for (std::size_t qi = 0; qi < order.size(); ++qi) {
+        const std::uint32_t s = order[qi];
+        for (std::size_t sym = 0; sym < alphabet_; ++sym) {
+            std::uint32_t& edge = next_[s * alphabet_ + sym];
+            const std::uint32_t via_fail = next_[fail[s] * alphabet_ + sym];
+            if (edge == NO_STATE) {
+                edge = via_fail;
+            } else {
+                fail[edge] = via_fail;
+                order.push_back(edge);
+            }
+        }
+    }
+
+    // 4) spłaszczone wyjścia: własne + łańcuch fail (BFS gwarantuje, że
+    //    stan fail jest już gotowy)
+    std::vector<std::vector<std::uint32_t>> all_out(state_count_);
+    all_out[0] = own_out[0];
+    for (const std::uint32_t s : order) {
+        all_out[s] = own_out[s];
+        const auto& inherited = all_out[fail[s]];
+        all_out[s].insert(all_out[s].end(), inherited.begin(), inherited.end());
+    }
+
+    out_begin_.assign(state_count_ + 1, 0);
+    out_.clear();
+    std::size_t max_out = 0;
+    for (std::size_t s = 0; s < state_count_; ++s) {
+        out_begin_[s] = static_cast<std::uint32_t>(out_.size());
+        out_.insert(out_.end(), all_out[s].begin(), all_out[s].end());
+        max_out = std::max(max_out, all_out[s].size());
+    }
+    out_begin_[state_count_] = static_cast<std::uint32_t>(out_.size());
+
+    history_t_.assign(max_len_, 0.0);
+    matches_.assign(max_out, ComboMatch{0, 0.0, 0.0});
+    reset();
+    return true;
+}
+
+std::uint16_t GestureSequenceMatcher::symbol_of(const std::string& label) const
+{
+    const auto it = symbols_.find(label);
+    return (it == symbols_.end()) ? std::uint16_t{0} : it->second;
+}
+
+void GestureSequenceMatcher::reset()
+{
+    state_ = 0;
+    history_pos_ = 0;
+    history_count_ = 0;
+}
+
+bool GestureSequenceMatcher::pattern_gaps_ok(const ComboPattern& p) const
+{
+    // history_t_[history_pos_ - 1] = bieżące zdarzenie, idziemy wstecz
+    const std::size_t cap = history_t_.size();
+    std::size_t idx = (history_pos_ + cap - 1) % cap;
+    double later = history_t_[idx];
+    for (std::size_t k = 1; k < p.steps.size(); ++k) {
+        idx = (idx + cap - 1) % cap;
+        const double earlier = history_t_[idx];
+        if (later - earlier > p.max_gap_s) {
+            return false;
+        }
+        later = earlier;
+    }
+    return true;
+}
+
+std::size_t GestureSequenceMatcher::feed_symbol(std::uint16_t symbol, double t)
+{
+    if (state_count_ == 0 || symbol >= alphabet_) {
+        return 0;
+    }
+
+    if (state_ != 0 && (t - last_t_) > timeout_[state_]) {
+        // za długa przerwa – porzucamy rozpoczęte sekwencje
+        reset();
+    }
+    last_t_ = t;
+
+    history_t_[history_pos_] = t;
+    history_pos_ = (history_pos_ + 1) % history_t_.size();
+    history_count_ = std::min(history_count_ + 1, history_t_.size());
+
+    state_ = next_[state_ * alphabet_ + symbol];
+
+    std::size_t n = 0;
+    for (std::uint32_t k = out_begin_[state_]; k < out_begin_[state_ + 1]; ++k) {
+        const ComboPattern& p = patterns_[out_[k]];
+        if (p.steps.size() > history_count_ || !pattern_gaps_ok(p)) {
+            continue;
+        }
+        const std::size_t cap = history_t_.size();
+        const std::size_t first = (history_pos_ + cap - p.steps.size()) % cap;
+        matches_[n++] = ComboMatch{out_[k], history_t_[first], t};
+    }
+
+    if (n > 0 && cfg_.reset_on_match) {
+        reset();
+    }
+    return n;
+}
+
+bool parse_combo_spec(const std::string& spec, ComboPattern& out, std::string& err)
+{
+    const auto eq = spec.find('=');
+    if (eq == std::string::npos || eq == 0 || eq + 1 == spec.size()) {
+        err = "combo expects NAME=LABEL,LABEL[,...], got: " + spec;
+        return false;
+    }
+    out = ComboPattern{};
+    out.name = spec.substr(0, eq);
+
+    std::size_t pos = eq + 1;
+    while (pos <= spec.size()) {
+        const auto comma = std::min(spec.find(',', pos), spec.size());
+        if (comma == pos) {
+            err = "combo " + out.name + ": empty step in " + spec;
+            return false;
+        }
+        out.steps.push_back(spec.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    return true;
+}
+
+} // namespace bno
@@ -0,0 +1,187 @@
+#include "bno/gesture_simd.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BNO_GESTURE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BNO_GESTURE_NEON 1
+#endif
+
+namespace bno {
+
+namespace {
+
+void rotate_tail(const float* qw, const float* qx, const float* qy, const float* qz,
+                 const float* vx, const float* vy, const float* vz,
+                 float* ox, float* oy, float* oz,
+                 std::size_t from, std::size_t n)
+{
+    for (std::size_t i = from; i < n; ++i) {
+        // lokalne kopie – wyjście może aliasować wejście
+        const float x = vx[i];
+        const float y = vy[i];
+        const float z = vz[i];
+        rotate_vector_by_quat_f(qw[i], qx[i], qy[i], qz[i], x, y, z, ox[i], oy[i], oz[i]);
+    }
+}
+
+} // namespace
+
+#if defined(BNO_GESTURE_SSE)
+
+void rotate_vectors_by_quats(const float* qw, const float* qx,
+                             const float* qy, const float* qz,
+                             const float* vx, const float* vy, const float* vz,
+                             float* ox, float* oy, float* oz,
+                             std::size_t n)
+{
+    const __m128 two = _mm_set1_ps(2.0f);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 w = _mm_loadu_ps(qw + i);
+        const __m128 x = _mm_loadu_ps(qx + i);
+        const __m128 y = _mm_loadu_ps(qy + i);
+        const __m128 z = _mm_loadu_ps(qz + i);
+        const __m128 px = _mm_loadu_ps(vx + i);
+        const __m128 py = _mm_loadu_ps(vy + i);
+        const __m128 pz = _mm_loadu_ps(vz + i);
+
+        // t = 2 * (q_vec x v)
+        const __m128 tx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(y, pz), _mm_mul_ps(z, py)));
+        const __m128 ty = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(z, px), _mm_mul_ps(x, pz)));
+        const __m128 tz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(x, py), _mm_mul_ps(y, px)));
+
+        // v' = v + w * t + (q_vec x t)
+        const __m128 rx = _mm_add_ps(_mm_add_ps(px, _mm_mul_ps(w, tx)),
+                                     _mm_sub_ps(_mm_mul_ps(y, tz), _mm_mul_ps(z, ty)));
+        const __m128 ry = _mm_add_ps(_mm_add_ps(py, _mm_mul_ps(w, ty)),
+                                     _mm_sub_ps(_mm_mul_ps(z, tx), _mm_mul_ps(x, tz)));
+        const __m128 rz = _mm_add_ps(_mm_add_ps(pz, _mm_mul_ps(w, tz)),
+                                     _mm_sub_ps(_mm_mul_ps(x, ty), _mm_mul_ps(y, tx)));
+
+        _mm_storeu_ps(ox + i, rx);
+        _mm_storeu_ps(oy + i, ry);
+        _mm_storeu_ps(oz + i, rz);
+    }
+    rotate_tail(qw, qx, qy, qz, vx, vy, vz, ox, oy, oz, i, n);
+}
+
+void vector_norms(const float* x, const float* y, const float* z,
+                  float bx, float by, float bz,
+                  float* out, std::size_t n)
+{
+    const __m128 vbx = _mm_set1_ps(bx);
+    const __m128 vby = _mm_set1_ps(by);
+    const __m128 vbz = _mm_set1_ps(bz);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), vbx);
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), vby);
+        const __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), vbz);
+        const __m128 sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                     _mm_mul_ps(dz, dz));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(sq));
+    }
+    for (; i < n; ++i) {
+        const float dx = x[i] - bx;
+        const float dy = y[i] - by;
+        const float dz = z[i] - bz;
+        out[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+#elif defined(BNO_GESTURE_NEON)
+
+void rotate_vectors_by_quats(const float* qw, const float* qx,
+                             const float* qy, const float* qz,
+                             const float* vx, const float* vy, const float* vz,
+                             float* ox, float* oy, float* oz,
+                             std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t w = vld1q_f32(qw + i);
+        const float32x4_t x = vld1q_f32(qx + i);
+        const float32x4_t y = vld1q_f32(qy + i);
+        const float32x4_t z = vld1q_f32(qz + i);
+        const float32x4_t px = vld1q_f32(vx + i);
+        const float32x4_t py = vld1q_f32(vy + i);
+        const float32x4_t pz = vld1q_f32(vz + i);
+
+        // t = 2 * (q_vec x v)
+        const float32x4_t tx = vmulq_n_f32(vmlsq_f32(vmulq_f32(y, pz), z, py), 2.0f);
+        const float32x4_t ty = vmulq_n_f32(vmlsq_f32(vmulq_f32(z, px), x, pz), 2.0f);
+        const float32x4_t tz = vmulq_n_f32(vmlsq_f32(vmulq_f32(x, py), y, px), 2.0f);
+
+        // v' = v + w * t + (q_vec x t)
+        const float32x4_t rx = vaddq_f32(vmlaq_f32(px, w, tx), vmlsq_f32(vmulq_f32(y, tz), z, ty));
+        const float32x4_t ry = vaddq_f32(vmlaq_f32(py, w, ty), vmlsq_f32(vmulq_f32(z, tx), x, tz));
+        const float32x4_t rz = vaddq_f32(vmlaq_f32(pz, w, tz), vmlsq_f32(vmulq_f32(x, ty), y, tx));
+
+        vst1q_f32(ox + i, rx);
+        vst1q_f32(oy + i, ry);
+        vst1q_f32(oz + i, rz);
+    }
+    rotate_tail(qw, qx, qy, qz, vx, vy, vz, ox, oy, oz, i, n);
+}
+
+void vector_norms(const float* x, const float* y, const float* z,
+                  float bx, float by, float bz,
+                  float* out, std::size_t n)
+{
+    const float32x4_t vbx = vdupq_n_f32(bx);
+    const float32x4_t vby = vdupq_n_f32(by);
+    const float32x4_t vbz = vdupq_n_f32(bz);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t dx = vsubq_f32(vld1q_f32(x + i), vbx);
+        const float32x4_t dy = vsubq_f32(vld1q_f32(y + i), vby);
+        const float32x4_t dz = vsubq_f32(vld1q_f32(z + i), vbz);
+        const float32x4_t sq = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+#if defined(__aarch64__)
+        vst1q_f32(out + i, vsqrtq_f32(sq));
+#else
+        // ARMv7 NEON nie ma vsqrtq – kwadraty wektorowo, pierwiastek skalarnie
+        vst1q_f32(out + i, sq);
+        for (std::size_t k = i; k < i + 4; ++k) {
+            out[k] = std::sqrt(out[k]);
+        }
+#endif
+    }
+    for (; i < n; ++i) {
+        const float dx = x[i] - bx;
+        const float dy = y[i] - by;
+        const float dz = z[i] - bz;
+        out[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+#else
+
+void rotate_vectors_by_quats(const float* qw, const float* qx,
+                             const float* qy, const float* qz,
+                             const float* vx, const float* vy, const float* vz,
+                             float* ox, float* oy, float* oz,
+                             std::size_t n)
+{
+    rotate_tail(qw, qx, qy, qz, vx, vy, vz, ox, oy, oz, 0, n);
+}
+
+void vector_norms(const float* x, const float* y, const float* z,
+                  float bx, float by, float bz,
+                  float* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        const float dx = x[i] - bx;
+        const float dy = y[i] - by;
+        const float dz = z[i] - bz;
+        out[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+#endif
+
+} // namespace bno
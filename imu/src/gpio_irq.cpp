@@ -0,0 +1,158 @@
+#include "bno/gpio_irq.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace bno {
+
+namespace {
+
+constexpr const char* DEFAULT_CHIP = "/dev/gpiochip0";
+
+void set_errno_error(ShtpError& err, const char* what)
+{
+    err.code = ShtpError::Code::IoError;
+    err.sys_errno = errno;
+    err.message = std::string(what) + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+GpioInterrupt::~GpioInterrupt()
+{
+    close();
+}
+
+bool GpioInterrupt::open(const std::string& spec, std::string& err)
+{
+    close();
+
+    std::string chip = DEFAULT_CHIP;
+    std::string line_str = spec;
+    const auto colon = spec.rfind(':');
+    if (colon != std::string::npos) {
+        chip = spec.substr(0, colon);
+        line_str = spec.substr(colon + 1);
+        if (chip.find('/') == std::string::npos) {
+            chip = "/dev/" + chip;
+        }
+    }
+    char* end = nullptr;
+    const unsigned long line = std::strtoul(line_str.c_str(), &end, 10);
+    if (line_str.empty() || *end != '\0') {
+        err = "gpio: expected <chip>:<line> or <line>, got " + spec;
+        return false;
+    }
+
+    const int chip_fd = ::open(chip.c_str(), O_RDONLY | O_CLOEXEC);
+    if (chip_fd < 0) {
+        err = "gpio: cannot open " + chip + ": " + std::strerror(errno);
+        return false;
+    }
+
+    // H_INTN jest aktywna niska: z ACTIVE_LOW "rising" = przejście w stan aktywny
+    gpio_v2_line_request req{};
+    req.offsets[0] = static_cast<__u32>(line);
+    req.num_lines = 1;
+    std::strncpy(req.consumer, "bno-int", sizeof(req.consumer) - 1);
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_ACTIVE_LOW |
+                       GPIO_V2_LINE_FLAG_EDGE_RISING;
+    req.event_buffer_size = 16;
+    const int rv = ::ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req);
+    const int saved_errno = errno;
+    ::close(chip_fd);
+    if (rv < 0) {
+        err = "gpio: cannot request " + chip + " line " + line_str + ": " +
+              std::strerror(saved_errno);
+        return false;
+    }
+
+    // zdarzenia zbieramy bez blokowania – czekanie jest w poll()
+    const int flags = ::fcntl(req.fd, F_GETFL);
+    if (flags < 0 || ::fcntl(req.fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        err = std::string("gpio: fcntl(O_NONBLOCK): ") + std::strerror(errno);
+        ::close(req.fd);
+        return false;
+    }
+    fd_ = req.fd;
+    edges_ = 0;
+    return true;
+}
+
+void GpioInterrupt::close() noexcept
+{
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool GpioInterrupt::line_active(bool& active, ShtpError& err) const
+{
+    gpio_v2_line_values values{};
+    values.mask = 1;
+    if (::ioctl(fd_, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0) {
+        set_errno_error(err, "gpio get values");
+        return false;
+    }
+    active = (values.bits & 1) != 0;
+    return true;
+}
+
+void GpioInterrupt::drain_events()
+{
+    gpio_v2_line_event events[16];
+    for (;;) {
+        const ssize_t n = ::read(fd_, events, sizeof(events));
+        if (n <= 0) {
+            return;   // EAGAIN – kolejka pusta
+        }
+        edges_ += static_cast<std::uint64_t>(n) / sizeof(gpio_v2_line_event);
+    }
+}
+
+bool GpioInterrupt::wait_active(int timeout_ms, ShtpError& err)
+{
+    if (fd_ < 0) {
+        err.code = ShtpError::Code::NotOpen;
+        err.sys_errno = EBADF;
+        err.message = "gpio not open";
+        return false;
+    }
+    err = ShtpError{};
+
+    // Linia trzyma stan aktywny do odczytu ramki – najpierw poziom, potem zbocze.
+    // Zbocze między sprawdzeniem a poll() czeka w kolejce jądra, nic nie ginie.
+    bool active = false;
+    if (!line_active(active, err)) {
+        return false;
+    }
+    if (active) {
+        drain_events();
+        return true;
+    }
+
+    pollfd pfd{};
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    const int rv = ::poll(&pfd, 1, timeout_ms);
+    if (rv == 0 || (rv < 0 && errno == EINTR)) {
+        return false;
+    }
+    if (rv < 0) {
+        set_errno_error(err, "gpio poll");
+        return false;
+    }
+    drain_events();
+    return true;
+}
+
+} // namespace bno
@@ -0,0 +1,115 @@
+#include "bno/idle_gate.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bno {
+
+bool IdleGate::add_sample(const Sample& s)
+{
+    if (idle_) {
+        return false;   // resztki strumienia sprzed uśpienia
+    }
+
+    push_ring(s);
+
+    if (!have_mean_ || s.t <= last_t_) {
+        have_mean_ = true;
+        mean_ = s.accel;
+        quiet_since_ = s.t;
+    } else {
+        const double alpha = std::min(1.0, (s.t - last_t_) / cfg_.mean_tau_s);
+        mean_ = Vec3{mean_.x + alpha * (s.accel.x - mean_.x),
+                     mean_.y + alpha * (s.accel.y - mean_.y),
+                     mean_.z + alpha * (s.accel.z - mean_.z)};
+    }
+    last_t_ = s.t;
+
+    const Vec3 d{s.accel.x - mean_.x, s.accel.y - mean_.y, s.accel.z - mean_.z};
+    if (norm(d) > cfg_.accel_threshold || norm(s.gyro) > cfg_.gyro_threshold) {
+        quiet_since_ = s.t;
+    }
+    return s.t - quiet_since_ >= cfg_.idle_after_s;
+}
+
+void IdleGate::add_idle_sample(const Sample& s)
+{
+    if (!idle_ || (!ring_.empty() && s.t <= ring_.back().t)) {
+        return;
+    }
+    push_ring(s);
+    idle_stream_ = true;
+    ++stats_.idle_samples;
+}
+
+void IdleGate::push_ring(const Sample& s)
+{
+    ring_.push_back(s);
+    while (ring_.size() > 2 && s.t - ring_.front().t > cfg_.preroll_s) {
+        ring_.pop_front();
+    }
+}
+
+void IdleGate::note_activity(double t)
+{
+    quiet_since_ = std::max(quiet_since_, t);
+}
+
+void IdleGate::enter_idle(double t)
+{
+    idle_ = true;
+    preroll_pending_ = false;
+    idle_stream_ = false;
+    t_idle_ = t;
+    ++stats_.idle_entries;
+}
+
+bool IdleGate::is_wake_event(const Sh2SensorEvent& evt) const
+{
+    const bool tap = evt.tap_flags.has_value();
+    const bool motion = evt.significant_motion;
+    switch (cfg_.wake) {
+    case Wake::Tap:               return tap;
+    case Wake::SignificantMotion: return motion;
+    case Wake::Any:               return tap || motion;
+    }
+    return false;
+}
+
+void IdleGate::wake(double t)
+{
+    if (!idle_) {
+        return;
+    }
+    idle_ = false;
+    preroll_pending_ = true;
+    t_wake_ = t;
+    stats_.idle_s += std::max(0.0, t - t_idle_);
+    ++stats_.wakes;
+}
+
+bool IdleGate::parse_wake(const std::string& name, Wake& out)
+{
+    if (name == "tap") {
+        out = Wake::Tap;
+    } else if (name == "motion") {
+        out = Wake::SignificantMotion;
+    } else if (name == "any") {
+        out = Wake::Any;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* IdleGate::wake_name(Wake w)
+{
+    switch (w) {
+    case Wake::Tap:               return "tap";
+    case Wake::SignificantMotion: return "motion";
+    case Wake::Any:               return "any";
+    }
+    return "?";
+}
+
+} // namespace bno
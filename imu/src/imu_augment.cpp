@@ -0,0 +1,310 @@
+// Syntetyczne okna uczące z nagrań gestów (augmentacja, wiele wątków).
+//
+//   imu_augment --out corpus/aug --windows 1000000 data/*.csv
+//   imu_augment --out aug --threads 4 --none 0.2 --rot 20 LEFT=rec1.csv rec2.imlog
+//
+// Każdy wątek losuje okna (WindowAugmenter: time warp, skala, bias/dryf,
+// szum, obrót montażu i świata) z własnym generatorem i pisze własny shard
+// <out>.<k>.imlog – bez blokad i bez wspólnego bufora. Obok <out>.labels:
+// etykiety w kolejności kolumny `label`, po jednej w linii.
+//
+// Kolumny shardu (schemat .imlog, jak imu_read + trzy dodatkowe):
+//   t (f64, od początku okna), ax..qk (f32),
+//   window (f64, numer okna w shardzie), label (f32, indeks w .labels),
+//   source (f32, indeks nagrania w linii poleceń).
+// Wynik jest deterministyczny dla tego samego --seed i --threads.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bno/augment.hpp"
+#include "bno/imu_log.hpp"
+
+namespace {
+
+struct CliConfig {
+    std::vector<std::pair<std::string, std::string>> inputs;   // (label, path)
+    std::string out_prefix;
+    std::uint64_t windows = 100000;
+    unsigned threads = 0;       // 0 = hardware_concurrency()
+    std::uint64_t seed = 1;
+    bno::WindowAugmenter::Config aug;
+};
+
+constexpr const char* NONE_LABEL = "NONE";   // jak cnn_train.py
+
+void print_usage(const char* argv0)
+{
+    std::cerr
+        << "Usage: " << argv0 << " --out <prefix> [options] <[LABEL=]recording.csv|.imlog>...\n"
+        << "Options:\n"
+        << "  --out <prefix>       Write <prefix>.<k>.imlog shards and <prefix>.labels\n"
+        << "  --windows <n>        Windows to generate (default 100000)\n"
+        << "  --threads <n>        Worker threads = shards (default: all cores)\n"
+        << "  --seed <n>           Random seed (default 1)\n"
+        << "  --rate <hz>          Output grid rate (default 50, as imu_dir --cnn)\n"
+        << "  --window <s>         Window length (default 1.0)\n"
+        << "  --jitter <s>         Gesture position jitter, +- (default 0.2)\n"
+        << "  --none <ratio>       Fraction of background windows labelled NONE (default 0)\n"
+        << "  --warp <w>           Tempo x[1/(1+w), 1+w] (default 0.15)\n"
+        << "  --wobble <a>         Tempo change within the window, < 1 (default 0.1)\n"
+        << "  --scale-accel <s>    Dynamic accel scale 1 +- s (default 0.2)\n"
+        << "  --scale-gyro <s>     Gyro scale 1 +- s (default 0.2)\n"
+        << "  --accel-bias <b>     Accel bias +- b m/s^2 (default 0.05)\n"
+        << "  --accel-drift <d>    Accel drift +- d m/s^2 per s (default 0.05)\n"
+        << "  --gyro-bias <b>      Gyro bias +- b rad/s (default 0.01)\n"
+        << "  --gyro-drift <d>     Gyro drift +- d rad/s per s (default 0.01)\n"
+        << "  --accel-noise <s>    Accel white noise sigma (default 0.03)\n"
+        << "  --gyro-noise <s>     Gyro white noise sigma (default 0.005)\n"
+        << "  --mount <deg>        Random sensor mounting rotation, max angle (default 0)\n"
+        << "  --rot <deg>          Random world-frame rotation, max angle (default 10)\n"
+        << "  -h, --help           Show this help\n"
+        << "Label defaults to the leading letters of the file name: left3.csv -> LEFT.\n";
+}
+
+bool parse_args(int argc, char** argv, CliConfig& cfg)
+{
+    auto& a = cfg.aug;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--out" && i + 1 < argc) {
+            cfg.out_prefix = argv[++i];
+        } else if (arg == "--windows" && i + 1 < argc) {
+            cfg.windows = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            cfg.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            cfg.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rate" && i + 1 < argc) {
+            a.rate_hz = std::atof(argv[++i]);
+        } else if (arg == "--window" && i + 1 < argc) {
+            a.window_s = std::atof(argv[++i]);
+        } else if (arg == "--jitter" && i + 1 < argc) {
+            a.jitter_s = std::atof(argv[++i]);
+        } else if (arg == "--none" && i + 1 < argc) {
+            a.background_ratio = std::atof(argv[++i]);
+        } else if (arg == "--warp" && i + 1 < argc) {
+            a.warp_speed = std::atof(argv[++i]);
+        } else if (arg == "--wobble" && i + 1 < argc) {
+            a.warp_wobble = std::atof(argv[++i]);
+        } else if (arg == "--scale-accel" && i + 1 < argc) {
+            a.scale_accel = std::atof(argv[++i]);
+        } else if (arg == "--scale-gyro" && i + 1 < argc) {
+            a.scale_gyro = std::atof(argv[++i]);
+        } else if (arg == "--accel-bias" && i + 1 < argc) {
+            a.accel_bias = std::atof(argv[++i]);
+        } else if (arg == "--accel-drift" && i + 1 < argc) {
+            a.accel_drift = std::atof(argv[++i]);
+        } else if (arg == "--gyro-bias" && i + 1 < argc) {
+            a.gyro_bias = std::atof(argv[++i]);
+        } else if (arg == "--gyro-drift" && i + 1 < argc) {
+            a.gyro_drift = std::atof(argv[++i]);
+        } else if (arg == "--accel-noise" && i + 1 < argc) {
+            a.accel_noise = std::atof(argv[++i]);
+        } else if (arg == "--gyro-noise" && i + 1 < argc) {
+            a.gyro_noise = std::atof(argv[++i]);
+        } else if (arg == "--mount" && i + 1 < argc) {
+            a.mount_deg = std::atof(argv[++i]);
+        } else if (arg == "--rot" && i + 1 < argc) {
+            a.rot_deg = std::atof(argv[++i]);
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        } else {
+            const auto eq = arg.find('=');
+            if (eq != std::string::npos) {
+                cfg.inputs.emplace_back(arg.substr(0, eq), arg.substr(eq + 1));
+            } else {
+                cfg.inputs.emplace_back(bno::recording_label(arg), arg);
+            }
+            if (cfg.inputs.back().first.empty()) {
+                std::cerr << "No label for " << arg << " (use LABEL=path)\n";
+                return false;
+            }
+        }
+    }
+    if (cfg.inputs.empty() || cfg.out_prefix.empty()) {
+        print_usage(argv[0]);
+        return false;
+    }
+    if (a.rate_hz <= 0.0 || a.window_s <= 0.0 || a.background_ratio < 0.0 ||
+        a.background_ratio > 1.0 || a.warp_wobble < 0.0 || a.warp_wobble >= 1.0) {
+        std::cerr << "--rate/--window must be > 0, --none in [0, 1], --wobble in [0, 1)\n";
+        return false;
+    }
+    if (cfg.threads == 0) {
+        cfg.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return true;
+}
+
+std::vector<bno::ImuLogColumn> shard_schema()
+{
+    std::vector<bno::ImuLogColumn> schema = bno::imu_log_default_schema();
+    schema.push_back({"window", bno::ImuLogType::F64});
+    schema.push_back({"label", bno::ImuLogType::F32});
+    schema.push_back({"source", bno::ImuLogType::F32});
+    return schema;
+}
+
+struct Shard {
+    std::string path;
+    std::uint64_t windows{0};
+    std::uint64_t rows{0};
+    std::uint64_t background{0};
+    std::string err;
+};
+
+// Jeden wątek: losowa klasa (równo), losowe nagranie tej klasy, okno → shard.
+void run_shard(const CliConfig& cfg, const std::vector<bno::AugmentSource>& sources,
+               const std::vector<std::vector<std::size_t>>& by_label, int none_index,
+               unsigned k, Shard& shard)
+{
+    std::seed_seq seq{cfg.seed, static_cast<std::uint64_t>(k)};
+    std::mt19937_64 rng(seq);
+    std::uniform_int_distribution<std::size_t> pick_label(0, by_label.size() - 1);
+    const bno::WindowAugmenter aug(cfg.aug);
+
+    bno::ImuLogWriter writer;
+    if (!writer.open(shard.path, shard_schema(), shard.err, 4096)) {
+        return;
+    }
+    bno::AugmentWindow w;
+    double row[bno::AugmentWindow::COLUMN_COUNT + 4];
+    for (std::uint64_t i = 0; i < shard.windows; ++i) {
+        const auto& group = by_label[pick_label(rng)];
+        std::uniform_int_distribution<std::size_t> pick_source(0, group.size() - 1);
+        const std::size_t s = group[pick_source(rng)];
+        aug.generate(sources[s], rng, w);
+
+        row[bno::AugmentWindow::COLUMN_COUNT + 1] = static_cast<double>(i);
+        row[bno::AugmentWindow::COLUMN_COUNT + 2] = w.background ? none_index : w.label;
+        row[bno::AugmentWindow::COLUMN_COUNT + 3] = static_cast<double>(s);
+        for (std::size_t r = 0; r < w.rows; ++r) {
+            row[0] = w.t[r];
+            for (std::size_t c = 0; c < bno::AugmentWindow::COLUMN_COUNT; ++c) {
+                row[c + 1] = static_cast<double>(w.c[c][r]);
+            }
+            if (!writer.append(row, shard.err)) {
+                return;
+            }
+        }
+        shard.background += w.background ? 1 : 0;
+    }
+    if (!writer.close(shard.err)) {
+        return;
+    }
+    shard.rows = writer.rows_written();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CliConfig cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        return 1;
+    }
+
+    // etykiety w kolejności pierwszego wystąpienia; NONE na końcu, jeśli są okna tła
+    std::vector<std::string> labels;
+    std::vector<bno::AugmentSource> sources;
+    std::vector<std::vector<std::size_t>> by_label;
+    for (const auto& [label, path] : cfg.inputs) {
+        std::vector<bno::ImuCsvRow> rows;
+        std::string err;
+        if (!bno::read_imu_samples(path, rows, err) || rows.empty()) {
+            // uszkodzone / puste nagrania pomijamy, jak imu_train
+            std::cerr << "skip " << (err.empty() ? path + ": no samples" : err) << "\n";
+            continue;
+        }
+        auto it = std::find(labels.begin(), labels.end(), label);
+        const auto index = static_cast<std::size_t>(it - labels.begin());
+        bno::AugmentSource src;
+        if (!bno::prepare_augment_source(std::move(rows), static_cast<int>(index), src, err)) {
+            std::cerr << "skip " << path << ": " << err << "\n";
+            continue;
+        }
+        if (it == labels.end()) {
+            labels.push_back(label);
+            by_label.emplace_back();
+        }
+        by_label[index].push_back(sources.size());
+        sources.push_back(std::move(src));
+    }
+    if (sources.empty()) {
+        std::cerr << "no usable recordings\n";
+        return 1;
+    }
+    int none_index = -1;
+    if (cfg.aug.background_ratio > 0.0) {
+        auto it = std::find(labels.begin(), labels.end(), NONE_LABEL);
+        none_index = static_cast<int>(it - labels.begin());
+        if (it == labels.end()) {
+            labels.emplace_back(NONE_LABEL);
+        }
+    }
+
+    const std::string labels_path = cfg.out_prefix + ".labels";
+    {
+        std::ofstream out(labels_path);
+        for (const auto& l : labels) {
+            out << l << "\n";
+        }
+        if (!out) {
+            std::cerr << "cannot write " << labels_path << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<Shard> shards(cfg.threads);
+    for (unsigned k = 0; k < cfg.threads; ++k) {
+        shards[k].path = cfg.out_prefix + "." + std::to_string(k) + ".imlog";
+        shards[k].windows = cfg.windows / cfg.threads + (k < cfg.windows % cfg.threads ? 1 : 0);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned k = 0; k < cfg.threads; ++k) {
+            workers.emplace_back(run_shard, std::cref(cfg), std::cref(sources), std::cref(by_label),
+                                 none_index, k, std::ref(shards[k]));
+        }
+    }
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::uint64_t windows = 0;
+    std::uint64_t rows = 0;
+    std::uint64_t background = 0;
+    bool ok = true;
+    for (const Shard& sh : shards) {
+        if (!sh.err.empty()) {
+            std::cerr << sh.path << ": " << sh.err << "\n";
+            ok = false;
+            continue;
+        }
+        windows += sh.windows;
+        rows += sh.rows;
+        background += sh.background;
+    }
+    std::cerr << "recordings: " << sources.size() << ", labels: " << labels.size()
+              << " (" << labels_path << ")\n"
+              << "windows: " << windows << " (" << background << " " << NONE_LABEL << "), rows: "
+              << rows << ", shards: " << cfg.threads << "\n"
+              << "time: " << s << " s, "
+              << (s > 0.0 ? static_cast<double>(windows) * 60.0 / s : 0.0) << " windows/min\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include "bno/imu_csv.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+namespace bno {
+
+bool parse_imu_csv_line(const char* begin, const char* end, ImuCsvRow& row) {
+    double* fields[11] = {
+        &row.t,
+        &row.ax, &row.ay, &row.az,
+        &row.gx, &row.gy, &row.gz,
+        &row.qw, &row.qi, &row.qj, &row.qk,
+    };
+
+    const char* p = begin;
+    for (std::size_t i = 0; i < 11; ++i) {
+        while (p < end && *p == ' ') {
+            ++p;
+        }
+        auto [next, ec] = std::from_chars(p, end, *fields[i]);
+        if (ec != std::errc{}) {
+            return false;
+        }
+        p = next;
+        if (i + 1 < 11) {
+            if (p >= end || *p != ',') {
+                return false;
+            }
+            ++p;
+        }
+    }
+
+    // dopuszczamy '\r' z plików zapisanych na Windowsie
+    while (p < end && (*p == '\r' || *p == ' ')) {
+        ++p;
+    }
+    return p == end;
+}
+
+bool read_imu_csv(const std::string& path,
+                  std::vector<ImuCsvRow>& out,
+                  std::string& err) {
+    out.clear();
+
+    std::ifstream in(path);
+    if (!in) {
+        err = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    std::size_t line_no = 0;
+    std::size_t bad_line = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        if (line.empty() || line == "\r") {
+            continue;
+        }
+        // nagłówek w pierwszym wierszu
+        if (line_no == 1 && line[0] == 't') {
+            continue;
+        }
+        if (bad_line != 0) {
+            // uszkodzony wiersz w środku pliku – to już nie jest ucięty zapis
+            err = path + ":" + std::to_string(bad_line) + ": malformed row";
+            return false;
+        }
+
+        ImuCsvRow row;
+        if (!parse_imu_csv_line(line.data(), line.data() + line.size(), row)) {
+            // imu_read zabity w trakcie zapisu zostawia ucięty ostatni wiersz –
+            // akceptujemy go, o ile nic już po nim nie ma.
+            bad_line = line_no;
+            continue;
+        }
+        out.push_back(row);
+    }
+
+    if (out.empty()) {
+        err = path + ": no samples";
+        return false;
+    }
+    return true;
+}
+
+std::string recording_label(const std::string& path)
+{
+    const auto slash = path.find_last_of('/');
+    const std::string_view name = std::string_view(path).substr(slash == std::string::npos ? 0 : slash + 1);
+    std::string label;
+    for (char c : name) {
+        if (c >= 'a' && c <= 'z') {
+            label += static_cast<char>(c - 'a' + 'A');
+        } else if ((c >= 'A' && c <= 'Z') || c == '_') {
+            label += c;
+        } else {
+            break;
+        }
+    }
+    return label;
+}
+
+} // namespace bno
@@ -0,0 +1,561 @@
+// imu_daemon – jeden proces trzyma magistralę I2C i rozsyła przez gniazdo
+// Unix trzy strumienie: surowe próbki (CSV jak imu_read), gesty (linie jak
+// imu_dir) i status (NDJSON co sekundę). Klienci mogą się podłączać
+// i rozłączać w trakcie – czujnik jest inicjalizowany raz.
+//
+//   ./build/imu_daemon --socket /tmp/imu.sock &
+//   socat - UNIX-CONNECT:/tmp/imu.sock <<< "SUB gestures"
+
+#include "bno/shtp.hpp"
+#include "bno/sh2_reports.hpp"
+#include "bno/sh2_enable.hpp"
+#include "bno/imu_log.hpp"
+#include "bno/resample.hpp"
+#include "bno/row_format.hpp"
+#include "bno/gesture_pipeline.hpp"
+#include "bno/local_server.hpp"
+#include "bno/control_server.hpp"
+#include "bno/imu_shm.hpp"
+#include "bno/log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct CliConfig {
+    int bus = 1;
+    std::uint8_t addr = 0x4A;
+    int hz = 100;
+    int timeout_ms = 50;
+    std::string socket_path = "/tmp/imu_daemon.sock";
+    std::size_t max_clients = 16;
+    std::string shm_name;        // --shm: pierścień próbek w /dev/shm dla lokalnych czytelników
+    std::size_t shm_slots = 4096;
+    bno::ResampleMode output_mode = bno::ResampleMode::Event;
+    bool linear_accel = true;    // --accel raw: Accelerometer w kolumnach ax/ay/az strumienia raw
+    std::string replay_path;     // --replay: CSV/.imlog zamiast I2C (testy bez czujnika)
+    bool replay_loop = false;
+    // detektor gestów – jak imu_dir
+    std::vector<std::pair<std::string, std::string>> templates;
+    bool segmented = false;
+    std::vector<bno::ComboPattern> combos;
+    double combo_gap_s = 0.8;
+    double min_interval_s = 0.5;
+    bno::log::Level log_level = bno::log::Level::Info;
+    bool trace = false;          // --trace: czasy zakresów BNO_TRACE_SPAN w logu
+    std::string control_path;    // --control: gniazdo do zmian progów i częstości w locie
+};
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void signal_handler(int)
+{
+    g_stop = 1;
+}
+
+void print_usage(const char* argv0)
+{
+    std::cerr
+        << "Usage: " << argv0 << " [options]\n"
+        << "  --bus <int>           I2C bus (default 1)\n"
+        << "  --addr <hex>          I2C address (default 0x4A)\n"
+        << "  --hz <50..100>        Sensor report rate (default 100)\n"
+        << "  --timeout-ms <int>    I2C read timeout (default 50)\n"
+        << "  --socket <path>       Unix socket (default /tmp/imu_daemon.sock)\n"
+        << "  --max-clients <n>     Max simultaneous clients (default 16)\n"
+        << "  --shm <name>          Also publish raw rows to a shared-memory ring (e.g. /imu_samples)\n"
+        << "  --shm-slots <n>       Ring size in samples, power of two (default 4096)\n"
+        << "  --output-mode <m>     raw stream: event (default), hold or linear\n"
+        << "  --accel <linear|raw>  raw stream ax/ay/az source (default linear)\n"
+        << "  --replay <file>       Serve a recorded CSV/.imlog in real time instead of I2C\n"
+        << "                        (raw stream sends recorded rows unchanged)\n"
+        << "  --loop                Restart --replay at end of file\n"
+        << "  --template L=path     Custom gesture template (repeatable)\n"
+        << "  --segmented           Online segmentation (provisional + final label)\n"
+        << "  --combo N=A,B,...     Gesture sequence (repeatable)\n"
+        << "  --combo-gap <s>       Max gap between combo steps (default 0.8)\n"
+        << "  --min-interval <s>    Min gap between gestures (default 0.5)\n"
+        << "  --log-level <l>       debug, info (default), warn, error\n"
+        << "  --trace               Log per-frame trace spans (needs BNO_TRACE build option)\n"
+        << "  --control <path>      Unix socket for live changes: GET | SET hz=.. min_peak=.. (see README)\n"
+        << "Clients send one line: SUB raw | SUB gestures | SUB status\n";
+}
+
+bool parse_args(int argc, char** argv, CliConfig& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--bus" && i + 1 < argc) {
+            cfg.bus = std::atoi(argv[++i]);
+        } else if (arg == "--addr" && i + 1 < argc) {
+            cfg.addr = static_cast<std::uint8_t>(std::strtol(argv[++i], nullptr, 0));
+        } else if (arg == "--hz" && i + 1 < argc) {
+            cfg.hz = std::atoi(argv[++i]);
+        } else if (arg == "--timeout-ms" && i + 1 < argc) {
+            cfg.timeout_ms = std::atoi(argv[++i]);
+        } else if (arg == "--socket" && i + 1 < argc) {
+            cfg.socket_path = argv[++i];
+        } else if (arg == "--max-clients" && i + 1 < argc) {
+            cfg.max_clients = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--shm" && i + 1 < argc) {
+            cfg.shm_name = argv[++i];
+        } else if (arg == "--shm-slots" && i + 1 < argc) {
+            cfg.shm_slots = static_cast<std::size_t>(std::max(2, std::atoi(argv[++i])));
+        } else if (arg == "--output-mode" && i + 1 < argc) {
+            const std::string_view mode{argv[++i]};
+            if (mode == "event") {
+                cfg.output_mode = bno::ResampleMode::Event;
+            } else if (mode == "hold") {
+                cfg.output_mode = bno::ResampleMode::Hold;
+            } else if (mode == "linear") {
+                cfg.output_mode = bno::ResampleMode::Linear;
+            } else {
+                std::cerr << "Unknown output mode: " << mode << "\n";
+                return false;
+            }
+        } else if (arg == "--accel" && i + 1 < argc) {
+            const std::string_view accel{argv[++i]};
+            if (accel != "raw" && accel != "linear") {
+                std::cerr << "Unknown accel source: " << accel << "\n";
+                return false;
+            }
+            cfg.linear_accel = (accel == "linear");
+        } else if (arg == "--replay" && i + 1 < argc) {
+            cfg.replay_path = argv[++i];
+        } else if (arg == "--loop") {
+            cfg.replay_loop = true;
+        } else if (arg == "--template" && i + 1 < argc) {
+            const std::string spec = argv[++i];
+            const auto eq = spec.find('=');
+            if (eq == std::string::npos || eq == 0 || eq + 1 == spec.size()) {
+                std::cerr << "--template expects LABEL=path.csv, got: " << spec << "\n";
+                return false;
+            }
+            cfg.templates.emplace_back(spec.substr(0, eq), spec.substr(eq + 1));
+        } else if (arg == "--segmented") {
+            cfg.segmented = true;
+        } else if (arg == "--combo" && i + 1 < argc) {
+            bno::ComboPattern pattern;
+            std::string perr;
+            if (!bno::parse_combo_spec(argv[++i], pattern, perr)) {
+                std::cerr << perr << "\n";
+                return false;
+            }
+            cfg.combos.push_back(std::move(pattern));
+        } else if (arg == "--combo-gap" && i + 1 < argc) {
+            cfg.combo_gap_s = std::atof(argv[++i]);
+        } else if (arg == "--min-interval" && i + 1 < argc) {
+            cfg.min_interval_s = std::atof(argv[++i]);
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            const std::string_view level{argv[++i]};
+            if (level == "debug") {
+                cfg.log_level = bno::log::Level::Debug;
+            } else if (level == "info") {
+                cfg.log_level = bno::log::Level::Info;
+            } else if (level == "warn") {
+                cfg.log_level = bno::log::Level::Warn;
+            } else if (level == "error") {
+                cfg.log_level = bno::log::Level::Error;
+            } else {
+                std::cerr << "Unknown log level: " << level << "\n";
+                return false;
+            }
+        } else if (arg == "--trace") {
+            cfg.trace = true;
+        } else if (arg == "--control" && i + 1 < argc) {
+            cfg.control_path = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            std::cerr << "Unknown arg: " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    if (cfg.hz < 50 || cfg.hz > 100) {
+        std::cerr << "hz must be in [50,100]\n";
+        return false;
+    }
+    if (cfg.replay_loop && cfg.replay_path.empty()) {
+        std::cerr << "--loop needs --replay <file>\n";
+        return false;
+    }
+    return true;
+}
+
+// Źródło próbek dla detektora: ostatnie gyro/kwaternion, próbka na raport accel
+struct DetectorState {
+    bool have_quat = false;
+    bno::Vec3 last_accel{};
+    bno::Vec3 last_gyro{};
+    bno::Quat last_quat{};
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CliConfig cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        return 1;
+    }
+
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+    std::signal(SIGPIPE, SIG_IGN);   // rozłączony klient nie może zabić demona
+
+    bno::log::start(stderr, cfg.log_level);
+    bno::log::set_trace(cfg.trace);
+
+    bno::GesturePipeline::Config gp_cfg;
+    gp_cfg.segmented      = cfg.segmented;
+    gp_cfg.min_interval_s = cfg.min_interval_s;
+    gp_cfg.combo_gap_s    = cfg.combo_gap_s;
+    gp_cfg.templates      = cfg.templates;
+    gp_cfg.combos         = cfg.combos;
+    bno::GesturePipeline pipeline(gp_cfg);
+    {
+        std::string perr;
+        if (!pipeline.load(perr)) {
+            std::cerr << perr << "\n";
+            return 1;
+        }
+    }
+
+    // Nagranie do --replay wczytujemy przed otwarciem gniazda – zły plik
+    // nie zostawia po sobie martwego /tmp/imu_daemon.sock
+    std::vector<bno::ImuCsvRow> replay_rows;
+    if (!cfg.replay_path.empty()) {
+        std::string rerr;
+        if (!bno::read_imu_samples(cfg.replay_path, replay_rows, rerr) || replay_rows.empty()) {
+            std::cerr << "Failed to read " << cfg.replay_path << ": "
+                      << (rerr.empty() ? "no samples" : rerr) << "\n";
+            return 1;
+        }
+    }
+
+    bno::ShtpI2cTransport transport;
+    bno::ShtpError err;
+
+    const bno::Sh2SensorId raw_accel_id = cfg.linear_accel
+        ? bno::Sh2SensorId::LinearAcceleration
+        : bno::Sh2SensorId::Accelerometer;
+
+    if (replay_rows.empty()) {
+        if (!transport.open(cfg.bus, cfg.addr, err)) {
+            std::cerr << "Failed to open I2C bus=" << cfg.bus
+                      << " addr=0x" << std::hex << int(cfg.addr) << std::dec
+                      << " : " << err.message << " (errno=" << err.sys_errno << ")\n";
+            return 1;
+        }
+        transport.set_max_frame_size(bno::SHTP_MAX_FRAME);
+
+    }
+
+    // Linear Acceleration zawsze – na nim pracuje detektor gestów i (domyślnie)
+    // strumień raw; Accelerometer tylko przy --accel raw.
+    // Jako lambdy, bo --control zmienia częstości w locie.
+    auto set_accel = [&](int hz) {
+        if (!cfg.linear_accel &&
+            !bno::enable_sensor_report(transport, bno::Sh2SensorId::Accelerometer, hz, err)) {
+            std::cerr << "Failed to set Accelerometer: " << err.message << "\n";
+        }
+        if (!bno::enable_sensor_report(transport, bno::Sh2SensorId::LinearAcceleration, hz, err)) {
+            std::cerr << "Failed to set Linear Accel: " << err.message << "\n";
+        }
+    };
+    auto set_gyro = [&](int hz) {
+        if (!bno::enable_sensor_report(transport, bno::Sh2SensorId::GyroscopeCalibrated, hz, err)) {
+            std::cerr << "Failed to set Gyro Calibrated: " << err.message << "\n";
+        }
+    };
+    auto set_grv = [&](int hz) {
+        if (!bno::enable_sensor_report(transport, bno::Sh2SensorId::GameRotationVector, hz, err)) {
+            std::cerr << "Failed to set Game Rotation Vector: " << err.message << "\n";
+        }
+    };
+    if (replay_rows.empty()) {
+        set_accel(cfg.hz);
+        set_gyro(cfg.hz);
+        set_grv(cfg.hz);
+    }
+
+    // Progi detektora i częstości raportów zmieniane przez --control.
+    // Siatka ImuResampler (--output-mode hold/linear) i hz w nagłówku shm
+    // zostają z --hz.
+    bno::LiveConfig live_initial;
+    live_initial.detector = pipeline.detector().config();
+    live_initial.accel_hz = cfg.hz;
+    live_initial.gyro_hz  = cfg.hz;
+    live_initial.grv_hz   = cfg.hz;
+    bno::LiveConfigCell live(live_initial);
+    bno::LiveConfig live_applied = live_initial;
+    bno::ControlServer control;
+
+    bno::LocalStreamServer server;
+    {
+        bno::LocalStreamServer::Config srv_cfg;
+        srv_cfg.max_clients = cfg.max_clients;
+        std::string serr;
+        if (!server.open(cfg.socket_path, srv_cfg, serr)) {
+            std::cerr << serr << "\n";
+            return 1;
+        }
+    }
+    if (!cfg.control_path.empty()) {
+        std::string serr;
+        if (!control.open(cfg.control_path, live, bno::ControlServer::Config{}, serr)) {
+            std::cerr << serr << "\n";
+            return 1;
+        }
+    }
+    bno::ImuShmWriter shm;
+    if (!cfg.shm_name.empty()) {
+        std::string serr;
+        if (!shm.open(cfg.shm_name, cfg.shm_slots, cfg.hz, serr)) {
+            std::cerr << serr << "\n";
+            return 1;
+        }
+    }
+    const std::uint32_t shm_flags =
+        (cfg.linear_accel ? bno::IMU_SHM_FLAG_LINEAR_ACCEL : 0u) |
+        (replay_rows.empty() ? 0u : bno::IMU_SHM_FLAG_REPLAY);
+
+    server.set_greeting(bno::StreamTopic::Raw, std::string(bno::IMU_CSV_HEADER) + "\n");
+
+    std::cerr << "imu_daemon: serving " << cfg.socket_path << " from "
+              << (replay_rows.empty() ? "I2C" : cfg.replay_path.c_str())
+              << ", hz=" << cfg.hz << "\n";
+
+    // --- strumień raw: ImuResampler -> CSV, jedna linia na wiersz ---
+    bno::ImuResampler::Config rs_cfg;
+    rs_cfg.mode = cfg.output_mode;
+    rs_cfg.rate_hz = cfg.hz;
+    bno::ImuResampler resampler(rs_cfg);
+
+    bno::RowFormatter raw_line(256);
+    auto publish_row = [&](const bno::ImuCsvRow& row) {
+        if (shm.is_open()) {
+            shm.publish(bno::to_shm_sample(row, shm_flags));
+        }
+        raw_line.clear();
+        raw_line.put_imu_row(row);
+        server.publish(bno::StreamTopic::Raw, raw_line.view());
+    };
+    auto publish_gesture = [&](std::string_view line) {
+        server.publish(bno::StreamTopic::Gestures, line);
+    };
+
+    DetectorState det;
+    std::uint64_t frames_total  = 0;
+    std::uint64_t reports_total = 0;
+    std::uint64_t timeouts      = 0;
+    std::uint64_t replay_rows_sent = 0;
+
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+    auto last_status = t0;
+    std::uint64_t reports_at_status = 0;
+    bno::RowFormatter status_line(512);
+
+    auto publish_status = [&](clock::time_point now) {
+        const double dt = std::chrono::duration<double>(now - last_status).count();
+        const double rate = dt > 0.0
+            ? static_cast<double>(reports_total - reports_at_status) / dt
+            : 0.0;
+        last_status = now;
+        reports_at_status = reports_total;
+
+        const auto& srv = server.stats();
+        auto& counters = pipeline.counters();
+        status_line.clear();
+        status_line.put_kv("{\"t\":", std::chrono::duration<double>(now - t0).count(), 3);
+        status_line.put(",\"source\":\"");
+        status_line.put(replay_rows.empty() ? "i2c" : "replay");
+        status_line.put("\",\"frames\":");
+        status_line.put_uint(frames_total);
+        status_line.put(",\"reports\":");
+        status_line.put_uint(reports_total);
+        status_line.put_kv(",\"report_hz\":", rate, 1);
+        status_line.put(",\"timeouts\":");
+        status_line.put_uint(timeouts);
+        status_line.put(",\"rows\":");
+        status_line.put_uint(resampler.rows_emitted() + replay_rows_sent);
+        status_line.put(",\"gestures\":");
+        status_line.put_uint(counters.gestures);
+        status_line.put(",\"dtw_matches\":");
+        status_line.put_uint(counters.dtw_matches);
+        status_line.put(",\"combo_matches\":");
+        status_line.put_uint(counters.combo_matches);
+        status_line.put(",\"clients\":");
+        status_line.put_uint(server.client_count());
+        status_line.put(",\"lines_sent\":");
+        status_line.put_uint(srv.lines_sent);
+        status_line.put(",\"lines_dropped\":");
+        status_line.put_uint(srv.lines_dropped);
+        status_line.put(",\"config_version\":");
+        status_line.put_uint(live_applied.version);
+        status_line.put("}\n");
+        counters.dtw_max_us = 0.0;
+        server.publish(bno::StreamTopic::Status, status_line.view());
+    };
+
+    // Jedna próbka z dowolnego źródła: raport SH-2 albo wiersz nagrania
+    auto on_accel_raw = [&](double t, const bno::Vec3& a) {
+        const double v[3] = {a.x, a.y, a.z};
+        resampler.push(bno::ImuChannel::Accel, t, v, publish_row);
+    };
+    auto on_accel_detector = [&](double t, const bno::Vec3& a) {
+        det.last_accel = a;
+        if (det.have_quat) {
+            pipeline.add_sample(t, det.last_accel, det.last_gyro, det.last_quat, publish_gesture);
+        }
+    };
+    auto on_gyro = [&](double t, const bno::Vec3& g) {
+        det.last_gyro = g;
+        const double v[3] = {g.x, g.y, g.z};
+        resampler.push(bno::ImuChannel::Gyro, t, v, publish_row);
+    };
+    auto on_quat = [&](double t, const bno::Quat& q) {
+        det.have_quat = true;
+        det.last_quat = q;
+        const double v[4] = {q.w, q.x, q.y, q.z};
+        resampler.push(bno::ImuChannel::Quat, t, v, publish_row);
+    };
+
+    bno::Sh2SensorEvent events[16];
+    std::size_t replay_pos = 0;
+    double replay_t_offset = 0.0;   // przesunięcie czasu nagrania przy --loop
+
+    while (!g_stop) {
+        bool idle = false;
+
+        // Nowa wersja z --control: progi od następnej próbki (baseline
+        // zostaje), Set Feature tylko dla zmienionych częstości
+        if (const bno::LiveConfig* next = nullptr; live.refresh(next)) {
+            pipeline.set_detector_config(next->detector);
+            if (replay_rows.empty()) {
+                if (next->accel_hz != live_applied.accel_hz) {
+                    set_accel(next->accel_hz);
+                }
+                if (next->gyro_hz != live_applied.gyro_hz) {
+                    set_gyro(next->gyro_hz);
+                }
+                if (next->grv_hz != live_applied.grv_hz) {
+                    set_grv(next->grv_hz);
+                }
+            }
+            live_applied = *next;
+            BNO_LOG_INFO("imu_daemon: applied config version {}", live_applied.version);
+        }
+
+        if (!replay_rows.empty()) {
+            // Odtwarzanie w tempie nagrania: wszystkie wiersze z t <= teraz
+            const double t_now = std::chrono::duration<double>(clock::now() - t0).count();
+            const double t_first = replay_rows.front().t;
+            idle = true;
+            while (replay_pos < replay_rows.size()) {
+                const auto& row = replay_rows[replay_pos];
+                const double t = row.t - t_first + replay_t_offset;
+                if (t > t_now) {
+                    break;
+                }
+                idle = false;
+                BNO_TRACE_SPAN("daemon.replay_row");
+                // nagranie jest już po ImuResampler – wiersze idą bez zmian
+                bno::ImuCsvRow shifted = row;
+                shifted.t = t;
+                publish_row(shifted);
+                ++replay_rows_sent;
+                det.have_quat = true;
+                det.last_gyro = bno::Vec3{row.gx, row.gy, row.gz};
+                det.last_quat = bno::Quat{row.qw, row.qi, row.qj, row.qk};
+                on_accel_detector(t, bno::Vec3{row.ax, row.ay, row.az});
+                ++reports_total;
+                ++replay_pos;
+            }
+            if (replay_pos == replay_rows.size()) {
+                if (!cfg.replay_loop) {
+                    std::cerr << "imu_daemon: replay finished\n";
+                    break;
+                }
+                replay_t_offset += replay_rows.back().t - t_first + 1.0 / cfg.hz;
+                replay_pos = 0;
+            }
+        } else if (auto frame_opt = transport.read_frame(err, cfg.timeout_ms)) {
+            BNO_TRACE_SPAN("daemon.frame");
+            const auto& frame = *frame_opt;
+            const auto ch = frame.header.channel;
+            if (ch >= 2 && ch <= 5) {
+                ++frames_total;
+                const double t_rx = std::chrono::duration<double>(clock::now() - t0).count();
+                const std::size_t n = bno::parse_sh2_input_reports(
+                    frame.payload.data(), frame.payload.size(), events, std::size(events));
+
+                for (std::size_t i = 0; i < n; ++i) {
+                    const auto& evt = events[i];
+                    const double t = t_rx + evt.host_offset_us * 1e-6;
+
+                    if (evt.accel.has_value()) {
+                        const bno::Vec3 a{evt.accel->x, evt.accel->y, evt.accel->z};
+                        if (evt.sensor_id == raw_accel_id) {
+                            on_accel_raw(t, a);
+                        }
+                        if (evt.sensor_id == bno::Sh2SensorId::LinearAcceleration) {
+                            on_accel_detector(t, a);
+                        }
+                    } else if (evt.gyro.has_value()) {
+                        on_gyro(t, bno::Vec3{evt.gyro->x, evt.gyro->y, evt.gyro->z});
+                    } else if (evt.game_quat.has_value()) {
+                        on_quat(t, bno::Quat{evt.game_quat->real, evt.game_quat->i,
+                                             evt.game_quat->j, evt.game_quat->k});
+                    } else {
+                        continue;
+                    }
+                    ++reports_total;
+                }
+            }
+        } else {
+            ++timeouts;
+            idle = true;
+        }
+
+        // Gniazdo obsługujemy w tym samym wątku. Gdy czujnik nie ma danych,
+        // poll() na gnieździe zastępuje dotychczasowe sleep 500 µs.
+        shm.notify();   // jeden FUTEX_WAKE na ramkę, nie na próbkę
+        server.poll(idle ? 1 : 0);
+
+        const auto now = clock::now();
+        if (now - last_status >= 1s) {
+            publish_status(now);
+        }
+    }
+
+    publish_status(clock::now());
+    server.poll(0);   // dosłać, co się da, przed zamknięciem
+    const auto& srv = server.stats();
+    std::cerr << "imu_daemon: stopped, frames=" << frames_total
+              << " reports=" << reports_total
+              << " rows=" << resampler.rows_emitted() + replay_rows_sent
+              << " gestures=" << pipeline.counters().gestures
+              << " clients_accepted=" << srv.accepted
+              << " lines_sent=" << srv.lines_sent
+              << " lines_dropped=" << srv.lines_dropped << "\n";
+    bno::log::stop();
+    return 0;
+}
@@ -1,14 +1,28 @@
+#include <algorithm>
 #include <chrono>
+#include <csignal>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <iostream>
+#include <iterator>
 #include <optional>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "bno/shtp.hpp"
 #include "bno/sh2_reports.hpp"
-#include "bno/gesture_dir.hpp"   // nasz detektor gestów
+#include "bno/sh2_enable.hpp"
+#include "bno/shtp_replay.hpp"
+#include "bno/gesture_pipeline.hpp"  // detektor + wzorce DTW + sekwencje
+#include "bno/control_server.hpp"
+#include "bno/gpio_irq.hpp"
+#include "bno/idle_gate.hpp"
+#include "bno/latency_trace.hpp"
+#include "bno/orientation_fusion.hpp"
 
 using namespace std::chrono_literals;
 
@@ -19,8 +33,58 @@ struct CliConfig {
     std::uint8_t addr = 0x4A;
     int hz = 100;
     int timeout_ms = 50;
+    std::vector<std::pair<std::string, std::string>> templates; // (label, path)
+    bool segmented = false;
+    bool track = false;          // --track: prędkość/pozycja z ZUPT, kształt toru w liniach gestów
+    std::string model_path;      // --model: klasyfikator z imu_train (ml= w liniach gestów)
+    std::string cnn_model;       // --cnn: sieć ONNX z cnn_train.py (linie cnn=)
+    bool cnn_int8 = false;
+    std::vector<bno::ComboPattern> combos;
+    double combo_gap_s = 0.8;
+    double min_interval_s = 0.5;
+    bool fusion = false;         // --fusion: orientacja z gyro na hoście zamiast samego GRV
+    bno::FusionMethod fusion_method = bno::FusionMethod::Mahony;
+    int gyro_hz = 0;             // 0 = jak --hz; z --fusion do 1000
+    bool gyro_uncalibrated = false;
+    std::string replay_path;     // --replay: nagranie zamiast I2C (testy, trening PGO)
+    double replay_speed = 1.0;   // 0 = bez czekania, kończy się na końcu pliku
+    double idle_after_s = 0.0;   // --idle-after: po tylu s ciszy tylko raporty budzące; 0 = wył.
+    bno::IdleGate::Wake idle_wake = bno::IdleGate::Wake::Any;
+    std::string int_gpio;        // --int-gpio: linia H_INTN, wątek śpi zamiast pytać szynę
+    int idle_poll_ms = 50;       // idle bez --int-gpio: co tyle ms jedno pytanie o ramkę
+    std::string control_path;    // --control: gniazdo do zmian progów i częstości w locie
 };
 
+// tracker całkuje a dwukrotnie – przy 400 Hz błąd całkowania jest mniejszy
+int max_hz(const CliConfig& cfg)
+{
+    return cfg.track ? 400 : 100;
+}
+
+int max_gyro_hz(const CliConfig& cfg)
+{
+    return cfg.fusion ? 1000 : max_hz(cfg);
+}
+
+// Raporty budzące sprawdzane w czujniku z tą częstością; przez szynę idzie tylko zdarzenie
+constexpr int IDLE_WAKE_HZ = 50;
+// Strumień w idle: mała częstość, raporty do 1 s w FIFO czujnika. Po
+// wybudzeniu FIFO idzie na szynę – pre-roll ma prawdziwy początek gestu.
+constexpr int IDLE_STREAM_HZ = 25;
+constexpr std::uint32_t IDLE_BATCH_US = 1'000'000;
+
+volatile std::sig_atomic_t g_stop = 0;
+volatile std::sig_atomic_t g_dump_latency = 0;
+
+void signal_handler(int sig)
+{
+    if (sig == SIGUSR1) {
+        g_dump_latency = 1;
+    } else {
+        g_stop = 1;
+    }
+}
+
 static void print_usage(const char* argv0)
 {
     std::cerr
@@ -28,9 +92,29 @@ static void print_usage(const char* argv0)
         << "Options:\n"
         << "  --bus <int>        I2C bus (default 1)\n"
         << "  --addr <hex>       I2C address (default 0x4A)\n"
-        << "  --hz <int>         Sampling rate (50..100, default 100)\n"
+        << "  --hz <int>         Sampling rate (50..100, up to 400 with --track; default 100)\n"
         << "  --timeout-ms <int> I2C read timeout (default 50)\n"
-        << "  -h, --help         Show this help\n";
+        << "  --template L=path  Custom gesture template from imu_read CSV (repeatable)\n"
+        << "  --segmented        Online onset/offset segmentation (provisional + final label)\n"
+        << "  --track            Track velocity/position (Kalman + zero-velocity updates), add path shape\n"
+        << "  --model <file>     Learned classifier from imu_train (adds ml=LABEL conf=)\n"
+        << "  --cnn <file.onnx>  1D-CNN from cnn_train.py over the last second (cnn=LABEL p= lines)\n"
+        << "  --cnn-int8         Quantise the CNN to int8 at start-up (<model>.calib from cnn_train.py)\n"
+        << "  --combo N=A,B,...  Gesture sequence, e.g. SWIPE=LEFT,RIGHT (repeatable)\n"
+        << "  --combo-gap <s>    Max gap between combo steps (default 0.8)\n"
+        << "  --min-interval <s> Min gap between gestures (default 0.5; lower for fast combos)\n"
+        << "  --fusion <m>       Host orientation from gyro + sensor quaternion: madgwick|mahony|ekf\n"
+        << "  --gyro-hz <int>    Gyro report rate (default = --hz, up to 1000 with --fusion)\n"
+        << "  --gyro-uncalibrated  Use Gyroscope Uncalibrated (bias estimated by --fusion)\n"
+        << "  --replay <file>    Decode a recorded CSV/.imlog as SHTP frames instead of I2C\n"
+        << "  --speed <x>        Replay speed (default 1 = real time, 0 = as fast as possible)\n"
+        << "  --idle-after <s>   After s of stillness stop streaming; wake on sensor tap/motion (0 = off)\n"
+        << "  --idle-wake <w>    Wake report in idle: tap|motion|any (default any)\n"
+        << "  --int-gpio <spec>  BNO H_INTN line, e.g. gpiochip0:17 - block on it instead of polling I2C\n"
+        << "  --idle-poll-ms <n> Idle bus poll period without --int-gpio (default 50)\n"
+        << "  --control <path>   Unix socket for live changes: GET | SET hz=.. min_peak=.. (see README)\n"
+        << "  -h, --help         Show this help\n"
+        << "SIGUSR1 prints per-stage latency histograms to stderr (also printed at exit).\n";
 }
 
 static bool parse_args(int argc, char** argv, CliConfig& cfg)
@@ -45,6 +129,65 @@ static bool parse_args(int argc, char** argv, CliConfig& cfg)
             cfg.hz = std::atoi(argv[++i]);
         } else if (arg == "--timeout-ms" && i + 1 < argc) {
             cfg.timeout_ms = std::atoi(argv[++i]);
+        } else if (arg == "--template" && i + 1 < argc) {
+            const std::string spec = argv[++i];
+            const auto eq = spec.find('=');
+            if (eq == std::string::npos || eq == 0 || eq + 1 == spec.size()) {
+                std::cerr << "--template expects LABEL=path.csv, got: " << spec << "\n";
+                return false;
+            }
+            cfg.templates.emplace_back(spec.substr(0, eq), spec.substr(eq + 1));
+        } else if (arg == "--segmented") {
+            cfg.segmented = true;
+        } else if (arg == "--track") {
+            cfg.track = true;
+        } else if (arg == "--model" && i + 1 < argc) {
+            cfg.model_path = argv[++i];
+        } else if (arg == "--cnn" && i + 1 < argc) {
+            cfg.cnn_model = argv[++i];
+        } else if (arg == "--cnn-int8") {
+            cfg.cnn_int8 = true;
+        } else if (arg == "--combo" && i + 1 < argc) {
+            bno::ComboPattern pattern;
+            std::string perr;
+            if (!bno::parse_combo_spec(argv[++i], pattern, perr)) {
+                std::cerr << perr << "\n";
+                return false;
+            }
+            cfg.combos.push_back(std::move(pattern));
+        } else if (arg == "--combo-gap" && i + 1 < argc) {
+            cfg.combo_gap_s = std::atof(argv[++i]);
+        } else if (arg == "--min-interval" && i + 1 < argc) {
+            cfg.min_interval_s = std::atof(argv[++i]);
+        } else if (arg == "--fusion" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (!bno::parse_fusion_method(name, cfg.fusion_method)) {
+                std::cerr << "--fusion expects madgwick|mahony|ekf, got: " << name << "\n";
+                return false;
+            }
+            cfg.fusion = true;
+        } else if (arg == "--gyro-hz" && i + 1 < argc) {
+            cfg.gyro_hz = std::atoi(argv[++i]);
+        } else if (arg == "--gyro-uncalibrated") {
+            cfg.gyro_uncalibrated = true;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            cfg.replay_path = argv[++i];
+        } else if (arg == "--speed" && i + 1 < argc) {
+            cfg.replay_speed = std::atof(argv[++i]);
+        } else if (arg == "--idle-after" && i + 1 < argc) {
+            cfg.idle_after_s = std::atof(argv[++i]);
+        } else if (arg == "--idle-wake" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (!bno::IdleGate::parse_wake(name, cfg.idle_wake)) {
+                std::cerr << "--idle-wake expects tap|motion|any, got: " << name << "\n";
+                return false;
+            }
+        } else if (arg == "--int-gpio" && i + 1 < argc) {
+            cfg.int_gpio = argv[++i];
+        } else if (arg == "--idle-poll-ms" && i + 1 < argc) {
+            cfg.idle_poll_ms = std::atoi(argv[++i]);
+        } else if (arg == "--control" && i + 1 < argc) {
+            cfg.control_path = argv[++i];
         } else if (arg == "--help" || arg == "-h") {
             print_usage(argv[0]);
             return false;
@@ -54,38 +197,30 @@ static bool parse_args(int argc, char** argv, CliConfig& cfg)
             return false;
         }
     }
-    if (cfg.hz < 50 || cfg.hz > 100) {
-        std::cerr << "hz must be in [50,100]\n";
+    const int hz_max = max_hz(cfg);
+    if (cfg.hz < 50 || cfg.hz > hz_max) {
+        std::cerr << "hz must be in [50," << hz_max << "]"
+                  << (cfg.track ? "" : " without --track") << "\n";
         return false;
     }
-    return true;
-}
-
-/// Dokładnie taki sam helper jak w imu_read.cpp:
-/// wysyła Set Feature Command dla podanego raportu.
-bool enable_report(bno::ShtpTransport& transport,
-                   bno::Sh2SensorId sensor,
-                   int hz,
-                   bno::ShtpError& err)
-{
-    const std::uint32_t interval_us =
-        static_cast<std::uint32_t>(1'000'000 / hz);
-
-    std::uint8_t buf[32];
-    std::size_t len = 0;
-    if (!bno::build_enable_report_command(sensor, interval_us,
-                                          buf, len, sizeof(buf))) {
-        std::cerr << "build_enable_report_command failed\n";
+    if (cfg.gyro_hz == 0) {
+        cfg.gyro_hz = cfg.hz;
+    }
+    const int gyro_hz_max = max_gyro_hz(cfg);
+    if (cfg.gyro_hz < 50 || cfg.gyro_hz > gyro_hz_max) {
+        std::cerr << "gyro-hz must be in [50," << gyro_hz_max << "]"
+                  << (cfg.fusion ? "" : " without --fusion") << "\n";
         return false;
     }
-
-    // Set Feature Command idzie na kanał kontrolny SH-2.
-    if (!transport.write_frame(bno::ShtpChannel::Control, buf, len, err)) {
-        std::cerr << "write_frame(SetFeature) failed: " << err.message
-                  << " (errno=" << err.sys_errno << ")\n";
+    if (cfg.idle_after_s < 0.0 || cfg.idle_poll_ms < 1) {
+        std::cerr << "idle-after must be >= 0, idle-poll-ms >= 1\n";
+        return false;
+    }
+    if (!cfg.replay_path.empty() && (cfg.idle_after_s > 0.0 || !cfg.int_gpio.empty())) {
+        // nagranie nie ma raportów budzących i ignoruje Set Feature
+        std::cerr << "--idle-after and --int-gpio need the sensor, not --replay\n";
         return false;
     }
-
     return true;
 }
 
@@ -98,70 +233,306 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    bno::ShtpI2cTransport transport;
+    bno::ShtpI2cTransport i2c;
+    bno::ShtpReplayTransport replay(bno::ShtpReplayTransport::Config{cfg.replay_speed, false});
     bno::ShtpError err;
+    const bool replay_mode = !cfg.replay_path.empty();
+    bno::ShtpTransport& transport = replay_mode
+        ? static_cast<bno::ShtpTransport&>(replay)
+        : static_cast<bno::ShtpTransport&>(i2c);
+
+    if (replay_mode) {
+        if (!replay.open(cfg.replay_path, err)) {
+            std::cerr << err.message << "\n";
+            return 1;
+        }
+    } else {
+        if (!i2c.open(cfg.bus, cfg.addr, err)) {
+            std::cerr << "Failed to open I2C bus=" << cfg.bus
+                      << " addr=0x" << std::hex << int(cfg.addr) << std::dec
+                      << " : " << err.message << " (errno=" << err.sys_errno << ")\n";
+            return 1;
+        }
 
-    if (!transport.open(cfg.bus, cfg.addr, err)) {
-        std::cerr << "Failed to open I2C bus=" << cfg.bus
-                  << " addr=0x" << std::hex << int(cfg.addr) << std::dec
-                  << " : " << err.message << " (errno=" << err.sys_errno << ")\n";
-        return 1;
+        // Tak jak w imu_read.cpp – dopiero po otwarciu:
+        i2c.set_max_frame_size(bno::SHTP_MAX_FRAME);
     }
 
-    // Tak jak w imu_read.cpp – dopiero po otwarciu:
-    transport.set_max_frame_size(bno::SHTP_MAX_FRAME);
+    bno::GpioInterrupt irq;
+    if (!cfg.int_gpio.empty()) {
+        std::string gerr;
+        if (!irq.open(cfg.int_gpio, gerr)) {
+            std::cerr << gerr << "\n";
+            return 1;
+        }
+        i2c.set_interrupt(&irq);
+    }
 
-    // Uwaga: tutaj używamy TEJ SAMEJ funkcji enable_report, co w imu_read.cpp.
     // Włączamy tylko to, czego potrzebuje detektor:
     //  - Linear Acceleration (m/s^2)
+    //  - Gyroscope Calibrated (rad/s, gesty obrotowe)
     //  - Game Rotation Vector (kwaternion orientacji)
-    if (!enable_report(transport, bno::Sh2SensorId::LinearAcceleration, cfg.hz, err)) {
-        std::cerr << "Failed to enable Linear Accel\n";
+    // Z --idle-after także po każdym wybudzeniu, a z --control po zmianie
+    // częstości, więc jako lambdy.
+    const auto gyro_id = cfg.gyro_uncalibrated ? bno::Sh2SensorId::GyroscopeUncalibrated
+                                               : bno::Sh2SensorId::GyroscopeCalibrated;
+    auto set_accel = [&](int hz, std::uint32_t batch_us = 0) {
+        if (!bno::enable_sensor_report(transport, bno::Sh2SensorId::LinearAcceleration, hz, err, 0,
+                                       batch_us)) {
+            std::cerr << "Failed to set Linear Accel: " << err.message << "\n";
+        }
+    };
+    auto set_gyro = [&](int hz, std::uint32_t batch_us = 0) {
+        if (!bno::enable_sensor_report(transport, gyro_id, hz, err, 0, batch_us)) {
+            std::cerr << "Failed to set Gyro: " << err.message << "\n";
+        }
+    };
+    auto set_grv = [&](int hz, std::uint32_t batch_us = 0) {
+        if (!bno::enable_sensor_report(transport, bno::Sh2SensorId::GameRotationVector, hz, err, 0,
+                                       batch_us)) {
+            std::cerr << "Failed to set Game Rotation Vector: " << err.message << "\n";
+        }
+    };
+    auto enable_stream = [&](int accel_hz, int gyro_hz, int grv_hz, std::uint32_t batch_us = 0) {
+        set_accel(accel_hz, batch_us);
+        set_gyro(gyro_hz, batch_us);
+        set_grv(grv_hz, batch_us);
+    };
+    // Po wybudzeniu: raporty zebrane w FIFO w idle od razu na szynę
+    auto flush_stream = [&] {
+        for (const auto id : {bno::Sh2SensorId::LinearAcceleration, gyro_id,
+                              bno::Sh2SensorId::GameRotationVector}) {
+            if (!bno::flush_sensor_reports(transport, id, err)) {
+                std::cerr << "Failed to flush sensor FIFO: " << err.message << "\n";
+            }
+        }
+    };
+    // Raporty budzące (flaga wake-up, kanał 4); hz = 0 je wyłącza
+    auto set_wake_reports = [&](int hz) {
+        const auto w = cfg.idle_wake;
+        if (w != bno::IdleGate::Wake::SignificantMotion &&
+            !bno::enable_sensor_report(transport, bno::Sh2SensorId::TapDetector, hz, err,
+                                       bno::SH2_FEATURE_WAKE_UP)) {
+            std::cerr << "Failed to set Tap Detector: " << err.message << "\n";
+        }
+        if (w != bno::IdleGate::Wake::Tap &&
+            !bno::enable_sensor_report(transport, bno::Sh2SensorId::SignificantMotion, hz, err,
+                                       bno::SH2_FEATURE_WAKE_UP)) {
+            std::cerr << "Failed to set Significant Motion: " << err.message << "\n";
+        }
+    };
+    if (!replay_mode) {
+        enable_stream(cfg.hz, cfg.gyro_hz, cfg.hz);
+    }
+
+    bno::IdleGate::Config idle_cfg;
+    idle_cfg.idle_after_s = cfg.idle_after_s;
+    idle_cfg.preroll_s = std::min(idle_cfg.preroll_s, cfg.idle_after_s);
+    idle_cfg.wake = cfg.idle_wake;
+    bno::IdleGate idle(idle_cfg);
+    const bool idle_mode = cfg.idle_after_s > 0.0;
+
+    // Detektor kierunku, wzorce DTW i kombinacje (wspólne z imu_daemon)
+    bno::GesturePipeline::Config gp_cfg;
+    gp_cfg.segmented      = cfg.segmented;
+    gp_cfg.min_interval_s = cfg.min_interval_s;
+    gp_cfg.combo_gap_s    = cfg.combo_gap_s;
+    gp_cfg.templates      = cfg.templates;
+    gp_cfg.combos         = cfg.combos;
+    gp_cfg.track          = cfg.track;
+    gp_cfg.model_path     = cfg.model_path;
+    gp_cfg.cnn_model      = cfg.cnn_model;
+    gp_cfg.cnn_int8       = cfg.cnn_int8;
+    bno::GesturePipeline pipeline(gp_cfg);
+    {
+        std::string perr;
+        if (!pipeline.load(perr)) {
+            std::cerr << perr << "\n";
+            return 1;
+        }
+    }
+    const auto& dtw = pipeline.dtw();
+    for (std::size_t i = 0; i < dtw.template_count(); ++i) {
+        const auto& tmpl = dtw.template_at(i);
+        std::cerr << "template " << tmpl.label << ": " << tmpl.length << " samples\n";
+    }
+    if (dtw.template_count() > 0) {
+        std::cerr << "dtw kernel: " << bno::dtw_kernels::active_isa() << "\n";
     }
-    if (!enable_report(transport, bno::Sh2SensorId::GameRotationVector, cfg.hz, err)) {
-        std::cerr << "Failed to enable Game Rotation Vector\n";
+    if (pipeline.has_combos()) {
+        std::cerr << "combos: " << pipeline.combos().pattern_count() << " patterns, "
+                  << pipeline.combos().state_count() << " states\n";
     }
 
-    // Konfiguracja detektora gestów – trochę poluzowane progi na start
-    bno::GestureDirectionDetector::Config det_cfg;
-    det_cfg.baseline_window_s    = 0.2;
-    det_cfg.half_window_s        = 0.3;
-    det_cfg.min_dyn_threshold    = 0.3; // było 0.5
-    det_cfg.min_peak_magnitude   = 1.0; // było 1.5
-    det_cfg.min_gesture_interval = 0.5; // było 0.8
+    // Progi i częstości zmieniane przez --control; live_applied to kopia
+    // migawki przyłożonej ostatnio w pętli głównej
+    bno::LiveConfig live_initial;
+    live_initial.detector = pipeline.detector().config();
+    live_initial.accel_hz = cfg.hz;
+    live_initial.gyro_hz  = cfg.gyro_hz;
+    live_initial.grv_hz   = cfg.hz;
+    bno::LiveConfigCell live(live_initial);
+    bno::LiveConfig live_applied = live_initial;
+    bno::ControlServer control;
+    if (!cfg.control_path.empty()) {
+        bno::ControlServer::Config ccfg;
+        ccfg.limits.max_hz = max_hz(cfg);
+        ccfg.limits.max_gyro_hz = max_gyro_hz(cfg);
+        std::string serr;
+        if (!control.open(cfg.control_path, live, ccfg, serr)) {
+            std::cerr << serr << "\n";
+            return 1;
+        }
+        std::cerr << "control: " << cfg.control_path << "\n";
+    }
 
-    bno::GestureDirectionDetector detector(det_cfg);
+    using clock = std::chrono::steady_clock;
+    const auto t_start = clock::now();
+    auto now_s = [&] {
+        return std::chrono::duration<double>(clock::now() - t_start).count();
+    };
+
+    // Znaczniki bieżącej próbki; emit liczy od nich opóźnienie do linii wyniku.
+    // Próbki pre-rollu (replay po przebudzeniu) nie mają własnych znaczników
+    // – linie wypisane w trakcie replayu nie trafiają do histogramów *ToEmit.
+    bno::LatencyTrace latency;
+    bno::LatencyTrace::SampleStamps stamps;
+    bool replaying_preroll = false;
+
+    auto write_line = [&](std::string_view line) {
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        std::fflush(stdout);
+        if (!replaying_preroll) {
+            latency.record_emit(stamps, pipeline.last_event_t(), now_s());
+        }
+        idle.note_activity(pipeline.last_event_t());
+    };
 
     struct LastState {
         bool have_accel = false;
         bool have_quat  = false;
         bno::Vec3 last_accel{};
+        bno::Vec3 last_gyro{};   // zostaje zerem, jeśli gyro nie przychodzi
         bno::Quat last_quat{};
     } state;
 
-    using clock = std::chrono::steady_clock;
-    const auto t_start = clock::now();
+    bno::OrientationFusion::Config fusion_cfg;
+    fusion_cfg.method = cfg.fusion_method;
+    bno::OrientationFusion fusion(fusion_cfg);
+    if (cfg.fusion) {
+        std::cerr << "fusion: " << bno::fusion_method_name(cfg.fusion_method)
+                  << ", gyro " << cfg.gyro_hz << " Hz"
+                  << (cfg.gyro_uncalibrated ? " (uncalibrated)" : "") << "\n";
+    }
 
-    std::cerr << "imu_dir_cpp: running on bus " << cfg.bus
-              << ", addr 0x" << std::hex << int(cfg.addr) << std::dec
-              << ", hz=" << cfg.hz << "\n";
+    if (replay_mode) {
+        std::cerr << "imu_dir_cpp: replaying " << cfg.replay_path
+                  << ", speed=" << cfg.replay_speed << "\n";
+    } else {
+        std::cerr << "imu_dir_cpp: running on bus " << cfg.bus
+                  << ", addr 0x" << std::hex << int(cfg.addr) << std::dec
+                  << ", hz=" << cfg.hz << "\n";
+    }
+    if (idle_mode) {
+        std::cerr << "idle: after " << cfg.idle_after_s << " s still, wake on "
+                  << bno::IdleGate::wake_name(cfg.idle_wake)
+                  << (irq.is_open() ? ", blocking on " + cfg.int_gpio
+                                    : ", polling every " + std::to_string(cfg.idle_poll_ms) + " ms")
+                  << "\n";
+    }
 
     // Statystyki debugowe
     std::uint64_t frames       = 0;
     std::uint64_t events       = 0;
     std::uint64_t accel_events = 0;
+    std::uint64_t gyro_events  = 0;
     std::uint64_t quat_events  = 0;
-    std::uint64_t samples      = 0;
-    std::uint64_t gestures     = 0;
     std::uint64_t timeouts     = 0;
+    auto& counters = pipeline.counters();
 
     auto last_stats_print = clock::now();
+    std::clock_t last_stats_cpu = std::clock();
+
+    // Próbka dla detektora i DTW – raz na raport akcelerometru, z jego czasem
+    std::uint64_t idle_polls = 0;
+    auto process_sample = [&](double t_s) {
+        if (idle.idle()) {
+            // strumień idle (mała częstość, z FIFO) – tylko na pre-roll
+            idle.add_idle_sample({t_s, state.last_accel, state.last_gyro, state.last_quat});
+            return;
+        }
+        if (idle.preroll_pending()) {
+            // próbki z idle (albo spokój sprzed uśpienia) tuż przed pierwszą
+            // próbką – okna bez dziury
+            replaying_preroll = true;
+            idle.replay_preroll(t_s, [&](const bno::IdleGate::Sample& s) {
+                pipeline.add_sample(s.t, s.accel, s.gyro, s.quat, write_line);
+            });
+            replaying_preroll = false;
+        }
+        stamps.ingest = now_s();
+        latency.record_ingest(stamps);
+        pipeline.add_sample(t_s, state.last_accel, state.last_gyro, state.last_quat, write_line);
+        latency.record(bno::LatencyTrace::Detector, now_s() - stamps.ingest);
+        if (idle_mode &&
+            idle.add_sample({t_s, state.last_accel, state.last_gyro, state.last_quat})) {
+            enable_stream(IDLE_STREAM_HZ, IDLE_STREAM_HZ, IDLE_STREAM_HZ, IDLE_BATCH_US);
+            set_wake_reports(IDLE_WAKE_HZ);
+            idle.enter_idle(t_s);
+        }
+    };
+
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+    std::signal(SIGUSR1, signal_handler);
+
+    bno::Sh2SensorEvent sh2_events[16];
 
     // Pętla główna
-    while (true) {
-        auto frame_opt = transport.read_frame(err, cfg.timeout_ms);
+    while (!g_stop) {
+        if (g_dump_latency) {
+            g_dump_latency = 0;
+            latency.dump(stderr, "[latency]");
+        }
+
+        // Nowa wersja z --control: progi od następnej próbki (baseline
+        // zostaje), Set Feature tylko dla zmienionych częstości. W idle
+        // strumień ma częstość idle – nowe częstości włączy wybudzenie.
+        if (const bno::LiveConfig* next = nullptr; live.refresh(next)) {
+            pipeline.set_detector_config(next->detector);
+            if (!replay_mode && !idle.idle()) {
+                if (next->accel_hz != live_applied.accel_hz) {
+                    set_accel(next->accel_hz);
+                }
+                if (next->gyro_hz != live_applied.gyro_hz) {
+                    set_gyro(next->gyro_hz);
+                }
+                if (next->grv_hz != live_applied.grv_hz) {
+                    set_grv(next->grv_hz);
+                }
+            }
+            live_applied = *next;
+            std::cerr << "control: applied " << bno::format_live_config(live_applied) << "\n";
+        }
+
+        // W idle z H_INTN wątek śpi w poll() do raportu budzącego (budzi się
+        // co sekundę na statystyki); bez linii – jedno pytanie o ramkę co idle_poll_ms.
+        const bool idle_now = idle.idle();
+        auto frame_opt = transport.read_frame(err, idle_now && irq.is_open() ? 1000 : cfg.timeout_ms);
+        if (idle_now) {
+            ++idle_polls;
+        }
         if (!frame_opt) {
+            if (replay_mode && replay.finished()) {
+                break;
+            }
             ++timeouts;
+            // BNO nie ma danych – krótka pauza zamiast kręcenia się po I2C
+            if (idle_now && !irq.is_open()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(cfg.idle_poll_ms));
+            } else if (!replay_mode && !irq.is_open()) {
+                std::this_thread::sleep_for(500us);
+            }
         } else {
             const auto& frame = *frame_opt;
             ++frames;
@@ -170,67 +541,80 @@ int main(int argc, char** argv)
 
             // Kanały z raportami SH-2 – jak w imu_read.cpp (2..5)
             if (ch >= 2 && ch <= 5) {
-                const std::uint8_t* p   = frame.payload.data();
-                std::size_t         len = frame.payload.size();
+                // t_rx to koniec read_frame() – dopiero tu, bo kanał znamy po odczycie
+                const double t_rx = now_s();
+                // przy --replay detektor dostaje czas z nagrania, niezależny od --speed
+                const double t_base = replay_mode ? replay.frame_time() : t_rx;
+                const std::size_t n = bno::parse_sh2_input_reports(
+                    frame.payload.data(), frame.payload.size(),
+                    sh2_events, std::size(sh2_events));
+                stamps.read  = t_rx;
+                stamps.parse = now_s();
+                latency.record(bno::LatencyTrace::ReadToParse, stamps.parse - t_rx);
+
+                for (std::size_t i = 0; i < n; ++i) {
+                    ++events;
+                    const auto& evt = sh2_events[i];
+                    const double t_evt = t_base + evt.host_offset_us * 1e-6;
+
+                    if (idle.idle() && idle.is_wake_event(evt)) {
+                        // najpierw FIFO (próbki z chwili wybudzenia), potem pełna częstość
+                        set_wake_reports(0);
+                        flush_stream();
+                        enable_stream(live_applied.accel_hz, live_applied.gyro_hz,
+                                      live_applied.grv_hz);
+                        idle.wake(t_evt);
+                        continue;
+                    }
 
-                // Obsługa 0xFB Base Timestamp Reference (jak w imu_read.cpp)
-                if (len >= 5 && p[0] == 0xFB) {
-                    p   += 5;
-                    len -= 5;
-                }
-                if (len > 0) {
-                    auto evt_opt = bno::parse_sh2_sensor_event(p, len);
-                    if (evt_opt) {
-                        ++events;
-                        const auto& evt = *evt_opt;
-
-                        if (evt.accel.has_value()) {
-                            ++accel_events;
-                            state.have_accel = true;
-                            state.last_accel = bno::Vec3{
-                                evt.accel->x,
-                                evt.accel->y,
-                                evt.accel->z,
-                            };
+                    if (evt.gyro.has_value()) {
+                        ++gyro_events;
+                        state.last_gyro = bno::Vec3{
+                            evt.gyro->x,
+                            evt.gyro->y,
+                            evt.gyro->z,
+                        };
+                        if (cfg.fusion) {
+                            // orientacja świeża przy każdej próbce gyro, nie dopiero przy GRV
+                            fusion.update_gyro(t_evt, state.last_gyro);
+                            const auto& b = fusion.gyro_bias();
+                            state.last_gyro = bno::Vec3{state.last_gyro.x - b.x,
+                                                        state.last_gyro.y - b.y,
+                                                        state.last_gyro.z - b.z};
                         }
+                    }
 
-                        if (evt.game_quat.has_value()) {
-                            ++quat_events;
-                            state.have_quat = true;
-                            state.last_quat = bno::Quat{
-                                evt.game_quat->real,
-                                evt.game_quat->i,
-                                evt.game_quat->j,
-                                evt.game_quat->k,
-                            };
+                    if (evt.game_quat.has_value()) {
+                        ++quat_events;
+                        state.have_quat = true;
+                        state.last_quat = bno::Quat{
+                            evt.game_quat->real,
+                            evt.game_quat->i,
+                            evt.game_quat->j,
+                            evt.game_quat->k,
+                        };
+                        if (cfg.fusion) {
+                            fusion.correct_quat(t_evt, state.last_quat);
                         }
                     }
-                }
-            }
-        }
 
-        // Jeśli mamy komplet (accel + quat), karmimy detektor
-        if (state.have_accel && state.have_quat) {
-            const auto now   = clock::now();
-            const double t_s = std::chrono::duration<double>(now - t_start).count();
-
-            detector.add_sample(t_s, state.last_accel, state.last_quat);
-            ++samples;
-
-            if (auto res_opt = detector.poll_result()) {
-                ++gestures;
-                const auto& res = *res_opt;
-
-                std::cout
-                    << "t=" << res.t_center
-                    << " dir=" << res.label
-                    << " axis=" << res.axis << res.sign
-                    << " dv=(" << res.delta_v_world.x
-                    << "," << res.delta_v_world.y
-                    << "," << res.delta_v_world.z << ")"
-                    << " dur=" << res.duration
-                    << "\n";
-                std::cout.flush();
+                    if (evt.accel.has_value()) {
+                        ++accel_events;
+                        state.have_accel = true;
+                        state.last_accel = bno::Vec3{
+                            evt.accel->x,
+                            evt.accel->y,
+                            evt.accel->z,
+                        };
+                        if (state.have_quat) {
+                            if (cfg.fusion) {
+                                state.last_quat = fusion.quat();
+                            }
+                            stamps.sensor = t_rx + evt.host_offset_us * 1e-6;
+                            process_sample(t_evt);
+                        }
+                    }
+                }
             }
         }
 
@@ -244,13 +628,54 @@ int main(int argc, char** argv)
                 << "[stats] frames="       << frames
                 << " events="             << events
                 << " accel_events="       << accel_events
+                << " gyro_events="        << gyro_events
                 << " quat_events="        << quat_events
-                << " samples="            << samples
-                << " gestures="           << gestures
-                << " timeouts="           << timeouts
-                << "\n";
+                << " samples="            << counters.samples
+                << " gestures="           << counters.gestures
+                << " timeouts="           << timeouts;
+            if (dtw.template_count() > 0) {
+                std::cerr
+                    << " dtw_matches="    << counters.dtw_matches
+                    << " dtw_max_us="     << counters.dtw_max_us
+                    << " dtw_pruned="     << dtw.stats().lb_pruned
+                    << " dtw_abandoned="  << dtw.stats().abandoned;
+                counters.dtw_max_us = 0.0;
+            }
+            if (pipeline.has_combos()) {
+                std::cerr << " combo_matches=" << counters.combo_matches;
+            }
+            if (cfg.track) {
+                std::cerr << " zupt=" << pipeline.tracker().stats().zupt_updates;
+            }
+            if (pipeline.classifier().loaded()) {
+                std::cerr << " ml_max_us=" << counters.ml_max_us;
+                counters.ml_max_us = 0.0;
+            }
+            if (idle_mode) {
+                // czas CPU procesu w tej sekundzie – zysk z idle widać, porównując
+                // linie idle=1 z idle=0
+                const std::clock_t cpu = std::clock();
+                const auto& is = idle.stats();
+                std::cerr << " idle=" << (idle.idle() ? 1 : 0)
+                          << " cpu_ms=" << static_cast<double>(cpu - last_stats_cpu) * 1e3 / CLOCKS_PER_SEC
+                          << " idle_entries=" << is.idle_entries
+                          << " idle_polls=" << idle_polls
+                          << " idle_samples=" << is.idle_samples
+                          << " idle_s=" << is.idle_s
+                          << " wake_ms=" << is.last_wake_ms
+                          << " wake_max_ms=" << is.max_wake_ms;
+            }
+            if (pipeline.cnn().loaded()) {
+                std::cerr << " cnn_matches=" << counters.cnn_matches
+                          << " cnn_max_us=" << counters.cnn_max_us
+                          << " cnn_int8=" << (pipeline.cnn().int8_active() ? 1 : 0);
+                counters.cnn_max_us = 0.0;
+            }
+            std::cerr << "\n";
+            last_stats_cpu = std::clock();
         }
     }
 
+    latency.dump(stderr, "[latency]");
     return 0;
 }
@@ -0,0 +1,774 @@
+#include "bno/imu_log.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace bno {
+
+static_assert(std::endian::native == std::endian::little,
+              "imu_log: format zakłada little-endian");
+
+namespace {
+
+std::array<std::uint32_t, 256> make_crc_table()
+{
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+std::size_t type_size(ImuLogType type)
+{
+    return (type == ImuLogType::F64) ? sizeof(double) : sizeof(float);
+}
+
+std::size_t pad8(std::size_t n)
+{
+    return (n + 7u) & ~std::size_t{7};
+}
+
+std::string sys_error(const std::string& what)
+{
+    return what + ": " + std::strerror(errno);
+}
+
+// CRC nagłówka bloku: wszystkie pola przed header_crc
+std::uint32_t block_header_crc(const ImuLogBlockHeader& h)
+{
+    return imu_log_crc32(&h, offsetof(ImuLogBlockHeader, header_crc));
+}
+
+std::uint32_t schema_crc(const std::vector<ImuLogColumnDesc>& descs)
+{
+    return imu_log_crc32(descs.data(), descs.size() * sizeof(ImuLogColumnDesc));
+}
+
+bool make_column_descs(const std::vector<ImuLogColumn>& schema,
+                       std::uint32_t block_rows,
+                       std::vector<ImuLogColumnDesc>& descs,
+                       std::string& err)
+{
+    if (schema.empty() || schema.size() > 0xFFFFu || block_rows == 0) {
+        err = "imu_log: bad schema or block size";
+        return false;
+    }
+    if (schema[0].type != ImuLogType::F64) {
+        err = "imu_log: column 0 (time) must be F64";
+        return false;
+    }
+
+    descs.assign(schema.size(), ImuLogColumnDesc{});
+    for (std::size_t i = 0; i < schema.size(); ++i) {
+        if (schema[i].name.empty() || schema[i].name.size() > IMU_LOG_NAME_LEN) {
+            err = "imu_log: bad column name '" + schema[i].name + "'";
+            return false;
+        }
+        std::memset(&descs[i], 0, sizeof(ImuLogColumnDesc));
+        std::memcpy(descs[i].name, schema[i].name.data(), schema[i].name.size());
+        descs[i].type = static_cast<std::uint8_t>(schema[i].type);
+    }
+    return true;
+}
+
+} // namespace
+
+std::uint32_t imu_log_crc32(const void* data, std::size_t len, std::uint32_t crc)
+{
+    static const std::array<std::uint32_t, 256> table = make_crc_table();
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < len; ++i) {
+        crc = table[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+std::vector<ImuLogColumn> imu_log_default_schema()
+{
+    std::vector<ImuLogColumn> schema;
+    schema.push_back({"t", ImuLogType::F64});
+    for (const char* name : {"ax", "ay", "az", "gx", "gy", "gz", "qw", "qi", "qj", "qk"}) {
+        schema.push_back({name, ImuLogType::F32});
+    }
+    return schema;
+}
+
+// ---------- ImuLogWriter ----------
+
+ImuLogWriter::~ImuLogWriter()
+{
+    std::string err;
+    close(err);
+}
+
+bool ImuLogWriter::open(const std::string& path,
+                        const std::vector<ImuLogColumn>& schema,
+                        std::string& err,
+                        std::uint32_t block_rows)
+{
+    if (is_open()) {
+        err = "imu_log: writer already open";
+        return false;
+    }
+    std::vector<ImuLogColumnDesc> descs;
+    if (!make_column_descs(schema, block_rows, descs, err)) {
+        return false;
+    }
+    async_.reset();
+
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        err = sys_error("imu_log: open " + path);
+        return false;
+    }
+    if (!begin(schema, descs, block_rows, err)) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool ImuLogWriter::open_async(const std::string& path,
+                              const std::vector<ImuLogColumn>& schema,
+                              const AsyncWriterConfig& async_cfg,
+                              std::string& err,
+                              std::uint32_t block_rows)
+{
+    if (is_open()) {
+        err = "imu_log: writer already open";
+        return false;
+    }
+    std::vector<ImuLogColumnDesc> descs;
+    if (!make_column_descs(schema, block_rows, descs, err)) {
+        return false;
+    }
+
+    async_ = std::make_unique<AsyncFileWriter>();
+    if (!async_->open(path, async_cfg, err)) {
+        async_.reset();
+        return false;
+    }
+    if (!begin(schema, descs, block_rows, err)) {
+        std::string ignored;
+        async_->close(ignored);
+        async_.reset();
+        return false;
+    }
+    return true;
+}
+
+bool ImuLogWriter::begin(const std::vector<ImuLogColumn>& schema,
+                         const std::vector<ImuLogColumnDesc>& descs,
+                         std::uint32_t block_rows,
+                         std::string& err)
+{
+    ImuLogFileHeader hdr{};
+    std::memcpy(hdr.magic, IMU_LOG_MAGIC, sizeof(hdr.magic));
+    hdr.version = IMU_LOG_VERSION;
+    hdr.column_count = static_cast<std::uint16_t>(schema.size());
+    hdr.block_rows = block_rows;
+    hdr.created_unix_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    hdr.schema_crc = schema_crc(descs);
+
+    schema_ = schema;
+    block_rows_ = block_rows;
+    offset_ = 0;
+    total_rows_ = 0;
+    rows_dropped_ = 0;
+    rows_ = 0;
+    index_.clear();
+
+    if (!write_all(&hdr, sizeof(hdr), err) ||
+        !write_all(descs.data(), descs.size() * sizeof(ImuLogColumnDesc), err)) {
+        return false;
+    }
+
+    cols_.assign(schema_.size(), {});
+    for (std::size_t c = 0; c < schema_.size(); ++c) {
+        cols_[c].reserve(block_rows_ * type_size(schema_[c].type));
+    }
+    return true;
+}
+
+bool ImuLogWriter::write_all(const void* data, std::size_t len, std::string& err)
+{
+    if (async_) {
+        // nagłówek i stopka – tu można poczekać na wolny bufor
+        if (!async_->append_wait(data, len)) {
+            err = "imu_log: async write failed";
+            return false;
+        }
+        offset_ += len;
+        return true;
+    }
+
+    const auto* p = static_cast<const unsigned char*>(data);
+    while (len > 0) {
+        const ssize_t n = ::write(fd_, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            err = sys_error("imu_log: write");
+            return false;
+        }
+        p += n;
+        len -= static_cast<std::size_t>(n);
+        offset_ += static_cast<std::uint64_t>(n);
+    }
+    return true;
+}
+
+bool ImuLogWriter::append(const double* values, std::string& err)
+{
+    if (!is_open()) {
+        err = "imu_log: writer not open";
+        return false;
+    }
+
+    for (std::size_t c = 0; c < schema_.size(); ++c) {
+        auto& col = cols_[c];
+        if (schema_[c].type == ImuLogType::F64) {
+            const auto* b = reinterpret_cast<const unsigned char*>(&values[c]);
+            col.insert(col.end(), b, b + sizeof(double));
+        } else {
+            const float f = static_cast<float>(values[c]);
+            const auto* b = reinterpret_cast<const unsigned char*>(&f);
+            col.insert(col.end(), b, b + sizeof(float));
+        }
+    }
+
+    if (rows_ == 0) {
+        t_first_ = values[0];
+    }
+    t_last_ = values[0];
+    ++rows_;
+
+    if (rows_ >= block_rows_) {
+        return write_block(err);
+    }
+    return true;
+}
+
+bool ImuLogWriter::append(const ImuCsvRow& row, std::string& err)
+{
+    const double values[11] = {
+        row.t,
+        row.ax, row.ay, row.az,
+        row.gx, row.gy, row.gz,
+        row.qw, row.qi, row.qj, row.qk,
+    };
+    if (schema_.size() != 11) {
+        err = "imu_log: append(ImuCsvRow) needs the default schema";
+        return false;
+    }
+    return append(values, err);
+}
+
+bool ImuLogWriter::write_block(std::string& err)
+{
+    if (rows_ == 0) {
+        return true;
+    }
+
+    std::size_t payload = 0;
+    for (const auto& col : cols_) {
+        payload += pad8(col.size());
+    }
+
+    block_buf_.assign(sizeof(ImuLogBlockHeader) + payload, 0);
+    unsigned char* dst = block_buf_.data() + sizeof(ImuLogBlockHeader);
+    for (auto& col : cols_) {
+        std::memcpy(dst, col.data(), col.size());
+        dst += pad8(col.size());
+        col.clear();
+    }
+
+    ImuLogBlockHeader bh{};
+    bh.magic = IMU_LOG_BLOCK_MAGIC;
+    bh.rows = rows_;
+    bh.payload_bytes = payload;
+    bh.t_first = t_first_;
+    bh.t_last = t_last_;
+    bh.payload_crc = imu_log_crc32(block_buf_.data() + sizeof(ImuLogBlockHeader), payload);
+    bh.header_crc = block_header_crc(bh);
+    std::memcpy(block_buf_.data(), &bh, sizeof(bh));
+
+    const std::uint64_t block_offset = offset_;
+    if (async_) {
+        // Bez czekania: brak miejsca w buforach = blok przepada w całości,
+        // offsety kolejnych bloków i indeks zostają spójne.
+        if (!async_->append(block_buf_.data(), block_buf_.size())) {
+            if (async_->stats().io_error) {
+                err = "imu_log: async write failed";
+                return false;
+            }
+            rows_dropped_ += rows_;
+            rows_ = 0;
+            return true;
+        }
+        offset_ += block_buf_.size();
+    } else if (!write_all(block_buf_.data(), block_buf_.size(), err)) {
+        // jeden write na blok – po awarii blok jest albo cały, albo ucięty (CRC)
+        return false;
+    }
+
+    index_.push_back(ImuLogIndexEntry{block_offset, rows_, t_first_, t_last_});
+    total_rows_ += rows_;
+    rows_ = 0;
+    return true;
+}
+
+bool ImuLogWriter::flush(bool sync, std::string& err)
+{
+    if (!is_open()) {
+        return true;
+    }
+    if (!write_block(err)) {
+        return false;
+    }
+    if (async_) {
+        async_->flush();
+        return true;
+    }
+    if (sync && ::fdatasync(fd_) != 0) {
+        err = sys_error("imu_log: fdatasync");
+        return false;
+    }
+    return true;
+}
+
+bool ImuLogWriter::close(std::string& err)
+{
+    if (!is_open()) {
+        return true;
+    }
+
+    bool ok = write_block(err);
+    if (ok) {
+        ImuLogFooter footer{};
+        footer.index_offset = offset_;
+        footer.block_count = index_.size();
+        footer.total_rows = total_rows_;
+        footer.index_crc = imu_log_crc32(index_.data(), index_.size() * sizeof(ImuLogIndexEntry));
+        std::memcpy(footer.magic, IMU_LOG_FOOTER_MAGIC, sizeof(footer.magic));
+
+        ok = write_all(index_.data(), index_.size() * sizeof(ImuLogIndexEntry), err) &&
+             write_all(&footer, sizeof(footer), err);
+    }
+    if (async_) {
+        std::string close_err;
+        if (!async_->close(close_err) && ok) {
+            err = close_err;
+            ok = false;
+        }
+        return ok;
+    }
+    if (ok && ::fdatasync(fd_) != 0) {
+        err = sys_error("imu_log: fdatasync");
+        ok = false;
+    }
+
+    ::close(fd_);
+    fd_ = -1;
+    return ok;
+}
+
+// ---------- ImuLogReader ----------
+
+ImuLogReader::~ImuLogReader()
+{
+    close();
+}
+
+void ImuLogReader::close()
+{
+    if (base_ != nullptr) {
+        ::munmap(const_cast<unsigned char*>(base_), size_);
+    }
+    base_ = nullptr;
+    size_ = 0;
+    schema_.clear();
+    col_offsets_.clear();
+    blocks_.clear();
+    checks_.clear();
+    total_rows_ = 0;
+    recovered_ = false;
+    dropped_bytes_ = 0;
+}
+
+bool ImuLogReader::open(const std::string& path, std::string& err)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        err = sys_error("imu_log: open " + path);
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        err = sys_error("imu_log: stat " + path);
+        ::close(fd);
+        return false;
+    }
+    const auto file_size = static_cast<std::size_t>(st.st_size);
+    if (file_size < sizeof(ImuLogFileHeader)) {
+        err = path + ": too short for imu log";
+        ::close(fd);
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        err = sys_error("imu_log: mmap " + path);
+        return false;
+    }
+    base_ = static_cast<const unsigned char*>(map);
+    size_ = file_size;
+    // czytamy zwykle sekwencyjnie, od początku do końca
+    ::madvise(map, file_size, MADV_SEQUENTIAL);
+
+    ImuLogFileHeader hdr;
+    std::memcpy(&hdr, base_, sizeof(hdr));
+    if (std::memcmp(hdr.magic, IMU_LOG_MAGIC, sizeof(hdr.magic)) != 0) {
+        err = path + ": not an imu log";
+        close();
+        return false;
+    }
+    if (hdr.version != IMU_LOG_VERSION) {
+        err = path + ": unsupported imu log version " + std::to_string(hdr.version);
+        close();
+        return false;
+    }
+
+    const std::size_t schema_bytes = hdr.column_count * sizeof(ImuLogColumnDesc);
+    const std::size_t data_begin = sizeof(ImuLogFileHeader) + schema_bytes;
+    if (hdr.column_count == 0 || data_begin > size_) {
+        err = path + ": truncated schema";
+        close();
+        return false;
+    }
+    std::vector<ImuLogColumnDesc> descs(hdr.column_count);
+    std::memcpy(descs.data(), base_ + sizeof(ImuLogFileHeader), schema_bytes);
+    if (schema_crc(descs) != hdr.schema_crc) {
+        err = path + ": schema CRC mismatch";
+        close();
+        return false;
+    }
+    for (const auto& d : descs) {
+        const auto type = static_cast<ImuLogType>(d.type);
+        if (type != ImuLogType::F32 && type != ImuLogType::F64) {
+            err = path + ": unknown column type";
+            close();
+            return false;
+        }
+        std::size_t len = 0;
+        while (len < IMU_LOG_NAME_LEN && d.name[len] != '\0') {
+            ++len;
+        }
+        schema_.push_back(ImuLogColumn{std::string(d.name, len), type});
+    }
+
+    if (!load_index(data_begin)) {
+        scan_blocks(data_begin);
+    }
+    return true;
+}
+
+bool ImuLogReader::load_index(std::size_t data_begin)
+{
+    if (size_ < data_begin + sizeof(ImuLogFooter)) {
+        return false;
+    }
+    ImuLogFooter footer;
+    std::memcpy(&footer, base_ + size_ - sizeof(footer), sizeof(footer));
+    if (std::memcmp(footer.magic, IMU_LOG_FOOTER_MAGIC, sizeof(footer.magic)) != 0) {
+        return false;
+    }
+    const std::uint64_t index_bytes = footer.block_count * sizeof(ImuLogIndexEntry);
+    if (footer.index_offset < data_begin ||
+        footer.index_offset + index_bytes + sizeof(footer) != size_) {
+        return false;
+    }
+    const unsigned char* index = base_ + footer.index_offset;
+    if (imu_log_crc32(index, index_bytes) != footer.index_crc) {
+        return false;
+    }
+
+    // Indeks jest spójny, ale bloki mogły się zepsuć niezależnie od niego.
+    // Każdy nagłówek bloku sprawdzamy tu (magic, CRC, rozmiar, zgodność
+    // z wpisem indeksu); CRC payloadu – przy pierwszym dostępie (block_valid).
+    auto fail = [this] {
+        blocks_.clear();
+        checks_.clear();
+        col_offsets_.clear();
+        total_rows_ = 0;
+        return false;
+    };
+
+    const std::size_t ncol = schema_.size();
+    for (std::uint64_t i = 0; i < footer.block_count; ++i) {
+        ImuLogIndexEntry e;
+        std::memcpy(&e, index + i * sizeof(e), sizeof(e));
+        if (e.offset < data_begin || e.offset + sizeof(ImuLogBlockHeader) > footer.index_offset) {
+            return fail();
+        }
+        ImuLogBlockHeader bh;
+        std::memcpy(&bh, base_ + e.offset, sizeof(bh));
+        if (bh.magic != IMU_LOG_BLOCK_MAGIC || block_header_crc(bh) != bh.header_crc ||
+            bh.rows != e.rows || bh.t_first != e.t_first || bh.t_last != e.t_last) {
+            return fail();
+        }
+
+        ImuLogBlockView v;
+        v.rows = bh.rows;
+        v.t_first = bh.t_first;
+        v.t_last = bh.t_last;
+        v.data = base_ + e.offset + sizeof(ImuLogBlockHeader);
+
+        std::size_t off = 0;
+        for (std::size_t c = 0; c < ncol; ++c) {
+            col_offsets_.push_back(off);
+            off += pad8(v.rows * type_size(schema_[c].type));
+        }
+        if (bh.payload_bytes != off ||
+            e.offset + sizeof(ImuLogBlockHeader) + off > footer.index_offset) {
+            return fail();
+        }
+        blocks_.push_back(v);
+        checks_.push_back(BlockCheck{off, bh.payload_crc, PayloadCheck::Unchecked});
+        total_rows_ += v.rows;
+    }
+    if (total_rows_ != footer.total_rows) {
+        return fail();
+    }
+    return true;
+}
+
+void ImuLogReader::scan_blocks(std::size_t data_begin)
+{
+    // Brak (poprawnej) stopki – plik po awarii. Idziemy blok po bloku
+    // i kończymy na pierwszym, który się nie zgadza.
+    recovered_ = true;
+    blocks_.clear();
+    checks_.clear();
+    col_offsets_.clear();
+    total_rows_ = 0;
+
+    const std::size_t ncol = schema_.size();
+    std::size_t pos = data_begin;
+    while (pos + sizeof(ImuLogBlockHeader) <= size_) {
+        ImuLogBlockHeader bh;
+        std::memcpy(&bh, base_ + pos, sizeof(bh));
+        if (bh.magic != IMU_LOG_BLOCK_MAGIC || block_header_crc(bh) != bh.header_crc) {
+            break;
+        }
+
+        std::size_t expected = 0;
+        for (std::size_t c = 0; c < ncol; ++c) {
+            expected += pad8(bh.rows * type_size(schema_[c].type));
+        }
+        const std::size_t payload_pos = pos + sizeof(bh);
+        if (bh.payload_bytes != expected || payload_pos + expected > size_ ||
+            imu_log_crc32(base_ + payload_pos, expected) != bh.payload_crc) {
+            break;
+        }
+
+        ImuLogBlockView v;
+        v.rows = bh.rows;
+        v.t_first = bh.t_first;
+        v.t_last = bh.t_last;
+        v.data = base_ + payload_pos;
+        std::size_t off = 0;
+        for (std::size_t c = 0; c < ncol; ++c) {
+            col_offsets_.push_back(off);
+            off += pad8(v.rows * type_size(schema_[c].type));
+        }
+        blocks_.push_back(v);
+        checks_.push_back(BlockCheck{expected, bh.payload_crc, PayloadCheck::Ok});
+        total_rows_ += v.rows;
+        pos = payload_pos + expected;
+    }
+    dropped_bytes_ = size_ - pos;
+}
+
+int ImuLogReader::column_index(const std::string& name) const
+{
+    for (std::size_t i = 0; i < schema_.size(); ++i) {
+        if (schema_[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const unsigned char* ImuLogReader::column_ptr(std::size_t b, std::size_t col) const
+{
+    return blocks_[b].data + col_offsets_[b * schema_.size() + col];
+}
+
+bool ImuLogReader::block_valid(std::size_t b) const
+{
+    BlockCheck& c = checks_[b];
+    if (c.state == PayloadCheck::Unchecked) {
+        c.state = (imu_log_crc32(blocks_[b].data, c.bytes) == c.crc) ? PayloadCheck::Ok
+                                                                     : PayloadCheck::Bad;
+    }
+    return c.state == PayloadCheck::Ok;
+}
+
+const float* ImuLogReader::column_f32(std::size_t b, std::size_t col) const
+{
+    if (schema_[col].type != ImuLogType::F32 || !block_valid(b)) {
+        return nullptr;
+    }
+    // payload jest wyrównany do 8 bajtów względem początku mmap
+    return reinterpret_cast<const float*>(static_cast<const void*>(column_ptr(b, col)));
+}
+
+const double* ImuLogReader::column_f64(std::size_t b, std::size_t col) const
+{
+    if (schema_[col].type != ImuLogType::F64 || !block_valid(b)) {
+        return nullptr;
+    }
+    return reinterpret_cast<const double*>(static_cast<const void*>(column_ptr(b, col)));
+}
+
+double ImuLogReader::value(std::size_t b, std::size_t col, std::size_t row) const
+{
+    if (!block_valid(b)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (schema_[col].type == ImuLogType::F64) {
+        return column_f64(b, col)[row];
+    }
+    return static_cast<double>(column_f32(b, col)[row]);
+}
+
+// ---------- wygodne funkcje ----------
+
+bool is_imu_log(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char magic[sizeof(IMU_LOG_MAGIC)] = {};
+    const ssize_t n = ::read(fd, magic, sizeof(magic));
+    ::close(fd);
+    return n == static_cast<ssize_t>(sizeof(magic)) &&
+           std::memcmp(magic, IMU_LOG_MAGIC, sizeof(magic)) == 0;
+}
+
+bool read_imu_log(const std::string& path, std::vector<ImuCsvRow>& out, std::string& err)
+{
+    out.clear();
+
+    ImuLogReader reader;
+    if (!reader.open(path, err)) {
+        return false;
+    }
+
+    const char* names[11] = {"t", "ax", "ay", "az", "gx", "gy", "gz", "qw", "qi", "qj", "qk"};
+    int idx[11];
+    for (std::size_t k = 0; k < 11; ++k) {
+        idx[k] = reader.column_index(names[k]);
+    }
+    if (idx[0] < 0) {
+        err = path + ": no 't' column";
+        return false;
+    }
+
+    out.reserve(reader.total_rows());
+    for (std::size_t b = 0; b < reader.block_count(); ++b) {
+        if (!reader.block_valid(b)) {
+            err = path + ": block " + std::to_string(b) + ": payload CRC mismatch";
+            out.clear();
+            return false;
+        }
+        const std::size_t rows = reader.block(b).rows;
+        const std::size_t first = out.size();
+        out.resize(first + rows);
+        for (std::size_t k = 0; k < 11; ++k) {
+            if (idx[k] < 0) {
+                continue;   // zostaje wartość domyślna z ImuCsvRow
+            }
+            const auto col = static_cast<std::size_t>(idx[k]);
+            double ImuCsvRow::*field = nullptr;
+            switch (k) {
+            case 0: field = &ImuCsvRow::t; break;
+            case 1: field = &ImuCsvRow::ax; break;
+            case 2: field = &ImuCsvRow::ay; break;
+            case 3: field = &ImuCsvRow::az; break;
+            case 4: field = &ImuCsvRow::gx; break;
+            case 5: field = &ImuCsvRow::gy; break;
+            case 6: field = &ImuCsvRow::gz; break;
+            case 7: field = &ImuCsvRow::qw; break;
+            case 8: field = &ImuCsvRow::qi; break;
+            case 9: field = &ImuCsvRow::qj; break;
+            default: field = &ImuCsvRow::qk; break;
+            }
+            if (const float* f = reader.column_f32(b, col)) {
+                for (std::size_t r = 0; r < rows; ++r) {
+                    out[first + r].*field = static_cast<double>(f[r]);
+                }
+            } else {
+                const double* d = reader.column_f64(b, col);
+                for (std::size_t r = 0; r < rows; ++r) {
+                    out[first + r].*field = d[r];
+                }
+            }
+        }
+    }
+
+    if (out.empty()) {
+        err = path + ": no samples";
+        return false;
+    }
+    return true;
+}
+
+bool write_imu_log(const std::string& path, const std::vector<ImuCsvRow>& rows,
+                   std::string& err)
+{
+    ImuLogWriter writer;
+    if (!writer.open(path, imu_log_default_schema(), err, 4096)) {
+        return false;
+    }
+    for (const auto& r : rows) {
+        if (!writer.append(r, err)) {
+            return false;
+        }
+    }
+    return writer.close(err);
+}
+
+bool read_imu_samples(const std::string& path, std::vector<ImuCsvRow>& out, std::string& err)
+{
+    if (is_imu_log(path)) {
+        return read_imu_log(path, out, err);
+    }
+    return read_imu_csv(path, out, err);
+}
+
+} // namespace bno
@@ -0,0 +1,166 @@
+// Konwersja nagrań imu_read: CSV <-> binarny log (.imlog).
+//
+//   imu_logconv in.csv out.imlog      # CSV -> log
+//   imu_logconv in.imlog out.csv      # log -> CSV (kierunek po nagłówku wejścia)
+//   imu_logconv --info in.imlog       # schemat, bloki, stan po awarii
+
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bno/imu_csv.hpp"
+#include "bno/imu_log.hpp"
+
+namespace {
+
+void print_usage(const char* argv0)
+{
+    std::cerr
+        << "Usage: " << argv0 << " <in.csv|in.imlog> <out>\n"
+        << "       " << argv0 << " --info <in.imlog>\n"
+        << "CSV input is written as binary log, binary log as CSV.\n";
+}
+
+int print_info(const std::string& path)
+{
+    bno::ImuLogReader reader;
+    std::string err;
+    if (!reader.open(path, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    std::cout << path << ": " << reader.total_rows() << " rows, "
+              << reader.block_count() << " blocks";
+    if (reader.recovered()) {
+        std::cout << " (no valid footer/index, recovered by scan, "
+                  << reader.dropped_bytes() << " trailing bytes dropped)";
+    }
+    std::cout << "\ncolumns:";
+    for (const auto& c : reader.schema()) {
+        std::cout << " " << c.name << (c.type == bno::ImuLogType::F64 ? ":f64" : ":f32");
+    }
+    std::cout << "\n";
+    std::size_t bad = 0;
+    for (std::size_t b = 0; b < reader.block_count(); ++b) {
+        if (!reader.block_valid(b)) {
+            ++bad;
+        }
+    }
+    if (bad > 0) {
+        std::cout << "payload CRC mismatch in " << bad << " blocks\n";
+    }
+    if (reader.block_count() > 0) {
+        std::cout << "t: " << reader.block(0).t_first << " .. "
+                  << reader.block(reader.block_count() - 1).t_last << " s\n";
+    }
+    return bad > 0 ? 1 : 0;
+}
+
+// Najkrótszy zapis, który wczytuje się z powrotem do tej samej wartości
+// (float dla kolumn f32 – bez sztucznych cyfr z rozszerzenia do double).
+void append_value(std::string& line, const bno::ImuLogReader& reader,
+                  std::size_t b, std::size_t col, std::size_t row)
+{
+    char buf[32];
+    std::to_chars_result r{};
+    if (const float* f = reader.column_f32(b, col)) {
+        r = std::to_chars(buf, buf + sizeof(buf), f[row]);
+    } else {
+        r = std::to_chars(buf, buf + sizeof(buf), reader.column_f64(b, col)[row]);
+    }
+    line.append(buf, r.ptr);
+}
+
+int log_to_csv(const std::string& in, const std::string& out)
+{
+    bno::ImuLogReader reader;
+    std::string err;
+    if (!reader.open(in, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+    if (reader.recovered()) {
+        std::cerr << in << ": no valid footer/index, recovered " << reader.total_rows() << " rows\n";
+    }
+
+    std::FILE* f = std::fopen(out.c_str(), "w");
+    if (f == nullptr) {
+        std::cerr << "cannot open " << out << "\n";
+        return 1;
+    }
+
+    // nagłówek z nazw kolumn – dla schematu domyślnego to IMU_CSV_HEADER
+    std::string line;
+    for (std::size_t c = 0; c < reader.schema().size(); ++c) {
+        if (c > 0) {
+            line += ',';
+        }
+        line += reader.schema()[c].name;
+    }
+    line += '\n';
+    std::fputs(line.c_str(), f);
+
+    const std::size_t ncol = reader.schema().size();
+    for (std::size_t b = 0; b < reader.block_count(); ++b) {
+        if (!reader.block_valid(b)) {
+            std::cerr << in << ": block " << b << ": payload CRC mismatch\n";
+            std::fclose(f);
+            return 1;
+        }
+        for (std::size_t r = 0; r < reader.block(b).rows; ++r) {
+            line.clear();
+            for (std::size_t c = 0; c < ncol; ++c) {
+                if (c > 0) {
+                    line += ',';
+                }
+                append_value(line, reader, b, c, r);
+            }
+            line += '\n';
+            std::fwrite(line.data(), 1, line.size(), f);
+        }
+    }
+
+    if (std::fclose(f) != 0) {
+        std::cerr << "write failed: " << out << "\n";
+        return 1;
+    }
+    std::cerr << in << " -> " << out << ": " << reader.total_rows() << " rows\n";
+    return 0;
+}
+
+int csv_to_log(const std::string& in, const std::string& out)
+{
+    std::vector<bno::ImuCsvRow> rows;
+    std::string err;
+    if (!bno::read_imu_csv(in, rows, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+    if (!bno::write_imu_log(out, rows, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+    std::cerr << in << " -> " << out << ": " << rows.size() << " rows\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && std::string_view(argv[1]) == "--info") {
+        return print_info(argv[2]);
+    }
+    if (argc != 3 || std::string_view(argv[1]) == "-h" || std::string_view(argv[1]) == "--help") {
+        print_usage(argv[0]);
+        return argc == 3 ? 0 : 1;
+    }
+
+    const std::string in = argv[1];
+    const std::string out = argv[2];
+    return bno::is_imu_log(in) ? log_to_csv(in, out) : csv_to_log(in, out);
+}
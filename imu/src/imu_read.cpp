@@ -1,16 +1,23 @@
 #include "bno/shtp.hpp"
 #include "bno/sh2_reports.hpp"
-
+#include "bno/sh2_enable.hpp"
+#include "bno/imu_log.hpp"
+#include "bno/resample.hpp"
+#include "bno/async_writer.hpp"
+#include "bno/row_format.hpp"
+#include "bno/log.hpp"
+
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <thread>
-#include <fstream>
 
 using namespace std::chrono_literals;
 
@@ -23,6 +30,14 @@ struct CliConfig {
     int timeout_ms = 50;
     bool header = true;
     std::string out_path = "dupa.csv";
+    bool binary = false;   // --format bin: log kolumnowy (.imlog) zamiast CSV
+    bno::ResampleMode output_mode = bno::ResampleMode::Event;
+    bool linear_accel = true;    // --accel raw: Accelerometer zamiast Linear Acceleration
+    int idle_us = 500;           // pauza, gdy BNO nie ma danych
+    bool async_writer = true;    // --writer async: zapis pliku w osobnym wątku
+    bno::AsyncWriterConfig writer;
+    double stats_s = 0.0;        // co ile sekund statystyki zapisu na stderr (0 = tylko na końcu)
+    bool trace = false;          // --trace: czasy zakresów BNO_TRACE_SPAN na stderr
 };
 
 volatile std::sig_atomic_t g_stop = 0;
@@ -35,10 +50,21 @@ void print_usage(const char* argv0) {
     std::cout << "Usage: " << argv0 << " [options]\n"
               << "  --bus <int>           I2C bus (default 1)\n"
               << "  --addr <hex>          I2C address (default 0x4A)\n"
-              << "  --hz <50..100>        Output rate (default 100)\n"
+              << "  --hz <50..100>        Sensor report rate and output grid (default 100)\n"
               << "  --timeout-ms <int>    I2C read timeout (default 50)\n"
               << "  --no-header           Do not print CSV header\n"
-              << "  --out <path>          Write CSV data to file instead of stdout\n";
+              << "  --out <path>          Write CSV data to file instead of stdout\n"
+              << "  --format <csv|bin>    Output format (bin = columnar .imlog, needs --out)\n"
+              << "  --output-mode <m>     event (row per report, default), hold (ZOH at --hz)\n"
+              << "                        or linear (lerp/SLERP onto --hz grid)\n"
+              << "  --accel <linear|raw>  ax/ay/az from Linear Accel (default) or Accelerometer\n"
+              << "  --idle-us <int>       Sleep when sensor has no data (default 500)\n"
+              << "  --writer <async|sync> File writes on background thread (default) or inline\n"
+              << "  --write-buffers <n>   Async writer buffer count (default 8)\n"
+              << "  --write-buffer-kb <n> Async writer buffer size (default 256)\n"
+              << "  --direct-io           Open output with O_DIRECT (async writer only)\n"
+              << "  --stats-s <sec>       Print writer stats to stderr every N seconds\n"
+              << "  --trace               Log per-frame trace spans to stderr\n";
 }
 
 bool parse_args(int argc, char** argv, CliConfig& cfg) {
@@ -56,6 +82,54 @@ bool parse_args(int argc, char** argv, CliConfig& cfg) {
             cfg.header = false;
         } else if (arg == "--out" && i + 1 < argc) {
             cfg.out_path = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            const std::string_view fmt{argv[++i]};
+            if (fmt == "bin") {
+                cfg.binary = true;
+            } else if (fmt == "csv") {
+                cfg.binary = false;
+            } else {
+                std::cout << "Unknown format: " << fmt << "\n";
+                return false;
+            }
+        } else if (arg == "--output-mode" && i + 1 < argc) {
+            const std::string_view mode{argv[++i]};
+            if (mode == "event") {
+                cfg.output_mode = bno::ResampleMode::Event;
+            } else if (mode == "hold") {
+                cfg.output_mode = bno::ResampleMode::Hold;
+            } else if (mode == "linear") {
+                cfg.output_mode = bno::ResampleMode::Linear;
+            } else {
+                std::cout << "Unknown output mode: " << mode << "\n";
+                return false;
+            }
+        } else if (arg == "--accel" && i + 1 < argc) {
+            const std::string_view accel{argv[++i]};
+            if (accel != "raw" && accel != "linear") {
+                std::cout << "Unknown accel source: " << accel << "\n";
+                return false;
+            }
+            cfg.linear_accel = (accel == "linear");
+        } else if (arg == "--idle-us" && i + 1 < argc) {
+            cfg.idle_us = std::atoi(argv[++i]);
+        } else if (arg == "--writer" && i + 1 < argc) {
+            const std::string_view writer{argv[++i]};
+            if (writer != "async" && writer != "sync") {
+                std::cout << "Unknown writer: " << writer << "\n";
+                return false;
+            }
+            cfg.async_writer = (writer == "async");
+        } else if (arg == "--write-buffers" && i + 1 < argc) {
+            cfg.writer.buffer_count = static_cast<std::size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--write-buffer-kb" && i + 1 < argc) {
+            cfg.writer.buffer_bytes = static_cast<std::size_t>(std::max(0, std::atoi(argv[++i]))) * 1024;
+        } else if (arg == "--direct-io") {
+            cfg.writer.direct_io = true;
+        } else if (arg == "--stats-s" && i + 1 < argc) {
+            cfg.stats_s = std::atof(argv[++i]);
+        } else if (arg == "--trace") {
+            cfg.trace = true;
         } else if (arg == "--help" || arg == "-h") {
             print_usage(argv[0]);
             return false;
@@ -69,33 +143,32 @@ bool parse_args(int argc, char** argv, CliConfig& cfg) {
         std::cout << "hz must be in [50,100]\n";
         return false;
     }
-    return true;
-}
-
-/// Helper: wyślij Set Feature Command dla danego raportu.
-bool enable_report(bno::ShtpTransport& transport,
-                   bno::Sh2SensorId sensor,
-                   int hz,
-                   bno::ShtpError& err) {
-    const std::uint32_t interval_us = static_cast<std::uint32_t>(1'000'000 / hz);
-
-    std::uint8_t buf[32];
-    std::size_t len = 0;
-    if (!bno::build_enable_report_command(sensor, interval_us, buf, len, sizeof(buf))) {
-        std::cout << "build_enable_report_command failed\n";
+    if (cfg.binary && cfg.out_path.empty()) {
+        std::cout << "--format bin needs --out <path>\n";
         return false;
     }
-
-    // Set Feature Command idzie na kanał kontrolny SH-2. :contentReference[oaicite:12]{index=12}
-    if (!transport.write_frame(bno::ShtpChannel::Control, buf, len, err)) {
-        std::cout << "write_frame(SetFeature) failed: " << err.message
-                  << " (errno=" << err.sys_errno << ")\n";
-        return false;
-    }
-
     return true;
 }
 
+void print_writer_stats(std::ostream& os, const bno::AsyncFileWriter& w,
+                        std::uint64_t rows_dropped) {
+    const bno::AsyncWriterStats s = w.stats();
+    const double avg_ms = (s.batches > 0)
+        ? static_cast<double>(s.write_us_total) / static_cast<double>(s.batches) / 1000.0
+        : 0.0;
+    os << "writer=" << w.backend_name() << (w.direct_io() ? "+direct" : "")
+       << " written_kb=" << s.bytes_written / 1024
+       << " queue=" << s.queue_depth
+       << " queue_max=" << s.queue_depth_max
+       << " batches=" << s.batches
+       << " write_ms_avg=" << avg_ms
+       << " write_ms_max=" << static_cast<double>(s.write_us_max) / 1000.0
+       << " overruns=" << s.overruns
+       << " dropped_kb=" << s.bytes_dropped / 1024
+       << " rows_dropped=" << rows_dropped
+       << (s.io_error ? " io_error" : "") << "\n";
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -105,21 +178,42 @@ int main(int argc, char** argv) {
     }
 
     std::signal(SIGINT, signal_handler);
+    // runner.py kończy nagranie przez terminate() – też zamykamy log porządnie
+    std::signal(SIGTERM, signal_handler);
+
+    bno::log::set_trace(cfg.trace);
 
     bno::ShtpI2cTransport transport;
     bno::ShtpError err;
 
-    // Strumień wyjściowy dla danych: stdout lub plik
-    std::ofstream file_out;
-    std::ostream* data_out = &std::cout;
-
-    if (!cfg.out_path.empty()) {
-        file_out.open(cfg.out_path, std::ios::out | std::ios::trunc);
-        if (!file_out) {
+    // Wyjście danych: stdout lub plik.
+    // Do pliku domyślnie przez AsyncFileWriter: przestój karty SD nie
+    // zatrzymuje odczytu I2C, najwyżej gubimy wiersze (overruns w statystykach).
+    std::FILE* text_out = stdout;
+    bno::AsyncFileWriter csv_async;
+    bno::ImuLogWriter log_out;
+    std::string log_err;
+    std::uint64_t csv_rows_dropped = 0;
+
+    if (cfg.binary) {
+        const bool opened = cfg.async_writer
+            ? log_out.open_async(cfg.out_path, bno::imu_log_default_schema(), cfg.writer, log_err)
+            : log_out.open(cfg.out_path, bno::imu_log_default_schema(), log_err);
+        if (!opened) {
+            std::cerr << "Failed to open output log: " << log_err << "\n";
+            return 1;
+        }
+    } else if (!cfg.out_path.empty() && cfg.async_writer) {
+        if (!csv_async.open(cfg.out_path, cfg.writer, log_err)) {
+            std::cerr << "Failed to open output file: " << log_err << "\n";
+            return 1;
+        }
+    } else if (!cfg.out_path.empty()) {
+        text_out = std::fopen(cfg.out_path.c_str(), "w");
+        if (text_out == nullptr) {
             std::cerr << "Failed to open output file: " << cfg.out_path << "\n";
             return 1;
         }
-        data_out = &file_out;
     }
 
     if (!transport.open(cfg.bus, cfg.addr, err)) {
@@ -132,125 +226,201 @@ int main(int argc, char** argv) {
     transport.set_max_frame_size(bno::SHTP_MAX_FRAME);
 
     // Włączamy raporty, których potrzebujemy:
-    //  - Linear Accel (preferowane do ax/ay/az)
-    //  - Accelerometer (fallback)
+    //  - Linear Accel (bez grawitacji – na nim pracuje detektor w imu_dir
+    //    i imu_daemon) albo Accelerometer (--accel raw). Nie oba naraz:
+    //    trafiają do tych samych kolumn ax/ay/az i przeplatały się w
+    //    starszych nagraniach.
     //  - Gyro Calibrated
     //  - Game Rotation Vector
-    if (!enable_report(transport, bno::Sh2SensorId::LinearAcceleration, cfg.hz, err)) {
-        std::cout << "Failed to enable Linear Accel\n";
-    }
-    if (!enable_report(transport, bno::Sh2SensorId::Accelerometer, cfg.hz, err)) {
-        std::cout << "Failed to enable Accelerometer\n";
+    const bno::Sh2SensorId accel_id = cfg.linear_accel
+        ? bno::Sh2SensorId::LinearAcceleration
+        : bno::Sh2SensorId::Accelerometer;
+    if (!bno::enable_sensor_report(transport, accel_id, cfg.hz, err)) {
+        std::cout << "Failed to enable "
+                  << (cfg.linear_accel ? "Linear Accel" : "Accelerometer")
+                  << ": " << err.message << "\n";
     }
-    if (!enable_report(transport, bno::Sh2SensorId::GyroscopeCalibrated, cfg.hz, err)) {
-        std::cout << "Failed to enable Gyro Calibrated\n";
+    if (!bno::enable_sensor_report(transport, bno::Sh2SensorId::GyroscopeCalibrated, cfg.hz, err)) {
+        std::cout << "Failed to enable Gyro Calibrated: " << err.message << "\n";
     }
-    if (!enable_report(transport, bno::Sh2SensorId::GameRotationVector, cfg.hz, err)) {
-        std::cout << "Failed to enable Game Rotation Vector\n";
+    if (!bno::enable_sensor_report(transport, bno::Sh2SensorId::GameRotationVector, cfg.hz, err)) {
+        std::cout << "Failed to enable Game Rotation Vector: " << err.message << "\n";
     }
 
-    if (cfg.header) {
-        *data_out << "t,ax,ay,az,gx,gy,gz,qw,qi,qj,qk\n";
-        data_out->flush();
-    }
+    const bno::AsyncFileWriter* async_out = cfg.binary ? log_out.async_writer()
+                                          : (csv_async.is_open() ? &csv_async : nullptr);
 
+    // Wiersze CSV zbieramy w jednym buforze i oddajemy kawałkami: po
+    // TEXT_CHUNK bajtach, gdy BNO nie ma danych, i raz na sekundę.
+    constexpr std::size_t TEXT_CHUNK = 8 * 1024;
+    bno::RowFormatter text(2 * TEXT_CHUNK);
+    std::uint64_t text_rows = 0;
+    bool write_failed = false;
+
+    auto flush_text = [&]() {
+        if (text.empty()) {
+            return;
+        }
+        if (csv_async.is_open()) {
+            if (!csv_async.append(text.data(), text.size())) {
+                if (csv_async.stats().io_error) {
+                    std::cerr << "CSV write failed\n";
+                    write_failed = true;
+                }
+                csv_rows_dropped += text_rows;
+            }
+            text.clear();
+        } else if (!text.write_to(text_out)) {
+            std::cerr << "CSV write failed\n";
+            write_failed = true;
+        }
+        text_rows = 0;
+    };
+
+    if (cfg.header && !cfg.binary) {
+        text.put(bno::IMU_CSV_HEADER);
+        text.put('\n');
+        if (csv_async.is_open()) {
+            csv_async.append_wait(text.data(), text.size());
+            text.clear();
+        } else {
+            flush_text();
+        }
+    }
 
-    const auto period = std::chrono::duration<double>(1.0 / cfg.hz);
     auto t0 = std::chrono::steady_clock::now();
+    auto last_log_flush = t0;
+    auto last_stats = t0;
 
     std::size_t frames_total = 0;
+    std::size_t reports_total = 0;
 
-    // Aktualny stan (ostatnie wartości z poszczególnych raportów)
-    double ax = 0.0, ay = 0.0, az = 0.0;
-    double gx = 0.0, gy = 0.0, gz = 0.0;
-    double qw = 1.0, qi = 0.0, qj = 0.0, qk = 0.0;
+    bno::ImuResampler::Config rs_cfg;
+    rs_cfg.mode = cfg.output_mode;
+    rs_cfg.rate_hz = cfg.hz;
+    bno::ImuResampler resampler(rs_cfg);
 
-    while (!g_stop) {
-        auto frame_opt = transport.read_frame(err, cfg.timeout_ms);
-        if (!frame_opt) {
-            // timeout / error – w docelowej wersji tu wejdzie logika reinit/reset.
-            continue;
+    auto write_row = [&](const bno::ImuCsvRow& row) {
+        if (write_failed) {
+            return;
         }
+        if (cfg.binary) {
+            if (!log_out.append(row, log_err)) {
+                std::cerr << "Log write failed: " << log_err << "\n";
+                write_failed = true;
+            }
+        } else {
+            text.put_imu_row(row);
+            ++text_rows;
+            if (text.size() >= TEXT_CHUNK) {
+                flush_text();
+            }
+        }
+    };
 
-        const auto& frame = *frame_opt;
-
-       const auto ch = frame.header.channel;
+    // Bez usypiania po każdej ramce: czytamy tak szybko, jak przychodzą,
+    // a tempo wyjścia ustala ImuResampler. Śpimy tylko, gdy BNO nie ma
+    // nic do wysłania (pusta ramka), żeby nie okupować magistrali.
+    bno::Sh2SensorEvent events[16];
 
-        // Interesują nas tylko kanały z raportami SH-2 (normal + gyroRV).
-        if (ch < 2 || ch > 5) {
+    while (!g_stop && !write_failed) {
+        auto frame_opt = transport.read_frame(err, cfg.timeout_ms);
+        if (!frame_opt) {
+            // timeout / brak danych – w docelowej wersji tu wejdzie logika reinit/reset.
+            flush_text();   // czujnik nie ma nic nowego – wypchnij, co mamy
+            if (cfg.idle_us > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(cfg.idle_us));
+            }
             continue;
         }
 
-        // --- NOWE: obsługa 0xFB Base Timestamp Reference ---
-        // BNO08x na kanale 3 potrafi wysłać:
-        //   [0xFB, baseDelta(4 bajty), 0x01/0x02/0x04/0x08, ...]
-        // Nasz parser oczekuje, że data[0] to już report ID sensora,
-        // więc jeśli widzimy 0xFB, pomijamy pierwszych 5 bajtów.
+        BNO_TRACE_SPAN("imu_read.frame");
 
-        const std::uint8_t* p   = frame.payload.data();
-        std::size_t         len = frame.payload.size();
+        // czas odczytu ramki; czasy raportów liczymy od niego wstecz (delay SH-2)
+        const auto now = std::chrono::steady_clock::now();
+        const double t_rx = std::chrono::duration<double>(now - t0).count();
 
-        if (len >= 5 && p[0] == 0xFB) {
-            // 0xFB = Base Timestamp Reference (5 bajtów)
-            p   += 5;
-            len -= 5;
-        }
+        const auto& frame = *frame_opt;
+        const auto ch = frame.header.channel;
 
-        // Jeśli po bazie czasu nie ma już nic – nie ma co parsować.
-        if (len == 0) {
+        // Interesują nas tylko kanały z raportami SH-2 (normal + gyroRV).
+        if (ch < 2 || ch > 5) {
             continue;
         }
+        ++frames_total;
 
-        auto evt_opt = bno::parse_sh2_sensor_event(p, len);
+        // Jedna ramka = [0xFB base delta] + kilka raportów (0x01/0x02/0x04/0x08 ...)
+        const std::size_t n = bno::parse_sh2_input_reports(
+            frame.payload.data(), frame.payload.size(), events, std::size(events));
 
-        if (!evt_opt) {
-            // DEBUG: teraz logujemy krótszy payload (już *po* ewentualnym 0xFB)
+        if (n == 0 && ch == 3 && !frame.payload.empty()) {
             std::cerr << "[imu_read_cpp] unknown sensor report on ch=" << int(ch)
-                    << " len=" << len << " :";
-            for (std::size_t i = 0; i < len && i < 16; ++i) {
-                std::cerr << " " << std::hex << int(p[i]) << std::dec;
+                      << " len=" << frame.payload.size() << " :";
+            for (std::size_t i = 0; i < frame.payload.size() && i < 16; ++i) {
+                std::cerr << " " << std::hex << int(frame.payload[i]) << std::dec;
             }
             std::cerr << "\n";
             continue;
         }
 
-        const auto& evt = *evt_opt;
-
-        if (evt.accel.has_value()) {
-            ax = evt.accel->x;
-            ay = evt.accel->y;
-            az = evt.accel->z;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& evt = events[i];
+            const double t = t_rx + evt.host_offset_us * 1e-6;
+
+            if (evt.accel.has_value() && evt.sensor_id == accel_id) {
+                const double v[3] = {evt.accel->x, evt.accel->y, evt.accel->z};
+                resampler.push(bno::ImuChannel::Accel, t, v, write_row);
+            } else if (evt.gyro.has_value()) {
+                const double v[3] = {evt.gyro->x, evt.gyro->y, evt.gyro->z};
+                resampler.push(bno::ImuChannel::Gyro, t, v, write_row);
+            } else if (evt.game_quat.has_value()) {
+                const double v[4] = {evt.game_quat->real, evt.game_quat->i,
+                                     evt.game_quat->j, evt.game_quat->k};
+                resampler.push(bno::ImuChannel::Quat, t, v, write_row);
+            } else {
+                continue;
+            }
+            ++reports_total;
         }
 
-        if (evt.gyro.has_value()) {
-            gx = evt.gyro->x;
-            gy = evt.gyro->y;
-            gz = evt.gyro->z;
+        // blok logu co ~1 s – po awarii tracimy najwyżej ostatnią sekundę
+        if (now - last_log_flush > 1s) {
+            last_log_flush = now;
+            if (cfg.binary && !log_out.flush(false, log_err)) {
+                std::cerr << "Log write failed: " << log_err << "\n";
+                break;
+            }
+            flush_text();
+            csv_async.flush();
         }
 
-        if (evt.game_quat.has_value()) {
-            qw = evt.game_quat->real;
-            qi = evt.game_quat->i;
-            qj = evt.game_quat->j;
-            qk = evt.game_quat->k;
+        if (async_out != nullptr && cfg.stats_s > 0.0 &&
+            std::chrono::duration<double>(now - last_stats).count() >= cfg.stats_s) {
+            last_stats = now;
+            print_writer_stats(std::cerr, *async_out,
+                               cfg.binary ? log_out.rows_dropped() : csv_rows_dropped);
         }
+    }
 
-
-        ++frames_total;
-        auto now = std::chrono::steady_clock::now();
-        double t = std::chrono::duration<double>(now - t0).count();
-
-        *data_out << t << ','
-          << ax << ',' << ay << ',' << az << ','
-          << gx << ',' << gy << ',' << gz << ','
-          << qw << ',' << qi << ',' << qj << ',' << qk << '\n';
-
-
-        // Throttling do ~cfg.hz (dane mogą realnie napływać z taką samą lub większą częstotliwością)
-        std::this_thread::sleep_for(period);
+    flush_text();
+    if (text_out != stdout) {
+        std::fclose(text_out);
+    }
+    if (cfg.binary && !log_out.close(log_err)) {
+        std::cerr << "Log close failed: " << log_err << "\n";
+    }
+    if (csv_async.is_open() && !csv_async.close(log_err)) {
+        std::cerr << "CSV close failed: " << log_err << "\n";
+    }
+    if (async_out != nullptr) {
+        print_writer_stats(std::cerr, *async_out,
+                           cfg.binary ? log_out.rows_dropped() : csv_rows_dropped);
     }
 
-    std::cout << "Stopped, frames_total=" << frames_total << "\n";
+    std::cout << "Stopped, frames_total=" << frames_total
+              << " reports_total=" << reports_total
+              << " rows=" << resampler.rows_emitted() << "\n";
+    bno::log::stop();
     return 0;
 }
 
@@ -0,0 +1,313 @@
+#include "bno/imu_shm.hpp"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <new>
+
+namespace bno {
+
+namespace {
+
+constexpr std::size_t HEADER_SIZE = sizeof(ImuShmHeader);
+
+std::size_t round_up_pow2(std::size_t n)
+{
+    std::size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+std::string shm_error(const char* what, const std::string& name)
+{
+    return std::string("imu_shm: ") + what + " " + name + ": " + std::strerror(errno);
+}
+
+// Bez FUTEX_PRIVATE_FLAG – słowo jest współdzielone między procesami
+long futex(const std::atomic<std::uint32_t>* addr, int op, std::uint32_t val, const timespec* timeout)
+{
+    return ::syscall(SYS_futex, addr, op, val, timeout, nullptr, 0);
+}
+
+} // namespace
+
+ImuShmSample to_shm_sample(const ImuCsvRow& row, std::uint32_t flags)
+{
+    ImuShmSample s;
+    s.t  = row.t;
+    s.ax = static_cast<float>(row.ax);
+    s.ay = static_cast<float>(row.ay);
+    s.az = static_cast<float>(row.az);
+    s.gx = static_cast<float>(row.gx);
+    s.gy = static_cast<float>(row.gy);
+    s.gz = static_cast<float>(row.gz);
+    s.qw = static_cast<float>(row.qw);
+    s.qi = static_cast<float>(row.qi);
+    s.qj = static_cast<float>(row.qj);
+    s.qk = static_cast<float>(row.qk);
+    s.flags = flags;
+    return s;
+}
+
+ImuCsvRow from_shm_sample(const ImuShmSample& s)
+{
+    ImuCsvRow row;
+    row.t  = s.t;
+    row.ax = static_cast<double>(s.ax);
+    row.ay = static_cast<double>(s.ay);
+    row.az = static_cast<double>(s.az);
+    row.gx = static_cast<double>(s.gx);
+    row.gy = static_cast<double>(s.gy);
+    row.gz = static_cast<double>(s.gz);
+    row.qw = static_cast<double>(s.qw);
+    row.qi = static_cast<double>(s.qi);
+    row.qj = static_cast<double>(s.qj);
+    row.qk = static_cast<double>(s.qk);
+    return row;
+}
+
+// ---------------------------------------------------------------------------
+// ImuShmWriter
+// ---------------------------------------------------------------------------
+
+ImuShmWriter::~ImuShmWriter()
+{
+    close();
+}
+
+bool ImuShmWriter::open(const std::string& name, std::size_t capacity, double rate_hz, std::string& err)
+{
+    close();
+
+    const std::size_t cap = round_up_pow2(capacity < 2 ? 2 : capacity);
+    const std::size_t size = HEADER_SIZE + cap * sizeof(ImuShmSlot);
+
+    // Nowy segment zamiast czyszczenia starego: czytelnik, który ma stary
+    // zmapowany, nie zobaczy nagle write_seq cofniętego do zera.
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        err = shm_error("shm_open", name);
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        err = shm_error("ftruncate", name);
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        err = shm_error("mmap", name);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate wyzerował segment; placement new formalnie tworzy atomiki
+    auto* base = static_cast<unsigned char*>(p);
+    hdr_ = new (base) ImuShmHeader{};
+    std::memcpy(hdr_->magic, IMU_SHM_MAGIC, sizeof(IMU_SHM_MAGIC));
+    hdr_->version = IMU_SHM_VERSION;
+    hdr_->slot_size = static_cast<std::uint32_t>(sizeof(ImuShmSlot));
+    hdr_->capacity = static_cast<std::uint32_t>(cap);
+    hdr_->header_size = static_cast<std::uint32_t>(HEADER_SIZE);
+    hdr_->rate_hz = rate_hz;
+    hdr_->writer_pid = static_cast<std::uint32_t>(::getpid());
+    slots_ = reinterpret_cast<ImuShmSlot*>(base + HEADER_SIZE);
+    for (std::size_t i = 0; i < cap; ++i) {
+        new (&slots_[i]) ImuShmSlot{};
+    }
+
+    name_ = name;
+    map_size_ = size;
+    mask_ = cap - 1;
+    next_ = 0;
+    dirty_ = false;
+    return true;
+}
+
+void ImuShmWriter::close()
+{
+    if (hdr_ == nullptr) {
+        return;
+    }
+    notify();
+    ::munmap(hdr_, map_size_);
+    ::shm_unlink(name_.c_str());
+    hdr_ = nullptr;
+    slots_ = nullptr;
+    name_.clear();
+}
+
+void ImuShmWriter::publish(const ImuShmSample& s)
+{
+    const std::uint64_t n = next_++;
+    ImuShmSlot& slot = slots_[n & mask_];
+
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.sample, &s, sizeof(s));
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+
+    hdr_->write_seq.store(next_, std::memory_order_release);
+    dirty_ = true;
+}
+
+void ImuShmWriter::notify()
+{
+    if (!dirty_) {
+        return;
+    }
+    dirty_ = false;
+    hdr_->notify.fetch_add(1, std::memory_order_release);
+    futex(&hdr_->notify, FUTEX_WAKE, INT32_MAX, nullptr);
+}
+
+// ---------------------------------------------------------------------------
+// ImuShmReader
+// ---------------------------------------------------------------------------
+
+ImuShmReader::~ImuShmReader()
+{
+    close();
+}
+
+bool ImuShmReader::open(const std::string& name, std::string& err)
+{
+    close();
+
+    const int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        err = shm_error("shm_open", name);
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < HEADER_SIZE) {
+        err = "imu_shm: " + name + " is not an IMU sample ring";
+        ::close(fd);
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        err = shm_error("mmap", name);
+        return false;
+    }
+
+    const auto* hdr = static_cast<const ImuShmHeader*>(p);
+    const std::size_t cap = hdr->capacity;
+    if (std::memcmp(hdr->magic, IMU_SHM_MAGIC, sizeof(IMU_SHM_MAGIC)) != 0 ||
+        hdr->version != IMU_SHM_VERSION ||
+        hdr->slot_size != sizeof(ImuShmSlot) ||
+        hdr->header_size != HEADER_SIZE ||
+        cap == 0 || (cap & (cap - 1)) != 0 ||
+        size < HEADER_SIZE + cap * sizeof(ImuShmSlot)) {
+        err = "imu_shm: " + name + ": bad header or version";
+        ::munmap(p, size);
+        return false;
+    }
+
+    hdr_ = hdr;
+    slots_ = reinterpret_cast<const ImuShmSlot*>(static_cast<const unsigned char*>(p) + HEADER_SIZE);
+    map_size_ = size;
+    mask_ = cap - 1;
+    return true;
+}
+
+void ImuShmReader::close()
+{
+    if (hdr_ != nullptr) {
+        ::munmap(const_cast<ImuShmHeader*>(hdr_), map_size_);
+        hdr_ = nullptr;
+        slots_ = nullptr;
+    }
+}
+
+bool ImuShmReader::read(std::uint64_t n, ImuShmSample& out) const
+{
+    const ImuShmSlot& slot = slots_[n & mask_];
+    const std::uint64_t expected = 2 * n + 2;
+
+    if (slot.seq.load(std::memory_order_acquire) != expected) {
+        return false;   // jeszcze nie ma albo już nadpisana
+    }
+    std::memcpy(&out, &slot.sample, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == expected;
+}
+
+std::size_t ImuShmReader::latest(std::size_t max, ImuShmSample* out, std::uint64_t& first_seq) const
+{
+    const std::uint64_t end = write_seq();
+    // slot najstarszej może być właśnie nadpisywany – zostawiamy jeden zapasu
+    const std::uint64_t avail = end > mask_ ? mask_ : end;
+    std::uint64_t begin = end - std::min<std::uint64_t>(avail, max);
+
+    std::size_t count = 0;
+    for (std::uint64_t n = begin; n < end; ++n) {
+        if (!read(n, out[count])) {
+            // pisarz nas wyprzedził – zaczynamy od następnej
+            count = 0;
+            begin = n + 1;
+            continue;
+        }
+        ++count;
+    }
+    first_seq = begin;
+    return count;
+}
+
+bool ImuShmReader::wait(std::uint64_t seq, int timeout_ms) const
+{
+    timespec deadline{};
+    ::clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += static_cast<long>(timeout_ms % 1000) * 1'000'000L;
+    if (deadline.tv_nsec >= 1'000'000'000L) {
+        ++deadline.tv_sec;
+        deadline.tv_nsec -= 1'000'000'000L;
+    }
+
+    for (;;) {
+        const std::uint32_t word = hdr_->notify.load(std::memory_order_acquire);
+        if (write_seq() > seq) {
+            return true;
+        }
+
+        timespec now{};
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        timespec rel{deadline.tv_sec - now.tv_sec, deadline.tv_nsec - now.tv_nsec};
+        if (rel.tv_nsec < 0) {
+            --rel.tv_sec;
+            rel.tv_nsec += 1'000'000'000L;
+        }
+        if (rel.tv_sec < 0) {
+            return false;
+        }
+        // FUTEX_WAIT na mapowaniu tylko do odczytu działa – futex tylko czyta słowo
+        if (futex(&hdr_->notify, FUTEX_WAIT, word, &rel) != 0 && errno == ETIMEDOUT) {
+            return write_seq() > seq;
+        }
+    }
+}
+
+bool ImuShmReader::writer_alive() const
+{
+    const auto pid = static_cast<pid_t>(hdr_->writer_pid);
+    return pid > 0 && (::kill(pid, 0) == 0 || errno == EPERM);
+}
+
+} // namespace bno
@@ -0,0 +1,128 @@
+// imu_shm_cat – czytelnik pierścienia próbek imu_daemon --shm.
+//
+//   imu_shm_cat --last 200          # 200 najnowszych próbek jako CSV
+//   imu_shm_cat --follow            # nowe próbki na bieżąco (futex, bez odpytywania)
+
+#include "bno/imu_shm.hpp"
+#include "bno/row_format.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct CliConfig {
+    std::string name = bno::IMU_SHM_DEFAULT_NAME;
+    std::size_t last = 0;
+    bool follow = false;
+    bool header = true;
+};
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void signal_handler(int)
+{
+    g_stop = 1;
+}
+
+void print_usage(const char* argv0)
+{
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+              << "  --shm <name>     Ring name (default /imu_samples)\n"
+              << "  --last <n>       Print the newest n samples (default: all in the ring)\n"
+              << "  --follow         Keep printing new samples until Ctrl+C\n"
+              << "  --no-header      Do not print CSV header\n";
+}
+
+bool parse_args(int argc, char** argv, CliConfig& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--shm" && i + 1 < argc) {
+            cfg.name = argv[++i];
+        } else if (arg == "--last" && i + 1 < argc) {
+            cfg.last = static_cast<std::size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--follow") {
+            cfg.follow = true;
+        } else if (arg == "--no-header") {
+            cfg.header = false;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            std::cerr << "Unknown arg: " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CliConfig cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        return 1;
+    }
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    bno::ImuShmReader reader;
+    std::string err;
+    if (!reader.open(cfg.name, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    bno::RowFormatter text(16 * 1024);
+    if (cfg.header) {
+        text.put(bno::IMU_CSV_HEADER);
+        text.put('\n');
+    }
+
+    const std::size_t n_last = cfg.last > 0 ? std::min(cfg.last, reader.capacity()) : reader.capacity();
+    std::vector<bno::ImuShmSample> buf(n_last);
+    std::uint64_t first = 0;
+    const std::size_t n = reader.latest(n_last, buf.data(), first);
+    for (std::size_t i = 0; i < n; ++i) {
+        text.put_imu_row(bno::from_shm_sample(buf[i]));
+    }
+    text.write_to(stdout);
+
+    std::uint64_t next = first + n;
+    std::uint64_t lost = 0;
+    while (cfg.follow && !g_stop) {
+        if (!reader.wait(next, 500)) {
+            if (!reader.writer_alive()) {
+                std::cerr << "imu_shm_cat: writer is gone\n";
+                break;
+            }
+            continue;
+        }
+        const std::uint64_t end = reader.write_seq();
+        for (; next < end; ++next) {
+            bno::ImuShmSample s;
+            if (!reader.read(next, s)) {
+                ++lost;   // nadpisana, zanim zdążyliśmy
+                continue;
+            }
+            text.put_imu_row(bno::from_shm_sample(s));
+        }
+        if (!text.write_to(stdout)) {
+            break;
+        }
+    }
+
+    if (lost > 0) {
+        std::cerr << "imu_shm_cat: lost " << lost << " overwritten samples\n";
+    }
+    return 0;
+}
@@ -0,0 +1,392 @@
+// Obciążenie ścieżki odczytu setkami symulowanych BNO08x w jednym procesie.
+//
+//   imu_sim_stress sim/stress.sim
+//   imu_sim_stress --threads 8 --duration 60 --speed 1 sim/stress.sim
+//
+// Każde urządzenie to ShtpSimTransport + własny GesturePipeline, jak jeden
+// imu_dir: Set Feature na starcie i po każdym resecie, read_frame(),
+// parse_sh2_input_reports(), próbka do detektora na raport akcelerometru.
+// Urządzenia są rozdzielone po równo (round-robin) na wątki akwizycji; każdy
+// wątek obsługuje swoje po kolei, jedna ramka na urządzenie na obrót.
+//
+// speed 0: czas wirtualny, bez czekania – sufit przepustowości parsera
+// i detektora (urządzeń·s danych na sekundę zegara).
+// speed > 0: ramki przychodzą w tempie zegara; sensor->read to spóźnienie
+// wątku względem chwili, w której raport był gotowy – ogon przy N urządzeniach.
+//
+// Na końcu: liczniki, przepustowość i histogramy LatencyTrace ze wszystkich
+// wątków. Wynik (poza czasami) jest deterministyczny dla scenariusza i --seed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bno/gesture_pipeline.hpp"
+#include "bno/latency_trace.hpp"
+#include "bno/sh2_enable.hpp"
+#include "bno/sh2_reports.hpp"
+#include "bno/shtp_sim.hpp"
+
+namespace {
+
+struct CliConfig {
+    std::string scenario_path;
+    unsigned threads = 0;        // 0 = jak w scenariuszu
+    double duration_s = 0.0;     // 0 = jak w scenariuszu
+    double speed = -1.0;         // < 0 = jak w scenariuszu
+    std::uint64_t seed = 0;      // 0 = jak w scenariuszu
+    bool print = false;          // --print: linie gestów na stdout z numerem urządzenia
+};
+
+void print_usage(const char* argv0)
+{
+    std::cerr
+        << "Usage: " << argv0 << " [options] <scenario.sim>\n"
+        << "Options:\n"
+        << "  --threads <n>      Acquisition threads (default: scenario, else 1)\n"
+        << "  --duration <s>     Virtual seconds per device (default: scenario)\n"
+        << "  --speed <x>        0 = as fast as possible, 1 = real time (default: scenario)\n"
+        << "  --seed <n>         Random seed (default: scenario)\n"
+        << "  --print            Print gesture lines prefixed with the device number\n"
+        << "  -h, --help         Show this help\n"
+        << "Scenario format: see bno/shtp_sim.hpp (SimScenario).\n";
+}
+
+bool parse_args(int argc, char** argv, CliConfig& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            cfg.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--duration" && i + 1 < argc) {
+            cfg.duration_s = std::atof(argv[++i]);
+        } else if (arg == "--speed" && i + 1 < argc) {
+            cfg.speed = std::atof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            cfg.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--print") {
+            cfg.print = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        } else if (cfg.scenario_path.empty()) {
+            cfg.scenario_path = arg;
+        } else {
+            std::cerr << "Only one scenario file expected\n";
+            return false;
+        }
+    }
+    if (cfg.scenario_path.empty()) {
+        print_usage(argv[0]);
+        return false;
+    }
+    if (cfg.duration_s < 0.0) {
+        std::cerr << "duration must be > 0\n";
+        return false;
+    }
+    return true;
+}
+
+// Czas odczytu jednej ramki przy speed 0 (okno czasu wirtualnego): tyle
+// urządzenie może "poczekać" na następną ramkę, zanim zgłosi timeout.
+constexpr int SIM_TIMEOUT_MS = 20;
+
+// Urządzenie bez ramki z raportami przez ostatnie tyle sekund przebiegu
+// liczymy w podsumowaniu jako milczące (np. po zgubionym "reset complete").
+constexpr double SILENT_TAIL_S = 1.0;
+
+struct Device {
+    std::size_t index;
+    bno::ShtpSimTransport sim;
+    bno::GesturePipeline pipeline;
+    bool need_enable = true;
+    bool have_quat = false;
+    bool done = false;
+    std::uint64_t resets_seen{0};   // porównywane z sim.stats().resets – zgubione "reset complete"
+    double last_report_t{-1.0};     // czas wirtualny ostatniej ramki z raportami
+    bno::Vec3 last_accel{};
+    bno::Vec3 last_gyro{};
+    bno::Quat last_quat{};
+
+    Device(std::size_t i, const bno::SimDeviceConfig& cfg, std::uint64_t seed, double speed)
+        : index(i), sim(cfg, seed, speed), pipeline(bno::GesturePipeline::Config{})
+    {}
+};
+
+struct WorkerStats {
+    std::uint64_t frames{0};
+    std::uint64_t events{0};
+    std::uint64_t samples{0};
+    std::uint64_t detected{0};
+    std::uint64_t timeouts{0};
+    std::uint64_t read_errors{0};
+    std::uint64_t resets_seen{0};
+    std::uint64_t wake_events{0};
+    bno::LatencyTrace latency;
+};
+
+void enable_reports(Device& dev)
+{
+    const auto& c = dev.sim.config();
+    bno::ShtpError err;
+    if (c.accel_hz > 0) {
+        bno::enable_sensor_report(dev.sim, bno::Sh2SensorId::LinearAcceleration, c.accel_hz, err);
+    }
+    if (c.gyro_hz > 0) {
+        bno::enable_sensor_report(dev.sim, bno::Sh2SensorId::GyroscopeCalibrated, c.gyro_hz, err);
+    }
+    if (c.grv_hz > 0) {
+        bno::enable_sensor_report(dev.sim, bno::Sh2SensorId::GameRotationVector, c.grv_hz, err);
+    }
+    dev.need_enable = false;
+    dev.have_quat = false;
+}
+
+void run_worker(std::vector<std::unique_ptr<Device>>& devices, std::size_t first, std::size_t step,
+                double duration_s, double speed, bool print,
+                std::chrono::steady_clock::time_point t_start, WorkerStats& ws)
+{
+    using clock = std::chrono::steady_clock;
+    auto now_s = [&] {
+        return std::chrono::duration<double>(clock::now() - t_start).count();
+    };
+
+    bno::Sh2SensorEvent events[16];
+    bno::LatencyTrace::SampleStamps stamps;
+    const int timeout_ms = speed > 0.0 ? 0 : SIM_TIMEOUT_MS;
+    std::size_t active = 0;
+    for (std::size_t i = first; i < devices.size(); i += step) {
+        ++active;
+    }
+
+    while (active > 0) {
+        bool any_frame = false;
+        for (std::size_t i = first; i < devices.size(); i += step) {
+            Device& dev = *devices[i];
+            if (dev.done) {
+                continue;
+            }
+            if (dev.need_enable) {
+                enable_reports(dev);
+            }
+
+            bno::ShtpError err;
+            auto frame_opt = dev.sim.read_frame(err, timeout_ms);
+            const double t_rx = now_s();
+            if (dev.sim.now() >= duration_s) {
+                dev.done = true;
+                --active;
+            }
+            if (!frame_opt) {
+                ++(err ? ws.read_errors : ws.timeouts);
+                continue;
+            }
+            any_frame = true;
+            ++ws.frames;
+
+            const auto& frame = *frame_opt;
+            const auto ch = frame.header.channel;
+            if (ch == static_cast<std::uint8_t>(bno::ShtpChannel::Executable)) {
+                if (!frame.payload.empty() && frame.payload[0] == 0x01) {
+                    ++ws.resets_seen;
+                    ++dev.resets_seen;
+                    dev.need_enable = true;   // po resecie raporty są wyłączone
+                }
+                continue;
+            }
+            if (ch < 2 || ch > 5) {
+                continue;
+            }
+
+            dev.last_report_t = dev.sim.frame_time();
+            const std::size_t n = bno::parse_sh2_input_reports(
+                frame.payload.data(), frame.payload.size(), events, std::size(events));
+            stamps.read = t_rx;
+            stamps.parse = now_s();
+            ws.latency.record(bno::LatencyTrace::ReadToParse, stamps.parse - t_rx);
+
+            const double t_base = dev.sim.frame_time();
+            for (std::size_t k = 0; k < n; ++k) {
+                ++ws.events;
+                const auto& evt = events[k];
+                const double t_evt = t_base + evt.host_offset_us * 1e-6;
+                if (evt.tap_flags.has_value() || evt.significant_motion) {
+                    ++ws.wake_events;
+                }
+                if (evt.gyro.has_value()) {
+                    dev.last_gyro = bno::Vec3{evt.gyro->x, evt.gyro->y, evt.gyro->z};
+                }
+                if (evt.game_quat.has_value()) {
+                    dev.have_quat = true;
+                    dev.last_quat = bno::Quat{evt.game_quat->real, evt.game_quat->i,
+                                              evt.game_quat->j, evt.game_quat->k};
+                }
+                if (!evt.accel.has_value()) {
+                    continue;
+                }
+                dev.last_accel = bno::Vec3{evt.accel->x, evt.accel->y, evt.accel->z};
+                if (!dev.have_quat) {
+                    continue;
+                }
+
+                stamps.ingest = now_s();
+                if (speed > 0.0) {
+                    // chwila, w której raport był gotowy, na zegarze ściennym
+                    stamps.sensor = t_evt / speed;
+                    ws.latency.record(bno::LatencyTrace::SensorToRead, stamps.read - stamps.sensor);
+                } else {
+                    stamps.sensor = stamps.read;
+                }
+                ws.latency.record(bno::LatencyTrace::ParseToIngest, stamps.ingest - stamps.parse);
+                dev.pipeline.add_sample(t_evt, dev.last_accel, dev.last_gyro, dev.last_quat,
+                                        [&](std::string_view line) {
+                    ++ws.detected;
+                    const double t_emit = now_s();
+                    if (speed > 0.0) {
+                        ws.latency.record_emit(stamps, dev.pipeline.last_event_t() / speed, t_emit);
+                    } else {
+                        // czas wirtualny nie ma odpowiednika na zegarze – tylko etap hosta
+                        ws.latency.record(bno::LatencyTrace::IngestToEmit, t_emit - stamps.ingest);
+                    }
+                    if (print) {
+                        std::printf("%zu %.*s", dev.index, static_cast<int>(line.size()), line.data());
+                    }
+                });
+                ws.latency.record(bno::LatencyTrace::Detector, now_s() - stamps.ingest);
+                ++ws.samples;
+            }
+        }
+        if (speed > 0.0 && !any_frame) {
+            // nic nie było gotowe – krótka pauza zamiast kręcenia się
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CliConfig cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        return 1;
+    }
+
+    bno::SimScenario sc;
+    std::string err;
+    if (!bno::load_sim_scenario(cfg.scenario_path, sc, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+    if (cfg.threads > 0) sc.threads = cfg.threads;
+    if (cfg.duration_s > 0.0) sc.duration_s = cfg.duration_s;
+    if (cfg.speed >= 0.0) sc.speed = cfg.speed;
+    if (cfg.seed > 0) sc.seed = cfg.seed;
+
+    const std::size_t n_dev = sc.device_count();
+    const std::size_t n_threads = std::min<std::size_t>(std::max(1u, sc.threads), n_dev);
+
+    std::vector<std::unique_ptr<Device>> devices;
+    devices.reserve(n_dev);
+    for (std::size_t i = 0; i < n_dev; ++i) {
+        // ziarno urządzenia z ziarna scenariusza i numeru – niezależne od --threads
+        std::seed_seq ss{sc.seed, static_cast<std::uint64_t>(i)};
+        std::uint64_t s[2];
+        ss.generate(std::begin(s), std::end(s));
+        devices.push_back(std::make_unique<Device>(i, sc.device(i), (s[0] << 32) ^ s[1], sc.speed));
+    }
+
+    std::cerr << "imu_sim_stress: " << n_dev << " devices, " << n_threads << " threads, "
+              << sc.duration_s << " s virtual each, speed=" << sc.speed << ", seed=" << sc.seed << "\n";
+
+    std::vector<WorkerStats> stats(n_threads);
+    const auto t0 = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t k = 0; k < n_threads; ++k) {
+            workers.emplace_back([&, k] {
+                run_worker(devices, k, n_threads, sc.duration_s, sc.speed, cfg.print, t0, stats[k]);
+            });
+        }
+    }
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    WorkerStats total;
+    for (const auto& ws : stats) {
+        total.frames += ws.frames;
+        total.events += ws.events;
+        total.samples += ws.samples;
+        total.detected += ws.detected;
+        total.timeouts += ws.timeouts;
+        total.read_errors += ws.read_errors;
+        total.resets_seen += ws.resets_seen;
+        total.wake_events += ws.wake_events;
+        total.latency.merge(ws.latency);
+    }
+    // Zgubiona ramka "reset complete" = raporty wyłączone, a host o tym nie
+    // wie; urządzenie milczy do następnego resetu (albo do końca przebiegu).
+    bno::ShtpSimTransport::Stats sim{};
+    std::uint64_t resets_missed = 0;
+    std::size_t devices_missed_reset = 0;
+    std::size_t devices_silent_at_end = 0;
+    for (const auto& dev : devices) {
+        const auto& s = dev->sim.stats();
+        if (s.resets > dev->resets_seen) {
+            resets_missed += s.resets - dev->resets_seen;
+            ++devices_missed_reset;
+        }
+        if (dev->last_report_t < sc.duration_s - SILENT_TAIL_S) {
+            ++devices_silent_at_end;
+        }
+        sim.reports += s.reports;
+        sim.corrupted += s.corrupted;
+        sim.truncated += s.truncated;
+        sim.dropped += s.dropped;
+        sim.io_errors += s.io_errors;
+        sim.resets += s.resets;
+        sim.gestures += s.gestures;
+    }
+
+    const double virt_s = sc.duration_s * static_cast<double>(n_dev);
+    const double w = std::max(wall_s, 1e-9);
+    std::fprintf(stderr,
+                 "wall %.3f s, virtual %.1f device-s (x%.1f real time)\n"
+                 "frames %llu (%.0f/s), reports sent %llu, events parsed %llu (%.0f/s), samples %llu (%.0f/s)\n"
+                 "faults: corrupted %llu, truncated %llu, dropped %llu, io_errors %llu, resets %llu\n"
+                 "host: timeouts %llu, read_errors %llu, resets_seen %llu, wake_events %llu\n"
+                 "resets missed %llu on %zu devices, silent for the last %.0f s: %zu devices\n"
+                 "gestures: injected %llu, detector lines %llu\n",
+                 wall_s, virt_s, virt_s / w,
+                 static_cast<unsigned long long>(total.frames), static_cast<double>(total.frames) / w,
+                 static_cast<unsigned long long>(sim.reports),
+                 static_cast<unsigned long long>(total.events), static_cast<double>(total.events) / w,
+                 static_cast<unsigned long long>(total.samples), static_cast<double>(total.samples) / w,
+                 static_cast<unsigned long long>(sim.corrupted),
+                 static_cast<unsigned long long>(sim.truncated),
+                 static_cast<unsigned long long>(sim.dropped),
+                 static_cast<unsigned long long>(sim.io_errors),
+                 static_cast<unsigned long long>(sim.resets),
+                 static_cast<unsigned long long>(total.timeouts),
+                 static_cast<unsigned long long>(total.read_errors),
+                 static_cast<unsigned long long>(total.resets_seen),
+                 static_cast<unsigned long long>(total.wake_events),
+                 static_cast<unsigned long long>(resets_missed), devices_missed_reset,
+                 SILENT_TAIL_S, devices_silent_at_end,
+                 static_cast<unsigned long long>(sim.gestures),
+                 static_cast<unsigned long long>(total.detected));
+    total.latency.dump(stderr, "[latency]");
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include "bno/shtp.hpp"
 #include "bno/sh2_reports.hpp"
+#include "bno/row_format.hpp"
 
 #include <csignal>
 #include <cstdlib>
@@ -80,6 +81,7 @@ int main(int argc, char** argv) {
 
     // TODO: enable reports dla Activity/Steps/Stability.
 
+    bno::RowFormatter out(1024);
     std::size_t count = 0;
     while (!g_stop) {
         auto frame_opt = transport.read_frame(err, 50);
@@ -91,22 +93,25 @@ int main(int argc, char** argv) {
         // Na razie placeholder żeby pokazać strukturę NDJSON.
 
         if (cfg.json) {
-            std::cout
-                << "{\"t\":" << count
-                << ",\"activity_label\":null"
-                << ",\"activity_conf\":null"
-                << ",\"steps_total\":null"
-                << ",\"step_event\":null"
-                << ",\"stability_state\":null"
-                << ",\"calib_state\":null"
-                << ",\"notes\":\"placeholder\""
-                << "}\n";
+            out.put("{\"t\":");
+            out.put_uint(count);
+            out.put(",\"activity_label\":null"
+                    ",\"activity_conf\":null"
+                    ",\"steps_total\":null"
+                    ",\"step_event\":null"
+                    ",\"stability_state\":null"
+                    ",\"calib_state\":null"
+                    ",\"notes\":\"placeholder\""
+                    "}\n");
         } else {
-            std::cout << "[t=" << count << "] activity=?, steps=?, stability=?, calib=?\n";
+            out.put("[t=");
+            out.put_uint(count);
+            out.put("] activity=?, steps=?, stability=?, calib=?\n");
         }
+        out.write_to(stdout);
 
         ++count;
-        if (cfg.duration_s > 0 && static_cast<int>(count / cfg.hz) >= cfg.duration_s) {
+        if (cfg.duration_s > 0 && static_cast<int>(count / static_cast<std::size_t>(cfg.hz)) >= cfg.duration_s) {
             break;
         }
     }
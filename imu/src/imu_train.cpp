@@ -0,0 +1,308 @@
+// Uczenie klasyfikatora gestów (las losowy, cv::ml::RTrees) na nagraniach.
+//
+//   imu_train --model gestures.yml data/*.csv
+//   imu_train --features feats.csv data/*.csv          # same cechy (bez OpenCV też)
+//   imu_train --model m.yml SWIPE=rec1.csv rec2.csv    # etykieta jawnie
+//
+// Okna wycina ten sam detektor co w imu_dir (GesturePipeline::detector_config),
+// a cechy liczy WindowFeatureExtractor – uczenie i imu_dir --model widzą
+// dokładnie to samo. Etykieta pliku to litery z początku nazwy:
+// left3.csv → LEFT. Każde okno wykryte w pliku dostaje jego etykietę.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bno/gesture_classifier.hpp"
+#include "bno/gesture_features.hpp"
+#include "bno/gesture_pipeline.hpp"
+#include "bno/imu_log.hpp"
+#include "bno/row_format.hpp"
+
+namespace {
+
+struct CliConfig {
+    std::vector<std::pair<std::string, std::string>> inputs;   // (label, path)
+    std::string model_path;
+    std::string features_path;
+    bno::GestureClassifier::TrainConfig train;
+    int folds = 5;              // walidacja krzyżowa po plikach; 0 = bez
+    bool segmented = false;     // okna z trybu Segmented (tylko wyniki końcowe)
+    double min_interval_s = 0.5;
+};
+
+struct Window {
+    bno::GestureFeatureVector x;
+    std::string label;
+    std::size_t file;
+};
+
+void print_usage(const char* argv0)
+{
+    std::cerr
+        << "Usage: " << argv0 << " [options] <[LABEL=]recording.csv|.imlog>...\n"
+        << "Options:\n"
+        << "  --model <path>     Train and save the model (cv::FileStorage, .yml/.xml[.gz])\n"
+        << "  --features <path>  Write per-window features as CSV\n"
+        << "  --trees <n>        Number of trees (default 100)\n"
+        << "  --depth <n>        Max tree depth (default 8)\n"
+        << "  --folds <k>        Cross-validation folds over files (default 5, 0 = off)\n"
+        << "  --segmented        Cut windows with the segmented detector (as imu_dir --segmented)\n"
+        << "  --min-interval <s> Min gap between gestures (default 0.5, as imu_dir)\n"
+        << "  -h, --help         Show this help\n"
+        << "Label defaults to the leading letters of the file name: left3.csv -> LEFT.\n";
+}
+
+bool parse_args(int argc, char** argv, CliConfig& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--model" && i + 1 < argc) {
+            cfg.model_path = argv[++i];
+        } else if (arg == "--features" && i + 1 < argc) {
+            cfg.features_path = argv[++i];
+        } else if (arg == "--trees" && i + 1 < argc) {
+            cfg.train.trees = std::atoi(argv[++i]);
+        } else if (arg == "--depth" && i + 1 < argc) {
+            cfg.train.max_depth = std::atoi(argv[++i]);
+        } else if (arg == "--folds" && i + 1 < argc) {
+            cfg.folds = std::atoi(argv[++i]);
+        } else if (arg == "--segmented") {
+            cfg.segmented = true;
+        } else if (arg == "--min-interval" && i + 1 < argc) {
+            cfg.min_interval_s = std::atof(argv[++i]);
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        } else {
+            const auto eq = arg.find('=');
+            if (eq != std::string::npos) {
+                cfg.inputs.emplace_back(arg.substr(0, eq), arg.substr(eq + 1));
+            } else {
+                cfg.inputs.emplace_back(bno::recording_label(arg), arg);
+            }
+            if (cfg.inputs.back().first.empty()) {
+                std::cerr << "No label for " << arg << " (use LABEL=path)\n";
+                return false;
+            }
+        }
+    }
+    if (cfg.inputs.empty() || (cfg.model_path.empty() && cfg.features_path.empty())) {
+        print_usage(argv[0]);
+        return false;
+    }
+    if (cfg.train.trees < 1 || cfg.train.max_depth < 1 || cfg.folds < 0 || cfg.folds == 1) {
+        std::cerr << "trees/depth must be >= 1, folds 0 or >= 2\n";
+        return false;
+    }
+    return true;
+}
+
+// Okna jednego nagrania: detektor jak w imu_dir, cechy z tego samego okna
+void collect_windows(const CliConfig& cfg, const std::vector<bno::ImuCsvRow>& rows,
+                     const std::string& label, std::size_t file, std::vector<Window>& out)
+{
+    bno::GesturePipeline::Config gp_cfg;
+    gp_cfg.segmented = cfg.segmented;
+    gp_cfg.min_interval_s = cfg.min_interval_s;
+    bno::GestureDirectionDetector detector(bno::GesturePipeline::detector_config(gp_cfg));
+    bno::WindowFeatureExtractor window;
+
+    for (const auto& r : rows) {
+        const bno::Vec3 a{r.ax, r.ay, r.az};
+        const bno::Vec3 g{r.gx, r.gy, r.gz};
+        const bno::Quat q{r.qw, r.qi, r.qj, r.qk};
+        detector.add_sample(r.t, a, g, q);
+        window.add_sample(r.t, a, g, q);
+        if (auto res = detector.poll_result()) {
+            if (res->provisional) {
+                continue;
+            }
+            Window w{{}, label, file};
+            if (window.extract(res->t_start, res->t_start + res->duration,
+                               detector.baseline_world(), w.x)) {
+                out.push_back(std::move(w));
+            }
+        }
+    }
+}
+
+bool write_features(const std::string& path, const std::vector<Window>& windows,
+                    const CliConfig& cfg)
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        std::cerr << "cannot open " << path << "\n";
+        return false;
+    }
+    bno::RowFormatter line(4096);
+    line.put("label,file");
+    for (std::size_t k = 0; k < bno::FEATURE_COUNT; ++k) {
+        line.put(',');
+        line.put(bno::gesture_feature_name(k));
+    }
+    line.put('\n');
+    for (const auto& w : windows) {
+        line.put(w.label);
+        line.put(',');
+        line.put(cfg.inputs[w.file].second);
+        for (float v : w.x) {
+            line.put_kv(",", static_cast<double>(v), 6);
+        }
+        line.put('\n');
+        if (line.size() > 3000) {
+            line.write_to(f, false);
+        }
+    }
+    const bool written = line.write_to(f, false);
+    if (std::fclose(f) != 0 || !written) {
+        std::cerr << "write failed: " << path << "\n";
+        return false;
+    }
+    std::cerr << "features: " << windows.size() << " windows -> " << path << "\n";
+    return true;
+}
+
+// k-krotna walidacja po plikach (fold = indeks pliku % k): okna z jednego
+// nagrania nigdy nie są jednocześnie w uczeniu i w teście.
+void cross_validate(const CliConfig& cfg, const std::vector<Window>& windows)
+{
+    std::size_t correct = 0;
+    std::size_t tested = 0;
+    std::map<std::string, std::pair<std::size_t, std::size_t>> per_label;   // (ok, all)
+    const auto k = static_cast<std::size_t>(cfg.folds);
+
+    for (std::size_t fold = 0; fold < k; ++fold) {
+        std::vector<bno::GestureFeatureVector> x;
+        std::vector<std::string> y;
+        for (const auto& w : windows) {
+            if (w.file % k != fold) {
+                x.push_back(w.x);
+                y.push_back(w.label);
+            }
+        }
+        bno::GestureClassifier model;
+        std::string err;
+        if (!model.train(x, y, cfg.train, err)) {
+            std::cerr << "fold " << fold << ": " << err << "\n";
+            continue;
+        }
+        for (const auto& w : windows) {
+            if (w.file % k != fold) {
+                continue;
+            }
+            bno::GestureClassifier::Prediction p;
+            const bool ok = model.predict(w.x, p) && model.label(p.label_index) == w.label;
+            auto& pl = per_label[w.label];
+            if (ok) {
+                ++pl.first;
+                ++correct;
+            }
+            ++pl.second;
+            ++tested;
+        }
+    }
+
+    if (tested == 0) {
+        return;
+    }
+    std::cerr << "cross-validation (" << k << " folds by file): "
+              << correct << "/" << tested << " = "
+              << 100.0 * static_cast<double>(correct) / static_cast<double>(tested) << "%\n";
+    for (const auto& [label, pl] : per_label) {
+        std::cerr << "  " << label << ": " << pl.first << "/" << pl.second << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CliConfig cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        return 1;
+    }
+
+    std::vector<Window> windows;
+    std::map<std::string, std::size_t> per_label;
+    for (std::size_t i = 0; i < cfg.inputs.size(); ++i) {
+        const auto& [label, path] = cfg.inputs[i];
+        std::vector<bno::ImuCsvRow> rows;
+        std::string err;
+        if (!bno::read_imu_samples(path, rows, err) || rows.empty()) {
+            // uszkodzone / puste nagrania pomijamy, jak trening PGO
+            std::cerr << "skip " << (err.empty() ? path + ": no samples" : err) << "\n";
+            continue;
+        }
+        const std::size_t before = windows.size();
+        collect_windows(cfg, rows, label, i, windows);
+        per_label[label] += windows.size() - before;
+    }
+
+    std::cerr << "windows: " << windows.size() << " (";
+    for (auto it = per_label.begin(); it != per_label.end(); ++it) {
+        std::cerr << (it == per_label.begin() ? "" : ", ") << it->first << " " << it->second;
+    }
+    std::cerr << ")\n";
+
+    if (!cfg.features_path.empty() && !write_features(cfg.features_path, windows, cfg)) {
+        return 1;
+    }
+    if (cfg.model_path.empty()) {
+        return 0;
+    }
+    if (!bno::GestureClassifier::available()) {
+        std::cerr << "--model: imu_train was built without OpenCV (ml)\n";
+        return 1;
+    }
+
+    if (cfg.folds >= 2) {
+        cross_validate(cfg, windows);
+    }
+
+    std::vector<bno::GestureFeatureVector> x;
+    std::vector<std::string> y;
+    for (const auto& w : windows) {
+        x.push_back(w.x);
+        y.push_back(w.label);
+    }
+    bno::GestureClassifier model;
+    std::string err;
+    if (!model.train(x, y, cfg.train, err) || !model.save(cfg.model_path, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    // koszt predykcji na okno – to samo, co imu_dir --model robi po każdym gescie
+    bno::GestureClassifier loaded;
+    if (!loaded.load(cfg.model_path, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    std::size_t n = 0;
+    for (int rep = 0; rep < 10; ++rep) {
+        for (const auto& w : windows) {
+            bno::GestureClassifier::Prediction p;
+            if (loaded.predict(w.x, p)) {
+                ++n;
+            }
+        }
+    }
+    const double us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - t0).count();
+    std::cerr << "model: " << cfg.model_path << " (" << cfg.train.trees << " trees, depth "
+              << cfg.train.max_depth << "), predict "
+              << (n > 0 ? us / static_cast<double>(n) : 0.0) << " us/window\n";
+    return 0;
+}
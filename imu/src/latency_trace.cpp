@@ -0,0 +1,152 @@
+#include "bno/latency_trace.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace bno {
+
+// ---------------------------------------------------------------------------
+// LatencyHistogram
+// ---------------------------------------------------------------------------
+
+std::size_t LatencyHistogram::bucket_of(std::uint64_t v)
+{
+    constexpr std::uint64_t SUB = 1u << SUB_BITS;
+    constexpr std::uint64_t LIMIT = (std::uint64_t{1} << MAX_BITS) - 1;
+    v = std::min(v, LIMIT);
+    if (v < SUB) {
+        return static_cast<std::size_t>(v);   // oktawa 0: co 1 µs
+    }
+    const int exp = static_cast<int>(std::bit_width(v)) - 1;   // v w [2^exp, 2^(exp+1))
+    const int shift = exp - SUB_BITS;
+    const auto sub = static_cast<std::size_t>((v >> shift) - SUB);
+    return (static_cast<std::size_t>(shift + 1) << SUB_BITS) + sub;
+}
+
+std::int64_t LatencyHistogram::bucket_high(std::size_t i)
+{
+    constexpr std::size_t SUB = 1u << SUB_BITS;
+    const std::size_t octave = i >> SUB_BITS;
+    const std::size_t sub = i & (SUB - 1);
+    if (octave == 0) {
+        return static_cast<std::int64_t>(sub);
+    }
+    const std::size_t shift = octave - 1;
+    const std::uint64_t low = static_cast<std::uint64_t>(SUB + sub) << shift;
+    return static_cast<std::int64_t>(low + (std::uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record_us(std::int64_t us)
+{
+    if (us < 0) {
+        us = 0;   // zegar czujnika minimalnie „przed” hostem – traktujemy jako 0
+    }
+    ++counts_[bucket_of(static_cast<std::uint64_t>(us))];
+    if (count_ == 0 || us < min_) {
+        min_ = us;
+    }
+    max_ = std::max(max_, us);
+    sum_ += static_cast<double>(us);
+    ++count_;
+}
+
+void LatencyHistogram::record_s(double seconds)
+{
+    record_us(std::llround(seconds * 1e6));
+}
+
+double LatencyHistogram::mean_us() const
+{
+    return count_ > 0 ? sum_ / static_cast<double>(count_) : 0.0;
+}
+
+std::int64_t LatencyHistogram::percentile_us(double p) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+    const auto target = static_cast<std::uint64_t>(
+        std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(count_)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts_[i];
+        if (seen >= std::max<std::uint64_t>(target, 1)) {
+            return std::min(bucket_high(i), max_);
+        }
+    }
+    return max_;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    if (other.count_ == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    min_ = count_ > 0 ? std::min(min_, other.min_) : other.min_;
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+    count_ += other.count_;
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram{};
+}
+
+// ---------------------------------------------------------------------------
+// LatencyTrace
+// ---------------------------------------------------------------------------
+
+const char* LatencyTrace::stage_name(Stage s)
+{
+    switch (s) {
+    case SensorToRead:  return "sensor->read";
+    case ReadToParse:   return "read->parse";
+    case ParseToIngest: return "parse->ingest";
+    case Detector:      return "detector";
+    case IngestToEmit:  return "ingest->emit";
+    case SensorToEmit:  return "sensor->emit";
+    case EventToEmit:   return "event->emit";
+    case STAGE_COUNT:   break;
+    }
+    return "?";
+}
+
+void LatencyTrace::dump(std::FILE* out, const char* title) const
+{
+    std::fprintf(out, "%s (us)\n", title);
+    std::fprintf(out, "  %-14s %9s %9s %9s %9s %9s %9s\n",
+                 "stage", "n", "p50", "p90", "p99", "p99.9", "max");
+    for (std::size_t i = 0; i < STAGE_COUNT; ++i) {
+        const auto& h = hist_[i];
+        std::fprintf(out, "  %-14s %9llu %9lld %9lld %9lld %9lld %9lld\n",
+                     stage_name(static_cast<Stage>(i)),
+                     static_cast<unsigned long long>(h.count()),
+                     static_cast<long long>(h.percentile_us(0.50)),
+                     static_cast<long long>(h.percentile_us(0.90)),
+                     static_cast<long long>(h.percentile_us(0.99)),
+                     static_cast<long long>(h.percentile_us(0.999)),
+                     static_cast<long long>(h.max_us()));
+    }
+    std::fflush(out);
+}
+
+void LatencyTrace::merge(const LatencyTrace& other)
+{
+    for (std::size_t i = 0; i < STAGE_COUNT; ++i) {
+        hist_[i].merge(other.hist_[i]);
+    }
+}
+
+void LatencyTrace::reset()
+{
+    for (auto& h : hist_) {
+        h.reset();
+    }
+}
+
+} // namespace bno
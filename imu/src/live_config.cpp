@@ -0,0 +1,182 @@
+#include "bno/live_config.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+
+namespace bno {
+
+namespace {
+
+using DetConfig = GestureDirectionDetector::Config;
+
+// Progi, które można zmienić bez restartu. Bez baseline_window_s (baseline
+// już jest) i trybu (Segmented zmienia format linii wyjścia).
+struct DetectorKey {
+    const char* name;
+    double DetConfig::* field;
+    double lo;
+    double hi;
+};
+
+constexpr DetectorKey DETECTOR_KEYS[] = {
+    {"min_dyn",          &DetConfig::min_dyn_threshold,    0.0,  50.0},
+    {"min_peak",         &DetConfig::min_peak_magnitude,   0.0,  100.0},
+    {"min_interval",     &DetConfig::min_gesture_interval, 0.0,  10.0},
+    {"half_window",      &DetConfig::half_window_s,        0.05, 2.0},
+    {"min_gyro_peak",    &DetConfig::min_gyro_peak,        0.1,  50.0},
+    {"twist_angle",      &DetConfig::min_twist_angle,      0.0,  6.3},
+    {"flick_net_angle",  &DetConfig::max_flick_net_angle,  0.0,  6.3},
+    {"flick_travel",     &DetConfig::min_flick_travel,     0.0,  20.0},
+    {"circle_sweep",     &DetConfig::min_circle_sweep,     0.0,  20.0},
+    {"seg_on",           &DetConfig::seg_on_threshold,     0.0,  50.0},
+    {"seg_off",          &DetConfig::seg_off_threshold,    0.0,  50.0},
+    {"seg_off_hold",     &DetConfig::seg_off_hold_s,       0.0,  1.0},
+    {"seg_settle",       &DetConfig::seg_settle_s,         0.0,  2.0},
+    {"seg_max_duration", &DetConfig::seg_max_duration_s,   0.1,  5.0},
+};
+
+bool parse_number(std::string_view s, double& out)
+{
+    const auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc{} && p == s.data() + s.size();
+}
+
+bool set_rate(int& field, std::string_view key, double v, int max_hz,
+              const LiveConfigLimits& limits, std::string& err)
+{
+    const int hz = static_cast<int>(v);
+    if (static_cast<double>(hz) != v || (hz != 0 && (hz < limits.min_hz || hz > max_hz))) {
+        err = std::string(key) + " must be 0 or in [" + std::to_string(limits.min_hz) + "," +
+              std::to_string(max_hz) + "]";
+        return false;
+    }
+    field = hz;
+    return true;
+}
+
+} // namespace
+
+bool apply_live_config_assignments(LiveConfig& cfg,
+                                   std::string_view assignments,
+                                   const LiveConfigLimits& limits,
+                                   std::string& err)
+{
+    LiveConfig next = cfg;
+    std::size_t count = 0;
+    std::size_t pos = 0;
+    while (pos < assignments.size()) {
+        if (assignments[pos] == ' ' || assignments[pos] == '\t') {
+            ++pos;
+            continue;
+        }
+        std::size_t end = assignments.find_first_of(" \t", pos);
+        if (end == std::string_view::npos) {
+            end = assignments.size();
+        }
+        const std::string_view item = assignments.substr(pos, end - pos);
+        pos = end;
+
+        const auto eq = item.find('=');
+        double v = 0.0;
+        if (eq == std::string_view::npos || !parse_number(item.substr(eq + 1), v)) {
+            err = "expected key=number, got: " + std::string(item);
+            return false;
+        }
+        const std::string_view key = item.substr(0, eq);
+
+        if (key == "hz") {
+            if (!set_rate(next.accel_hz, key, v, limits.max_hz, limits, err)) {
+                return false;
+            }
+        } else if (key == "gyro_hz") {
+            if (!set_rate(next.gyro_hz, key, v, limits.max_gyro_hz, limits, err)) {
+                return false;
+            }
+        } else if (key == "grv_hz") {
+            if (!set_rate(next.grv_hz, key, v, limits.max_hz, limits, err)) {
+                return false;
+            }
+        } else {
+            const auto* k = std::find_if(std::begin(DETECTOR_KEYS), std::end(DETECTOR_KEYS),
+                                         [&](const DetectorKey& d) { return key == d.name; });
+            if (k == std::end(DETECTOR_KEYS)) {
+                err = "unknown key: " + std::string(key);
+                return false;
+            }
+            if (!(v >= k->lo && v <= k->hi)) {
+                char range[64];
+                std::snprintf(range, sizeof(range), " must be in [%g,%g]", k->lo, k->hi);
+                err = std::string(key) + range;
+                return false;
+            }
+            next.detector.*(k->field) = v;
+        }
+        ++count;
+    }
+
+    if (count == 0) {
+        err = "nothing to set";
+        return false;
+    }
+    if (next.detector.seg_off_threshold > next.detector.seg_on_threshold) {
+        err = "seg_off must be <= seg_on";
+        return false;
+    }
+    cfg = next;
+    return true;
+}
+
+std::string format_live_config(const LiveConfig& cfg)
+{
+    std::string out = "version=" + std::to_string(cfg.version) +
+                      " hz=" + std::to_string(cfg.accel_hz) +
+                      " gyro_hz=" + std::to_string(cfg.gyro_hz) +
+                      " grv_hz=" + std::to_string(cfg.grv_hz);
+    char buf[64];
+    for (const auto& k : DETECTOR_KEYS) {
+        std::snprintf(buf, sizeof(buf), " %s=%g", k.name, cfg.detector.*(k.field));
+        out += buf;
+    }
+    return out;
+}
+
+LiveConfigCell::LiveConfigCell(const LiveConfig& initial)
+{
+    auto first = std::make_unique<LiveConfig>(initial);
+    first->version = 0;
+    reader_last_ = first.get();   // wątek próbek startuje już z tą konfiguracją
+    current_.store(first.get(), std::memory_order_release);
+    snapshots_.push_back(std::move(first));
+}
+
+LiveConfig LiveConfigCell::copy() const
+{
+    const std::lock_guard<std::mutex> lock(writer_mutex_);
+    return *current_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LiveConfigCell::publish(LiveConfig next)
+{
+    const std::lock_guard<std::mutex> lock(writer_mutex_);
+    next.version = current_.load(std::memory_order_relaxed)->version + 1;
+    auto snap = std::make_unique<const LiveConfig>(next);
+    current_.store(snap.get(), std::memory_order_release);
+    snapshots_.push_back(std::move(snap));
+
+    // Czytelnik, który potwierdził wersję v, nie sięga już do starszych
+    const std::uint64_t seen = reader_version_.load(std::memory_order_acquire);
+    std::erase_if(snapshots_, [&](const std::unique_ptr<const LiveConfig>& s) {
+        return s->version < seen;
+    });
+    return next.version;
+}
+
+std::size_t LiveConfigCell::snapshot_count() const
+{
+    const std::lock_guard<std::mutex> lock(writer_mutex_);
+    return snapshots_.size();
+}
+
+} // namespace bno
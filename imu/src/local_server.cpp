@@ -0,0 +1,336 @@
+#include "bno/local_server.hpp"
+#include "bno/log.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace bno {
+
+namespace {
+
+constexpr std::size_t MAX_COMMAND_LINE = 256;
+
+bool send_some(int fd, const char* data, std::size_t len, std::size_t& sent)
+{
+    sent = 0;
+    while (sent < len) {
+        const ssize_t n = ::send(fd, data + sent, len - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EAGAIN – reszta poczeka na POLLOUT
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+const char* stream_topic_name(StreamTopic topic)
+{
+    switch (topic) {
+    case StreamTopic::Raw:      return "raw";
+    case StreamTopic::Gestures: return "gestures";
+    case StreamTopic::Status:   return "status";
+    }
+    return "?";
+}
+
+bool parse_stream_topic(std::string_view name, StreamTopic& topic)
+{
+    for (std::size_t i = 0; i < STREAM_TOPIC_COUNT; ++i) {
+        const auto t = static_cast<StreamTopic>(i);
+        if (name == stream_topic_name(t)) {
+            topic = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+int listen_unix_socket(const std::string& path, const char* who, std::string& err)
+{
+    sockaddr_un addr{};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        err = std::string(who) + ": bad socket path '" + path + "'";
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        err = std::string(who) + ": socket: " + std::strerror(errno);
+        return -1;
+    }
+
+    // Gniazdo po poprzednim (zabitym) procesie – usuwamy tylko, jeśli nikt nie słucha.
+    struct stat st{};
+    if (::stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const bool alive = probe >= 0 &&
+            ::connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (alive) {
+            err = std::string(who) + ": " + path + " is in use by another process";
+            ::close(fd);
+            return -1;
+        }
+        ::unlink(path.c_str());
+    }
+
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 8) != 0) {
+        err = std::string(who) + ": bind " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+LocalStreamServer::~LocalStreamServer()
+{
+    close();
+}
+
+bool LocalStreamServer::open(const std::string& path, const Config& cfg, std::string& err)
+{
+    close();
+
+    listen_fd_ = listen_unix_socket(path, "local_server", err);
+    if (listen_fd_ < 0) {
+        return false;
+    }
+
+    path_ = path;
+    cfg_ = cfg;
+    stats_ = LocalServerStats{};
+    return true;
+}
+
+void LocalStreamServer::close()
+{
+    while (!clients_.empty()) {
+        drop_client(clients_.size() - 1);
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        ::unlink(path_.c_str());
+    }
+    path_.clear();
+}
+
+void LocalStreamServer::set_greeting(StreamTopic topic, std::string line)
+{
+    greetings_[static_cast<std::size_t>(topic)] = std::move(line);
+}
+
+void LocalStreamServer::poll(int timeout_ms)
+{
+    if (listen_fd_ < 0) {
+        return;
+    }
+
+    // [0] = gniazdo nasłuchujące, [1 + i] = clients_[i]
+    pollfd fds[1 + 64];
+    const std::size_t n_clients = std::min<std::size_t>(clients_.size(), 64);
+    fds[0] = pollfd{listen_fd_, POLLIN, 0};
+    for (std::size_t i = 0; i < n_clients; ++i) {
+        const Client& c = clients_[i];
+        short events = POLLIN;
+        if (c.pending.size() > c.pending_off) {
+            events = static_cast<short>(events | POLLOUT);
+        }
+        fds[1 + i] = pollfd{c.fd, events, 0};
+    }
+
+    const int r = ::poll(fds, static_cast<nfds_t>(1 + n_clients), timeout_ms);
+    if (r <= 0) {
+        return;
+    }
+
+    // od końca – drop_client() przesuwa dalsze elementy
+    for (std::size_t i = n_clients; i-- > 0;) {
+        const short re = fds[1 + i].revents;
+        if (re == 0) {
+            continue;
+        }
+        Client& c = clients_[i];
+        bool ok = true;
+        if (re & (POLLERR | POLLNVAL)) {
+            ok = false;
+        }
+        if (ok && (re & (POLLIN | POLLHUP))) {
+            ok = read_commands(c);
+        }
+        if (ok && (re & POLLOUT)) {
+            ok = flush_pending(c);
+        }
+        if (!ok) {
+            drop_client(i);
+        }
+    }
+
+    if (fds[0].revents & POLLIN) {
+        accept_clients();
+    }
+}
+
+void LocalStreamServer::accept_clients()
+{
+    for (;;) {
+        const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;   // EAGAIN albo błąd – spróbujemy przy następnym poll()
+        }
+        if (clients_.size() >= cfg_.max_clients || clients_.size() >= 64) {
+            static constexpr char busy[] = "ERR too many clients\n";
+            std::size_t sent = 0;
+            send_some(fd, busy, sizeof(busy) - 1, sent);
+            ::close(fd);
+            ++stats_.rejected;
+            BNO_LOG_WARN("local_server: rejected client, {} already connected", clients_.size());
+            continue;
+        }
+        Client c;
+        c.fd = fd;
+        clients_.push_back(std::move(c));
+        ++stats_.accepted;
+    }
+}
+
+bool LocalStreamServer::read_commands(Client& c)
+{
+    char buf[256];
+    for (;;) {
+        const ssize_t n = ::recv(c.fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n == 0) {
+            return false;   // klient się rozłączył
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (c.subscribed) {
+            continue;       // po SUB wejście ignorujemy
+        }
+
+        c.in.append(buf, static_cast<std::size_t>(n));
+        const auto nl = c.in.find('\n');
+        if (nl == std::string::npos) {
+            if (c.in.size() > MAX_COMMAND_LINE) {
+                ++stats_.rejected;
+                return false;
+            }
+            continue;
+        }
+
+        std::string_view line(c.in.data(), nl);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        StreamTopic topic{};
+        if (line.substr(0, 4) != "SUB " || !parse_stream_topic(line.substr(4), topic)) {
+            static constexpr char bad[] = "ERR expected: SUB raw|gestures|status\n";
+            std::size_t sent = 0;
+            send_some(c.fd, bad, sizeof(bad) - 1, sent);
+            ++stats_.rejected;
+            return false;
+        }
+
+        c.subscribed = true;
+        c.topic = topic;
+        BNO_LOG_INFO("local_server: fd {} subscribed to {}", c.fd, stream_topic_name(topic));
+        c.in.clear();
+        ++subscribers_[static_cast<std::size_t>(topic)];
+        const std::string& greeting = greetings_[static_cast<std::size_t>(topic)];
+        if (!greeting.empty()) {
+            enqueue(c, greeting);
+        }
+    }
+}
+
+bool LocalStreamServer::flush_pending(Client& c)
+{
+    const std::size_t left = c.pending.size() - c.pending_off;
+    if (left == 0) {
+        return true;
+    }
+    std::size_t sent = 0;
+    if (!send_some(c.fd, c.pending.data() + c.pending_off, left, sent)) {
+        return false;
+    }
+    c.pending_off += sent;
+    if (c.pending_off == c.pending.size()) {
+        c.pending.clear();
+        c.pending_off = 0;
+    } else if (c.pending_off > c.pending.size() / 2) {
+        c.pending.erase(0, c.pending_off);
+        c.pending_off = 0;
+    }
+    return true;
+}
+
+void LocalStreamServer::enqueue(Client& c, std::string_view data)
+{
+    const std::size_t queued = c.pending.size() - c.pending_off;
+    if (queued + data.size() > cfg_.max_pending_bytes) {
+        // cała linia albo nic – strumień u klienta zostaje w liniach
+        ++c.dropped;
+        ++stats_.lines_dropped;
+        return;
+    }
+
+    if (queued == 0) {
+        // typowy przypadek: nic nie czeka, wysyłamy od razu
+        std::size_t sent = 0;
+        if (send_some(c.fd, data.data(), data.size(), sent) && sent == data.size()) {
+            ++stats_.lines_sent;
+            return;
+        }
+        data.remove_prefix(sent);
+    }
+    c.pending.append(data.data(), data.size());
+    ++stats_.lines_sent;
+}
+
+void LocalStreamServer::publish(StreamTopic topic, std::string_view line)
+{
+    if (!has_subscribers(topic)) {
+        return;
+    }
+    for (Client& c : clients_) {
+        if (c.subscribed && c.topic == topic) {
+            enqueue(c, line);
+        }
+    }
+}
+
+void LocalStreamServer::drop_client(std::size_t i)
+{
+    Client& c = clients_[i];
+    if (c.subscribed) {
+        --subscribers_[static_cast<std::size_t>(c.topic)];
+    }
+    BNO_LOG_INFO("local_server: fd {} disconnected, {} lines dropped", c.fd, c.dropped);
+    ::close(c.fd);
+    clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(i));
+}
+
+} // namespace bno
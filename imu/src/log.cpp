@@ -0,0 +1,334 @@
+#include "bno/log.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bno/row_format.hpp"
+
+namespace bno::log {
+
+namespace detail {
+
+std::atomic<std::uint8_t> g_level{static_cast<std::uint8_t>(Level::Info)};
+std::atomic<bool> g_trace{false};
+constinit thread_local ThreadRing* t_ring = nullptr;
+
+} // namespace detail
+
+namespace {
+
+using detail::ArgType;
+using detail::Kind;
+using detail::Record;
+
+using detail::RING_RECORDS;
+using detail::ThreadRing;
+
+constexpr auto DRAIN_PERIOD = std::chrono::milliseconds(20);
+
+class Logger {
+public:
+    ~Logger() { stop(); }
+
+    ThreadRing* register_thread()
+    {
+        auto ring = std::make_unique<ThreadRing>();
+        ThreadRing* raw = ring.get();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            raw->id = next_id_++;
+            rings_.push_back(std::move(ring));
+        }
+        start(nullptr, std::nullopt);   // drain rusza przy pierwszym wątku
+        return raw;
+    }
+
+    void start(std::FILE* sink, std::optional<Level> level)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sink != nullptr) {
+            sink_.store(sink, std::memory_order_release);
+        }
+        if (level) {
+            detail::g_level.store(static_cast<std::uint8_t>(*level), std::memory_order_relaxed);
+        }
+        if (!thread_.joinable()) {
+            stop_ = false;
+            thread_ = std::thread([this] { run(); });
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!thread_.joinable()) {
+                return;
+            }
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+        drain_all();   // co przyszło po ostatnim obrocie
+        std::fflush(sink_.load(std::memory_order_acquire));
+    }
+
+    Stats stats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats s;
+        s.written = written_;
+        s.dropped = dropped_retired_ + dropped_exited_.load(std::memory_order_relaxed);
+        for (const auto& r : rings_) {
+            s.dropped += r->dropped.load(std::memory_order_relaxed);
+        }
+        s.threads = static_cast<std::uint32_t>(rings_.size());
+        return s;
+    }
+
+    void count_exited_drop() { dropped_exited_.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    std::mutex mutex_;         // rejestr pierścieni, stan wątku drain
+    std::mutex drain_mutex_;   // jeden drain_all() naraz (wątek drain / stop())
+    std::condition_variable cv_;
+    std::vector<std::unique_ptr<ThreadRing>> rings_;
+    std::thread thread_;
+    bool stop_{false};
+    std::atomic<std::FILE*> sink_{stderr};   // start() zmienia go przy działającym drainie
+    std::uint32_t next_id_{0};
+    std::uint64_t written_{0};
+    std::uint64_t dropped_retired_{0};
+    std::atomic<std::uint64_t> dropped_exited_{0};   // logi z wątku po jego ThreadHandle
+    // kalibracja ticków: para (ticki, ns) ze startu i z bieżącego drain_all()
+    const std::uint64_t t0_ticks_{detail::now_ticks()};
+    const std::uint64_t t0_ns_{detail::now_ns()};
+    double ns_per_tick_{1.0};
+    RowFormatter text_{16 * 1024};
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            cv_.wait_for(lock, DRAIN_PERIOD);
+            lock.unlock();
+            drain_all();
+            lock.lock();
+        }
+    }
+
+    void drain_all()
+    {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        std::vector<ThreadRing*> rings;
+        {
+            std::lock_guard<std::mutex> reg(mutex_);
+            rings.reserve(rings_.size());
+            for (const auto& r : rings_) {
+                rings.push_back(r.get());
+            }
+        }
+
+        const std::uint64_t ticks = detail::now_ticks();
+        const std::uint64_t ns = detail::now_ns();
+        if (ticks > t0_ticks_ && ns > t0_ns_ + 1'000'000) {
+            ns_per_tick_ = static_cast<double>(ns - t0_ns_) / static_cast<double>(ticks - t0_ticks_);
+        }
+
+        // rekordy wątków wypisujemy pierścień po pierścieniu – kolejność
+        // w obrębie wątku zachowana, między wątkami wystarczy znacznik czasu
+        std::uint64_t written = 0;
+        for (ThreadRing* r : rings) {
+            const std::uint64_t head = r->head.load(std::memory_order_acquire);
+            std::uint64_t tail = r->tail.load(std::memory_order_relaxed);
+            for (; tail != head; ++tail) {
+                format(*r, r->records[tail % RING_RECORDS]);
+                ++written;
+            }
+            r->tail.store(tail, std::memory_order_release);
+        }
+        text_.write_to(sink_.load(std::memory_order_acquire), written > 0);
+
+        std::lock_guard<std::mutex> reg(mutex_);
+        written_ += written;
+        // Pierścienie zakończonych wątków – już opróżnione. Zwalniamy je tylko
+        // tu: właściciel po retired nie ma już do nich wskaźnika (t_ring = nullptr).
+        for (auto it = rings_.begin(); it != rings_.end();) {
+            ThreadRing* r = it->get();
+            if (r->retired.load(std::memory_order_acquire) &&
+                r->tail.load(std::memory_order_relaxed) == r->head.load(std::memory_order_acquire)) {
+                dropped_retired_ += r->dropped.load(std::memory_order_relaxed);
+                it = rings_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void format(const ThreadRing& ring, const Record& rec)
+    {
+        static constexpr char LEVEL_CHAR[] = {'T', 'D', 'I', 'W', 'E', '?'};
+        const double t = static_cast<double>(rec.ticks - std::min(rec.ticks, t0_ticks_)) * ns_per_tick_ * 1e-9;
+
+        text_.put('[');
+        text_.put_fixed(t, 6);
+        text_.put("] ");
+        text_.put(LEVEL_CHAR[std::min<std::size_t>(static_cast<std::size_t>(rec.level), 5)]);
+        text_.put(" #");
+        text_.put_uint(ring.id);
+        text_.put(' ');
+
+        if (rec.kind == Kind::Span) {
+            text_.put("span ");
+            text_.put(rec.fmt);
+            text_.put_kv(" ", static_cast<double>(rec.args[0].u) * ns_per_tick_ * 1e-3, 2);
+            text_.put(" us\n");
+            return;
+        }
+
+        std::string_view fmt(rec.fmt);
+        std::size_t arg = 0;
+        for (;;) {
+            const auto pos = fmt.find("{}");
+            if (pos == std::string_view::npos || arg >= rec.nargs) {
+                text_.put(fmt);
+                break;
+            }
+            text_.put(fmt.substr(0, pos));
+            put_arg(rec.types[arg], rec.args[arg]);
+            ++arg;
+            fmt.remove_prefix(pos + 2);
+        }
+        text_.put('\n');
+    }
+
+    void put_arg(ArgType type, const detail::ArgValue& v)
+    {
+        switch (type) {
+        case ArgType::Int:    text_.put_int(v.i); break;
+        case ArgType::Uint:   text_.put_uint(v.u); break;
+        case ArgType::Double: text_.put_fixed(v.d, 6); break;
+        case ArgType::Str:    text_.put(v.s != nullptr ? v.s : "(null)"); break;
+        case ArgType::None:   break;
+        }
+    }
+};
+
+Logger& logger()
+{
+    static Logger instance;
+    return instance;
+}
+
+using detail::t_ring;
+// Ustawiane przez ~ThreadHandle: późniejsze logi z tego wątku (np. z innych
+// destruktorów thread_local) są odrzucane, zamiast pisać do pierścienia,
+// który drain może już zwolnić, albo rejestrować nowy, którego nikt nie odda
+thread_local bool t_exited = false;
+
+// Przy końcu wątku oddaje pierścień drainowi do opróżnienia
+struct ThreadHandle {
+    ThreadRing* ring{nullptr};
+    ~ThreadHandle()
+    {
+        if (ring != nullptr) {
+            t_ring = nullptr;
+            t_exited = true;
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadHandle t_handle;
+
+[[gnu::noinline]] ThreadRing* register_thread_ring()
+{
+    if (t_exited) {
+        logger().count_exited_drop();
+        return nullptr;
+    }
+    t_handle.ring = logger().register_thread();
+    t_ring = t_handle.ring;
+    return t_ring;
+}
+
+} // namespace
+
+void start(std::FILE* sink, Level runtime_level)
+{
+    logger().start(sink, runtime_level);
+    if (t_ring == nullptr) {
+        register_thread_ring();
+    }
+}
+
+void stop()
+{
+    logger().stop();
+}
+
+void set_level(Level level)
+{
+    detail::g_level.store(static_cast<std::uint8_t>(level), std::memory_order_relaxed);
+}
+
+void set_trace(bool on)
+{
+    detail::g_trace.store(on, std::memory_order_relaxed);
+}
+
+Stats stats()
+{
+    return logger().stats();
+}
+
+namespace detail {
+
+Slot reserve_slow()
+{
+    ThreadRing* r = t_ring;
+    if (r == nullptr) {
+        r = register_thread_ring();
+        if (r == nullptr) {
+            return Slot{nullptr, nullptr};
+        }
+    }
+    const std::uint64_t head = r->head.load(std::memory_order_relaxed);
+    if (head - r->tail_cached >= RING_RECORDS) {
+        r->tail_cached = r->tail.load(std::memory_order_acquire);
+        if (head - r->tail_cached >= RING_RECORDS) {
+            r->dropped.fetch_add(1, std::memory_order_relaxed);
+            return Slot{nullptr, nullptr};
+        }
+    }
+    __builtin_prefetch(&r->records[(head + 1) % RING_RECORDS], 1);
+    return Slot{&r->records[head % RING_RECORDS], &r->head};
+}
+
+void Span::end()
+{
+    const std::uint64_t t1 = now_ticks();
+    const Slot slot = reserve();
+    Record* rec = slot.rec;
+    if (rec == nullptr) {
+        return;
+    }
+    rec->ticks = t0_;
+    rec->fmt = name_;
+    rec->level = Level::Trace;
+    rec->kind = Kind::Span;
+    rec->nargs = 1;
+    rec->types[0] = ArgType::Uint;
+    rec->args[0].u = t1 - t0_;
+    commit(slot);
+}
+
+} // namespace detail
+
+} // namespace bno::log
@@ -0,0 +1,277 @@
+#include "bno/motion_tracker.hpp"
+
+#include <cmath>
+
+namespace bno {
+
+PathShape classify_path(const PathFeatures& f, double min_length)
+{
+    if (f.points < 3 || f.length < min_length) {
+        return PathShape::None;
+    }
+    if (f.straightness >= 0.8) {
+        return PathShape::Line;
+    }
+    if (f.roundness >= 0.5) {
+        return PathShape::Loop;
+    }
+    return PathShape::Arc;
+}
+
+const char* path_shape_name(PathShape s)
+{
+    switch (s) {
+    case PathShape::None: return "none";
+    case PathShape::Line: return "line";
+    case PathShape::Loop: return "loop";
+    case PathShape::Arc:  return "arc";
+    }
+    return "?";
+}
+
+void MotionTracker::Axis::predict(double a_meas, double dt, double q_acc, double q_bias)
+{
+    const double dt2 = 0.5 * dt * dt;
+    const double a = a_meas - x[2];
+    x[0] += x[1] * dt + a * dt2;
+    x[1] += a * dt;
+
+    // F = [1 dt -dt²/2; 0 1 -dt; 0 0 1]; FP = F * P, potem P = FP * Fᵀ
+    std::array<double, 9> fp{};
+    for (std::size_t c = 0; c < 3; ++c) {
+        fp[0 * 3 + c] = P[0 * 3 + c] + dt * P[1 * 3 + c] - dt2 * P[2 * 3 + c];
+        fp[1 * 3 + c] = P[1 * 3 + c] - dt * P[2 * 3 + c];
+        fp[2 * 3 + c] = P[2 * 3 + c];
+    }
+    for (std::size_t r = 0; r < 3; ++r) {
+        P[r * 3 + 0] = fp[r * 3 + 0] + dt * fp[r * 3 + 1] - dt2 * fp[r * 3 + 2];
+        P[r * 3 + 1] = fp[r * 3 + 1] - dt * fp[r * 3 + 2];
+        P[r * 3 + 2] = fp[r * 3 + 2];
+    }
+
+    // Q = σa² G Gᵀ, G = [dt²/2, dt, 0] (szum wchodzi jak przyspieszenie) + dryf biasu
+    const double g0 = dt2;
+    const double g1 = dt;
+    P[0] += q_acc * g0 * g0;
+    P[1] += q_acc * g0 * g1;
+    P[3] += q_acc * g0 * g1;
+    P[4] += q_acc * g1 * g1;
+    P[8] += q_bias * dt;
+}
+
+void MotionTracker::Axis::zero_velocity(double r)
+{
+    // H = [0 1 0], pomiar skalarny – bez odwracania macierzy
+    const double s = P[4] + r;
+    const std::array<double, 3> k{P[1] / s, P[4] / s, P[7] / s};
+    const double innov = -x[1];
+    for (std::size_t i = 0; i < 3; ++i) {
+        x[i] += k[i] * innov;
+    }
+    // P = (I - K H) P; wiersz 1 trzeba zapamiętać przed nadpisaniem
+    const std::array<double, 3> row1{P[3], P[4], P[5]};
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            P[i * 3 + j] -= k[i] * row1[j];
+        }
+    }
+    // symetria mimo zaokrągleń
+    P[1] = P[3] = 0.5 * (P[1] + P[3]);
+    P[2] = P[6] = 0.5 * (P[2] + P[6]);
+    P[5] = P[7] = 0.5 * (P[5] + P[7]);
+}
+
+MotionTracker::MotionTracker(const Config& cfg)
+    : cfg_(cfg)
+    , ring_(TRAJECTORY)
+{
+    reset();
+}
+
+void MotionTracker::reset()
+{
+    for (auto& a : axes_) {
+        a.x = {};
+        a.P = {};
+    }
+    t_ = 0.0;
+    initialized_ = false;
+    still_ = false;
+    moving_since_ = 0.0;
+    init_t0_ = 0.0;
+    init_sum_ = Vec3{};
+    init_count_ = 0;
+    still_mean_ = {};
+    still_var_ = 0.0;
+    head_ = 0;
+    size_ = 0;
+    stats_ = Stats{};
+}
+
+void MotionTracker::add_sample(double t, const Vec3& accel_sensor, const Vec3& gyro_sensor,
+                               const Quat& quat)
+{
+    ++stats_.samples;
+    const Vec3 a = rotate_vector_by_quat(accel_sensor, quat);
+    const double a_w[3] = {a.x, a.y, a.z};
+
+    if (!initialized_) {
+        // początek: urządzenie w spoczynku, średnia a to bias (jak baseline detektora)
+        if (init_count_ == 0) {
+            init_t0_ = t;
+        }
+        init_sum_.x += a.x;
+        init_sum_.y += a.y;
+        init_sum_.z += a.z;
+        ++init_count_;
+        if (t - init_t0_ < cfg_.init_window_s || init_count_ < 3) {
+            return;
+        }
+        const double n = static_cast<double>(init_count_);
+        const double bias[3] = {init_sum_.x / n, init_sum_.y / n, init_sum_.z / n};
+        const double var_b = cfg_.accel_noise * cfg_.accel_noise / n;
+        for (std::size_t i = 0; i < 3; ++i) {
+            axes_[i].x = {0.0, 0.0, bias[i]};
+            axes_[i].P = {0.0, 0.0, 0.0,
+                          0.0, cfg_.zupt_noise * cfg_.zupt_noise, 0.0,
+                          0.0, 0.0, var_b};
+        }
+        still_mean_ = {bias[0], bias[1], bias[2]};
+        still_var_ = 0.0;
+        initialized_ = true;
+        still_ = true;
+        moving_since_ = t - cfg_.still_hold_s;
+        t_ = t;
+        push_point(t);
+        return;
+    }
+
+    const double dt = t - t_;
+    t_ = t;
+    if (dt <= 0.0 || dt > cfg_.max_dt) {
+        if (dt > cfg_.max_dt) {
+            ++stats_.gaps;
+        }
+        push_point(t);
+        return;
+    }
+
+    const double q_acc = cfg_.accel_noise * cfg_.accel_noise;
+    const double q_bias = cfg_.bias_walk * cfg_.bias_walk;
+    for (std::size_t i = 0; i < 3; ++i) {
+        axes_[i].predict(a_w[i], dt, q_acc, q_bias);
+    }
+
+    // Bezruch po rozrzucie a wokół średniej kroczącej, nie po |a - b|:
+    // przy złym biasie ten drugi nigdy nie wykryłby spoczynku, więc ZUPT
+    // nie miałby jak biasu poprawić.
+    const double alpha = std::fmin(1.0, dt / cfg_.still_hold_s);
+    double dev2 = 0.0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const double d = a_w[i] - still_mean_[i];
+        still_mean_[i] += alpha * d;
+        dev2 += d * d;
+    }
+    still_var_ += alpha * (dev2 - still_var_);
+
+    const double rate = norm(gyro_sensor);
+    if (still_var_ >= cfg_.still_accel * cfg_.still_accel || rate >= cfg_.still_gyro) {
+        moving_since_ = t;
+    }
+    const bool was_still = still_;
+    still_ = (t - moving_since_) >= cfg_.still_hold_s;
+    if (still_ && !was_still) {
+        ++stats_.still_periods;
+    }
+
+    if (still_) {
+        const double r = cfg_.zupt_noise * cfg_.zupt_noise;
+        for (auto& ax : axes_) {
+            ax.zero_velocity(r);
+        }
+        ++stats_.zupt_updates;
+    }
+
+    push_point(t);
+}
+
+void MotionTracker::push_point(double t)
+{
+    std::size_t idx;
+    if (size_ < TRAJECTORY) {
+        idx = (head_ + size_) % TRAJECTORY;
+        ++size_;
+    } else {
+        idx = head_;
+        head_ = (head_ + 1) % TRAJECTORY;
+    }
+    TrackPoint& p = ring_[idx];
+    p.t = t;
+    p.p = position();
+    p.v = velocity();
+    p.still = still_;
+}
+
+const TrackPoint& MotionTracker::point(std::size_t i) const
+{
+    return ring_[(head_ + i) % TRAJECTORY];
+}
+
+std::size_t MotionTracker::first_at_or_after(double t) const
+{
+    std::size_t lo = 0;
+    std::size_t hi = size_;
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (point(mid).t < t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void MotionTracker::trajectory(double t_from, double t_to, std::vector<TrackPoint>& out) const
+{
+    out.clear();
+    for (std::size_t i = first_at_or_after(t_from); i < size_ && point(i).t <= t_to; ++i) {
+        out.push_back(point(i));
+    }
+}
+
+PathFeatures MotionTracker::path_features(double t_from, double t_to) const
+{
+    PathFeatures f;
+    const std::size_t i0 = first_at_or_after(t_from);
+    if (i0 >= size_ || point(i0).t > t_to) {
+        return f;
+    }
+
+    const Vec3 origin = point(i0).p;
+    Vec3 prev_r{};
+    f.points = 1;
+    f.peak_speed = norm(point(i0).v);
+    for (std::size_t i = i0 + 1; i < size_ && point(i).t <= t_to; ++i) {
+        const TrackPoint& tp = point(i);
+        const Vec3 r{tp.p.x - origin.x, tp.p.y - origin.y, tp.p.z - origin.z};
+        f.length += norm(Vec3{r.x - prev_r.x, r.y - prev_r.y, r.z - prev_r.z});
+        const Vec3 c = cross(prev_r, r);
+        f.area.x += 0.5 * c.x;
+        f.area.y += 0.5 * c.y;
+        f.area.z += 0.5 * c.z;
+        f.peak_speed = std::fmax(f.peak_speed, norm(tp.v));
+        prev_r = r;
+        ++f.points;
+    }
+
+    f.displacement = prev_r;
+    if (f.length > 1e-9) {
+        constexpr double PI = 3.14159265358979323846;
+        f.straightness = norm(f.displacement) / f.length;
+        f.roundness = 4.0 * PI * norm(f.area) / (f.length * f.length);
+    }
+    return f;
+}
+
+} // namespace bno
@@ -0,0 +1,337 @@
+#include "bno/orientation_fusion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bno {
+
+namespace {
+
+Quat normalized(const Quat& q)
+{
+    const double n = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    if (n < 1e-12) {
+        return Quat{};
+    }
+    return Quat{q.w / n, q.x / n, q.y / n, q.z / n};
+}
+
+// Obrót o wektor v (rad): exp(v/2). Krok gyro przy 1 kHz to ułamki stopnia,
+// więc zwykle wystarcza szereg Taylora zamiast sin/cos (błąd < 1e-13).
+Quat quat_exp(const Vec3& v)
+{
+    const double a2 = v.x * v.x + v.y * v.y + v.z * v.z;
+    if (a2 < 0.05 * 0.05) {
+        const double c = 1.0 - a2 / 8.0 + a2 * a2 / 384.0;
+        const double s = 0.5 - a2 / 48.0 + a2 * a2 / 3840.0;
+        return Quat{c, v.x * s, v.y * s, v.z * s};
+    }
+    const double angle = std::sqrt(a2);
+    const double s = std::sin(0.5 * angle) / angle;
+    return Quat{std::cos(0.5 * angle), v.x * s, v.y * s, v.z * s};
+}
+
+// q i ref po tej samej stronie hipersfery – różnica q - ref ma wtedy sens
+Quat same_hemisphere(const Quat& q, const Quat& ref)
+{
+    const double d = q.w * ref.w + q.x * ref.x + q.y * ref.y + q.z * ref.z;
+    return d < 0.0 ? Quat{-q.w, -q.x, -q.y, -q.z} : q;
+}
+
+Vec3 scaled(const Vec3& v, double k)
+{
+    return Vec3{v.x * k, v.y * k, v.z * k};
+}
+
+} // namespace
+
+const char* fusion_method_name(FusionMethod m)
+{
+    switch (m) {
+    case FusionMethod::Madgwick: return "madgwick";
+    case FusionMethod::Mahony:   return "mahony";
+    case FusionMethod::Ekf:      return "ekf";
+    }
+    return "?";
+}
+
+bool parse_fusion_method(std::string_view name, FusionMethod& out)
+{
+    for (auto m : {FusionMethod::Madgwick, FusionMethod::Mahony, FusionMethod::Ekf}) {
+        if (name == fusion_method_name(m)) {
+            out = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+OrientationFusion::OrientationFusion(const Config& cfg)
+    : cfg_(cfg)
+{
+    reset();
+}
+
+void OrientationFusion::reset()
+{
+    q_ = Quat{};
+    g_ = Quat{};
+    align_ = Quat{};
+    bias_ = Vec3{};
+    t_ = 0.0;
+    have_t_ = false;
+    initialized_ = false;
+    hist_head_ = 0;
+    hist_size_ = 0;
+    P_.fill(0.0);
+    stats_ = Stats{};
+}
+
+void OrientationFusion::push_history()
+{
+    hist_head_ = (hist_head_ + 1) % HISTORY;
+    hist_[hist_head_] = HistoryEntry{t_, g_};
+    if (hist_size_ < HISTORY) {
+        ++hist_size_;
+    }
+}
+
+Quat OrientationFusion::gyro_quat_at(double t)
+{
+    if (hist_size_ == 0 || t >= hist_[hist_head_].t) {
+        return g_;
+    }
+    const std::size_t oldest = (hist_head_ + HISTORY + 1 - hist_size_) % HISTORY;
+    auto at = [&](std::size_t i) -> const HistoryEntry& {
+        return hist_[(oldest + i) % HISTORY];
+    };
+    if (t < at(0).t) {
+        ++stats_.stale_corrections;
+        return at(0).g;
+    }
+
+    // ostatni wpis z czasem <= t (historia rośnie monotonicznie)
+    std::size_t lo = 0;
+    std::size_t hi = hist_size_ - 1;
+    while (lo + 1 < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (at(mid).t <= t) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    const HistoryEntry& a = at(lo);
+    const HistoryEntry& b = at(hi);
+    const double span = b.t - a.t;
+    const double u = span > 0.0 ? (t - a.t) / span : 0.0;
+    const Quat bq = same_hemisphere(b.g, a.g);
+    return normalized(Quat{
+        a.g.w + (bq.w - a.g.w) * u,
+        a.g.x + (bq.x - a.g.x) * u,
+        a.g.y + (bq.y - a.g.y) * u,
+        a.g.z + (bq.z - a.g.z) * u,
+    });
+}
+
+const Quat& OrientationFusion::update_gyro(double t, const Vec3& gyro)
+{
+    ++stats_.gyro_samples;
+    if (!have_t_) {
+        have_t_ = true;
+        t_ = t;
+        push_history();
+        return q_;
+    }
+    const double dt = t - t_;
+    if (dt <= 0.0) {
+        return q_;   // powtórzony albo cofnięty czas – próbka pomijana
+    }
+    t_ = t;
+    if (dt > cfg_.max_dt) {
+        push_history();   // przerwa w danych: nie całkujemy zgadywanego obrotu
+        return q_;
+    }
+
+    const Vec3 w{gyro.x - bias_.x, gyro.y - bias_.y, gyro.z - bias_.z};
+    g_ = normalized(quat_mul(g_, quat_exp(scaled(w, dt))));
+    push_history();
+
+    if (!initialized_) {
+        q_ = normalized(quat_mul(q_, quat_exp(scaled(w, dt))));
+        return q_;
+    }
+
+    switch (cfg_.method) {
+    case FusionMethod::Madgwick: {
+        // q' = ½ q ⊗ ω − β ∇f, f = q − ref: krok po gyro, potem ku pomiarowi
+        const Quat ref = same_hemisphere(quat_mul(align_, g_), q_);
+        const Quat q_gyro = quat_mul(q_, quat_exp(scaled(w, dt)));
+        Quat grad{q_gyro.w - ref.w, q_gyro.x - ref.x, q_gyro.y - ref.y, q_gyro.z - ref.z};
+        const double gn = std::sqrt(grad.w * grad.w + grad.x * grad.x + grad.y * grad.y + grad.z * grad.z);
+        // krok nie dłuższy niż odległość do pomiaru – bez drgań wokół niego
+        const double step = std::min(cfg_.madgwick_beta * dt, gn);
+        const double k = gn > 1e-12 ? step / gn : 0.0;
+        q_ = normalized(Quat{q_gyro.w - grad.w * k, q_gyro.x - grad.x * k,
+                             q_gyro.y - grad.y * k, q_gyro.z - grad.z * k});
+        break;
+    }
+    case FusionMethod::Mahony: {
+        // e – obrót (układ czujnika) od estymaty do pomiaru; całka e = -bias
+        const Quat ref = quat_mul(align_, g_);
+        const Vec3 e = rotation_vector(quat_mul(quat_conj(q_), ref));
+        bias_.x -= cfg_.mahony_ki * e.x * dt;
+        bias_.y -= cfg_.mahony_ki * e.y * dt;
+        bias_.z -= cfg_.mahony_ki * e.z * dt;
+        const Vec3 wc{w.x + cfg_.mahony_kp * e.x, w.y + cfg_.mahony_kp * e.y, w.z + cfg_.mahony_kp * e.z};
+        q_ = normalized(quat_mul(q_, quat_exp(scaled(wc, dt))));
+        break;
+    }
+    case FusionMethod::Ekf:
+        q_ = normalized(quat_mul(q_, quat_exp(scaled(w, dt))));
+        ekf_predict(w, dt);
+        break;
+    }
+    return q_;
+}
+
+void OrientationFusion::correct_quat(double t, const Quat& q_sensor)
+{
+    ++stats_.corrections;
+    const Quat qs = normalized(q_sensor);
+
+    // pomiar z chwili t przeniesiony do teraz obrotem z samego gyro
+    const Quat g_then = gyro_quat_at(t);
+    align_ = normalized(quat_mul(qs, quat_conj(g_then)));
+    const Quat measured_now = normalized(quat_mul(align_, g_));
+
+    if (!initialized_) {
+        initialized_ = true;
+        q_ = measured_now;
+        P_.fill(0.0);
+        const double att = cfg_.ekf_quat_noise * cfg_.ekf_quat_noise;
+        const double bias = 0.01 * 0.01;   // (rad/s)^2 – bias po kalibracji czujnika
+        for (std::size_t i = 0; i < 3; ++i) {
+            P_[i * 6 + i] = att;
+            P_[(i + 3) * 6 + (i + 3)] = bias;
+        }
+        return;
+    }
+    if (cfg_.method == FusionMethod::Ekf) {
+        ekf_update(measured_now);
+    }
+}
+
+// Stan błędu x = [δθ (układ czujnika), δb]; δθ' = -[ω]x δθ - δb, δb' = szum.
+void OrientationFusion::ekf_predict(const Vec3& w, double dt)
+{
+    // Φ = [[I - [ω]x dt, -I dt], [0, I]]
+    std::array<double, 36> F{};
+    for (std::size_t i = 0; i < 6; ++i) {
+        F[i * 6 + i] = 1.0;
+    }
+    F[0 * 6 + 1] =  w.z * dt;  F[0 * 6 + 2] = -w.y * dt;
+    F[1 * 6 + 0] = -w.z * dt;  F[1 * 6 + 2] =  w.x * dt;
+    F[2 * 6 + 0] =  w.y * dt;  F[2 * 6 + 1] = -w.x * dt;
+    for (std::size_t i = 0; i < 3; ++i) {
+        F[i * 6 + i + 3] = -dt;
+    }
+
+    std::array<double, 36> FP{};
+    for (std::size_t r = 0; r < 6; ++r) {
+        for (std::size_t c = 0; c < 6; ++c) {
+            double s = 0.0;
+            for (std::size_t k = 0; k < 6; ++k) {
+                s += F[r * 6 + k] * P_[k * 6 + c];
+            }
+            FP[r * 6 + c] = s;
+        }
+    }
+    for (std::size_t r = 0; r < 6; ++r) {
+        for (std::size_t c = r; c < 6; ++c) {
+            double s = 0.0;
+            for (std::size_t k = 0; k < 6; ++k) {
+                s += FP[r * 6 + k] * F[c * 6 + k];
+            }
+            P_[r * 6 + c] = s;
+            P_[c * 6 + r] = s;
+        }
+    }
+
+    const double qg = cfg_.ekf_gyro_noise * cfg_.ekf_gyro_noise * dt;
+    const double qb = cfg_.ekf_bias_walk * cfg_.ekf_bias_walk * dt;
+    for (std::size_t i = 0; i < 3; ++i) {
+        P_[i * 6 + i] += qg;
+        P_[(i + 3) * 6 + (i + 3)] += qb;
+    }
+}
+
+// Pomiar z = δθ (H = [I 0]), R = σ² I
+void OrientationFusion::ekf_update(const Quat& measured_now)
+{
+    const Vec3 zv = rotation_vector(quat_mul(quat_conj(q_), measured_now));
+    const double z[3] = {zv.x, zv.y, zv.z};
+
+    // S = P[0:3,0:3] + R, odwrotność z dopełnień algebraicznych
+    const double r = cfg_.ekf_quat_noise * cfg_.ekf_quat_noise;
+    double S[9];
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            S[i * 3 + j] = P_[i * 6 + j] + (i == j ? r : 0.0);
+        }
+    }
+    const double c00 = S[4] * S[8] - S[5] * S[7];
+    const double c01 = S[5] * S[6] - S[3] * S[8];
+    const double c02 = S[3] * S[7] - S[4] * S[6];
+    const double det = S[0] * c00 + S[1] * c01 + S[2] * c02;
+    if (std::fabs(det) < 1e-30) {
+        return;
+    }
+    const double inv_det = 1.0 / det;
+    const double Si[9] = {
+        c00 * inv_det, (S[2] * S[7] - S[1] * S[8]) * inv_det, (S[1] * S[5] - S[2] * S[4]) * inv_det,
+        c01 * inv_det, (S[0] * S[8] - S[2] * S[6]) * inv_det, (S[2] * S[3] - S[0] * S[5]) * inv_det,
+        c02 * inv_det, (S[1] * S[6] - S[0] * S[7]) * inv_det, (S[0] * S[4] - S[1] * S[3]) * inv_det,
+    };
+
+    // K = P[:,0:3] S^-1 (6x3), δx = K z
+    double K[18];
+    double dx[6];
+    for (std::size_t i = 0; i < 6; ++i) {
+        dx[i] = 0.0;
+        for (std::size_t j = 0; j < 3; ++j) {
+            double s = 0.0;
+            for (std::size_t k = 0; k < 3; ++k) {
+                s += P_[i * 6 + k] * Si[k * 3 + j];
+            }
+            K[i * 3 + j] = s;
+            dx[i] += s * z[j];
+        }
+    }
+
+    q_ = normalized(quat_mul(q_, quat_exp(Vec3{dx[0], dx[1], dx[2]})));
+    bias_.x += dx[3];
+    bias_.y += dx[4];
+    bias_.z += dx[5];
+
+    // P = (I - K H) P; H wybiera pierwsze 3 wiersze P
+    std::array<double, 36> Pn{};
+    for (std::size_t i = 0; i < 6; ++i) {
+        for (std::size_t j = 0; j < 6; ++j) {
+            double s = P_[i * 6 + j];
+            for (std::size_t k = 0; k < 3; ++k) {
+                s -= K[i * 3 + k] * P_[k * 6 + j];
+            }
+            Pn[i * 6 + j] = s;
+        }
+    }
+    for (std::size_t i = 0; i < 6; ++i) {
+        for (std::size_t j = i; j < 6; ++j) {
+            const double s = 0.5 * (Pn[i * 6 + j] + Pn[j * 6 + i]);
+            P_[i * 6 + j] = s;
+            P_[j * 6 + i] = s;
+        }
+    }
+}
+
+} // namespace bno
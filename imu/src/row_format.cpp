@@ -0,0 +1,96 @@
+#include "bno/row_format.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <system_error>
+
+namespace bno {
+
+namespace {
+
+// "-" + 309 cyfr części całkowitej double + '.' + miejsca po przecinku
+constexpr std::size_t MAX_FIXED_INT_DIGITS = 311;
+
+} // namespace
+
+RowFormatter::RowFormatter(std::size_t capacity)
+    : buf_(std::max<std::size_t>(capacity, 64))
+{}
+
+void RowFormatter::grow(std::size_t n)
+{
+    buf_.resize(std::max(buf_.size() * 2, size_ + n));
+}
+
+void RowFormatter::put(std::string_view s)
+{
+    reserve_more(s.size());
+    std::memcpy(buf_.data() + size_, s.data(), s.size());
+    size_ += s.size();
+}
+
+void RowFormatter::put_fixed(double v, int decimals)
+{
+    decimals = std::clamp(decimals, 0, 17);
+
+    // typowe wartości (|v| < 1e15) mieszczą się w 40 znakach – pełny zapas
+    // tylko, gdy pierwsza próba się nie uda
+    reserve_more(40);
+    char* begin = buf_.data() + size_;
+    auto r = std::to_chars(begin, buf_.data() + buf_.size(), v, std::chars_format::fixed, decimals);
+    if (r.ec != std::errc{}) {
+        reserve_more(MAX_FIXED_INT_DIGITS + static_cast<std::size_t>(decimals));
+        begin = buf_.data() + size_;
+        r = std::to_chars(begin, buf_.data() + buf_.size(), v, std::chars_format::fixed, decimals);
+    }
+    size_ += static_cast<std::size_t>(r.ptr - begin);
+}
+
+void RowFormatter::put_int(std::int64_t v)
+{
+    reserve_more(24);
+    char* begin = buf_.data() + size_;
+    const auto r = std::to_chars(begin, buf_.data() + buf_.size(), v);
+    size_ += static_cast<std::size_t>(r.ptr - begin);
+}
+
+void RowFormatter::put_uint(std::uint64_t v)
+{
+    reserve_more(24);
+    char* begin = buf_.data() + size_;
+    const auto r = std::to_chars(begin, buf_.data() + buf_.size(), v);
+    size_ += static_cast<std::size_t>(r.ptr - begin);
+}
+
+void RowFormatter::put_imu_row(const ImuCsvRow& row, int decimals)
+{
+    const double values[11] = {
+        row.t,
+        row.ax, row.ay, row.az,
+        row.gx, row.gy, row.gz,
+        row.qw, row.qi, row.qj, row.qk,
+    };
+    for (std::size_t i = 0; i < 11; ++i) {
+        if (i > 0) {
+            put(',');
+        }
+        put_fixed(values[i], decimals);
+    }
+    put('\n');
+}
+
+bool RowFormatter::write_to(std::FILE* f, bool flush)
+{
+    bool ok = true;
+    if (size_ > 0) {
+        ok = std::fwrite(buf_.data(), 1, size_, f) == size_;
+        size_ = 0;
+    }
+    if (flush) {
+        ok = (std::fflush(f) == 0) && ok;
+    }
+    return ok;
+}
+
+} // namespace bno
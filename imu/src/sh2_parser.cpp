@@ -1,4 +1,5 @@
 #include "bno/sh2_reports.hpp"
+#include "bno/sh2_decode.hpp"
 
 #include <cmath>
 #include <cstring>
@@ -8,10 +9,8 @@ namespace bno {
 
 namespace {
 
-// mały helper
-inline std::int16_t le_i16(const std::uint8_t* p) {
-    return static_cast<std::int16_t>(p[0] | (std::int16_t(p[1]) << 8));
-}
+using sh2::le_i16;
+using sh2::decode_delay;
 
 inline Sh2Accuracy decode_accuracy(std::uint8_t status) {
     // Wg SH-2 RM: w polu „Status” dolne 2 bity kodują dokładność 0..3. :contentReference[oaicite:6]{index=6}
@@ -87,6 +86,22 @@ std::optional<Sh2SensorEvent> parse_sh2_sensor_event(const std::uint8_t* data,
         break;
     }
 
+    case 0x07: { // Gyroscope Uncalibrated (rad/s, Q9): x, y, z, potem bias x, y, z
+        if (len < 16) return std::nullopt;
+        std::int16_t x_raw = le_i16(&data[4]);
+        std::int16_t y_raw = le_i16(&data[6]);
+        std::int16_t z_raw = le_i16(&data[8]);
+        constexpr float SCALE = 1.0f / 512.0f; // Q9
+        Vec3f v{
+            x_raw * SCALE,
+            y_raw * SCALE,
+            z_raw * SCALE,
+        };
+        evt.sensor_id = Sh2SensorId::GyroscopeUncalibrated;
+        evt.gyro = v;   // bias czujnika pomijamy – fuzja na hoście estymuje własny
+        break;
+    }
+
     case 0x08: { // Game Rotation Vector (kwaternion Q14) :contentReference[oaicite:10]{index=10}
         if (len < 12) return std::nullopt;
         std::int16_t i_raw = le_i16(&data[4]);
@@ -105,6 +120,20 @@ std::optional<Sh2SensorEvent> parse_sh2_sensor_event(const std::uint8_t* data,
         break;
     }
 
+    case 0x10: { // Tap Detector: bajt 4 – flagi (oś, znak, double tap)
+        if (len < 5) return std::nullopt;
+        evt.sensor_id = Sh2SensorId::TapDetector;
+        evt.tap_flags = data[4];
+        break;
+    }
+
+    case 0x12: { // Significant Motion: uint16 "motion" (zawsze 1)
+        if (len < 6) return std::nullopt;
+        evt.sensor_id = Sh2SensorId::SignificantMotion;
+        evt.significant_motion = true;
+        break;
+    }
+
     default:
         // Inny raport – na razie nie obsługujemy.
         return std::nullopt;
@@ -113,11 +142,39 @@ std::optional<Sh2SensorEvent> parse_sh2_sensor_event(const std::uint8_t* data,
     return evt;
 }
 
+std::size_t sh2_report_length(std::uint8_t report_id) {
+    return sh2::report_length(report_id);
+}
+
+std::size_t parse_sh2_input_reports(const std::uint8_t* data,
+                                    std::size_t len,
+                                    Sh2SensorEvent* out,
+                                    std::size_t max_out) {
+    if (!data || !out || max_out == 0) {
+        return 0;
+    }
+
+    // Ta sama pętla po ramce co decode_sh2_readings<Num>(); parsera nie da się
+    // na niej oprzeć wprost, bo zwraca też raporty bez wektora (tap,
+    // significant motion) i dokładność ze statusu.
+    std::size_t n = 0;
+    sh2::walk_reports(data, len, [&](const std::uint8_t* r, std::size_t rlen, std::int32_t offset_us) {
+        if (auto evt = parse_sh2_sensor_event(r, rlen)) {
+            evt->host_offset_us = offset_us;
+            out[n++] = *evt;
+        }
+        return n < max_out;
+    });
+    return n;
+}
+
 bool build_enable_report_command(Sh2SensorId sensor,
                                  std::uint32_t interval_us,
                                  std::uint8_t* out_buf,
                                  std::size_t& out_len,
-                                 std::size_t max_len) {
+                                 std::size_t max_len,
+                                 std::uint8_t flags,
+                                 std::uint32_t batch_interval_us) {
     // Set Feature Command (0xFD) + Common Dynamic Feature Report (17 bajtów). :contentReference[oaicite:11]{index=11}
     if (!out_buf || max_len < 17) {
         return false;
@@ -129,7 +186,7 @@ bool build_enable_report_command(Sh2SensorId sensor,
 
     out_buf[0] = 0xFD;                // Report ID = Set Feature Command
     out_buf[1] = feature_report_id;   // Feature Report ID
-    out_buf[2] = 0x00;                // Feature flags (0 = non-wakeup)
+    out_buf[2] = flags;               // Feature flags (0 = non-wakeup)
     out_buf[3] = 0x00;                // Change sensitivity LSB
     out_buf[4] = 0x00;                // Change sensitivity MSB
 
@@ -139,11 +196,11 @@ bool build_enable_report_command(Sh2SensorId sensor,
     out_buf[7] = static_cast<std::uint8_t>((interval_us >> 16) & 0xFF);
     out_buf[8] = static_cast<std::uint8_t>((interval_us >> 24) & 0xFF);
 
-    // Batch Interval = 0 (bierzemy dane "na żywo")
-    out_buf[9]  = 0;
-    out_buf[10] = 0;
-    out_buf[11] = 0;
-    out_buf[12] = 0;
+    // Batch Interval (4 bajty LE, µs; 0 = dane "na żywo")
+    out_buf[9]  = static_cast<std::uint8_t>(batch_interval_us & 0xFF);
+    out_buf[10] = static_cast<std::uint8_t>((batch_interval_us >> 8) & 0xFF);
+    out_buf[11] = static_cast<std::uint8_t>((batch_interval_us >> 16) & 0xFF);
+    out_buf[12] = static_cast<std::uint8_t>((batch_interval_us >> 24) & 0xFF);
 
     // Sensor-specific config word = 0
     out_buf[13] = 0;
@@ -1,11 +1,12 @@
 #include "bno/shtp.hpp"
+#include "bno/gpio_irq.hpp"
+#include "bno/log.hpp"
 
 #include <array>
 #include <cerrno>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
-#include <iostream>
 #include <optional>
 #include <string>
 #include <system_error>
@@ -68,7 +69,7 @@ void ShtpI2cTransport::close() noexcept {
 ///
 /// Czytanie ramki SHTP po I²C.
 /// Schemat:
-///   1. poll() z timeoutem,
+///   1. poll() z timeoutem (albo czekanie na H_INTN, jeśli jest),
 ///   2. read(4) → nagłówek (Length[2], Channel, Sequence),
 ///   3. wyliczamy length = Length & 0x7FFF,
 ///   4. read(length) → cała ramka (nagłówek + payload),
@@ -83,7 +84,12 @@ std::optional<ShtpFrame> ShtpI2cTransport::read_frame(ShtpError& err,
         return std::nullopt;
     }
 
-    // 1. poll() na fd z timeoutem
+    // 1. z linią przerwania: szyna dopiero, gdy czujnik zgłosi ramkę
+    if (irq_ && !irq_->wait_active(timeout_ms, err)) {
+        return std::nullopt;
+    }
+
+    // poll() na fd z timeoutem (i2c-dev zgłasza gotowość od razu)
     struct pollfd pfd;
     pfd.fd     = fd_;
     pfd.events = POLLIN;
@@ -128,6 +134,12 @@ std::optional<ShtpFrame> ShtpI2cTransport::read_frame(ShtpError& err,
                                          (std::uint16_t(header_raw[1]) << 8));
     length &= 0x7FFF; // bez bitu kontynuacji
 
+    if (length == 0) {
+        // BNO nie ma nic do wysłania – tak samo jak timeout
+        err = ShtpError{};
+        return std::nullopt;
+    }
+
     if (length < 4 || length > max_frame_size_) {
         err.code      = ShtpError::Code::OversizeFrame;
         err.sys_errno = EPROTO;
@@ -158,8 +170,7 @@ std::optional<ShtpFrame> ShtpI2cTransport::read_frame(ShtpError& err,
 
     if (length2 != length) {
         // coś dziwnego – log i odrzucamy tę ramkę
-        std::cerr << "[shtp] length mismatch header=" << length2
-                  << " second_read=" << length << "\n";
+        BNO_LOG_WARN("shtp: length mismatch header={} second_read={}", length2, length);
         err.code      = ShtpError::Code::InvalidHeader;
         err.sys_errno = EPROTO;
         err.message   = "length mismatch";
@@ -0,0 +1,140 @@
+#include "bno/shtp_replay.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#include "bno/imu_log.hpp"
+#include "bno/sh2_reports.hpp"
+
+namespace bno {
+
+namespace {
+
+void put_q(std::vector<std::uint8_t>& out, double v, double scale)
+{
+    const double raw = std::clamp(std::round(v * scale), -32768.0, 32767.0);
+    const auto u = static_cast<std::uint16_t>(static_cast<std::int16_t>(raw));
+    out.push_back(static_cast<std::uint8_t>(u & 0xFF));
+    out.push_back(static_cast<std::uint8_t>(u >> 8));
+}
+
+// id, sequence, status (dokładność 3, delay 0), delay
+void put_report_header(std::vector<std::uint8_t>& out, Sh2SensorId id, std::uint8_t seq)
+{
+    out.push_back(static_cast<std::uint8_t>(id));
+    out.push_back(seq);
+    out.push_back(0x03);
+    out.push_back(0x00);
+}
+
+} // namespace
+
+void encode_sh2_input_payload(const ImuCsvRow& row, std::uint8_t report_seq,
+                              std::vector<std::uint8_t>& out)
+{
+    out.clear();
+    out.push_back(0xFB);   // Base Timestamp Reference, delta 0
+    out.push_back(0x00);
+    out.push_back(0x00);
+    out.push_back(0x00);
+    out.push_back(0x00);
+
+    put_report_header(out, Sh2SensorId::GameRotationVector, report_seq);
+    put_q(out, row.qi, 16384.0);
+    put_q(out, row.qj, 16384.0);
+    put_q(out, row.qk, 16384.0);
+    put_q(out, row.qw, 16384.0);
+
+    put_report_header(out, Sh2SensorId::GyroscopeCalibrated, report_seq);
+    put_q(out, row.gx, 512.0);
+    put_q(out, row.gy, 512.0);
+    put_q(out, row.gz, 512.0);
+
+    put_report_header(out, Sh2SensorId::LinearAcceleration, report_seq);
+    put_q(out, row.ax, 256.0);
+    put_q(out, row.ay, 256.0);
+    put_q(out, row.az, 256.0);
+}
+
+bool ShtpReplayTransport::open(const std::string& path, ShtpError& err)
+{
+    std::vector<ImuCsvRow> rows;
+    std::string rerr;
+    if (!read_imu_samples(path, rows, rerr) || rows.empty()) {
+        err.code      = ShtpError::Code::IoError;
+        err.sys_errno = 0;
+        err.message   = "replay " + path + ": " + (rerr.empty() ? "no samples" : rerr);
+        return false;
+    }
+    open_rows(std::move(rows));
+    err = ShtpError{};
+    return true;
+}
+
+void ShtpReplayTransport::open_rows(std::vector<ImuCsvRow> rows)
+{
+    rows_ = std::move(rows);
+    pos_ = 0;
+    t_offset_ = 0.0;
+    frame_t_ = 0.0;
+    frames_sent_ = 0;
+}
+
+std::optional<ShtpFrame> ShtpReplayTransport::read_frame(ShtpError& err, int timeout_ms)
+{
+    err = ShtpError{};
+    if (rows_.empty()) {
+        err.code    = ShtpError::Code::NotOpen;
+        err.message = "replay not open";
+        return std::nullopt;
+    }
+    if (pos_ >= rows_.size()) {
+        if (!cfg_.loop) {
+            return std::nullopt;
+        }
+        // kolejny przebieg zaczyna się okres próbki po ostatnim wierszu
+        const double span = rows_.back().t - rows_.front().t;
+        const double dt = rows_.size() > 1 ? span / static_cast<double>(rows_.size() - 1) : 0.01;
+        t_offset_ += span + dt;
+        pos_ = 0;
+    }
+
+    const auto& row = rows_[pos_];
+    const double t = row.t - rows_.front().t + t_offset_;
+
+    if (cfg_.speed > 0.0) {
+        if (frames_sent_ == 0) {
+            wall_start_ = std::chrono::steady_clock::now();
+        }
+        const auto due = wall_start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(t / cfg_.speed));
+        const auto now = std::chrono::steady_clock::now();
+        if (due - now > std::chrono::milliseconds(timeout_ms)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+            return std::nullopt;   // jak timeout poll() w ShtpI2cTransport
+        }
+        std::this_thread::sleep_until(due);
+    }
+
+    ShtpFrame frame;
+    encode_sh2_input_payload(row, sequence_, frame.payload);
+    frame.header.length_le = static_cast<std::uint16_t>(frame.payload.size() + 4);
+    frame.header.channel   = static_cast<std::uint8_t>(ShtpChannel::SensorReport);
+    frame.header.sequence  = sequence_++;
+
+    frame_t_ = t;
+    ++frames_sent_;
+    ++pos_;
+    return frame;
+}
+
+bool ShtpReplayTransport::write_frame(ShtpChannel, const std::uint8_t*, std::size_t,
+                                      ShtpError& err)
+{
+    err = ShtpError{};
+    return true;
+}
+
+} // namespace bno
@@ -0,0 +1,552 @@
+#include "bno/shtp_sim.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "bno/sh2_reports.hpp"
+
+namespace bno {
+
+namespace {
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+// Gest: szybki start (półokres sinusa, szczyt gesture_peak) i dwa razy
+// dłuższe, łagodniejsze hamowanie – Δv obu faz się znosi, ruch kończy się w miejscu
+constexpr double GESTURE_ACCEL_S = 0.12;
+constexpr double GESTURE_S = 3.0 * GESTURE_ACCEL_S;
+constexpr double TAP_LATENCY_S = 0.01;      // tap zgłaszany tuż po początku ruchu
+constexpr double SIG_MOTION_LATENCY_S = 0.15;
+constexpr double DELAY_UNIT_S = 1e-4;       // delay / base delta SH-2: 100 µs
+constexpr std::size_t MAX_REPORT_BYTES = 12;
+
+constexpr Sh2SensorId SLOT_IDS[] = {
+    Sh2SensorId::GameRotationVector,
+    Sh2SensorId::GyroscopeCalibrated,
+    Sh2SensorId::LinearAcceleration,
+    Sh2SensorId::TapDetector,
+    Sh2SensorId::SignificantMotion,
+};
+
+// Stały, dostępny w dowolnej kolejności ciąg liczb losowych (splitmix64) –
+// gest k nie zależy od tego, ile próbek wygenerowano przed nim.
+std::uint64_t splitmix64(std::uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+double unit_from(std::uint64_t h)
+{
+    return static_cast<double>(h >> 11) * 0x1.0p-53;
+}
+
+void put_q(std::vector<std::uint8_t>& out, double v, double scale)
+{
+    const double raw = std::clamp(std::round(v * scale), -32768.0, 32767.0);
+    const auto u = static_cast<std::uint16_t>(static_cast<std::int16_t>(raw));
+    out.push_back(static_cast<std::uint8_t>(u & 0xFF));
+    out.push_back(static_cast<std::uint8_t>(u >> 8));
+}
+
+void put_u32(std::vector<std::uint8_t>& out, std::uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+    }
+}
+
+std::uint32_t le_u32(const std::uint8_t* p)
+{
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+template <typename T>
+bool parse_number(std::string_view s, T& out)
+{
+    const auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc{} && p == s.data() + s.size();
+}
+
+bool set_device_key(SimDeviceConfig& d, std::string_view key, std::string_view value)
+{
+    if (key == "count") return parse_number(value, d.count);
+    if (key == "accel") return parse_number(value, d.accel_hz);
+    if (key == "gyro") return parse_number(value, d.gyro_hz);
+    if (key == "grv") return parse_number(value, d.grv_hz);
+    if (key == "batch") return parse_number(value, d.batch);
+    if (key == "gesture_every") return parse_number(value, d.gesture_every_s);
+    if (key == "gesture_peak") return parse_number(value, d.gesture_peak);
+    if (key == "noise") return parse_number(value, d.noise);
+    if (key == "corrupt") return parse_number(value, d.corrupt);
+    if (key == "truncate") return parse_number(value, d.truncate);
+    if (key == "drop") return parse_number(value, d.drop);
+    if (key == "io_error") return parse_number(value, d.io_error);
+    if (key == "reset_every") return parse_number(value, d.reset_every_s);
+    return false;
+}
+
+} // namespace
+
+// ---------- Scenariusz ----------
+
+std::size_t SimScenario::device_count() const
+{
+    std::size_t n = 0;
+    for (const auto& g : groups) {
+        n += g.count;
+    }
+    return n;
+}
+
+const SimDeviceConfig& SimScenario::device(std::size_t index) const
+{
+    for (const auto& g : groups) {
+        if (index < g.count) {
+            return g;
+        }
+        index -= g.count;
+    }
+    return groups.back();
+}
+
+bool parse_sim_scenario(std::string_view text, SimScenario& out, std::string& err)
+{
+    SimScenario sc;
+    std::size_t line_no = 0;
+    while (!text.empty()) {
+        const auto nl = text.find('\n');
+        std::string_view line = text.substr(0, nl);
+        text = nl == std::string_view::npos ? std::string_view{} : text.substr(nl + 1);
+        ++line_no;
+        if (const auto hash = line.find('#'); hash != std::string_view::npos) {
+            line = line.substr(0, hash);
+        }
+
+        std::vector<std::string_view> tok;
+        std::size_t pos = 0;
+        while (pos < line.size()) {
+            while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) {
+                ++pos;
+            }
+            const std::size_t start = pos;
+            while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r') {
+                ++pos;
+            }
+            if (pos > start) {
+                tok.push_back(line.substr(start, pos - start));
+            }
+        }
+        if (tok.empty()) {
+            continue;
+        }
+
+        const std::string where = "line " + std::to_string(line_no) + ": ";
+        bool ok = true;
+        if (tok[0] == "device") {
+            SimDeviceConfig d;
+            for (std::size_t i = 1; i < tok.size() && ok; ++i) {
+                const auto eq = tok[i].find('=');
+                ok = eq != std::string_view::npos &&
+                     set_device_key(d, tok[i].substr(0, eq), tok[i].substr(eq + 1));
+                if (!ok) {
+                    err = where + "bad device key '" + std::string(tok[i]) + "'";
+                    return false;
+                }
+            }
+            if (d.count == 0 || d.batch == 0 || d.accel_hz < 0 || d.gyro_hz < 0 || d.grv_hz < 0 ||
+                (d.gesture_every_s > 0.0 && d.gesture_every_s < 1.0)) {
+                err = where + "count and batch must be >= 1, rates >= 0, gesture_every 0 or >= 1";
+                return false;
+            }
+            sc.groups.push_back(d);
+        } else if (tok.size() == 2 && tok[0] == "duration") {
+            ok = parse_number(tok[1], sc.duration_s) && sc.duration_s > 0.0;
+        } else if (tok.size() == 2 && tok[0] == "speed") {
+            ok = parse_number(tok[1], sc.speed) && sc.speed >= 0.0;
+        } else if (tok.size() == 2 && tok[0] == "seed") {
+            ok = parse_number(tok[1], sc.seed);
+        } else if (tok.size() == 2 && tok[0] == "threads") {
+            ok = parse_number(tok[1], sc.threads) && sc.threads > 0;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            err = where + "cannot parse '" + std::string(line) + "'";
+            return false;
+        }
+    }
+    if (sc.groups.empty()) {
+        err = "scenario has no device lines";
+        return false;
+    }
+    out = std::move(sc);
+    return true;
+}
+
+bool load_sim_scenario(const std::string& path, SimScenario& out, std::string& err)
+{
+    std::ifstream in(path);
+    if (!in) {
+        err = "cannot open " + path;
+        return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    if (!parse_sim_scenario(ss.str(), out, err)) {
+        err = path + ": " + err;
+        return false;
+    }
+    return true;
+}
+
+// ---------- Urządzenie ----------
+
+ShtpSimTransport::ShtpSimTransport(const SimDeviceConfig& cfg, std::uint64_t seed, double speed)
+    : cfg_(cfg), rng_(seed), speed_(speed)
+{
+    // batch tak, by ramka zmieściła się w SHTP_MAX_FRAME
+    const std::size_t max_batch = (SHTP_MAX_FRAME - 4 - 5) / MAX_REPORT_BYTES;
+    cfg_.batch = std::clamp<std::size_t>(cfg_.batch, 1, max_batch);
+
+    std::normal_distribution<double> normal(0.0, 1.0);
+    Quat q{normal(rng_), normal(rng_), normal(rng_), normal(rng_)};
+    const double n = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    orientation_ = n > 1e-9 ? Quat{q.w / n, q.x / n, q.y / n, q.z / n} : Quat{};
+    gesture_seed_ = rng_();
+    for (auto& r : reports_) {
+        r.next_t = INF;
+    }
+    next_reset_t_ = cfg_.reset_every_s > 0.0 ? cfg_.reset_every_s : INF;
+}
+
+double ShtpSimTransport::gesture_start(std::uint64_t k) const
+{
+    // gest k w [every·(k+1), every·(k+1.25)) – kolejne nigdy się nie nakładają
+    const double jitter = 0.25 * unit_from(splitmix64(gesture_seed_ ^ (2 * k)));
+    return cfg_.gesture_every_s * (static_cast<double>(k) + 1.0 + jitter);
+}
+
+Vec3 ShtpSimTransport::gesture_axis(std::uint64_t k) const
+{
+    const auto h = splitmix64(gesture_seed_ ^ (2 * k + 1));
+    const double s = (h & 1) ? 1.0 : -1.0;
+    switch ((h >> 1) % 3) {
+    case 0:  return Vec3{s, 0.0, 0.0};
+    case 1:  return Vec3{0.0, s, 0.0};
+    default: return Vec3{0.0, 0.0, s};
+    }
+}
+
+std::uint64_t ShtpSimTransport::first_gesture_at_or_after(double t) const
+{
+    if (t <= 0.0) {
+        return 0;
+    }
+    auto k = static_cast<std::uint64_t>(std::max(0.0, std::floor(t / cfg_.gesture_every_s) - 2.0));
+    while (gesture_start(k) < t) {
+        ++k;
+    }
+    return k;
+}
+
+Vec3 ShtpSimTransport::world_accel(double t) const
+{
+    if (cfg_.gesture_every_s <= 0.0) {
+        return Vec3{};
+    }
+    const double k0 = std::floor(t / cfg_.gesture_every_s) - 1.0;
+    for (double kd = k0; kd >= std::max(0.0, k0 - 1.0); kd -= 1.0) {
+        const auto k = static_cast<std::uint64_t>(kd);
+        const double u = t - gesture_start(k);
+        if (u >= 0.0 && u < GESTURE_S) {
+            constexpr double PI = 3.14159265358979323846;
+            const double a = u < GESTURE_ACCEL_S
+                ? cfg_.gesture_peak * std::sin(PI * u / GESTURE_ACCEL_S)
+                : -0.5 * cfg_.gesture_peak * std::sin(PI * (u - GESTURE_ACCEL_S) / (2.0 * GESTURE_ACCEL_S));
+            const Vec3 axis = gesture_axis(k);
+            return Vec3{a * axis.x, a * axis.y, a * axis.z};
+        }
+    }
+    return Vec3{};
+}
+
+void ShtpSimTransport::schedule_wake(Slot slot, double after)
+{
+    Report& r = reports_[slot];
+    if (r.interval_us == 0 || cfg_.gesture_every_s <= 0.0) {
+        r.next_t = INF;
+        return;
+    }
+    const double latency = slot == TAP ? TAP_LATENCY_S : SIG_MOTION_LATENCY_S;
+    r.next_t = gesture_start(first_gesture_at_or_after(after - latency)) + latency;
+}
+
+void ShtpSimTransport::reset_device(double t)
+{
+    for (auto& r : reports_) {
+        r.interval_us = 0;
+        r.next_t = INF;
+    }
+    next_reset_t_ = cfg_.reset_every_s > 0.0 ? t + cfg_.reset_every_s : INF;
+    ++stats_.resets;
+}
+
+void ShtpSimTransport::put_report(std::vector<std::uint8_t>& out, Slot slot, double t, double t_first)
+{
+    Report& r = reports_[slot];
+    const auto delay = static_cast<std::uint32_t>(
+        std::clamp(std::lround((t - t_first) / DELAY_UNIT_S), 0L, 16383L));
+    out.push_back(static_cast<std::uint8_t>(SLOT_IDS[slot]));
+    out.push_back(r.seq++);
+    out.push_back(static_cast<std::uint8_t>(0x03 | ((delay >> 8) << 2)));   // dokładność 3
+    out.push_back(static_cast<std::uint8_t>(delay & 0xFF));
+
+    std::normal_distribution<double> noise(0.0, 1.0);
+    switch (slot) {
+    case GRV:
+        put_q(out, orientation_.x, 16384.0);
+        put_q(out, orientation_.y, 16384.0);
+        put_q(out, orientation_.z, 16384.0);
+        put_q(out, orientation_.w, 16384.0);
+        break;
+    case GYRO:
+        for (int i = 0; i < 3; ++i) {
+            put_q(out, cfg_.noise * noise(rng_), 512.0);
+        }
+        break;
+    case ACCEL: {
+        const Vec3 a = rotate_vector_by_quat(world_accel(t), quat_conj(orientation_));
+        put_q(out, a.x + cfg_.noise * noise(rng_), 256.0);
+        put_q(out, a.y + cfg_.noise * noise(rng_), 256.0);
+        put_q(out, a.z + cfg_.noise * noise(rng_), 256.0);
+        break;
+    }
+    case TAP: {
+        // flagi: bit osi (X=1, Y=2, Z=4) i znaku (X+=8, Y+=16, Z+=32)
+        const Vec3 axis = gesture_axis(first_gesture_at_or_after(t - TAP_LATENCY_S));
+        const int i = axis.x != 0.0 ? 0 : (axis.y != 0.0 ? 1 : 2);
+        const double sgn = axis.x + axis.y + axis.z;
+        out.push_back(static_cast<std::uint8_t>((1 << i) | (sgn > 0.0 ? (8 << i) : 0)));
+        break;
+    }
+    case SIG_MOTION:
+        out.push_back(1);
+        out.push_back(0);
+        break;
+    case SLOT_COUNT:
+        break;
+    }
+    ++stats_.reports;
+}
+
+bool ShtpSimTransport::build_frame(ShtpFrame& frame, double& t_frame, double horizon)
+{
+    picks_.clear();
+    bool wake = false;
+    while (picks_.size() < cfg_.batch) {
+        std::size_t best = SLOT_COUNT;
+        for (std::size_t s = 0; s < SLOT_COUNT; ++s) {
+            if (reports_[s].next_t < INF &&
+                (best == SLOT_COUNT || reports_[s].next_t < reports_[best].next_t)) {
+                best = s;
+            }
+        }
+        const double t_best = best == SLOT_COUNT ? INF : reports_[best].next_t;
+
+        if (next_reset_t_ <= t_best) {
+            if (!picks_.empty() || next_reset_t_ > horizon) {
+                break;
+            }
+            // reset: ramka "reset complete" na kanale wykonawczym, raporty wyłączone
+            const double t = next_reset_t_;
+            reset_device(t);
+            frame.payload.assign(1, 0x01);
+            frame.header.channel = static_cast<std::uint8_t>(ShtpChannel::Executable);
+            t_frame = t;
+            return true;
+        }
+        if (best == SLOT_COUNT || t_best > horizon) {
+            break;
+        }
+        const bool is_wake = best == TAP || best == SIG_MOTION;
+        if (is_wake && !picks_.empty()) {
+            break;   // raport budzący idzie osobną ramką kanału 4
+        }
+        picks_.emplace_back(static_cast<Slot>(best), t_best);
+        Report& r = reports_[best];
+        if (best == SIG_MOTION) {
+            r.interval_us = 0;    // one-shot
+            r.next_t = INF;
+        } else if (is_wake) {
+            schedule_wake(static_cast<Slot>(best), t_best + GESTURE_S);
+        } else {
+            r.next_t += static_cast<double>(r.interval_us) * 1e-6;
+        }
+        if (is_wake) {
+            wake = true;
+            break;
+        }
+    }
+    if (picks_.empty()) {
+        return false;
+    }
+
+    // 0xFB: base delta = czas od pierwszego raportu do wysłania ramki (ostatni raport)
+    const double t_first = picks_.front().second;
+    t_frame = picks_.back().second;
+    frame.payload.clear();
+    frame.payload.push_back(0xFB);
+    put_u32(frame.payload, static_cast<std::uint32_t>(std::lround((t_frame - t_first) / DELAY_UNIT_S)));
+    for (const auto& [slot, t] : picks_) {
+        put_report(frame.payload, slot, t, t_first);
+    }
+    frame.header.channel = static_cast<std::uint8_t>(wake ? ShtpChannel::WakeReport
+                                                          : ShtpChannel::SensorReport);
+    return true;
+}
+
+bool ShtpSimTransport::apply_faults(ShtpFrame& frame, ShtpError& err)
+{
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    if (cfg_.drop > 0.0 && u(rng_) < cfg_.drop) {
+        ++stats_.dropped;
+        return false;
+    }
+    if (cfg_.io_error > 0.0 && u(rng_) < cfg_.io_error) {
+        ++stats_.io_errors;
+        err.code = ShtpError::Code::IoError;
+        err.sys_errno = EIO;   // jak nieudany read() na i2c-dev
+        err.message = "sim: injected I/O error";
+        return false;
+    }
+    if (cfg_.truncate > 0.0 && frame.payload.size() > 1 && u(rng_) < cfg_.truncate) {
+        std::uniform_int_distribution<std::size_t> cut(1, frame.payload.size() - 1);
+        frame.payload.resize(cut(rng_));
+        ++stats_.truncated;
+    }
+    if (cfg_.corrupt > 0.0 && !frame.payload.empty() && u(rng_) < cfg_.corrupt) {
+        std::uniform_int_distribution<std::size_t> at(0, frame.payload.size() - 1);
+        std::uniform_int_distribution<int> bit(0, 7);
+        frame.payload[at(rng_)] ^= static_cast<std::uint8_t>(1 << bit(rng_));
+        ++stats_.corrupted;
+    }
+    return true;
+}
+
+std::optional<ShtpFrame> ShtpSimTransport::read_frame(ShtpError& err, int timeout_ms)
+{
+    err = ShtpError{};
+    const double timeout_s = std::max(timeout_ms, 1) * 1e-3;
+    // speed = 0: ramka musi zmieścić się w oknie timeoutu czasu wirtualnego;
+    // speed > 0: na czas czeka się niżej, na zegarze ściennym
+    const double horizon = speed_ > 0.0 ? INF : now_ + timeout_s;
+    if (speed_ > 0.0 && !wall_started_) {
+        // czas wirtualny now_ odpowiada chwili pierwszego odczytu
+        wall_started_ = true;
+        wall_start_ = std::chrono::steady_clock::now() -
+                      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                          std::chrono::duration<double>(now_ / speed_));
+    }
+
+    // zgubione ramki nie kończą wywołania – jak na szynie, przychodzi następna
+    for (int attempt = 0; !ready_ && attempt < 64; ++attempt) {
+        ShtpFrame frame;
+        double t = 0.0;
+        if (!build_frame(frame, t, horizon)) {
+            // nic do wysłania w tym oknie – timeout, czas wirtualny płynie dalej
+            if (speed_ > 0.0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+                const double wall = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - wall_start_).count();
+                now_ = std::max(now_, wall * speed_);
+            } else {
+                now_ += timeout_s;
+            }
+            return std::nullopt;
+        }
+        now_ = std::max(now_, t);
+        if (!apply_faults(frame, err)) {
+            if (err) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        frame.header.length_le = static_cast<std::uint16_t>(frame.payload.size() + 4);
+        frame.header.sequence = channel_seq_[frame.header.channel & 7]++;
+        ready_ = std::move(frame);
+        ready_t_ = t;
+    }
+    if (!ready_) {
+        return std::nullopt;
+    }
+
+    if (speed_ > 0.0) {
+        const auto due = wall_start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(ready_t_ / speed_));
+        const auto now = std::chrono::steady_clock::now();
+        if (due - now > std::chrono::milliseconds(timeout_ms)) {
+            if (timeout_ms > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+            }
+            return std::nullopt;   // jak timeout poll() w ShtpI2cTransport
+        }
+        std::this_thread::sleep_until(due);
+    }
+
+    frame_t_ = ready_t_;
+    ++stats_.frames;
+    if (cfg_.gesture_every_s > 0.0) {
+        stats_.gestures = first_gesture_at_or_after(frame_t_ + 1e-9);
+    }
+    std::optional<ShtpFrame> out = std::move(ready_);
+    ready_.reset();
+    return out;
+}
+
+bool ShtpSimTransport::write_frame(ShtpChannel channel, const std::uint8_t* data, std::size_t len,
+                                   ShtpError& err)
+{
+    err = ShtpError{};
+    if (!data || len == 0) {
+        return true;
+    }
+    ++stats_.commands;
+    if (channel == ShtpChannel::Executable && data[0] == 0x01) {
+        for (auto& r : reports_) {
+            r.interval_us = 0;
+            r.next_t = INF;
+        }
+        next_reset_t_ = now_;   // "reset complete" jako następna ramka
+        return true;
+    }
+    if (channel != ShtpChannel::Control || data[0] != 0xFD || len < 17) {
+        return true;            // inne komendy przyjmujemy bez skutku
+    }
+    for (std::size_t s = 0; s < SLOT_COUNT; ++s) {
+        if (static_cast<std::uint8_t>(SLOT_IDS[s]) != data[1]) {
+            continue;
+        }
+        Report& r = reports_[s];
+        r.interval_us = le_u32(&data[5]);
+        if (r.interval_us == 0) {
+            r.next_t = INF;
+        } else if (s == TAP || s == SIG_MOTION) {
+            schedule_wake(static_cast<Slot>(s), now_);
+        } else {
+            r.next_t = now_ + static_cast<double>(r.interval_us) * 1e-6;
+        }
+    }
+    return true;
+}
+
+} // namespace bno